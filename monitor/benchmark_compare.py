@@ -0,0 +1,78 @@
+#!/usr/bin/env python3
+# Copyright 2023 Dhiraj Wishal
+# SPDX-License-Identifier: Apache-2.0
+
+'''
+Compare two benchmark runs.
+
+The benchmarks (src/bench/) print one JSON object per line. Any other line in the files (for example the serial monitor's output) is
+ignored. The median and the 99th percentile of every benchmark are compared, and the script fails when a median got slower than the
+threshold, so it can be used to catch regressions.
+
+Usage: benchmark_compare.py <baseline> <current> [--threshold 10]
+'''
+
+import argparse
+import json
+import sys
+
+
+def load_results(path):
+    results = {}
+    with open(path, 'r', encoding='latin-1') as file:
+        for line in file:
+            line = line.strip()
+            if not line.startswith('{'):
+                continue
+
+            try:
+                result = json.loads(line)
+            except json.JSONDecodeError:
+                continue
+
+            if 'name' in result:
+                results[result['name']] = result
+
+    return results
+
+
+def change(baseline, current):
+    if baseline == 0:
+        return 0.0
+
+    return (current - baseline) * 100.0 / baseline
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Compare two benchmark runs.')
+    parser.add_argument('baseline', help='The baseline results.')
+    parser.add_argument('current', help='The current results.')
+    parser.add_argument('--threshold', type=float, default=10.0, help='The allowed median slow down in percent.')
+    arguments = parser.parse_args()
+
+    baseline = load_results(arguments.baseline)
+    current = load_results(arguments.current)
+
+    regressions = 0
+    print(f'{"benchmark":32} {"unit":>6} {"median":>10} {"change":>8} {"p99":>10} {"change":>8}')
+    for name, result in current.items():
+        if name not in baseline:
+            print(f'{name:32} {result["unit"]:>6} {result["median"]:>10} {"new":>8} {result["p99"]:>10} {"new":>8}')
+            continue
+
+        previous = baseline[name]
+        median_change = change(previous['median'], result['median'])
+        p99_change = change(previous['p99'], result['p99'])
+
+        marker = ''
+        if median_change > arguments.threshold:
+            marker = ' <- slower'
+            regressions += 1
+
+        print(f'{name:32} {result["unit"]:>6} {result["median"]:>10} {median_change:>+7.1f}% {result["p99"]:>10} {p99_change:>+7.1f}%{marker}')
+
+    return 1 if regressions > 0 else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,196 @@
+#!/usr/bin/env python3
+# Copyright 2023 Dhiraj Wishal
+# SPDX-License-Identifier: Apache-2.0
+
+'''
+Decoder for the controller's blackbox logs.
+
+The log is a sequence of blocks. Every block is a packed, little-endian header, followed by the records. A record is its type, followed by
+the difference of its time to the previous record and the differences of its fields to the previous record of the same type in the block,
+as zig-zag encoded variable length integers (7 bits per byte, least significant first). The blocks start with "PBBX", so a damaged block
+(the checksum does not match) is skipped.
+
+A download of the blackbox partition holds every log since it was last erased, one after the other. The blocks of a log are numbered from
+0, so a block with the number 0 starts the next log.
+
+This file must match src/algorithms/BlackboxEncoder.hpp and src/systems/BlackboxSystem.cpp.
+
+Usage: blackbox_decoder.py <log> [--output prefix] [--index index]
+Each record type of the selected log (the last one by default) is written to <prefix>_<type>.csv.
+'''
+
+import argparse
+import binascii
+import struct
+import sys
+
+BLACKBOX_VERSION = 3
+BLACKBOX_MAGIC = b'PBBX'
+
+HEADER = struct.Struct('<4sHHIIHH')
+
+# The fixed point scale of the angles, rates, PID terms and rotor commands.
+SCALE = 100.0
+
+AXES = ['pitch', 'yaw', 'roll']
+
+# Type: (name, field names, field kinds). The kinds are 'i' for integers, 'x' for fixed point values and 'f' for float bits.
+RECORDS = {
+    0: ('imu', ['accel_x', 'accel_y', 'accel_z', 'gyro_x', 'gyro_y', 'gyro_z', 'dt'], 'iiiiiif'),
+    1: ('attitude', AXES + [axis + '_rate' for axis in AXES], 'xxxxxx'),
+    2: ('rate_control', [term + '_' + axis for term in ['setpoint', 'p', 'i', 'd'] for axis in AXES], 'x' * 12),
+    3: ('inputs', ['thrust', 'pitch', 'roll', 'yaw', 'frame_timestamp', 'required_fly_mode', 'control_mode'], 'ffffiii'),
+    4: ('actuators', ['left_rotor', 'right_rotor', 'left_wing', 'right_wing', 'elevator', 'rudder', 'fly_mode'], 'xxiiiii'),
+    5: ('calibration', ['gyro_bias_x', 'gyro_bias_y', 'gyro_bias_z', 'accel_offset_x', 'accel_offset_y', 'accel_offset_z', 'temperature'], 'fffffff'),
+}
+
+
+def decode_varint(data, index):
+    value = 0
+    shift = 0
+    while True:
+        if index >= len(data) or shift > 28:
+            raise ValueError('truncated varint')
+        byte = data[index]
+        index += 1
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if byte < 0x80:
+            return value, index
+
+
+def decode_zigzag(value):
+    return (value >> 1) ^ -(value & 1)
+
+
+def to_int32(value):
+    value &= 0xFFFFFFFF
+    return value - (1 << 32) if value & 0x80000000 else value
+
+
+def convert(value, kind):
+    if kind == 'x':
+        return value / SCALE
+    if kind == 'f':
+        return struct.unpack('<f', struct.pack('<i', value))[0]
+    return value
+
+
+class Record:
+    def __init__(self, name, timestamp, raw, fields):
+        self.name = name
+        self.timestamp = timestamp
+        self.raw = raw
+        self.fields = fields
+
+
+class BlackboxDecoder:
+    def __init__(self):
+        self.damaged_blocks = 0
+        self.lost_blocks = 0
+        self.previous_sequence = None
+        self.log = -1
+
+    def decode(self, data):
+        '''
+        Decode a whole log. Yields Record objects in the order they were recorded.
+        '''
+        index = 0
+        while True:
+            start = data.find(BLACKBOX_MAGIC, index)
+            if start < 0 or start + HEADER.size > len(data):
+                return
+            magic, version, size, sequence, timestamp, checksum, _ = HEADER.unpack_from(data, start)
+            end = start + HEADER.size + size
+            if version != BLACKBOX_VERSION or end > len(data) or self.checksum(data[start:end]) != checksum:
+                self.damaged_blocks += 1
+                index = start + 1
+                continue
+
+            try:
+                records = list(self.decode_block(data[start + HEADER.size:end], timestamp))
+            except (ValueError, KeyError):
+                self.damaged_blocks += 1
+                index = start + 1
+                continue
+
+            if sequence == 0 or self.previous_sequence is None:
+                self.log += 1
+            elif sequence > self.previous_sequence:
+                self.lost_blocks += sequence - self.previous_sequence - 1
+            self.previous_sequence = sequence
+
+            yield from records
+            index = end
+
+    @staticmethod
+    def checksum(block):
+        # CRC-16/CCITT-FALSE of the block, with the checksum field set to 0.
+        return binascii.crc_hqx(block[:16] + b'\x00\x00' + block[18:], 0xFFFF)
+
+    def decode_block(self, data, timestamp):
+        previous = {key: [0] * len(value[1]) for key, value in RECORDS.items()}
+        index = 0
+        while index < len(data):
+            record_type = data[index]
+            index += 1
+            name, names, kinds = RECORDS[record_type]
+
+            difference, index = decode_varint(data, index)
+            timestamp = (timestamp + decode_zigzag(difference)) & 0xFFFFFFFF
+
+            fields = previous[record_type]
+            for i in range(len(fields)):
+                difference, index = decode_varint(data, index)
+                fields[i] = to_int32(fields[i] + decode_zigzag(difference))
+
+            raw = list(fields)
+            yield Record(name, timestamp, raw, [convert(value, kind) for value, kind in zip(raw, kinds)])
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decode a blackbox log to CSV files.')
+    parser.add_argument('log')
+    parser.add_argument('--output', default=None, help='the prefix of the CSV files (the log name by default)')
+    parser.add_argument('--index', type=int, default=-1, help='the index of the log in a partition download (the last one by default)')
+    args = parser.parse_args()
+
+    prefix = args.output or args.log.rsplit('.', 1)[0]
+    with open(args.log, 'rb') as log:
+        data = log.read()
+
+    files = {}
+    counts = {}
+    decoder = BlackboxDecoder()
+    logs = []
+    for record in decoder.decode(data):
+        if decoder.log == len(logs):
+            logs.append([])
+        logs[decoder.log].append(record)
+
+    if not -len(logs) <= args.index < len(logs):
+        sys.stderr.write(f'There are {len(logs)} logs.\n')
+        sys.exit(1)
+
+    for record in logs[args.index]:
+        if record.name not in files:
+            names = next(value[1] for value in RECORDS.values() if value[0] == record.name)
+            files[record.name] = open(f'{prefix}_{record.name}.csv', 'w')
+            files[record.name].write('timestamp,' + ','.join(names) + '\n')
+            counts[record.name] = 0
+        values = ','.join(f'{value:.9g}' if isinstance(value, float) else str(value) for value in record.fields)
+        files[record.name].write(f'{record.timestamp},{values}\n')
+        counts[record.name] += 1
+
+    for file in files.values():
+        file.close()
+
+    sys.stderr.write(f'Log {args.index % len(logs)} (the logs are numbered from 0 to {len(logs) - 1}).\n')
+    for name, count in counts.items():
+        sys.stderr.write(f'{name}: {count} records\n')
+    if decoder.damaged_blocks or decoder.lost_blocks:
+        sys.stderr.write(f'{decoder.damaged_blocks} damaged and {decoder.lost_blocks} lost blocks.\n')
+
+
+if __name__ == '__main__':
+    main()
@@ -29,6 +29,9 @@ import sys
 from platformio.commands.device import DeviceMonitorFilter
 from platformio.project.config import ProjectConfig
 
+sys.path.append(os.path.dirname(os.path.abspath(__file__)))
+from telemetry_decoder import TelemetryDecoder
+
 PORT = 19200
 
 class SerialPlotter(DeviceMonitorFilter):
@@ -41,6 +44,7 @@ class SerialPlotter(DeviceMonitorFilter):
         self.plot = None
         self.plot_sock = ''
         self.plot = ''
+        self.decoder = TelemetryDecoder()
 
     def __call__(self):
         pio_root = ProjectConfig.get_instance().get_optional_dir("core")
@@ -64,8 +68,15 @@ class SerialPlotter(DeviceMonitorFilter):
             self.plot.kill()
 
     def rx(self, text):
+        # The telemetry is binary, so get the raw bytes back (monitor_encoding must be latin-1) and turn each message into a plot line.
+        output = ''
+        for result in self.decoder.feed(text.encode('latin-1')):
+            if isinstance(result, str):
+                output += result
+            else:
+                self.buffer += ' '.join(f'{result.name}.{key}:{value}' for key, value in result.fields.items()) + '\n'
+
         if self.plot.poll() is None:    # None means the child is running
-            self.buffer += text
             if '\n' in self.buffer:
                 try:
                     self.plot_sock.send(bytes(self.buffer, 'utf-8'))
@@ -78,4 +89,4 @@ class SerialPlotter(DeviceMonitorFilter):
                 self.buffer = ''
         else:
             os.kill(os.getpid(), signal.SIGINT)
-        return text
\ No newline at end of file
+        return output
\ No newline at end of file
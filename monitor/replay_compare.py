@@ -0,0 +1,78 @@
+#!/usr/bin/env python3
+# Copyright 2023 Dhiraj Wishal
+# SPDX-License-Identifier: Apache-2.0
+
+'''
+Compare two replays of a blackbox log.
+
+The replay (src/replay/) prints the actuator commands of every output update as CSV. A replay always produces the same commands, so two
+replays of the same log only differ when the controller changed: a different build or different gains. The commands are compared row by
+row, and the script prints the first difference and the largest difference of every actuator. It fails when any command differs by more
+than the tolerance, so it can be used to check that a change does not affect the control (or to review how much it does).
+
+Usage: replay_compare.py <baseline> <current> [--tolerance 0]
+'''
+
+import argparse
+import csv
+import sys
+
+
+def load_replay(path):
+    with open(path, 'r', newline='') as file:
+        return list(csv.DictReader(file))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Compare two replays of a blackbox log.')
+    parser.add_argument('baseline', help='The baseline replay.')
+    parser.add_argument('current', help='The current replay.')
+    parser.add_argument('--tolerance', type=float, default=0.0, help='The allowed difference of a command.')
+    arguments = parser.parse_args()
+
+    baseline = load_replay(arguments.baseline)
+    current = load_replay(arguments.current)
+    if not baseline or not current:
+        print('A replay is empty.')
+        return 1
+
+    columns = [column for column in baseline[0].keys() if column != 'timestamp']
+    maximum = {column: 0.0 for column in columns}
+    differing_rows = 0
+    first_difference = None
+
+    for previous, row in zip(baseline, current):
+        if previous['timestamp'] != row['timestamp']:
+            print(f'The replays are of different logs (timestamp {previous["timestamp"]} and {row["timestamp"]}).')
+            return 1
+
+        differences = {column: abs(float(row[column]) - float(previous[column])) for column in columns}
+        for column, difference in differences.items():
+            maximum[column] = max(maximum[column], difference)
+
+        if any(difference > arguments.tolerance for difference in differences.values()):
+            differing_rows += 1
+            if first_difference is None:
+                first_difference = (row['timestamp'], previous, row)
+
+    print(f'{"actuator":12} {"max difference":>16}')
+    for column in columns:
+        print(f'{column:12} {maximum[column]:>16.6g}')
+
+    print()
+    if len(baseline) != len(current):
+        print(f'The replays have {len(baseline)} and {len(current)} frames.')
+
+    if first_difference is None:
+        print(f'All {min(len(baseline), len(current))} frames match.')
+        return 1 if len(baseline) != len(current) else 0
+
+    timestamp, previous, row = first_difference
+    print(f'{differing_rows} of {min(len(baseline), len(current))} frames differ. The first difference is at {timestamp} us:')
+    print('  baseline ' + ','.join(previous[column] for column in columns))
+    print('  current  ' + ','.join(row[column] for column in columns))
+    return 1
+
+
+if __name__ == '__main__':
+    sys.exit(main())
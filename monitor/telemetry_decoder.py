@@ -0,0 +1,264 @@
+#!/usr/bin/env python3
+# Copyright 2023 Dhiraj Wishal
+# SPDX-License-Identifier: Apache-2.0
+
+'''
+Decoder for the controller's binary telemetry stream.
+
+Every frame is a packed, little-endian header, followed by the message and a CRC-16/CCITT-FALSE of both. The frame is COBS encoded and
+delimited with zero bytes. Anything that is not a valid frame (for example the text printed while the controller starts) is returned
+as text.
+
+This file must match src/core/TelemetryMessages.hpp.
+
+Usage: telemetry_decoder.py <port> [--baud 115200] [--subscribe attitude=20 pid_terms=50 ...] [--autotune rate,roll,tyreus_luyben]
+                            [--get pitch_rate_kp ...] [--set pitch_rate_kp=0.5 ...] [--reset] [--save]
+'''
+
+import argparse
+import struct
+import sys
+
+TELEMETRY_VERSION = 5
+
+HEADER = struct.Struct('<BBHI')
+CRC = struct.Struct('<H')
+
+# ID: (name, format, field names)
+MESSAGES = {
+    0: ('setpoints', '<ffffB', ['thrust', 'pitch', 'roll', 'yaw', 'fly_mode']),
+    1: ('attitude', '<ffffff', ['pitch', 'roll', 'yaw', 'pitch_rate', 'roll_rate', 'yaw_rate']),
+    2: ('pid_terms', '<' + 'f' * 12, [term + '_' + axis for term in ['p', 'i', 'd', 'output'] for axis in ['pitch', 'roll', 'yaw']]),
+    3: ('actuator_commands', '<BBBBBB', ['left_rotor', 'right_rotor', 'left_wing', 'right_wing', 'elevator', 'rudder']),
+    4: ('stage_timings', '<BBfIIHH' + 'H' * 16, ['stage', 'cpu_frequency', 'rate', 'count', 'overruns', 'budget', 'maximum'] + [f'bucket_{i}' for i in range(16)]),
+    5: ('link_quality', '<IIIIII', ['received', 'lost', 'errors', 'remote_timestamp', 'age', 'jitter']),
+    6: ('calibration', '<fffffffIHB', ['gyro_bias_x', 'gyro_bias_y', 'gyro_bias_z', 'accel_offset_x', 'accel_offset_y', 'accel_offset_z', 'temperature',
+                                       'arm_time', 'calibrations', 'loaded']),
+    7: ('auto_tune', '<BBBBHfffff', ['loop', 'axis', 'rule', 'state', 'cycles', 'ultimate_gain', 'ultimate_period', 'kp', 'ki', 'kd']),
+    8: ('parameter', '<BBBB4s', ['id', 'type', 'action', 'status', 'value']),
+}
+
+# The stages of the stage timings message.
+STAGES = ['input', 'sensor_read', 'stabilization', 'output_write', 'control_tick', 'rate_control', 'blackbox_write']
+
+# The loops, axes, rules and states of the auto tune messages.
+TUNING_LOOPS = ['rate', 'angle']
+TUNING_AXES = ['pitch', 'roll', 'yaw']
+TUNING_RULES = ['ziegler_nichols', 'ziegler_nichols_pi', 'tyreus_luyben', 'some_overshoot', 'no_overshoot']
+TUNING_STATES = ['idle', 'running', 'completed', 'failed']
+
+# The parameters in the order of their IDs, with their types (f for the floats and i for the integers), and the actions and statuses of
+# the parameter messages. These must match src/algorithms/ParameterRegistry.cpp.
+PARAMETERS = [(loop + '_' + gain, 'f') for loop in ['pitch_angle', 'roll_angle', 'pitch_rate', 'roll_rate', 'yaw_rate'] for gain in ['kp', 'ki', 'kd']] + \
+    [('wing_servo_offset_hover', 'i'), ('wing_servo_offset_cruise', 'i'), ('elevator_offset', 'i'), ('rudder_offset', 'i'),
+     ('pitch_input_range', 'i'), ('roll_input_range', 'i'), ('yaw_input_range', 'i'),
+     ('kalman_angle_noise', 'f'), ('kalman_bias_noise', 'f'), ('kalman_measurement_noise', 'f')]
+PARAMETER_TYPES = ['f', 'i']
+PARAMETER_ACTIONS = ['read', 'write', 'save', 'reset']
+PARAMETER_STATUSES = ['done', 'invalid', 'rejected']
+
+SUBSCRIBE_ID = 0x80
+SUBSCRIBE = struct.Struct('<BH')
+
+# The control message of the packet data link: thrust (0 to 1), pitch, roll and yaw (-1 to 1), fly mode, control mode and 12 auxiliary
+# channels.
+CONTROL_ID = 0x81
+CONTROL = struct.Struct('<ffffBB' + 'H' * 12)
+
+# Starts or stops an auto tune experiment: loop, axis, rule and 1 to start or 0 to stop.
+AUTO_TUNE_ID = 0x82
+AUTO_TUNE = struct.Struct('<BBBB')
+
+# Reads, writes, saves or resets the parameters: action, parameter ID, value type and the value (a float or an integer). The saves and
+# resets are answered with the parameter of the ID.
+PARAMETER_ID = 0x83
+PARAMETER = struct.Struct('<BBB4s')
+
+
+def crc16(data, crc=0xFFFF):
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def cobs_encode(data):
+    output = bytearray([0])
+    code_index = 0
+    code = 1
+    for byte in data:
+        if byte != 0:
+            output.append(byte)
+            code += 1
+        if byte == 0 or code == 0xFF:
+            output[code_index] = code
+            code_index = len(output)
+            output.append(0)
+            code = 1
+    output[code_index] = code
+    return bytes(output)
+
+
+def cobs_decode(data):
+    output = bytearray()
+    index = 0
+    while index < len(data):
+        code = data[index]
+        index += 1
+        if code == 0 or index + code - 1 > len(data):
+            return None
+        output += data[index:index + code - 1]
+        index += code - 1
+        if code != 0xFF and index < len(data):
+            output.append(0)
+    return bytes(output)
+
+
+def encode_frame(message_id, payload, sequence=0, timestamp=0):
+    frame = HEADER.pack(TELEMETRY_VERSION, message_id, sequence, timestamp) + payload
+    frame += CRC.pack(crc16(frame))
+    return b'\x00' + cobs_encode(frame) + b'\x00'
+
+
+def encode_subscribe(name, interval):
+    ids = {value[0]: key for key, value in MESSAGES.items()}
+    return encode_frame(SUBSCRIBE_ID, SUBSCRIBE.pack(ids[name], interval))
+
+
+def encode_control(sequence, timestamp, thrust, pitch, roll, yaw, fly_mode=0, control_mode=0, channels=None):
+    channels = list(channels or []) + [0] * (12 - len(channels or []))
+    return encode_frame(CONTROL_ID, CONTROL.pack(thrust, pitch, roll, yaw, fly_mode, control_mode, *channels), sequence, timestamp)
+
+
+def encode_auto_tune(loop, axis, rule, start=True):
+    return encode_frame(AUTO_TUNE_ID, AUTO_TUNE.pack(TUNING_LOOPS.index(loop), TUNING_AXES.index(axis), TUNING_RULES.index(rule), int(start)))
+
+
+def encode_parameter(action, name='pitch_angle_kp', value=0):
+    names = [parameter[0] for parameter in PARAMETERS]
+    parameter_type = PARAMETERS[names.index(name)][1]
+    return encode_frame(PARAMETER_ID, PARAMETER.pack(PARAMETER_ACTIONS.index(action), names.index(name), PARAMETER_TYPES.index(parameter_type),
+                                                     struct.pack('<' + parameter_type, float(value) if parameter_type == 'f' else int(value))))
+
+
+def decode_parameter(fields):
+    '''
+    Replace the IDs and the raw value of a parameter message with the names and the value of its type.
+    '''
+    if fields['type'] < len(PARAMETER_TYPES):
+        fields['value'] = struct.unpack('<' + PARAMETER_TYPES[fields['type']], fields['value'])[0]
+    for field, names in [('id', [parameter[0] for parameter in PARAMETERS]), ('action', PARAMETER_ACTIONS), ('status', PARAMETER_STATUSES)]:
+        if fields[field] < len(names):
+            fields[field] = names[fields[field]]
+    del fields['type']
+
+
+class Message:
+    def __init__(self, name, sequence, timestamp, fields):
+        self.name = name
+        self.sequence = sequence
+        self.timestamp = timestamp
+        self.fields = fields
+
+
+class TelemetryDecoder:
+    def __init__(self):
+        self.buffer = bytearray()
+        self.crc_errors = 0
+        self.lost_frames = 0
+        self.previous_sequence = None
+
+    def feed(self, data):
+        '''
+        Feed raw bytes to the decoder. Returns a list of decoded Message objects and text strings.
+        '''
+        results = []
+        self.buffer += data
+        while True:
+            delimiter = self.buffer.find(0)
+            if delimiter < 0:
+                break
+            chunk = bytes(self.buffer[:delimiter])
+            del self.buffer[:delimiter + 1]
+            if chunk:
+                results.append(self.decode_chunk(chunk))
+        return [result for result in results if result is not None]
+
+    def decode_chunk(self, chunk):
+        frame = cobs_decode(chunk)
+        if frame is None or len(frame) < HEADER.size + CRC.size or crc16(frame[:-CRC.size]) != CRC.unpack(frame[-CRC.size:])[0]:
+            # Not a frame, this is text printed by the controller.
+            if all(32 <= byte < 127 or byte in b'\r\n\t' for byte in chunk):
+                return chunk.decode('ascii')
+            self.crc_errors += 1
+            return None
+
+        version, message_id, sequence, timestamp = HEADER.unpack(frame[:HEADER.size])
+        if version != TELEMETRY_VERSION or message_id not in MESSAGES:
+            return None
+
+        if self.previous_sequence is not None:
+            self.lost_frames += (sequence - self.previous_sequence - 1) & 0xFFFF
+        self.previous_sequence = sequence
+
+        name, layout, names = MESSAGES[message_id]
+        payload = frame[HEADER.size:-CRC.size]
+        if len(payload) != struct.calcsize(layout):
+            return None
+        return Message(name, sequence, timestamp, dict(zip(names, struct.unpack(layout, payload))))
+
+
+def main():
+    import serial
+
+    parser = argparse.ArgumentParser(description='Decode the controller telemetry to CSV lines.')
+    parser.add_argument('port')
+    parser.add_argument('--baud', type=int, default=115200)
+    parser.add_argument('--subscribe', nargs='*', default=[], help='name=interval_ms pairs, 0 disables a message')
+    parser.add_argument('--autotune', help='loop,axis,rule of an auto tune experiment to start, or stop to stop it')
+    parser.add_argument('--get', nargs='*', default=[], help='names of the parameters to read')
+    parser.add_argument('--set', nargs='*', default=[], help='name=value pairs of the parameters to write')
+    parser.add_argument('--reset', action='store_true', help='replace the parameters with the defaults, before they are written')
+    parser.add_argument('--save', action='store_true', help='store the parameters, after they are written (only on the ground)')
+    args = parser.parse_args()
+
+    connection = serial.Serial(args.port, args.baud, timeout=0.1)
+    for subscription in args.subscribe:
+        name, interval = subscription.split('=')
+        connection.write(encode_subscribe(name, int(interval)))
+    if args.autotune == 'stop':
+        connection.write(encode_auto_tune('rate', 'pitch', 'ziegler_nichols', False))
+    elif args.autotune:
+        connection.write(encode_auto_tune(*args.autotune.split(',')))
+    if args.reset:
+        connection.write(encode_parameter('reset'))
+    for assignment in args.set:
+        name, value = assignment.split('=')
+        connection.write(encode_parameter('write', name, value))
+    for name in args.get:
+        connection.write(encode_parameter('read', name))
+    if args.save:
+        connection.write(encode_parameter('save'))
+
+    decoder = TelemetryDecoder()
+    while True:
+        for result in decoder.feed(connection.read(256)):
+            if isinstance(result, str):
+                sys.stderr.write(result)
+            else:
+                if result.name == 'stage_timings' and result.fields['stage'] < len(STAGES):
+                    result.fields['stage'] = STAGES[result.fields['stage']]
+                if result.name == 'auto_tune':
+                    for field, names in [('loop', TUNING_LOOPS), ('axis', TUNING_AXES), ('rule', TUNING_RULES), ('state', TUNING_STATES)]:
+                        if result.fields[field] < len(names):
+                            result.fields[field] = names[result.fields[field]]
+                if result.name == 'parameter':
+                    decode_parameter(result.fields)
+                values = ','.join(str(value) for value in result.fields.values())
+                print(f'{result.name},{result.timestamp},{values}', flush=True)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,101 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#include "AttitudeEstimators.hpp"
+
+#include "core/FastMath.hpp"
+
+#include <math.h>
+
+/**
+ * @brief Wrap an angle to -180 to 180 degrees.
+ *
+ * @param angle The angle in degrees.
+ * @return The wrapped angle.
+ */
+static float WrapAngle(float angle)
+{
+	if (angle > 180.0f)
+		return angle - 360.0f;
+
+	if (angle < -180.0f)
+		return angle + 360.0f;
+
+	return angle;
+}
+
+Vec3 GetAccelerometerAngles(Vec3 acceleration)
+{
+	const auto pitch = FastAtan2(acceleration.m_Y, acceleration.m_Z) * g_RadiansToDegrees;
+	const auto roll = FastAtan2(-acceleration.m_X, sqrtf((acceleration.m_Y * acceleration.m_Y) + (acceleration.m_Z * acceleration.m_Z))) * g_RadiansToDegrees;
+	return Vec3(pitch, 0.0f, roll);
+}
+
+Vec3 GetBodyRates(Vec3 rate)
+{
+	return Vec3(rate.m_X, -rate.m_Z, rate.m_Y);
+}
+
+void KalmanEstimator::update(const IMUSample &sample)
+{
+	const auto angles = GetAccelerometerAngles(sample.m_Acceleration);
+	m_Rate = GetBodyRates(sample.m_Rate);
+
+	// This fixes the transition problem when the accelerometer angle jumps between -180 and 180 degrees
+	if ((angles.m_Pitch < -90 && m_Attitude.m_Pitch > 90) || (angles.m_Pitch > 90 && m_Attitude.m_Pitch < -90))
+	{
+		m_PitchFilter.setAngle(angles.m_Pitch);
+		m_Attitude.m_Pitch = angles.m_Pitch;
+	}
+	else
+	{
+		m_Attitude.m_Pitch = m_PitchFilter.compute(angles.m_Pitch, m_Rate.m_Pitch, sample.m_DeltaTime); // Calculate the angle using a Kalman filter
+	}
+
+	if (fabsf(m_Attitude.m_Roll) > 90)
+		m_Rate.m_Roll = -m_Rate.m_Roll; // Invert rate, so it fits the restricted accelerometer reading
+
+	m_Attitude.m_Roll = m_RollFilter.compute(angles.m_Roll, m_Rate.m_Roll, sample.m_DeltaTime); // Calculate the angle using a Kalman filter
+}
+
+void ComplementaryEstimator::update(const IMUSample &sample)
+{
+	const auto angles = GetAccelerometerAngles(sample.m_Acceleration);
+	m_Rate = GetBodyRates(sample.m_Rate);
+
+	if (!m_isInitialized)
+	{
+		m_Attitude = angles;
+		m_isInitialized = true;
+		return;
+	}
+
+	// The weight of the integrated angle for this time step.
+	const auto weight = g_ComplementaryTimeConstant / (g_ComplementaryTimeConstant + sample.m_DeltaTime);
+
+	m_Attitude.m_Pitch = (weight * (m_Attitude.m_Pitch + (m_Rate.m_Pitch * sample.m_DeltaTime))) + ((1.0f - weight) * angles.m_Pitch);
+	m_Attitude.m_Roll = (weight * (m_Attitude.m_Roll + (m_Rate.m_Roll * sample.m_DeltaTime))) + ((1.0f - weight) * angles.m_Roll);
+	m_Attitude.m_Yaw = WrapAngle(m_Attitude.m_Yaw + (m_Rate.m_Yaw * sample.m_DeltaTime));
+}
+
+void GyroIntegrationEstimator::update(const IMUSample &sample)
+{
+	m_Rate = GetBodyRates(sample.m_Rate);
+
+	if (!m_isInitialized)
+	{
+		m_Attitude = GetAccelerometerAngles(sample.m_Acceleration);
+		m_isInitialized = true;
+		return;
+	}
+
+	m_Attitude.m_Pitch = WrapAngle(m_Attitude.m_Pitch + (m_Rate.m_Pitch * sample.m_DeltaTime));
+	m_Attitude.m_Yaw = WrapAngle(m_Attitude.m_Yaw + (m_Rate.m_Yaw * sample.m_DeltaTime));
+	m_Attitude.m_Roll = WrapAngle(m_Attitude.m_Roll + (m_Rate.m_Roll * sample.m_DeltaTime));
+}
+
+void MahonyEstimator::update(const IMUSample &sample)
+{
+	m_Rate = GetBodyRates(sample.m_Rate);
+	m_Filter.update(sample.m_Acceleration, m_Rate, sample.m_DeltaTime);
+}
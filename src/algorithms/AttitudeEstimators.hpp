@@ -0,0 +1,205 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "core/Types.hpp"
+#include "KalmanFilter.hpp"
+#include "MahonyFilter.hpp"
+
+// The time constant of the complementary estimator in seconds. The gyroscope is trusted for changes faster than this and the
+// accelerometer for slower ones. This matches the default Mahony filter gain.
+constexpr auto g_ComplementaryTimeConstant = 5.0f;
+
+/**
+ * The attitude estimators are policies of the AttitudeSensor component, which is instantiated with exactly one of them (see
+ * Stabilizer.hpp). So the filters which are not selected are not compiled into the firmware, and the sensor task only pays for the one
+ * which is used. A custom estimator only needs the following methods.
+ *
+ *	void update(const IMUSample &sample);	// Called for every sample read from the sensor.
+ *	Vec3 getAttitude() const;				// The pitch, yaw and roll angles in degrees.
+ *	Vec3 getRate() const;					// The pitch, yaw and roll rates in degrees per second.
+ *
+ * Unless noted otherwise, a positive pitch is nose up, a positive roll is right wing down and a positive yaw is nose right.
+ */
+
+/**
+ * @brief Get the pitch and roll angles from the direction of gravity.
+ *
+ * @param acceleration The specific force in the sensor frame.
+ * @return The pitch and roll angles in degrees. The yaw is 0.
+ */
+[[nodiscard]] Vec3 GetAccelerometerAngles(Vec3 acceleration);
+
+/**
+ * @brief Get the body rates from the sensor's rotation rates.
+ * The sensor's X axis is the pitch axis, Y is the roll axis and Z is the yaw axis. Since Z points up, it's inverted.
+ *
+ * @param rate The rotation rate in the sensor frame.
+ * @return The pitch, yaw and roll rates.
+ */
+[[nodiscard]] Vec3 GetBodyRates(Vec3 rate);
+
+/**
+ * @brief Kalman estimator class.
+ * This is the original estimator which filters the pitch and the roll using a Kalman filter each. The yaw angle is not estimated.
+ */
+class KalmanEstimator final
+{
+public:
+	/**
+	 * @brief Update the attitude using a new sample.
+	 *
+	 * @param sample The sample.
+	 */
+	void update(const IMUSample &sample);
+
+	/**
+	 * @brief Get the attitude.
+	 *
+	 * @return The pitch, yaw and roll angles in degrees.
+	 */
+	[[nodiscard]] Vec3 getAttitude() const { return m_Attitude; }
+
+	/**
+	 * @brief Get the rotation rate.
+	 *
+	 * @return The pitch, yaw and roll rates in degrees per second.
+	 */
+	[[nodiscard]] Vec3 getRate() const { return m_Rate; }
+
+	/**
+	 * @brief Tune the pitch and the roll filters.
+	 *
+	 * @param angle The process noise of the angle.
+	 * @param bias The process noise of the gyroscope bias.
+	 * @param measure The measurement noise.
+	 */
+	void tune(float angle, float bias, float measure)
+	{
+		m_PitchFilter.tune(angle, bias, measure);
+		m_RollFilter.tune(angle, bias, measure);
+	}
+
+private:
+	KalmanFilter m_PitchFilter;
+	KalmanFilter m_RollFilter;
+
+	Vec3 m_Attitude;
+	Vec3 m_Rate;
+};
+
+/**
+ * @brief Complementary estimator class.
+ * This integrates the body rates and pulls the pitch and the roll towards the accelerometer angles with a first order filter
+ * (g_ComplementaryTimeConstant). The yaw is only integrated.
+ */
+class ComplementaryEstimator final
+{
+public:
+	/**
+	 * @brief Update the attitude using a new sample.
+	 * The first sample aligns the attitude with the accelerometer.
+	 *
+	 * @param sample The sample.
+	 */
+	void update(const IMUSample &sample);
+
+	/**
+	 * @brief Get the attitude.
+	 *
+	 * @return The pitch, yaw and roll angles in degrees.
+	 */
+	[[nodiscard]] Vec3 getAttitude() const { return m_Attitude; }
+
+	/**
+	 * @brief Get the rotation rate.
+	 *
+	 * @return The pitch, yaw and roll rates in degrees per second.
+	 */
+	[[nodiscard]] Vec3 getRate() const { return m_Rate; }
+
+private:
+	Vec3 m_Attitude;
+	Vec3 m_Rate;
+
+	bool m_isInitialized = false;
+};
+
+/**
+ * @brief Gyroscope integration estimator class.
+ * This only integrates the body rates, starting from the accelerometer angles. It's the cheapest estimator, but it drifts, so it's meant
+ * for short tests and for comparing the other estimators.
+ */
+class GyroIntegrationEstimator final
+{
+public:
+	/**
+	 * @brief Update the attitude using a new sample.
+	 * The first sample aligns the attitude with the accelerometer.
+	 *
+	 * @param sample The sample.
+	 */
+	void update(const IMUSample &sample);
+
+	/**
+	 * @brief Get the attitude.
+	 *
+	 * @return The pitch, yaw and roll angles in degrees (-180 to 180).
+	 */
+	[[nodiscard]] Vec3 getAttitude() const { return m_Attitude; }
+
+	/**
+	 * @brief Get the rotation rate.
+	 *
+	 * @return The pitch, yaw and roll rates in degrees per second.
+	 */
+	[[nodiscard]] Vec3 getRate() const { return m_Rate; }
+
+private:
+	Vec3 m_Attitude;
+	Vec3 m_Rate;
+
+	bool m_isInitialized = false;
+};
+
+/**
+ * @brief Mahony estimator class.
+ * This feeds the samples to the quaternion based Mahony filter, which fuses all 3 gyroscope axes. The Euler angles are only computed when
+ * requested.
+ */
+class MahonyEstimator final
+{
+public:
+	/**
+	 * @brief Update the attitude using a new sample.
+	 *
+	 * @param sample The sample.
+	 */
+	void update(const IMUSample &sample);
+
+	/**
+	 * @brief Get the attitude.
+	 *
+	 * @return The pitch, yaw and roll angles in degrees.
+	 */
+	[[nodiscard]] Vec3 getAttitude() const { return m_Filter.getEulerAngles(); }
+
+	/**
+	 * @brief Get the rotation rate.
+	 *
+	 * @return The pitch, yaw and roll rates in degrees per second.
+	 */
+	[[nodiscard]] Vec3 getRate() const { return m_Rate; }
+
+	/**
+	 * @brief Get the Mahony filter.
+	 *
+	 * @return The filter.
+	 */
+	[[nodiscard]] MahonyFilter &getFilter() { return m_Filter; }
+
+private:
+	MahonyFilter m_Filter;
+	Vec3 m_Rate;
+};
\ No newline at end of file
@@ -0,0 +1,49 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#include "BiquadFilter.hpp"
+
+#include "core/FastMath.hpp"
+
+#include <math.h>
+
+/**
+ * @brief Normalize the coefficients of a filter.
+ *
+ * @param b0 The first feed forward coefficient.
+ * @param b1 The second feed forward coefficient.
+ * @param b2 The third feed forward coefficient.
+ * @param a0 The output coefficient.
+ * @param a1 The first feedback coefficient.
+ * @param a2 The second feedback coefficient.
+ * @return The coefficients divided by a0.
+ */
+static BiquadCoefficients Normalize(float b0, float b1, float b2, float a0, float a1, float a2)
+{
+	BiquadCoefficients coefficients;
+	coefficients.m_B0 = b0 / a0;
+	coefficients.m_B1 = b1 / a0;
+	coefficients.m_B2 = b2 / a0;
+	coefficients.m_A1 = a1 / a0;
+	coefficients.m_A2 = a2 / a0;
+	return coefficients;
+}
+
+BiquadCoefficients ComputeLowPassCoefficients(float cutoff, float sampleRate, float q)
+{
+	const auto omega = 2.0f * g_Pi * cutoff / sampleRate;
+	const auto cosine = cosf(omega);
+	const auto alpha = sinf(omega) / (2.0f * q);
+
+	const auto b1 = 1.0f - cosine;
+	return Normalize(b1 * 0.5f, b1, b1 * 0.5f, 1.0f + alpha, -2.0f * cosine, 1.0f - alpha);
+}
+
+BiquadCoefficients ComputeNotchCoefficients(float center, float sampleRate, float q)
+{
+	const auto omega = 2.0f * g_Pi * center / sampleRate;
+	const auto cosine = cosf(omega);
+	const auto alpha = sinf(omega) / (2.0f * q);
+
+	return Normalize(1.0f, -2.0f * cosine, 1.0f, 1.0f + alpha, -2.0f * cosine, 1.0f - alpha);
+}
@@ -0,0 +1,106 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+// The quality factor of a second order Butterworth low pass filter (1 / sqrt(2)), which is flat in the pass band and does not overshoot.
+constexpr auto g_ButterworthQ = 0.70710678f;
+
+// The maximum absolute error of a biquad filter's output for an input with an amplitude of 1, compared with a double precision filter
+// designed from the analog prototype (the measured error is about 1e-5). This is checked by the unit tests (test/test_sensor_filter/).
+constexpr auto g_BiquadMaximumError = 1e-4f;
+
+/**
+ * @brief Biquad coefficients structure.
+ * These are the coefficients of a second order filter, normalized so that a0 is 1. The defaults pass the input through unchanged.
+ */
+struct BiquadCoefficients final
+{
+	float m_B0 = 1.0f;
+	float m_B1 = 0.0f;
+	float m_B2 = 0.0f;
+	float m_A1 = 0.0f;
+	float m_A2 = 0.0f;
+};
+
+/**
+ * @brief Compute the coefficients of a low pass filter.
+ * Ref: https://www.w3.org/TR/audio-eq-cookbook/
+ *
+ * @param cutoff The cutoff (-3 dB with the Butterworth quality factor) frequency in hertz. It must be below half of the sample rate.
+ * @param sampleRate The sample rate in hertz.
+ * @param q The quality factor.
+ * @return The coefficients.
+ */
+[[nodiscard]] BiquadCoefficients ComputeLowPassCoefficients(float cutoff, float sampleRate, float q = g_ButterworthQ);
+
+/**
+ * @brief Compute the coefficients of a notch filter.
+ * The gain is 0 at the center frequency and 1 far from it. The -3 dB bandwidth is the center frequency divided by the quality factor.
+ * Ref: https://www.w3.org/TR/audio-eq-cookbook/
+ *
+ * @param center The center frequency in hertz. It must be below half of the sample rate.
+ * @param sampleRate The sample rate in hertz.
+ * @param q The quality factor.
+ * @return The coefficients.
+ */
+[[nodiscard]] BiquadCoefficients ComputeNotchCoefficients(float center, float sampleRate, float q);
+
+/**
+ * @brief Biquad filter class.
+ * This is a second order filter of a single channel, in the transposed direct form II, which only keeps two state variables and behaves
+ * well in single precision. The coefficients can be changed while filtering (the dynamic notch moves a little on every update) without
+ * resetting the state.
+ */
+class BiquadFilter final
+{
+public:
+	/**
+	 * @brief Construct a new Biquad Filter object.
+	 * The filter passes the input through until the coefficients are set.
+	 */
+	BiquadFilter() = default;
+
+	/**
+	 * @brief Set the coefficients.
+	 *
+	 * @param coefficients The coefficients.
+	 */
+	void setCoefficients(const BiquadCoefficients &coefficients) { m_Coefficients = coefficients; }
+
+	/**
+	 * @brief Filter a sample.
+	 *
+	 * @param input The input sample.
+	 * @return The output sample.
+	 */
+	float apply(float input)
+	{
+		const auto output = (m_Coefficients.m_B0 * input) + m_State1;
+		m_State1 = (m_Coefficients.m_B1 * input) - (m_Coefficients.m_A1 * output) + m_State2;
+		m_State2 = (m_Coefficients.m_B2 * input) - (m_Coefficients.m_A2 * output);
+		return output;
+	}
+
+	/**
+	 * @brief Reset the state, as if the input was 0 so far.
+	 */
+	void reset()
+	{
+		m_State1 = 0.0f;
+		m_State2 = 0.0f;
+	}
+
+	/**
+	 * @brief Get the coefficients.
+	 *
+	 * @return The coefficients.
+	 */
+	[[nodiscard]] const BiquadCoefficients &getCoefficients() const { return m_Coefficients; }
+
+private:
+	BiquadCoefficients m_Coefficients;
+
+	float m_State1 = 0.0f;
+	float m_State2 = 0.0f;
+};
\ No newline at end of file
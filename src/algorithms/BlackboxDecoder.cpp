@@ -0,0 +1,109 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#include "BlackboxDecoder.hpp"
+#include "CRC.hpp"
+
+#include <string.h>
+
+size_t DecodeVarint(const uint8_t *pData, size_t size, uint32_t &value)
+{
+	value = 0;
+	for (size_t i = 0; i < size && i < 5; i++)
+	{
+		value |= static_cast<uint32_t>(pData[i] & 0x7F) << (i * 7);
+		if ((pData[i] & 0x80) == 0)
+			return i + 1;
+	}
+
+	return 0;
+}
+
+float DecodeBlackboxFixed(int32_t value)
+{
+	return static_cast<float>(value) / g_BlackboxScale;
+}
+
+float DecodeBlackboxFloat(int32_t value)
+{
+	float result = 0.0f;
+	memcpy(&result, &value, sizeof(result));
+	return result;
+}
+
+size_t BlackboxDecoder::setBlock(const uint8_t *pData, size_t size)
+{
+	m_pRecords = nullptr;
+	m_Size = 0;
+	m_Offset = 0;
+	m_isDamaged = false;
+
+	if (size < sizeof(BlackboxBlockHeader))
+		return 0;
+
+	memcpy(&m_Header, pData, sizeof(BlackboxBlockHeader));
+	if (m_Header.m_Magic != g_BlackboxMagic || m_Header.m_Version != g_BlackboxVersion || m_Header.m_Size > size - sizeof(BlackboxBlockHeader))
+		return 0;
+
+	// The checksum was computed with its own field set to 0.
+	auto header = m_Header;
+	header.m_Checksum = 0;
+	const auto checksum = ComputeCRC16(reinterpret_cast<const uint8_t *>(&header), sizeof(header));
+	if (ComputeCRC16(pData + sizeof(BlackboxBlockHeader), m_Header.m_Size, checksum) != m_Header.m_Checksum)
+		return 0;
+
+	m_pRecords = pData + sizeof(BlackboxBlockHeader);
+	m_Size = m_Header.m_Size;
+	m_PreviousTimestamp = m_Header.m_Timestamp;
+	memset(m_PreviousFields, 0, sizeof(m_PreviousFields));
+
+	return sizeof(BlackboxBlockHeader) + m_Size;
+}
+
+bool BlackboxDecoder::decode(BlackboxRecord &record)
+{
+	if (m_isDamaged || m_Offset >= m_Size)
+		return false;
+
+	const auto type = m_pRecords[m_Offset++];
+	int32_t difference = 0;
+	if (type >= g_BlackboxRecordTypeCount || !decodeValue(difference))
+	{
+		m_isDamaged = true;
+		return false;
+	}
+
+	record.m_Type = static_cast<BlackboxRecordType>(type);
+	record.m_Timestamp = m_PreviousTimestamp + static_cast<uint32_t>(difference);
+	m_PreviousTimestamp = record.m_Timestamp;
+
+	auto *pPrevious = m_PreviousFields[type];
+	for (uint8_t i = 0; i < g_BlackboxFieldCounts[type]; i++)
+	{
+		if (!decodeValue(difference))
+		{
+			m_isDamaged = true;
+			return false;
+		}
+
+		pPrevious[i] = static_cast<int32_t>(static_cast<uint32_t>(pPrevious[i]) + static_cast<uint32_t>(difference));
+		record.m_Fields[i] = pPrevious[i];
+	}
+
+	for (uint8_t i = g_BlackboxFieldCounts[type]; i < g_MaxBlackboxFields; i++)
+		record.m_Fields[i] = 0;
+
+	return true;
+}
+
+bool BlackboxDecoder::decodeValue(int32_t &value)
+{
+	uint32_t encoded = 0;
+	const auto size = DecodeVarint(m_pRecords + m_Offset, m_Size - m_Offset, encoded);
+	if (size == 0)
+		return false;
+
+	m_Offset += size;
+	value = DecodeZigZag(encoded);
+	return true;
+}
@@ -0,0 +1,113 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "BlackboxEncoder.hpp"
+
+/**
+ * @brief Decode a variable length integer.
+ *
+ * @param pData The data.
+ * @param size The size of the data.
+ * @param value The decoded value.
+ * @return The decoded size. 0 if the value is cut short or longer than 5 bytes.
+ */
+size_t DecodeVarint(const uint8_t *pData, size_t size, uint32_t &value);
+
+/**
+ * @brief Decode a zig-zag encoded value.
+ *
+ * @param value The encoded value.
+ * @return The signed value.
+ */
+[[nodiscard]] constexpr int32_t DecodeZigZag(uint32_t value)
+{
+	return static_cast<int32_t>((value >> 1) ^ (~(value & 1) + 1));
+}
+
+/**
+ * @brief Convert a fixed point value of the log back to a float.
+ *
+ * @param value The fixed point value.
+ * @return The value.
+ */
+[[nodiscard]] float DecodeBlackboxFixed(int32_t value);
+
+/**
+ * @brief Restore a float from its bits.
+ *
+ * @param value The bits.
+ * @return The value.
+ */
+[[nodiscard]] float DecodeBlackboxFloat(int32_t value);
+
+/**
+ * @brief Blackbox decoder class.
+ * This decodes the records of a block, in the order they were encoded. It's the counterpart of BlackboxEncoder and is used on the host,
+ * where the logs are read (monitor/blackbox_decoder.py does the same in Python).
+ */
+class BlackboxDecoder final
+{
+public:
+	/**
+	 * @brief Construct a new Blackbox Decoder object.
+	 */
+	BlackboxDecoder() = default;
+
+	/**
+	 * @brief Start decoding a block.
+	 *
+	 * @param pData The data, starting at the block header. It must stay valid while the block is decoded.
+	 * @param size The size of the data. It can be larger than the block.
+	 * @return The size of the block. 0 if the data does not start with an intact block of this version.
+	 */
+	size_t setBlock(const uint8_t *pData, size_t size);
+
+	/**
+	 * @brief Decode the next record of the block.
+	 *
+	 * @param record The decoded record.
+	 * @return true If a record was decoded.
+	 * @return false If the end of the block was reached or the block is damaged.
+	 */
+	bool decode(BlackboxRecord &record);
+
+	/**
+	 * @brief Get the header of the block.
+	 *
+	 * @return The block header.
+	 */
+	[[nodiscard]] const BlackboxBlockHeader &getHeader() const { return m_Header; }
+
+	/**
+	 * @brief Check if the block is damaged.
+	 * A record was cut short or has an unknown type.
+	 *
+	 * @return true If the block is damaged.
+	 * @return false If the block decoded cleanly so far.
+	 */
+	[[nodiscard]] bool isDamaged() const { return m_isDamaged; }
+
+private:
+	/**
+	 * @brief Decode the next zig-zag encoded value of the block.
+	 *
+	 * @param value The decoded value.
+	 * @return true If a value was decoded.
+	 * @return false If the value is cut short.
+	 */
+	bool decodeValue(int32_t &value);
+
+private:
+	const uint8_t *m_pRecords = nullptr;
+	size_t m_Size = 0;
+	size_t m_Offset = 0;
+
+	BlackboxBlockHeader m_Header;
+
+	uint32_t m_PreviousTimestamp = 0;
+	int32_t m_PreviousFields[g_BlackboxRecordTypeCount][g_MaxBlackboxFields] = {};
+
+	bool m_isDamaged = false;
+};
\ No newline at end of file
@@ -0,0 +1,83 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#include "BlackboxEncoder.hpp"
+#include "CRC.hpp"
+
+#include <string.h>
+
+static_assert(g_BlackboxBlockSize - sizeof(BlackboxBlockHeader) <= UINT16_MAX, "The size of the records must fit in the block header!");
+
+size_t EncodeVarint(uint32_t value, uint8_t *pOutput)
+{
+	size_t size = 0;
+	while (value >= 0x80)
+	{
+		pOutput[size++] = static_cast<uint8_t>(value | 0x80);
+		value >>= 7;
+	}
+
+	pOutput[size++] = static_cast<uint8_t>(value);
+	return size;
+}
+
+int32_t EncodeBlackboxFixed(float value)
+{
+	const auto scaled = value * g_BlackboxScale;
+	return static_cast<int32_t>(scaled < 0.0f ? scaled - 0.5f : scaled + 0.5f);
+}
+
+int32_t EncodeBlackboxFloat(float value)
+{
+	int32_t bits = 0;
+	memcpy(&bits, &value, sizeof(bits));
+	return bits;
+}
+
+bool BlackboxEncoder::encode(const BlackboxRecord &record)
+{
+	const auto type = static_cast<uint8_t>(record.m_Type);
+	if (type >= g_BlackboxRecordTypeCount || g_BlackboxBlockSize - m_Size < g_MaxEncodedBlackboxRecordSize)
+		return false;
+
+	if (isEmpty())
+	{
+		m_Header.m_Timestamp = record.m_Timestamp;
+		m_PreviousTimestamp = record.m_Timestamp;
+	}
+
+	// The records of both cores are mixed, so the time can go back a little.
+	auto *pOutput = m_Block + m_Size;
+	*pOutput++ = type;
+	pOutput += EncodeVarint(EncodeZigZag(static_cast<int32_t>(record.m_Timestamp - m_PreviousTimestamp)), pOutput);
+	m_PreviousTimestamp = record.m_Timestamp;
+
+	auto *pPrevious = m_PreviousFields[type];
+	for (uint8_t i = 0; i < g_BlackboxFieldCounts[type]; i++)
+	{
+		const auto difference = static_cast<int32_t>(static_cast<uint32_t>(record.m_Fields[i]) - static_cast<uint32_t>(pPrevious[i]));
+		pOutput += EncodeVarint(EncodeZigZag(difference), pOutput);
+		pPrevious[i] = record.m_Fields[i];
+	}
+
+	m_Size = pOutput - m_Block;
+	return true;
+}
+
+size_t BlackboxEncoder::finish(uint32_t sequence)
+{
+	m_Header.m_Size = static_cast<uint16_t>(m_Size - sizeof(BlackboxBlockHeader));
+	m_Header.m_Sequence = sequence;
+	m_Header.m_Checksum = 0;
+	memcpy(m_Block, &m_Header, sizeof(BlackboxBlockHeader));
+
+	m_Header.m_Checksum = ComputeCRC16(m_Block, m_Size);
+	memcpy(m_Block, &m_Header, sizeof(BlackboxBlockHeader));
+	return m_Size;
+}
+
+void BlackboxEncoder::reset()
+{
+	m_Size = sizeof(BlackboxBlockHeader);
+	memset(m_PreviousFields, 0, sizeof(m_PreviousFields));
+}
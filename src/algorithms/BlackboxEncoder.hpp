@@ -0,0 +1,196 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// The version of the log format. It must be increased when the records change (monitor/blackbox_decoder.py must match).
+constexpr uint16_t g_BlackboxVersion = 3;
+
+// The blocks start with "PBBX", so the decoder can find the next block after a damaged one.
+constexpr uint32_t g_BlackboxMagic = 0x58424250;
+
+// The blocks are written to the storage in one piece. They are large, since the flash is much faster with large writes.
+constexpr size_t g_BlackboxBlockSize = 4096;
+
+// The angles, rates, PID terms and actuator values are recorded as fixed point values with this scale.
+constexpr auto g_BlackboxScale = 100.0f;
+
+// The maximum number of fields of a record.
+constexpr auto g_MaxBlackboxFields = 12;
+
+// The maximum size of an encoded record: the type, the time and the fields, each up to 5 bytes.
+constexpr size_t g_MaxEncodedBlackboxRecordSize = 1 + ((1 + g_MaxBlackboxFields) * 5);
+
+/**
+ * @brief Blackbox record type enum.
+ * The fields of each record type are listed in monitor/blackbox_decoder.py. The angles and rates are in hundredths of a degree (per second)
+ * and the actuator values in hundredths of the output range. The values which are replayed (the delta times, the inputs and the
+ * calibrations) are stored as the bits of the floats, so they are restored exactly.
+ */
+enum class BlackboxRecordType : uint8_t
+{
+	// The raw accelerometer and gyroscope readings and the delta time of a sample.
+	IMU,
+
+	// The estimated attitude and the rates.
+	Attitude,
+
+	// The rate setpoints and the proportional, integral and derivative terms of the rate controller.
+	RateControl,
+
+	// The inputs of a new data link frame, the frame's timestamp, the required fly mode and the control mode.
+	Inputs,
+
+	// The rotor and servo commands and the current fly mode.
+	Actuators,
+
+	// The gyroscope bias, the accelerometer offsets and the temperature of a new sensor calibration.
+	Calibration
+};
+
+// The number of fields of each record type.
+constexpr uint8_t g_BlackboxFieldCounts[] = {7, 6, 12, 7, 7, 7};
+constexpr auto g_BlackboxRecordTypeCount = sizeof(g_BlackboxFieldCounts);
+
+/**
+ * @brief Blackbox record structure.
+ */
+struct BlackboxRecord final
+{
+	BlackboxRecordType m_Type = BlackboxRecordType::IMU;
+	uint32_t m_Timestamp = 0;
+	int32_t m_Fields[g_MaxBlackboxFields] = {};
+};
+
+/**
+ * @brief Blackbox block header structure.
+ * Every block is followed by its records. The times and fields of the records are encoded relative to the previous record (of the same
+ * type) in the block, so each block can be decoded on its own.
+ */
+struct BlackboxBlockHeader final
+{
+	uint32_t m_Magic = g_BlackboxMagic;
+	uint16_t m_Version = g_BlackboxVersion;
+
+	// The size of the records in bytes.
+	uint16_t m_Size = 0;
+
+	// The number of the block, counting from 0 in each log. A gap means that a block could not be written.
+	uint32_t m_Sequence = 0;
+
+	// The time of the first record in microseconds.
+	uint32_t m_Timestamp = 0;
+
+	// The CRC-16 of the whole block, computed with this field set to 0. The decoder skips the blocks which were damaged in the storage.
+	uint16_t m_Checksum = 0;
+	uint16_t m_Reserved = 0;
+};
+
+/**
+ * @brief Encode a value as a variable length integer.
+ * Each byte holds 7 bits, starting with the least significant ones, and the most significant bit is set when more bytes follow.
+ *
+ * @param value The value.
+ * @param pOutput The output buffer. It must have room for 5 bytes.
+ * @return The encoded size.
+ */
+size_t EncodeVarint(uint32_t value, uint8_t *pOutput);
+
+/**
+ * @brief Zig-zag encode a signed value, so small negative values become small unsigned values (0, -1, 1, -2... to 0, 1, 2, 3...).
+ *
+ * @param value The value.
+ * @return The encoded value.
+ */
+[[nodiscard]] constexpr uint32_t EncodeZigZag(int32_t value)
+{
+	return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+}
+
+/**
+ * @brief Convert a value to the fixed point representation of the log.
+ *
+ * @param value The value.
+ * @return The fixed point value, rounded to the nearest step.
+ */
+[[nodiscard]] int32_t EncodeBlackboxFixed(float value);
+
+/**
+ * @brief Get the bits of a float, so the value can be restored exactly.
+ *
+ * @param value The value.
+ * @return The bits.
+ */
+[[nodiscard]] int32_t EncodeBlackboxFloat(float value);
+
+/**
+ * @brief Blackbox encoder class.
+ * This encodes records into a block. A record is its type, followed by the difference of its time to the previous record and the
+ * differences of its fields to the previous record of the same type, as zig-zag encoded variable length integers. Consecutive samples
+ * change very little, so most of the differences take a single byte.
+ */
+class BlackboxEncoder final
+{
+public:
+	/**
+	 * @brief Construct a new Blackbox Encoder object.
+	 */
+	BlackboxEncoder() = default;
+
+	/**
+	 * @brief Encode a record into the block.
+	 * The first record of a block sets the block's time.
+	 *
+	 * @param record The record.
+	 * @return true If the record was encoded.
+	 * @return false If the block is full.
+	 */
+	bool encode(const BlackboxRecord &record);
+
+	/**
+	 * @brief Write the header of the block and its checksum.
+	 *
+	 * @param sequence The number of the block.
+	 * @return The size of the block.
+	 */
+	size_t finish(uint32_t sequence);
+
+	/**
+	 * @brief Start a new block.
+	 */
+	void reset();
+
+	/**
+	 * @brief Get the block.
+	 *
+	 * @return The block pointer.
+	 */
+	[[nodiscard]] const uint8_t *getBlock() const { return m_Block; }
+
+	/**
+	 * @brief Check if the block contains any records.
+	 *
+	 * @return true If the block is empty.
+	 * @return false If the block contains records.
+	 */
+	[[nodiscard]] bool isEmpty() const { return m_Size == sizeof(BlackboxBlockHeader); }
+
+	/**
+	 * @brief Get the time of the first record of the block.
+	 *
+	 * @return The timestamp in microseconds.
+	 */
+	[[nodiscard]] uint32_t getTimestamp() const { return m_Header.m_Timestamp; }
+
+private:
+	uint8_t m_Block[g_BlackboxBlockSize] = {};
+	size_t m_Size = sizeof(BlackboxBlockHeader);
+
+	BlackboxBlockHeader m_Header;
+
+	uint32_t m_PreviousTimestamp = 0;
+	int32_t m_PreviousFields[g_BlackboxRecordTypeCount][g_MaxBlackboxFields] = {};
+};
\ No newline at end of file
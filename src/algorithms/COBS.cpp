@@ -0,0 +1,53 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#include "COBS.hpp"
+
+size_t EncodeCOBS(const uint8_t *pData, size_t size, uint8_t *pOutput)
+{
+	size_t codeIndex = 0;
+	size_t outputIndex = 1;
+	uint8_t code = 1;
+
+	for (size_t i = 0; i < size; i++)
+	{
+		if (pData[i] != 0)
+		{
+			pOutput[outputIndex++] = pData[i];
+			code++;
+		}
+
+		// Close the block when we hit a zero, or when the block is full.
+		if (pData[i] == 0 || code == 0xFF)
+		{
+			pOutput[codeIndex] = code;
+			codeIndex = outputIndex++;
+			code = 1;
+		}
+	}
+
+	pOutput[codeIndex] = code;
+	return outputIndex;
+}
+
+size_t DecodeCOBS(const uint8_t *pData, size_t size, uint8_t *pOutput)
+{
+	size_t inputIndex = 0;
+	size_t outputIndex = 0;
+
+	while (inputIndex < size)
+	{
+		const auto code = pData[inputIndex++];
+		if (code == 0 || inputIndex + code - 1 > size)
+			return 0;
+
+		for (uint8_t i = 1; i < code; i++)
+			pOutput[outputIndex++] = pData[inputIndex++];
+
+		// A block shorter than the maximum implies a zero, except at the very end of the frame.
+		if (code != 0xFF && inputIndex < size)
+			pOutput[outputIndex++] = 0;
+	}
+
+	return outputIndex;
+}
@@ -0,0 +1,41 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Ref: https://en.wikipedia.org/wiki/Consistent_Overhead_Byte_Stuffing
+
+/**
+ * @brief Get the maximum encoded size of a COBS frame.
+ *
+ * @param size The decoded size.
+ * @return The maximum encoded size (without the delimiter).
+ */
+constexpr size_t GetCOBSEncodedSize(size_t size)
+{
+	return size + (size / 254) + 1;
+}
+
+/**
+ * @brief Encode data using consistent overhead byte stuffing.
+ * The encoded data does not contain any zero bytes, so a zero can be used to delimit frames.
+ *
+ * @param pData The data to encode.
+ * @param size The size of the data.
+ * @param pOutput The output buffer. It must be at least GetCOBSEncodedSize(size) bytes.
+ * @return The encoded size (without the delimiter).
+ */
+size_t EncodeCOBS(const uint8_t *pData, size_t size, uint8_t *pOutput);
+
+/**
+ * @brief Decode a COBS frame.
+ *
+ * @param pData The encoded data (without the delimiter).
+ * @param size The size of the encoded data.
+ * @param pOutput The output buffer. It must be at least size bytes.
+ * @return The decoded size. This is 0 if the frame is malformed.
+ */
+size_t DecodeCOBS(const uint8_t *pData, size_t size, uint8_t *pOutput);
\ No newline at end of file
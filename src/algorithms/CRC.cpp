@@ -0,0 +1,16 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#include "CRC.hpp"
+
+uint16_t ComputeCRC16(const uint8_t *pData, size_t size, uint16_t crc)
+{
+	for (size_t i = 0; i < size; i++)
+	{
+		crc ^= static_cast<uint16_t>(pData[i]) << 8;
+		for (uint8_t bit = 0; bit < 8; bit++)
+			crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x1021) : static_cast<uint16_t>(crc << 1);
+	}
+
+	return crc;
+}
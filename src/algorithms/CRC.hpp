@@ -0,0 +1,18 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Compute the CRC-16/CCITT-FALSE checksum.
+ * Polynomial 0x1021, initial value 0xFFFF, no reflection and no final XOR.
+ *
+ * @param pData The data to compute the checksum of.
+ * @param size The size of the data.
+ * @param crc The initial value. This can be used to continue a previous computation.
+ * @return The checksum.
+ */
+uint16_t ComputeCRC16(const uint8_t *pData, size_t size, uint16_t crc = 0xFFFF);
\ No newline at end of file
@@ -0,0 +1,75 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#include "IBusParser.hpp"
+
+// The size of the checksum at the end of the frame.
+constexpr auto g_IBusChecksumSize = 2;
+
+/**
+ * @brief Compute the checksum of an iBus frame.
+ *
+ * @param pFrame The frame.
+ * @return The checksum.
+ */
+static uint16_t ComputeIBusChecksum(const uint8_t *pFrame)
+{
+	uint16_t checksum = 0xFFFF;
+	for (uint8_t i = 0; i < g_IBusFrameSize - g_IBusChecksumSize; i++)
+		checksum -= pFrame[i];
+
+	return checksum;
+}
+
+void EncodeIBusFrame(const uint16_t *pChannels, uint8_t *pOutput)
+{
+	pOutput[0] = g_IBusFrameLength;
+	pOutput[1] = g_IBusServoCommand;
+
+	for (uint8_t i = 0; i < g_IBusChannelCount; i++)
+	{
+		pOutput[2 + (i * 2)] = static_cast<uint8_t>(pChannels[i] & 0xFF);
+		pOutput[3 + (i * 2)] = static_cast<uint8_t>(pChannels[i] >> 8);
+	}
+
+	const auto checksum = ComputeIBusChecksum(pOutput);
+	pOutput[g_IBusFrameSize - 2] = static_cast<uint8_t>(checksum & 0xFF);
+	pOutput[g_IBusFrameSize - 1] = static_cast<uint8_t>(checksum >> 8);
+}
+
+bool IBusParser::parse(uint8_t value, uint32_t timestamp)
+{
+	// Bytes were lost if the frame stalled, so the next byte starts a new frame.
+	if (m_Position > 0 && timestamp - m_PreviousTimestamp > g_IBusFrameGap)
+		m_Position = 0;
+
+	m_PreviousTimestamp = timestamp;
+
+	// Wait for the header. The second byte may also be the first byte of the next header.
+	if ((m_Position == 0 && value != g_IBusFrameLength) || (m_Position == 1 && value != g_IBusServoCommand))
+	{
+		m_Position = value == g_IBusFrameLength ? 1 : 0;
+		m_Buffer[0] = value;
+		return false;
+	}
+
+	m_Buffer[m_Position++] = value;
+	if (m_Position < g_IBusFrameSize)
+		return false;
+
+	m_Position = 0;
+
+	const auto checksum = static_cast<uint16_t>(m_Buffer[g_IBusFrameSize - 2] | (m_Buffer[g_IBusFrameSize - 1] << 8));
+	if (checksum != ComputeIBusChecksum(m_Buffer))
+	{
+		m_ChecksumErrors++;
+		return false;
+	}
+
+	for (uint8_t i = 0; i < g_IBusChannelCount; i++)
+		m_Frame.m_Channels[i] = static_cast<uint16_t>(m_Buffer[2 + (i * 2)] | (m_Buffer[3 + (i * 2)] << 8)) & g_IBusChannelMask;
+
+	m_Frame.m_Timestamp = timestamp;
+	m_Frame.m_Sequence++;
+	return true;
+}
@@ -0,0 +1,96 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// An iBus servo frame is 32 bytes: the length (0x20), the command (0x40), 14 little endian channel values and a little endian checksum,
+// which is 0xFFFF minus the sum of all the other bytes. The receiver sends a frame every 7 ms at 115200 baud.
+constexpr auto g_IBusChannelCount = 14;
+constexpr auto g_IBusFrameSize = 32;
+constexpr uint8_t g_IBusFrameLength = 0x20;
+constexpr uint8_t g_IBusServoCommand = 0x40;
+
+// The upper 4 bits of the channel values carry the extra channels of the 18 channel receivers, which are not used.
+constexpr uint16_t g_IBusChannelMask = 0x0FFF;
+
+// The frames are separated by a gap of a few milliseconds. A gap longer than this in the middle of a frame means that bytes were lost,
+// so the parser starts looking for a new frame (microseconds).
+constexpr uint32_t g_IBusFrameGap = 2000;
+
+/**
+ * @brief iBus frame structure.
+ * This is a complete and valid frame received from the iBus receiver.
+ */
+struct IBusFrame final
+{
+	// The channel values (1000 to 2000 for the sticks and switches).
+	uint16_t m_Channels[g_IBusChannelCount] = {};
+
+	// The time at which the last byte of the frame was received in microseconds.
+	uint32_t m_Timestamp = 0;
+
+	// The number of the frame, counting the valid frames from 1. This is 0 until the first frame is received.
+	uint32_t m_Sequence = 0;
+};
+
+/**
+ * @brief Encode an iBus servo frame.
+ * This is what the receiver sends. It's used to feed the parser with known data on the host.
+ *
+ * @param pChannels The g_IBusChannelCount channel values.
+ * @param pOutput The output buffer. It must be at least g_IBusFrameSize bytes.
+ */
+void EncodeIBusFrame(const uint16_t *pChannels, uint8_t *pOutput);
+
+/**
+ * @brief iBus parser class.
+ * This parses the byte stream received from the iBus receiver, one byte at a time. It does not depend on the serial port, so it can be fed
+ * from the UART receive event, or with recorded and generated data on the host.
+ *
+ * Frames with an invalid checksum are dropped and counted. After an error, the parser looks for the next frame header, and a gap in the
+ * stream resynchronizes it to the start of the next frame.
+ */
+class IBusParser final
+{
+public:
+	/**
+	 * @brief Construct a new IBus Parser object.
+	 */
+	IBusParser() = default;
+
+	/**
+	 * @brief Parse a received byte.
+	 *
+	 * @param value The byte.
+	 * @param timestamp The time at which the byte was received in microseconds.
+	 * @return true If the byte completed a valid frame.
+	 * @return false If the frame is not complete yet or the frame was invalid.
+	 */
+	bool parse(uint8_t value, uint32_t timestamp);
+
+	/**
+	 * @brief Get the last valid frame.
+	 *
+	 * @return The frame.
+	 */
+	[[nodiscard]] const IBusFrame &getFrame() const { return m_Frame; }
+
+	/**
+	 * @brief Get the number of frames which were dropped because of an invalid checksum.
+	 *
+	 * @return The error count.
+	 */
+	[[nodiscard]] uint32_t getChecksumErrors() const { return m_ChecksumErrors; }
+
+private:
+	uint8_t m_Buffer[g_IBusFrameSize] = {};
+	uint8_t m_Position = 0;
+
+	IBusFrame m_Frame;
+
+	uint32_t m_ChecksumErrors = 0;
+	uint32_t m_PreviousTimestamp = 0;
+};
\ No newline at end of file
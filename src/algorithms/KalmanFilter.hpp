@@ -3,6 +3,12 @@
 
 #pragma once
 
+// The default process noise of the angle and the gyroscope bias, and the measurement noise of the accelerometer angle. In flight, the
+// accelerometer mostly measures the thrust rather than gravity, so its angle is given a high noise and only corrects the attitude slowly.
+constexpr auto g_KalmanAngleNoise = 0.001f;
+constexpr auto g_KalmanBiasNoise = 0.00001f;
+constexpr auto g_KalmanMeasurementNoise = 3.0f;
+
 /**
  * @brief Kalman filter class.
  * This filter is used to filter out the noisy inputs of the accelerometer and the gyroscope.
@@ -44,9 +50,9 @@ public:
 private:
 	float m_ErrorMatrix[2][2] = {0};
 
-	float m_ConstantAngle = 0.001f;
-	float m_ConstantBias = 0.003f;
-	float m_Measure = 0.03f;
+	float m_ConstantAngle = g_KalmanAngleNoise;
+	float m_ConstantBias = g_KalmanBiasNoise;
+	float m_Measure = g_KalmanMeasurementNoise;
 
 	float m_Angle = 0.0f;
 	float m_Bias = 0.0f;
@@ -0,0 +1,127 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+// Ref: https://x-io.co.uk/open-source-imu-and-ahrs-algorithms/
+
+#include "MahonyFilter.hpp"
+
+#include "core/Common.hpp"
+#include "core/Constants.hpp"
+#include "core/FastMath.hpp"
+
+#include <math.h>
+
+// The accelerometer correction is only applied within these limits of the squared specific force.
+constexpr auto g_MinimumSquaredAcceleration = (1.0f - g_MahonyAccelerationTolerance) * (1.0f - g_MahonyAccelerationTolerance) * g_StandardGravity * g_StandardGravity;
+constexpr auto g_MaximumSquaredAcceleration = (1.0f + g_MahonyAccelerationTolerance) * (1.0f + g_MahonyAccelerationTolerance) * g_StandardGravity * g_StandardGravity;
+
+void MahonyFilter::update(Vec3 acceleration, Vec3 rate, float delta)
+{
+	// Setup the initial attitude if we don't have it already.
+	if (!m_isInitialized)
+	{
+		align(acceleration);
+		return;
+	}
+
+	// The sensor's X axis is the pitch axis, Y is the roll axis and Z is the (inverted) yaw axis.
+	auto rateX = rate.m_Pitch * g_DegreesToRadians;
+	auto rateY = rate.m_Roll * g_DegreesToRadians;
+	auto rateZ = -rate.m_Yaw * g_DegreesToRadians;
+
+	auto &w = m_Quaternion[0];
+	auto &x = m_Quaternion[1];
+	auto &y = m_Quaternion[2];
+	auto &z = m_Quaternion[3];
+
+	const auto squaredAcceleration = (acceleration.m_X * acceleration.m_X) + (acceleration.m_Y * acceleration.m_Y) + (acceleration.m_Z * acceleration.m_Z);
+	if (squaredAcceleration > g_MinimumSquaredAcceleration && squaredAcceleration < g_MaximumSquaredAcceleration)
+	{
+		const auto inverseNorm = 1.0f / sqrtf(squaredAcceleration);
+		const auto accelerationX = acceleration.m_X * inverseNorm;
+		const auto accelerationY = acceleration.m_Y * inverseNorm;
+		const auto accelerationZ = acceleration.m_Z * inverseNorm;
+
+		// The direction of gravity (up) in the sensor frame according to the current attitude.
+		const auto upX = 2.0f * ((x * z) - (w * y));
+		const auto upY = 2.0f * ((w * x) + (y * z));
+		const auto upZ = (w * w) - (x * x) - (y * y) + (z * z);
+
+		// The error is the rotation between the measured and the estimated directions.
+		const auto errorX = (accelerationY * upZ) - (accelerationZ * upY);
+		const auto errorY = (accelerationZ * upX) - (accelerationX * upZ);
+		const auto errorZ = (accelerationX * upY) - (accelerationY * upX);
+
+		m_IntegralError[0] += m_IntegralGain * errorX * delta;
+		m_IntegralError[1] += m_IntegralGain * errorY * delta;
+		m_IntegralError[2] += m_IntegralGain * errorZ * delta;
+
+		rateX += m_ProportionalGain * errorX;
+		rateY += m_ProportionalGain * errorY;
+		rateZ += m_ProportionalGain * errorZ;
+	}
+
+	rateX += m_IntegralError[0];
+	rateY += m_IntegralError[1];
+	rateZ += m_IntegralError[2];
+
+	// Integrate the rate of change of the quaternion and normalize it.
+	const auto halfDelta = 0.5f * delta;
+	const auto previousW = w;
+	const auto previousX = x;
+	const auto previousY = y;
+
+	w += (-(previousX * rateX) - (previousY * rateY) - (z * rateZ)) * halfDelta;
+	x += ((previousW * rateX) + (previousY * rateZ) - (z * rateY)) * halfDelta;
+	y += ((previousW * rateY) - (previousX * rateZ) + (z * rateX)) * halfDelta;
+	z += ((previousW * rateZ) + (previousX * rateY) - (previousY * rateX)) * halfDelta;
+
+	const auto inverseNorm = 1.0f / sqrtf((w * w) + (x * x) + (y * y) + (z * z));
+	w *= inverseNorm;
+	x *= inverseNorm;
+	y *= inverseNorm;
+	z *= inverseNorm;
+}
+
+Vec3 MahonyFilter::getEulerAngles() const
+{
+	const auto w = m_Quaternion[0];
+	const auto x = m_Quaternion[1];
+	const auto y = m_Quaternion[2];
+	const auto z = m_Quaternion[3];
+
+	// The elements of the rotation matrix which are needed for the angles.
+	const auto forwardX = 2.0f * ((x * y) - (w * z));
+	const auto forwardY = 1.0f - (2.0f * ((x * x) + (z * z)));
+	const auto forwardZ = clamp(2.0f * ((y * z) + (w * x)), -1.0f, 1.0f);
+	const auto rightZ = 2.0f * ((x * z) - (w * y));
+	const auto upZ = 1.0f - (2.0f * ((x * x) + (y * y)));
+
+	Vec3 angles;
+	angles.m_Pitch = FastAtan2(forwardZ, sqrtf(1.0f - (forwardZ * forwardZ))) * g_RadiansToDegrees;
+	angles.m_Roll = FastAtan2(-rightZ, upZ) * g_RadiansToDegrees;
+	angles.m_Yaw = FastAtan2(forwardX, forwardY) * g_RadiansToDegrees;
+	return angles;
+}
+
+void MahonyFilter::tune(float proportional, float integral)
+{
+	m_ProportionalGain = proportional;
+	m_IntegralGain = integral;
+}
+
+void MahonyFilter::align(Vec3 acceleration)
+{
+	if (acceleration.m_X == 0.0f && acceleration.m_Y == 0.0f && acceleration.m_Z == 0.0f)
+		return;
+
+	// The yaw is unknown, so it starts at 0.
+	const auto halfPitch = 0.5f * FastAtan2(acceleration.m_Y, sqrtf((acceleration.m_X * acceleration.m_X) + (acceleration.m_Z * acceleration.m_Z)));
+	const auto halfRoll = 0.5f * FastAtan2(-acceleration.m_X, acceleration.m_Z);
+
+	m_Quaternion[0] = cosf(halfPitch) * cosf(halfRoll);
+	m_Quaternion[1] = sinf(halfPitch) * cosf(halfRoll);
+	m_Quaternion[2] = cosf(halfPitch) * sinf(halfRoll);
+	m_Quaternion[3] = sinf(halfPitch) * sinf(halfRoll);
+	m_isInitialized = true;
+}
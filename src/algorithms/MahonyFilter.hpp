@@ -0,0 +1,85 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "core/Types.hpp"
+
+// The default gains. The proportional gain sets how fast the accelerometer pulls the attitude back (the time constant is about 1/Kp
+// seconds) and the integral gain how fast the gyroscope bias is learned. In flight, the accelerometer mostly measures the thrust rather
+// than gravity, so it's only trusted over a few seconds.
+constexpr auto g_MahonyProportionalGain = 0.2f;
+constexpr auto g_MahonyIntegralGain = 0.02f;
+
+// The accelerometer only corrects the attitude while the magnitude of the specific force is within this fraction of 1 g. Otherwise it
+// is dominated by the acceleration of the airframe (for example during the transition) and the attitude is only integrated.
+constexpr auto g_MahonyAccelerationTolerance = 0.15f;
+
+/**
+ * @brief Mahony filter class.
+ * This is a quaternion attitude estimator which fuses all 3 gyroscope axes with the accelerometer (Mahony et al., "Nonlinear
+ * Complementary Filters on the Special Orthogonal Group"). The gyroscope is integrated and the accelerometer corrects the pitch and roll
+ * drift using a proportional-integral feedback, which also learns the gyroscope bias of those axes. Without a magnetometer, the yaw is
+ * only integrated.
+ *
+ * The update does not use any trigonometric functions. Since the attitude is a quaternion, there are no singularities or wrap arounds
+ * while integrating, the Euler angles are only computed when requested.
+ *
+ * The vectors are in the sensor frame: X to the right wing, Y to the front and Z up. A positive pitch is nose up, a positive roll is
+ * right wing down and a positive yaw is nose right (the yaw rate is inverted).
+ */
+class MahonyFilter final
+{
+public:
+	/**
+	 * @brief Construct a new Mahony Filter object.
+	 */
+	MahonyFilter() = default;
+
+	/**
+	 * @brief Update the attitude using a new sample.
+	 * The first sample aligns the attitude with the accelerometer.
+	 *
+	 * @param acceleration The specific force in meters per square second (X, Y and Z of the sensor frame).
+	 * @param rate The rotation rate in degrees per second (pitch, yaw and roll).
+	 * @param delta The time since the previous sample in seconds.
+	 */
+	void update(Vec3 acceleration, Vec3 rate, float delta);
+
+	/**
+	 * @brief Get the attitude as Euler angles.
+	 * The angles are applied in the yaw, pitch, roll order. The pitch is within -90 to 90 degrees and the other angles are within -180 to
+	 * 180 degrees.
+	 *
+	 * @return The pitch, yaw and roll angles in degrees.
+	 */
+	[[nodiscard]] Vec3 getEulerAngles() const;
+
+	/**
+	 * @brief Tune the Mahony filter.
+	 *
+	 * @param proportional The proportional gain.
+	 * @param integral The integral gain.
+	 */
+	void tune(float proportional, float integral);
+
+private:
+	/**
+	 * @brief Set the attitude from the direction of gravity.
+	 *
+	 * @param acceleration The specific force.
+	 */
+	void align(Vec3 acceleration);
+
+private:
+	// The rotation from the sensor frame to the world frame (W, X, Y, Z).
+	float m_Quaternion[4] = {1.0f, 0.0f, 0.0f, 0.0f};
+
+	// The integral of the error, in radians per second.
+	float m_IntegralError[3] = {0.0f, 0.0f, 0.0f};
+
+	float m_ProportionalGain = g_MahonyProportionalGain;
+	float m_IntegralGain = g_MahonyIntegralGain;
+
+	bool m_isInitialized = false;
+};
\ No newline at end of file
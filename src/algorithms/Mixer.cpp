@@ -0,0 +1,39 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Mixer.hpp"
+
+MixerMatrix BlendMixers(const MixerMatrix &from, const MixerMatrix &to, float factor)
+{
+	const auto blend = [factor](float a, float b)
+	{
+		return a + ((b - a) * factor);
+	};
+
+	MixerMatrix matrix;
+	for (uint8_t i = 0; i < g_MixerOutputCount; i++)
+	{
+		for (uint8_t j = 0; j < g_MixerInputCount; j++)
+			matrix.m_Coefficients[i][j] = blend(from.m_Coefficients[i][j], to.m_Coefficients[i][j]);
+
+		matrix.m_Offsets[i] = blend(from.m_Offsets[i], to.m_Offsets[i]);
+		matrix.m_Minimum[i] = blend(from.m_Minimum[i], to.m_Minimum[i]);
+		matrix.m_Maximum[i] = blend(from.m_Maximum[i], to.m_Maximum[i]);
+	}
+
+	return matrix;
+}
+
+void Mix(const MixerMatrix &matrix, float thrust, Vec3 outputs, float *pOutputs)
+{
+	const float inputs[g_MixerInputCount] = {thrust, outputs.m_Pitch, outputs.m_Roll, outputs.m_Yaw};
+
+	for (uint8_t i = 0; i < g_MixerOutputCount; i++)
+	{
+		auto value = matrix.m_Offsets[i];
+		for (uint8_t j = 0; j < g_MixerInputCount; j++)
+			value += matrix.m_Coefficients[i][j] * inputs[j];
+
+		pOutputs[i] = value < matrix.m_Minimum[i] ? matrix.m_Minimum[i] : (value > matrix.m_Maximum[i] ? matrix.m_Maximum[i] : value);
+	}
+}
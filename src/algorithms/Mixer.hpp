@@ -0,0 +1,60 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "core/Types.hpp"
+
+#include <stdint.h>
+
+// The inputs of a mixer are the thrust and the pitch, roll and yaw outputs of the stabilizer.
+constexpr auto g_MixerInputCount = 4;
+constexpr auto g_MixerOutputCount = 6;
+
+/**
+ * @brief Mixer output enum.
+ * These are the actuators, in the order of the rows of a mixer matrix.
+ */
+enum class MixerOutput : uint8_t
+{
+	LeftRotor,
+	RightRotor,
+	LeftWing,
+	RightWing,
+	Elevator,
+	Rudder
+};
+
+/**
+ * @brief Mixer matrix structure.
+ * This describes how an airframe layout moves its actuators. Each actuator is a weighted sum of the inputs (thrust, pitch, roll and yaw)
+ * plus an offset, which is clamped to the actuator's range. All the values are in the output range (0 - 180).
+ */
+struct MixerMatrix final
+{
+	float m_Coefficients[g_MixerOutputCount][g_MixerInputCount] = {};
+	float m_Offsets[g_MixerOutputCount] = {};
+	float m_Minimum[g_MixerOutputCount] = {};
+	float m_Maximum[g_MixerOutputCount] = {};
+};
+
+/**
+ * @brief Blend two mixer matrices.
+ * Every coefficient, offset and limit is interpolated, so the actuators move smoothly from one layout to the other.
+ *
+ * @param from The matrix at 0.
+ * @param to The matrix at 1.
+ * @param factor The blend factor (0 - 1).
+ * @return The blended matrix.
+ */
+[[nodiscard]] MixerMatrix BlendMixers(const MixerMatrix &from, const MixerMatrix &to, float factor);
+
+/**
+ * @brief Mix the inputs into the actuator values.
+ *
+ * @param matrix The mixer matrix.
+ * @param thrust The thrust, mapped to the output range.
+ * @param outputs The stabilizer outputs.
+ * @param pOutputs The g_MixerOutputCount actuator values, in the order of MixerOutput.
+ */
+void Mix(const MixerMatrix &matrix, float thrust, Vec3 outputs, float *pOutputs);
\ No newline at end of file
@@ -5,30 +5,90 @@
 
 #include "core/Common.hpp"
 #include "core/Constants.hpp"
+#include "core/FastMath.hpp"
 
-#include <Arduino.h>
+constexpr auto g_OutputMinimum = static_cast<float>(g_PIDOutputMinimum);
+constexpr auto g_OutputMaximum = static_cast<float>(g_PIDOutputMaximum);
 
-PID::PID(float kp, float ki, float kd)
-	: m_kP(kp), m_kI(ki), m_kD(kd)
+PID::PID(Vec3 kp, Vec3 ki, Vec3 kd, float derivativeCutoff)
+	: m_DerivativeTimeConstant(1.0f / (2.0f * g_Pi * derivativeCutoff))
 {
+	tune(kp, ki, kd);
 }
 
-float PID::calculate(float current, float expected)
+Vec3 PID::calculate(Vec3 current, Vec3 expected, float delta)
 {
-	// Calculate the error, derivative and integral.
-	const auto error = expected - current;
-	const auto derivative = m_kD * (current - m_PreviousValue);
-	m_Integral = clamp(m_Integral + (m_kI * error), static_cast<float>(g_PIDOutputMinimum), static_cast<float>(g_PIDOutputMaximum));
-	m_PreviousValue = current;
+	if (delta <= 0.0f)
+		return getOutput();
 
-	// Calculate the output and clamp it in between the required ranges.
-	const auto output = (m_kP * error) + m_Integral - derivative;
+	const float currentValues[g_PIDAxisCount] = {current.m_X, current.m_Y, current.m_Z};
+	const float expectedValues[g_PIDAxisCount] = {expected.m_X, expected.m_Y, expected.m_Z};
 
-	if (output < g_PIDOutputMinimum)
-		return g_PIDOutputMinimum;
+	// Start the derivative from the first measurement, otherwise the first calculation sees a step from 0.
+	if (!m_isInitialized)
+	{
+		for (uint8_t i = 0; i < g_PIDAxisCount; i++)
+			m_PreviousValue[i] = currentValues[i];
 
-	if (output > g_PIDOutputMaximum)
-		return g_PIDOutputMaximum;
+		m_isInitialized = true;
+	}
 
-	return output;
+	// The weight of the new rate in the first order derivative filter.
+	const auto derivativeWeight = delta / (m_DerivativeTimeConstant + delta);
+
+	for (uint8_t i = 0; i < g_PIDAxisCount; i++)
+	{
+		// Calculate the error, derivative and integral.
+		const auto error = expectedValues[i] - currentValues[i];
+		const auto rate = (currentValues[i] - m_PreviousValue[i]) / delta;
+		m_FilteredRate[i] += derivativeWeight * (rate - m_FilteredRate[i]);
+		m_PreviousValue[i] = currentValues[i];
+
+		m_Proportional[i] = m_kP[i] * error;
+		m_Derivative[i] = -m_kD[i] * m_FilteredRate[i];
+
+		// Only integrate if the output would not be saturated, or if the error drives it back into the range.
+		const auto integral = clamp(m_Integral[i] + (m_kI[i] * error * delta), g_OutputMinimum, g_OutputMaximum);
+		const auto output = m_Proportional[i] + integral + m_Derivative[i];
+		if ((output < g_OutputMaximum || error < 0.0f) && (output > g_OutputMinimum || error > 0.0f))
+			m_Integral[i] = integral;
+
+		// Calculate the output and clamp it in between the required ranges.
+		m_Output[i] = clamp(m_Proportional[i] + m_Integral[i] + m_Derivative[i], g_OutputMinimum, g_OutputMaximum);
+	}
+
+	return getOutput();
+}
+
+void PID::tune(Vec3 kp, Vec3 ki, Vec3 kd)
+{
+	m_kP[0] = kp.m_X;
+	m_kP[1] = kp.m_Y;
+	m_kP[2] = kp.m_Z;
+
+	m_kI[0] = ki.m_X;
+	m_kI[1] = ki.m_Y;
+	m_kI[2] = ki.m_Z;
+
+	m_kD[0] = kd.m_X;
+	m_kD[1] = kd.m_Y;
+	m_kD[2] = kd.m_Z;
+}
+
+void PID::tune(uint8_t axis, const PIDGains &gains)
+{
+	m_kP[axis] = gains.m_KP;
+	m_kI[axis] = gains.m_KI;
+	m_kD[axis] = gains.m_KD;
+}
+
+void PID::reset()
+{
+	for (uint8_t i = 0; i < g_PIDAxisCount; i++)
+	{
+		m_FilteredRate[i] = 0.0f;
+		m_Integral[i] = 0.0f;
+	}
+
+	m_isInitialized = false;
 }
@@ -3,10 +3,26 @@
 
 #pragma once
 
+#include "core/Types.hpp"
+
+// The number of axes processed by the PID controller (pitch, yaw and roll).
+constexpr auto g_PIDAxisCount = 3;
+
+// The default cutoff frequency of the derivative low pass filter in hertz. The derivative amplifies the sensor noise, so it's filtered
+// well below the control rate.
+constexpr auto g_PIDDerivativeCutoff = 50.0f;
+
 /**
  * @brief PID class.
- * PID is used to stabilize each of the 3 rotations (pitch, roll and yaw).
- * This class is intended to be instanced one for each axis.
+ * PID is used to stabilize the 3 rotations (pitch, yaw and roll) together. The state of the axes is stored in a structure of arrays
+ * layout, so the axes are computed in the same loop.
+ *
+ * The terms are normalized by the time step, so the gains do not depend on the loop rate. The proportional gain is in output units per
+ * unit of error, the integral gain per unit of error and second and the derivative gain per unit of error per second. The derivative is
+ * taken on the measurement (so a setpoint step does not kick the output) and is low pass filtered. The integral is not accumulated while
+ * the output is saturated in the direction of the error (conditional integration), so it does not wind up.
+ *
+ * The vectors are in the pitch, yaw and roll components of Vec3.
  */
 class PID final
 {
@@ -14,27 +30,100 @@ public:
 	/**
 	 * @brief Construct a new PID object.
 	 *
-	 * @param kp The proportional constant.
-	 * @param ki The integral constant.
-	 * @param kd The derivative constant.
+	 * @param kp The proportional constants.
+	 * @param ki The integral constants.
+	 * @param kd The derivative constants.
+	 * @param derivativeCutoff The cutoff frequency of the derivative low pass filter in hertz.
+	 */
+	explicit PID(Vec3 kp, Vec3 ki, Vec3 kd, float derivativeCutoff = g_PIDDerivativeCutoff);
+
+	/**
+	 * @brief Calculate the PID outputs.
+	 * The outputs are clamped to g_PIDOutputMinimum and g_PIDOutputMaximum.
+	 *
+	 * @param current The current values.
+	 * @param expected The expected values.
+	 * @param delta The time since the previous calculation in seconds. If this is not positive, the previous outputs are returned.
+	 * @return The outputs.
+	 */
+	[[nodiscard]] Vec3 calculate(Vec3 current, Vec3 expected, float delta);
+
+	/**
+	 * @brief Tune the PID controller.
+	 * The integral is kept, so this can be done while running.
+	 *
+	 * @param kp The proportional constants.
+	 * @param ki The integral constants.
+	 * @param kd The derivative constants.
+	 */
+	void tune(Vec3 kp, Vec3 ki, Vec3 kd);
+
+	/**
+	 * @brief Tune a single axis of the PID controller.
+	 * The integral is kept, so this can be done while running.
+	 *
+	 * @param axis The axis index (0 for pitch, 1 for yaw and 2 for roll).
+	 * @param gains The gains.
+	 */
+	void tune(uint8_t axis, const PIDGains &gains);
+
+	/**
+	 * @brief Get the gains of an axis.
+	 *
+	 * @param axis The axis index (0 for pitch, 1 for yaw and 2 for roll).
+	 * @return The gains.
+	 */
+	[[nodiscard]] PIDGains getGains(uint8_t axis) const { return PIDGains{m_kP[axis], m_kI[axis], m_kD[axis]}; }
+
+	/**
+	 * @brief Reset the integral and the derivative state.
+	 */
+	void reset();
+
+	/**
+	 * @brief Get the proportional terms of the last calculation.
+	 *
+	 * @return The proportional terms.
+	 */
+	[[nodiscard]] Vec3 getProportional() const { return Vec3(m_Proportional[0], m_Proportional[1], m_Proportional[2]); }
+
+	/**
+	 * @brief Get the integral terms of the last calculation.
+	 *
+	 * @return The integral terms.
 	 */
-	explicit PID(float kp, float ki, float kd);
+	[[nodiscard]] Vec3 getIntegral() const { return Vec3(m_Integral[0], m_Integral[1], m_Integral[2]); }
 
 	/**
-	 * @brief Calculate the PID output.
+	 * @brief Get the derivative terms of the last calculation.
+	 * The derivative is taken on the filtered measurement, so the terms have the opposite sign of the measured rate of change.
 	 *
-	 * @param current The current value.
-	 * @param expected The expected value.
-	 * @return The result.
+	 * @return The derivative terms.
 	 */
-	[[nodiscard]] float calculate(float current, float expected);
+	[[nodiscard]] Vec3 getDerivative() const { return Vec3(m_Derivative[0], m_Derivative[1], m_Derivative[2]); }
+
+	/**
+	 * @brief Get the outputs of the last calculation.
+	 * The outputs are the sum of the proportional, integral and derivative terms, clamped to g_PIDOutputMinimum and g_PIDOutputMaximum.
+	 *
+	 * @return The outputs.
+	 */
+	[[nodiscard]] Vec3 getOutput() const { return Vec3(m_Output[0], m_Output[1], m_Output[2]); }
 
 private:
-	float m_kP = 0.0f;
-	float m_kI = 0.0f;
-	float m_kD = 0.0f;
+	float m_kP[g_PIDAxisCount] = {};
+	float m_kI[g_PIDAxisCount] = {};
+	float m_kD[g_PIDAxisCount] = {};
+
+	float m_PreviousValue[g_PIDAxisCount] = {};
+	float m_FilteredRate[g_PIDAxisCount] = {};
+
+	float m_Proportional[g_PIDAxisCount] = {};
+	float m_Integral[g_PIDAxisCount] = {};
+	float m_Derivative[g_PIDAxisCount] = {};
+	float m_Output[g_PIDAxisCount] = {};
 
-	float m_PreviousValue = 0.0f;
+	float m_DerivativeTimeConstant = 0.0f;
 
-	float m_Integral = 0.0f;
+	bool m_isInitialized = false;
 };
\ No newline at end of file
@@ -0,0 +1,73 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#include "PacketCodec.hpp"
+#include "CRC.hpp"
+
+#include <string.h>
+
+constexpr auto g_CRCSize = sizeof(uint16_t);
+
+size_t EncodePacket(const TelemetryHeader &header, const void *pMessage, size_t size, uint8_t *pOutput)
+{
+	// Assemble the raw frame: header, message and the checksum of both.
+	uint8_t frame[g_MaxPacketSize];
+	memcpy(frame, &header, sizeof(header));
+	memcpy(frame + sizeof(header), pMessage, size);
+
+	const auto frameSize = sizeof(header) + size;
+	const auto crc = ComputeCRC16(frame, frameSize);
+	memcpy(frame + frameSize, &crc, g_CRCSize);
+
+	pOutput[0] = 0;
+	const auto encodedSize = EncodeCOBS(frame, frameSize + g_CRCSize, pOutput + 1) + 2;
+	pOutput[encodedSize - 1] = 0;
+
+	return encodedSize;
+}
+
+bool PacketDecoder::decode(uint8_t value)
+{
+	if (value != 0)
+	{
+		if (m_Size < sizeof(m_Buffer))
+			m_Buffer[m_Size++] = value;
+		else
+			m_isOverflowed = true;
+
+		return false;
+	}
+
+	// The delimiter ends the frame. Consecutive delimiters are not frames, they are between the trailing and the leading delimiter.
+	if (m_Size == 0)
+		return false;
+
+	const auto isValid = !m_isOverflowed && validate();
+	if (!isValid)
+		m_Errors++;
+
+	m_Size = 0;
+	m_isOverflowed = false;
+	return isValid;
+}
+
+bool PacketDecoder::validate()
+{
+	const auto frameSize = DecodeCOBS(m_Buffer, m_Size, m_Frame);
+	if (frameSize < sizeof(TelemetryHeader) + g_CRCSize || frameSize > g_MaxPacketSize)
+		return false;
+
+	uint16_t crc = 0;
+	memcpy(&crc, m_Frame + frameSize - g_CRCSize, g_CRCSize);
+	if (crc != ComputeCRC16(m_Frame, frameSize - g_CRCSize))
+		return false;
+
+	TelemetryHeader header;
+	memcpy(&header, m_Frame, sizeof(header));
+	if (header.m_Version != g_TelemetryVersion)
+		return false;
+
+	m_Header = header;
+	m_MessageSize = frameSize - sizeof(header) - g_CRCSize;
+	return true;
+}
@@ -0,0 +1,98 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "COBS.hpp"
+#include "core/TelemetryMessages.hpp"
+
+// The maximum size of a frame: the header, the message and the checksum.
+constexpr size_t g_MaxPacketSize = 64;
+
+// The maximum size of an encoded frame, including the leading and the trailing delimiter.
+constexpr size_t g_MaxEncodedPacketSize = GetCOBSEncodedSize(g_MaxPacketSize) + 2;
+
+/**
+ * @brief Encode a packet.
+ * The header and the message are followed by a CRC-16 of both, COBS encoded and delimited with a zero on both sides. The leading delimiter
+ * keeps the frame separate from anything sent before it (like text, or a frame which was cut short).
+ *
+ * @param header The header.
+ * @param pMessage The message.
+ * @param size The size of the message. The frame must fit in g_MaxPacketSize.
+ * @param pOutput The output buffer. It must be at least g_MaxEncodedPacketSize bytes.
+ * @return The encoded size, including the delimiters.
+ */
+size_t EncodePacket(const TelemetryHeader &header, const void *pMessage, size_t size, uint8_t *pOutput);
+
+/**
+ * @brief Packet decoder class.
+ * This decodes the packets of a byte stream, one byte at a time, so it can be fed from any transport. Frames which are malformed, too long,
+ * have an invalid checksum or a different version are dropped and counted.
+ */
+class PacketDecoder final
+{
+public:
+	/**
+	 * @brief Construct a new Packet Decoder object.
+	 */
+	PacketDecoder() = default;
+
+	/**
+	 * @brief Decode a received byte.
+	 *
+	 * @param value The byte.
+	 * @return true If the byte completed a valid packet.
+	 * @return false If the packet is not complete yet or the packet was invalid.
+	 */
+	bool decode(uint8_t value);
+
+	/**
+	 * @brief Get the header of the last valid packet.
+	 *
+	 * @return The header.
+	 */
+	[[nodiscard]] const TelemetryHeader &getHeader() const { return m_Header; }
+
+	/**
+	 * @brief Get the message of the last valid packet.
+	 * The message is only valid until the next frame ends, so it must be handled when decode returns true.
+	 *
+	 * @return The message data.
+	 */
+	[[nodiscard]] const uint8_t *getMessage() const { return m_Frame + sizeof(TelemetryHeader); }
+
+	/**
+	 * @brief Get the message size of the last valid packet.
+	 *
+	 * @return The message size in bytes.
+	 */
+	[[nodiscard]] size_t getMessageSize() const { return m_MessageSize; }
+
+	/**
+	 * @brief Get the number of packets which were dropped.
+	 *
+	 * @return The error count.
+	 */
+	[[nodiscard]] uint32_t getErrors() const { return m_Errors; }
+
+private:
+	/**
+	 * @brief Validate the buffered frame.
+	 *
+	 * @return true If the frame is a valid packet.
+	 * @return false If the frame is invalid.
+	 */
+	bool validate();
+
+private:
+	uint8_t m_Buffer[GetCOBSEncodedSize(g_MaxPacketSize)] = {};
+	uint8_t m_Frame[GetCOBSEncodedSize(g_MaxPacketSize)] = {};
+	size_t m_Size = 0;
+
+	TelemetryHeader m_Header;
+	size_t m_MessageSize = 0;
+
+	uint32_t m_Errors = 0;
+	bool m_isOverflowed = false;
+};
\ No newline at end of file
@@ -0,0 +1,131 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ParameterRegistry.hpp"
+#include "CRC.hpp"
+
+#include "core/Constants.hpp"
+
+#include <stddef.h>
+#include <string.h>
+
+// The gains can't be negative. The largest ones are well above anything that flies, and only catch a misplaced decimal point.
+constexpr auto g_MaximumProportionalGain = 100.0f;
+constexpr auto g_MaximumIntegralGain = 100.0f;
+constexpr auto g_MaximumDerivativeGain = 10.0f;
+
+// The noise of a Kalman filter must be positive.
+constexpr auto g_MinimumKalmanNoise = 1e-6f;
+constexpr auto g_MaximumKalmanNoise = 10.0f;
+
+// The descriptors of the parameters, in the order of the IDs.
+static const ParameterDescriptor s_ParameterDescriptors[g_ParameterCount] = {
+	{"pitch_angle_kp", ParameterType::Float, offsetof(ParameterSet, m_PitchAngle.m_KP), 0.0f, g_MaximumProportionalGain},
+	{"pitch_angle_ki", ParameterType::Float, offsetof(ParameterSet, m_PitchAngle.m_KI), 0.0f, g_MaximumIntegralGain},
+	{"pitch_angle_kd", ParameterType::Float, offsetof(ParameterSet, m_PitchAngle.m_KD), 0.0f, g_MaximumDerivativeGain},
+
+	{"roll_angle_kp", ParameterType::Float, offsetof(ParameterSet, m_RollAngle.m_KP), 0.0f, g_MaximumProportionalGain},
+	{"roll_angle_ki", ParameterType::Float, offsetof(ParameterSet, m_RollAngle.m_KI), 0.0f, g_MaximumIntegralGain},
+	{"roll_angle_kd", ParameterType::Float, offsetof(ParameterSet, m_RollAngle.m_KD), 0.0f, g_MaximumDerivativeGain},
+
+	{"pitch_rate_kp", ParameterType::Float, offsetof(ParameterSet, m_PitchRate.m_KP), 0.0f, g_MaximumProportionalGain},
+	{"pitch_rate_ki", ParameterType::Float, offsetof(ParameterSet, m_PitchRate.m_KI), 0.0f, g_MaximumIntegralGain},
+	{"pitch_rate_kd", ParameterType::Float, offsetof(ParameterSet, m_PitchRate.m_KD), 0.0f, g_MaximumDerivativeGain},
+
+	{"roll_rate_kp", ParameterType::Float, offsetof(ParameterSet, m_RollRate.m_KP), 0.0f, g_MaximumProportionalGain},
+	{"roll_rate_ki", ParameterType::Float, offsetof(ParameterSet, m_RollRate.m_KI), 0.0f, g_MaximumIntegralGain},
+	{"roll_rate_kd", ParameterType::Float, offsetof(ParameterSet, m_RollRate.m_KD), 0.0f, g_MaximumDerivativeGain},
+
+	{"yaw_rate_kp", ParameterType::Float, offsetof(ParameterSet, m_YawRate.m_KP), 0.0f, g_MaximumProportionalGain},
+	{"yaw_rate_ki", ParameterType::Float, offsetof(ParameterSet, m_YawRate.m_KI), 0.0f, g_MaximumIntegralGain},
+	{"yaw_rate_kd", ParameterType::Float, offsetof(ParameterSet, m_YawRate.m_KD), 0.0f, g_MaximumDerivativeGain},
+
+	{"wing_servo_offset_hover", ParameterType::Integer, offsetof(ParameterSet, m_WingServoOffsetHover), g_ServoOutputMinimum, g_ServoOutputMaximum},
+	{"wing_servo_offset_cruise", ParameterType::Integer, offsetof(ParameterSet, m_WingServoOffsetCruise), g_ServoOutputMinimum, g_ServoOutputMaximum},
+	{"elevator_offset", ParameterType::Integer, offsetof(ParameterSet, m_ElevatorOffset), g_ServoOutputMinimum, g_ServoOutputMaximum},
+	{"rudder_offset", ParameterType::Integer, offsetof(ParameterSet, m_RudderOffset), g_ServoOutputMinimum, g_ServoOutputMaximum},
+
+	// A stick can't command more than the sensor reports.
+	{"pitch_input_range", ParameterType::Integer, offsetof(ParameterSet, m_PitchInputRange), 1.0f, g_SensorInputMaximum},
+	{"roll_input_range", ParameterType::Integer, offsetof(ParameterSet, m_RollInputRange), 1.0f, g_SensorInputMaximum},
+	{"yaw_input_range", ParameterType::Integer, offsetof(ParameterSet, m_YawInputRange), 1.0f, g_SensorInputMaximum},
+
+	{"kalman_angle_noise", ParameterType::Float, offsetof(ParameterSet, m_KalmanAngleNoise), g_MinimumKalmanNoise, g_MaximumKalmanNoise},
+	{"kalman_bias_noise", ParameterType::Float, offsetof(ParameterSet, m_KalmanBiasNoise), g_MinimumKalmanNoise, g_MaximumKalmanNoise},
+	{"kalman_measurement_noise", ParameterType::Float, offsetof(ParameterSet, m_KalmanMeasurementNoise), g_MinimumKalmanNoise, g_MaximumKalmanNoise}};
+
+static_assert(sizeof(ParameterSet) <= UINT8_MAX, "The parameter offsets don't fit in the descriptors!");
+static_assert(sizeof(ParameterValue) == sizeof(float) && sizeof(ParameterValue) == sizeof(int32_t), "The parameter types must be 4 bytes!");
+
+/**
+ * @brief Compute the checksum of a parameter set.
+ *
+ * @param parameters The parameters.
+ * @return The CRC-16 of the parameters.
+ */
+static uint16_t ComputeParameterChecksum(const ParameterSet &parameters)
+{
+	return ComputeCRC16(reinterpret_cast<const uint8_t *>(&parameters), sizeof(parameters));
+}
+
+/**
+ * @brief Check if a value is in the range of a parameter.
+ *
+ * @param descriptor The descriptor of the parameter.
+ * @param value The value.
+ * @return true If the value is a number within the range.
+ * @return false If the value is out of the range or not a number.
+ */
+static bool IsInRange(const ParameterDescriptor &descriptor, ParameterValue value)
+{
+	const auto number = descriptor.m_Type == ParameterType::Float ? value.m_Float : static_cast<float>(value.m_Integer);
+
+	// A NaN fails both comparisons.
+	return number >= descriptor.m_Minimum && number <= descriptor.m_Maximum;
+}
+
+const ParameterDescriptor &GetParameterDescriptor(ParameterID id)
+{
+	return s_ParameterDescriptors[static_cast<uint8_t>(id) % g_ParameterCount];
+}
+
+ParameterValue GetParameter(const ParameterSet &parameters, ParameterID id)
+{
+	ParameterValue value;
+	memcpy(&value, reinterpret_cast<const uint8_t *>(&parameters) + GetParameterDescriptor(id).m_Offset, sizeof(value));
+	return value;
+}
+
+bool SetParameter(ParameterSet &parameters, ParameterID id, ParameterValue value)
+{
+	const auto &descriptor = GetParameterDescriptor(id);
+	if (!IsInRange(descriptor, value))
+		return false;
+
+	memcpy(reinterpret_cast<uint8_t *>(&parameters) + descriptor.m_Offset, &value, sizeof(value));
+	return true;
+}
+
+ParameterRecord EncodeParameterRecord(const ParameterSet &parameters)
+{
+	ParameterRecord record;
+	record.m_Parameters = parameters;
+	record.m_Checksum = ComputeParameterChecksum(parameters);
+	return record;
+}
+
+bool DecodeParameterRecord(const ParameterRecord &record, ParameterSet &parameters)
+{
+	if (record.m_Version != g_ParameterVersion || record.m_Checksum != ComputeParameterChecksum(record.m_Parameters))
+		return false;
+
+	for (uint8_t i = 0; i < g_ParameterCount; i++)
+	{
+		const auto id = static_cast<ParameterID>(i);
+		if (!IsInRange(GetParameterDescriptor(id), GetParameter(record.m_Parameters, id)))
+			return false;
+	}
+
+	parameters = record.m_Parameters;
+	return true;
+}
@@ -0,0 +1,138 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "core/Types.hpp"
+#include "core/IRecordStorage.hpp"
+
+// The version of the stored parameters. It must be increased when the parameter set changes, so older ones are replaced by the defaults.
+constexpr uint16_t g_ParameterVersion = 1;
+
+/**
+ * @brief Parameter ID enum.
+ * These are the IDs of the parameters in the telemetry frames, so new parameters must be added at the end.
+ */
+enum class ParameterID : uint8_t
+{
+	PitchAngleKP,
+	PitchAngleKI,
+	PitchAngleKD,
+	RollAngleKP,
+	RollAngleKI,
+	RollAngleKD,
+
+	PitchRateKP,
+	PitchRateKI,
+	PitchRateKD,
+	RollRateKP,
+	RollRateKI,
+	RollRateKD,
+	YawRateKP,
+	YawRateKI,
+	YawRateKD,
+
+	WingServoOffsetHover,
+	WingServoOffsetCruise,
+	ElevatorOffset,
+	RudderOffset,
+
+	PitchInputRange,
+	RollInputRange,
+	YawInputRange,
+
+	KalmanAngleNoise,
+	KalmanBiasNoise,
+	KalmanMeasurementNoise
+};
+
+// The number of parameters.
+constexpr auto g_ParameterCount = 25;
+
+/**
+ * @brief Parameter descriptor structure.
+ * This describes where a parameter is in the parameter set and which values it accepts.
+ */
+struct ParameterDescriptor final
+{
+	const char *m_pName = nullptr;
+	ParameterType m_Type = ParameterType::Float;
+
+	// The offset of the parameter in the parameter set.
+	uint8_t m_Offset = 0;
+
+	// The smallest and the largest value. The integers are compared as floats, which is exact in their range.
+	float m_Minimum = 0.0f;
+	float m_Maximum = 0.0f;
+};
+
+/**
+ * @brief Parameter record structure.
+ * This is how the parameters are stored, with their version and a checksum.
+ */
+struct ParameterRecord final
+{
+	uint16_t m_Version = g_ParameterVersion;
+	uint16_t m_Checksum = 0;
+
+	ParameterSet m_Parameters;
+};
+
+/**
+ * @brief Get the descriptor of a parameter.
+ *
+ * @param id The parameter ID.
+ * @return The descriptor.
+ */
+[[nodiscard]] const ParameterDescriptor &GetParameterDescriptor(ParameterID id);
+
+/**
+ * @brief Get a parameter.
+ *
+ * @param parameters The parameter set.
+ * @param id The parameter ID.
+ * @return The value, of the type of the parameter.
+ */
+[[nodiscard]] ParameterValue GetParameter(const ParameterSet &parameters, ParameterID id);
+
+/**
+ * @brief Set a parameter.
+ *
+ * @param parameters The parameter set.
+ * @param id The parameter ID.
+ * @param value The value, of the type of the parameter.
+ * @return true If the value was set.
+ * @return false If the value is out of the range of the parameter, or not a number.
+ */
+bool SetParameter(ParameterSet &parameters, ParameterID id, ParameterValue value);
+
+/**
+ * @brief Encode the parameters into a record.
+ *
+ * @param parameters The parameters.
+ * @return The record.
+ */
+[[nodiscard]] ParameterRecord EncodeParameterRecord(const ParameterSet &parameters);
+
+/**
+ * @brief Decode a stored parameter record.
+ *
+ * @param record The record.
+ * @param parameters The decoded parameters.
+ * @return true If the record is intact, of the current version and every parameter is in its range.
+ * @return false If the record is damaged, of another version or has a parameter out of its range.
+ */
+bool DecodeParameterRecord(const ParameterRecord &record, ParameterSet &parameters);
+
+/**
+ * @brief Record codec structure of the parameters.
+ * The parameters are stored as a parameter record.
+ */
+template <>
+struct RecordCodec<ParameterSet>
+{
+	using Record = ParameterRecord;
+
+	static Record Encode(const ParameterSet &parameters) { return EncodeParameterRecord(parameters); }
+	static bool Decode(const Record &record, ParameterSet &parameters) { return DecodeParameterRecord(record, parameters); }
+};
\ No newline at end of file
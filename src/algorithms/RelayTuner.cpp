@@ -0,0 +1,172 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#include "RelayTuner.hpp"
+
+#include "core/Common.hpp"
+#include "core/FastMath.hpp"
+
+#include <math.h>
+
+/**
+ * @brief Tuning rule factors structure.
+ * The proportional gain is a factor of the ultimate gain, and the integral and derivative times are factors of the ultimate period.
+ */
+struct TuningRuleFactors final
+{
+	float m_Proportional;
+	float m_Integral;
+	float m_Derivative;
+};
+
+// The factors of each tuning rule, in the order of the enum.
+static constexpr TuningRuleFactors s_TuningRuleFactors[g_TuningRuleCount] = {
+	{0.6f, 0.5f, 0.125f},		   // ZieglerNichols
+	{0.45f, 1.0f / 1.2f, 0.0f},	   // ZieglerNicholsPI
+	{1.0f / 2.2f, 2.2f, 1.0f / 6.3f}, // TyreusLuyben
+	{1.0f / 3.0f, 0.5f, 1.0f / 3.0f}, // SomeOvershoot
+	{0.2f, 0.5f, 1.0f / 3.0f}	   // NoOvershoot
+};
+
+PIDGains ComputePIDGains(float ultimateGain, float ultimatePeriod, TuningRule rule)
+{
+	const auto &factors = s_TuningRuleFactors[static_cast<uint8_t>(rule) % g_TuningRuleCount];
+
+	// The PID class takes the gains of the parallel form, so the integral gain is the proportional gain divided by the integral time and
+	// the derivative gain is the proportional gain times the derivative time.
+	PIDGains gains;
+	gains.m_KP = factors.m_Proportional * ultimateGain;
+	gains.m_KI = gains.m_KP / (factors.m_Integral * ultimatePeriod);
+	gains.m_KD = gains.m_KP * factors.m_Derivative * ultimatePeriod;
+	return gains;
+}
+
+void RelayTuner::start(const RelaySettings &settings)
+{
+	m_Settings = settings;
+	m_Amplitude = settings.m_Amplitude;
+
+	m_Time = 0.0f;
+	m_Frequency = 0.0f;
+	m_Cycles = 0;
+	m_SettledCycles = 0;
+	m_UltimateGain = 0.0f;
+	m_UltimatePeriod = 0.0f;
+
+	m_State = RelayTunerState::Running;
+	m_isHigh = false;
+	m_isCycling = false;
+}
+
+float RelayTuner::update(float measurement, float setpoint, float delta)
+{
+	if (m_State != RelayTunerState::Running)
+		return m_Settings.m_Bias;
+
+	m_Time += delta;
+	const auto error = setpoint - measurement;
+	if (fabsf(error) > m_Settings.m_Limit || m_Time > g_RelayTimeout)
+	{
+		m_State = RelayTunerState::Failed;
+		return m_Settings.m_Bias;
+	}
+
+	// The error is transformed rather than the measurement, since the setpoint may move a little while the relay is running.
+	if (m_Frequency > 0.0f)
+	{
+		const auto phase = 2.0f * g_Pi * m_Frequency * (m_Time - m_CycleStart);
+		m_Cosine += error * cosf(phase) * delta;
+		m_Sine += error * sinf(phase) * delta;
+	}
+
+	// A cycle ends and the next one starts when the relay switches up.
+	if (!m_isHigh && error > m_Settings.m_Hysteresis)
+	{
+		if (m_isCycling)
+			completeCycle();
+
+		m_CycleStart = m_Time;
+		m_Cosine = 0.0f;
+		m_Sine = 0.0f;
+		m_isCycling = true;
+		m_isHigh = true;
+	}
+	else if (m_isHigh && error < -m_Settings.m_Hysteresis)
+	{
+		m_isHigh = false;
+	}
+
+	// The experiment may have completed in this update.
+	if (m_State != RelayTunerState::Running)
+		return m_Settings.m_Bias;
+
+	return m_isHigh ? m_Settings.m_Bias + m_Amplitude : m_Settings.m_Bias - m_Amplitude;
+}
+
+void RelayTuner::completeCycle()
+{
+	// The amplitude of the fundamental. The sums are of the frequency of the previous cycle, which is close enough once the oscillation
+	// settled (the cycles only count when they agree).
+	const auto period = m_Time - m_CycleStart;
+	const auto fundamental = (2.0f / period) * sqrtf((m_Cosine * m_Cosine) + (m_Sine * m_Sine));
+	m_Frequency = 1.0f / period;
+
+	m_Cycles++;
+	m_SettledCycles++;
+	if (m_SettledCycles <= g_RelaySettlingCycles)
+		return;
+
+	// The oscillation settles again after the relay amplitude changed.
+	if (adjustAmplitude(fundamental))
+	{
+		m_SettledCycles = 0;
+		return;
+	}
+
+	const auto index = (m_SettledCycles - g_RelaySettlingCycles - 1) % g_RelayMeasuredCycles;
+	m_Periods[index] = period;
+	m_Amplitudes[index] = fundamental;
+
+	if (m_SettledCycles < g_RelaySettlingCycles + g_RelayMeasuredCycles)
+		return;
+
+	auto averagePeriod = 0.0f;
+	auto amplitude = 0.0f;
+	for (uint8_t i = 0; i < g_RelayMeasuredCycles; i++)
+	{
+		averagePeriod += m_Periods[i];
+		amplitude += m_Amplitudes[i];
+	}
+
+	averagePeriod /= g_RelayMeasuredCycles;
+	amplitude /= g_RelayMeasuredCycles;
+
+	for (uint8_t i = 0; i < g_RelayMeasuredCycles; i++)
+	{
+		if (fabsf(m_Periods[i] - averagePeriod) > averagePeriod * g_RelayConvergence || fabsf(m_Amplitudes[i] - amplitude) > amplitude * g_RelayConvergence)
+			return;
+	}
+
+	// The describing function of a relay with hysteresis. The amplitude is always larger than the hysteresis, since the error crossed it
+	// on both sides.
+	const auto hysteresis = m_Settings.m_Hysteresis;
+	m_UltimateGain = (4.0f * m_Amplitude) / (g_Pi * sqrtf(fmaxf((amplitude * amplitude) - (hysteresis * hysteresis), 1e-6f)));
+	m_UltimatePeriod = averagePeriod;
+	m_State = RelayTunerState::Completed;
+}
+
+bool RelayTuner::adjustAmplitude(float amplitude)
+{
+	const auto target = m_Settings.m_TargetAmplitude;
+	if (target <= 0.0f || fabsf(amplitude - target) <= target * g_RelayAmplitudeTolerance)
+		return false;
+
+	// The oscillation amplitude is about proportional to the relay amplitude.
+	const auto scale = amplitude > 0.0f ? target / amplitude : g_RelayAmplitudeStep;
+	const auto relayAmplitude = fminf(m_Amplitude * clamp(scale, 1.0f / g_RelayAmplitudeStep, g_RelayAmplitudeStep), m_Settings.m_MaximumAmplitude);
+	if (relayAmplitude == m_Amplitude)
+		return false;
+
+	m_Amplitude = relayAmplitude;
+	return true;
+}
@@ -0,0 +1,223 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "PID.hpp"
+
+#include <stdint.h>
+
+// The oscillation settles in the first few cycles after the start and after every change of the relay amplitude, which are not measured.
+constexpr auto g_RelaySettlingCycles = 2;
+
+// The relay amplitude is adjusted when the oscillation is further than this from the target amplitude (relative to the target). It changes
+// by a factor of g_RelayAmplitudeStep at most, so a nonlinear loop does not make it jump around.
+constexpr auto g_RelayAmplitudeTolerance = 0.3f;
+constexpr auto g_RelayAmplitudeStep = 2.0f;
+
+// The number of cycles which are measured. Their periods and amplitudes must all be within g_RelayConvergence of their averages.
+constexpr auto g_RelayMeasuredCycles = 4;
+constexpr auto g_RelayConvergence = 0.1f;
+
+// The experiment fails when it did not converge within this time.
+constexpr auto g_RelayTimeout = 10.0f; // Seconds.
+
+/**
+ * @brief Tuning rule enum.
+ * The rules turn the ultimate gain and period into PID gains. They trade the speed of the response for the overshoot.
+ * Ref: https://en.wikipedia.org/wiki/Ziegler%E2%80%93Nichols_method
+ */
+enum class TuningRule : uint8_t
+{
+	// The classic Ziegler-Nichols PID rule. It's fast, but overshoots and rings a little.
+	ZieglerNichols,
+
+	// The Ziegler-Nichols PI rule, without a derivative term.
+	ZieglerNicholsPI,
+
+	// The Tyreus-Luyben rule. It's much less aggressive than Ziegler-Nichols and is robust to an inaccurate measurement.
+	TyreusLuyben,
+
+	// The rules of Ziegler-Nichols with some and without overshoot.
+	SomeOvershoot,
+	NoOvershoot
+};
+
+// The number of tuning rules.
+constexpr auto g_TuningRuleCount = 5;
+
+/**
+ * @brief Relay tuner state enum.
+ */
+enum class RelayTunerState : uint8_t
+{
+	// The experiment was not started or was stopped.
+	Idle,
+
+	// The relay is driving the loop.
+	Running,
+
+	// The oscillation was measured and the gains are ready.
+	Completed,
+
+	// The measurement left the limit or the oscillation did not converge in time.
+	Failed
+};
+
+/**
+ * @brief Relay settings structure.
+ * The amplitudes and the bias are in the units of the output, the hysteresis and the limit in the units of the measurement.
+ */
+struct RelaySettings final
+{
+	// The output around which the relay switches, which is the output that holds the setpoint (the trim).
+	float m_Bias = 0.0f;
+
+	// The initial and the largest amplitude of the relay.
+	float m_Amplitude = 0.0f;
+	float m_MaximumAmplitude = 0.0f;
+
+	// The measurement has to cross the setpoint by this much before the relay switches. This must be larger than the noise.
+	float m_Hysteresis = 0.0f;
+
+	// The relay amplitude is adjusted until the measurement oscillates with this amplitude, which should be a few times the hysteresis. 0
+	// keeps the initial relay amplitude.
+	float m_TargetAmplitude = 0.0f;
+
+	// The experiment fails when the measurement is further than this from the setpoint.
+	float m_Limit = 0.0f;
+};
+
+/**
+ * @brief Compute the PID gains of a loop from its ultimate gain and period.
+ *
+ * @param ultimateGain The proportional gain at which the loop oscillates.
+ * @param ultimatePeriod The period of the oscillation in seconds.
+ * @param rule The tuning rule.
+ * @return The gains, in the units of the PID class (the integral gain is per second and the derivative gain is in seconds).
+ */
+[[nodiscard]] PIDGains ComputePIDGains(float ultimateGain, float ultimatePeriod, TuningRule rule);
+
+/**
+ * @brief Relay tuner class.
+ * This runs the relay feedback (Astrom-Hagglund) experiment on a single control loop axis. The tuner replaces the controller and drives
+ * the loop with a relay: the output is the bias plus the amplitude while the measurement is below the setpoint, and the bias minus the
+ * amplitude while it's above. This makes the loop oscillate at its ultimate period, with a measurement amplitude which gives the ultimate
+ * gain (Ku = 4 * d / (pi * a), for a relay amplitude d and a measurement amplitude a). The relay has a hysteresis, so the sensor noise does
+ * not make it chatter, which is corrected for in the ultimate gain.
+ *
+ * The measurement amplitude is that of the fundamental of the oscillation (a single bin of a Fourier transform at the frequency of the
+ * previous cycle), not half of its peak to peak. The relation above only holds for the fundamental, and the oscillation of a loop with
+ * little lag is closer to a triangle than a sine, which makes the peaks underestimate the ultimate gain by 20 to 30 percent.
+ *
+ * The amplitude of the relay is adjusted after each cycle until the oscillation has the target amplitude. The loops of an airframe need
+ * very different relay amplitudes, and a single one would either make the oscillation disappear in the hysteresis or shake the airframe.
+ *
+ * A cycle starts whenever the relay switches up. The first g_RelaySettlingCycles cycles with a relay amplitude are skipped, and the
+ * experiment completes once the last g_RelayMeasuredCycles cycles agree with each other. Their average is the result.
+ */
+class RelayTuner final
+{
+public:
+	/**
+	 * @brief Construct a new Relay Tuner object.
+	 */
+	RelayTuner() = default;
+
+	/**
+	 * @brief Start the experiment.
+	 *
+	 * @param settings The relay settings.
+	 */
+	void start(const RelaySettings &settings);
+
+	/**
+	 * @brief Stop the experiment.
+	 */
+	void stop() { m_State = RelayTunerState::Idle; }
+
+	/**
+	 * @brief Update the relay.
+	 *
+	 * @param measurement The measurement.
+	 * @param setpoint The setpoint.
+	 * @param delta The time since the previous update in seconds.
+	 * @return The output of the relay. This is the bias when the experiment is not running.
+	 */
+	float update(float measurement, float setpoint, float delta);
+
+	/**
+	 * @brief Get the state.
+	 *
+	 * @return The state of the experiment.
+	 */
+	[[nodiscard]] RelayTunerState getState() const { return m_State; }
+
+	/**
+	 * @brief Get the relay amplitude.
+	 *
+	 * @return The amplitude which is used.
+	 */
+	[[nodiscard]] float getAmplitude() const { return m_Amplitude; }
+
+	/**
+	 * @brief Get the number of complete cycles.
+	 *
+	 * @return The cycle count, including the settling cycles.
+	 */
+	[[nodiscard]] uint32_t getCycles() const { return m_Cycles; }
+
+	/**
+	 * @brief Get the ultimate gain.
+	 *
+	 * @return The ultimate gain. This is only valid when the experiment completed.
+	 */
+	[[nodiscard]] float getUltimateGain() const { return m_UltimateGain; }
+
+	/**
+	 * @brief Get the ultimate period.
+	 *
+	 * @return The ultimate period in seconds. This is only valid when the experiment completed.
+	 */
+	[[nodiscard]] float getUltimatePeriod() const { return m_UltimatePeriod; }
+
+private:
+	/**
+	 * @brief Complete the current cycle and check if the measured cycles agree.
+	 */
+	void completeCycle();
+
+	/**
+	 * @brief Adjust the relay amplitude to the target amplitude.
+	 *
+	 * @param amplitude The amplitude of the last cycle.
+	 * @return true If the relay amplitude changed.
+	 * @return false If the oscillation is close enough to the target or the relay amplitude is at its limit.
+	 */
+	bool adjustAmplitude(float amplitude);
+
+private:
+	RelaySettings m_Settings;
+	float m_Amplitude = 0.0f;
+
+	float m_Time = 0.0f;
+	float m_CycleStart = 0.0f;
+
+	// The Fourier sums of the current cycle, at the frequency of the previous one.
+	float m_Frequency = 0.0f;
+	float m_Cosine = 0.0f;
+	float m_Sine = 0.0f;
+
+	// The periods and the measurement amplitudes of the last cycles, as a ring buffer.
+	float m_Periods[g_RelayMeasuredCycles] = {};
+	float m_Amplitudes[g_RelayMeasuredCycles] = {};
+	uint32_t m_Cycles = 0;
+	uint32_t m_SettledCycles = 0;
+
+	float m_UltimateGain = 0.0f;
+	float m_UltimatePeriod = 0.0f;
+
+	RelayTunerState m_State = RelayTunerState::Idle;
+	bool m_isHigh = false;
+	bool m_isCycling = false;
+};
\ No newline at end of file
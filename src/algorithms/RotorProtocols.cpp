@@ -0,0 +1,96 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#include "RotorProtocols.hpp"
+
+constexpr uint16_t g_DShotThrottleRange = g_DShotThrottleMaximum - g_DShotThrottleMinimum;
+
+/**
+ * @brief Compute the DShot checksum.
+ *
+ * @param data The 12 bits of the value and the telemetry bit.
+ * @return The 4 bit checksum.
+ */
+static uint16_t ComputeDShotChecksum(uint16_t data)
+{
+	return (data ^ (data >> 4) ^ (data >> 8)) & 0x0F;
+}
+
+uint16_t GetDShotValue(float throttle)
+{
+	if (!(throttle > 0.0f))
+		return 0;
+
+	if (throttle >= 1.0f)
+		return g_DShotThrottleMaximum;
+
+	return g_DShotThrottleMinimum + static_cast<uint16_t>((throttle * g_DShotThrottleRange) + 0.5f);
+}
+
+uint16_t EncodeDShotFrame(uint16_t value, bool telemetry)
+{
+	const auto data = static_cast<uint16_t>(((value & 0x07FF) << 1) | (telemetry ? 1 : 0));
+	return static_cast<uint16_t>((data << 4) | ComputeDShotChecksum(data));
+}
+
+bool DecodeDShotFrame(uint16_t frame, uint16_t &value)
+{
+	const auto data = static_cast<uint16_t>(frame >> 4);
+	if ((frame & 0x0F) != ComputeDShotChecksum(data))
+		return false;
+
+	value = data >> 1;
+	return true;
+}
+
+size_t EncodeRotorPulses(RotorProtocol protocol, float throttle, RotorPulse *pPulses)
+{
+	if (protocol == RotorProtocol::OneShot125)
+	{
+		const auto clamped = throttle < 0.0f ? 0.0f : (throttle > 1.0f ? 1.0f : throttle);
+		pPulses[0].m_High = g_OneShot125MinimumPulse + static_cast<uint16_t>((clamped * (g_OneShot125MaximumPulse - g_OneShot125MinimumPulse)) + 0.5f);
+		pPulses[0].m_Low = g_OneShot125Gap;
+		return 1;
+	}
+
+	const auto &timing = GetDShotTiming(protocol);
+	const auto frame = EncodeDShotFrame(GetDShotValue(throttle));
+	for (uint8_t i = 0; i < g_DShotFrameBits; i++)
+	{
+		const auto isOne = (frame & (0x8000 >> i)) != 0;
+		pPulses[i].m_High = isOne ? timing.m_OneHigh : timing.m_ZeroHigh;
+		pPulses[i].m_Low = timing.m_BitPeriod - pPulses[i].m_High;
+	}
+
+	return g_DShotFrameBits;
+}
+
+bool DecodeRotorPulses(RotorProtocol protocol, const RotorPulse *pPulses, size_t count, float &throttle)
+{
+	if (protocol == RotorProtocol::OneShot125)
+	{
+		if (count != 1 || pPulses[0].m_High < g_OneShot125MinimumPulse || pPulses[0].m_High > g_OneShot125MaximumPulse)
+			return false;
+
+		throttle = static_cast<float>(pPulses[0].m_High - g_OneShot125MinimumPulse) / (g_OneShot125MaximumPulse - g_OneShot125MinimumPulse);
+		return true;
+	}
+
+	if (count != g_DShotFrameBits)
+		return false;
+
+	// The ESC samples the line in the middle of the two high times.
+	const auto &timing = GetDShotTiming(protocol);
+	const auto threshold = (timing.m_ZeroHigh + timing.m_OneHigh) / 2;
+
+	uint16_t frame = 0;
+	for (uint8_t i = 0; i < g_DShotFrameBits; i++)
+		frame = static_cast<uint16_t>((frame << 1) | (pPulses[i].m_High > threshold ? 1 : 0));
+
+	uint16_t value = 0;
+	if (!DecodeDShotFrame(frame, value) || (value > 0 && value < g_DShotThrottleMinimum))
+		return false;
+
+	throttle = value == 0 ? 0.0f : static_cast<float>(value - g_DShotThrottleMinimum) / g_DShotThrottleRange;
+	return true;
+}
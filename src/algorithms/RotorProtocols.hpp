@@ -0,0 +1,128 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// The pulses are timed by the RMT peripheral, which is clocked from the 80 MHz APB clock without a divider (12.5 ns ticks).
+constexpr uint32_t g_RotorPulseTickRate = 80000000;
+
+// A OneShot125 pulse is 125 us (stopped) to 250 us (full throttle) long.
+constexpr uint16_t g_OneShot125MinimumPulse = 10000;
+constexpr uint16_t g_OneShot125MaximumPulse = 20000;
+
+// The low time after a OneShot125 pulse, before the line goes idle (1 us).
+constexpr uint16_t g_OneShot125Gap = 80;
+
+// A DShot frame is 16 bits, sent most significant bit first: an 11 bit value, the telemetry request bit and a 4 bit checksum. The value
+// 0 stops the motor, 1 to 47 are ESC commands and 48 to 2047 is the throttle.
+constexpr auto g_DShotFrameBits = 16;
+constexpr uint16_t g_DShotThrottleMinimum = 48;
+constexpr uint16_t g_DShotThrottleMaximum = 2047;
+
+// The maximum number of pulses of a frame of any protocol.
+constexpr auto g_MaxRotorPulses = g_DShotFrameBits;
+
+/**
+ * @brief Rotor protocol enum.
+ * These are the digital ESC protocols which can be generated with the RMT peripheral.
+ */
+enum class RotorProtocol : uint8_t
+{
+	OneShot125,
+	DShot150,
+	DShot300,
+	DShot600
+};
+
+/**
+ * @brief DShot timing structure.
+ * This is the timing of the bits of a DShot protocol in RMT ticks. A 0 is high for 37.5% of the bit period and a 1 for 75%.
+ */
+struct DShotTiming final
+{
+	uint16_t m_BitPeriod = 0;
+	uint16_t m_ZeroHigh = 0;
+	uint16_t m_OneHigh = 0;
+};
+
+// The bit timings of DShot150 (6.67 us bits), DShot300 (3.33 us bits) and DShot600 (1.67 us bits).
+constexpr DShotTiming g_DShotTimings[] = {
+	{533, 200, 400},
+	{267, 100, 200},
+	{133, 50, 100}};
+
+/**
+ * @brief Rotor pulse structure.
+ * This is a high time followed by a low time, in RMT ticks. It maps to an RMT item.
+ */
+struct RotorPulse final
+{
+	uint16_t m_High = 0;
+	uint16_t m_Low = 0;
+};
+
+/**
+ * @brief Get the DShot timing of a protocol.
+ *
+ * @param protocol The protocol. It must be a DShot protocol.
+ * @return The timing.
+ */
+[[nodiscard]] constexpr const DShotTiming &GetDShotTiming(RotorProtocol protocol)
+{
+	return g_DShotTimings[static_cast<uint8_t>(protocol) - static_cast<uint8_t>(RotorProtocol::DShot150)];
+}
+
+/**
+ * @brief Get the DShot value of a throttle.
+ * Any positive throttle keeps the motor spinning, only 0 stops it.
+ *
+ * @param throttle The throttle (0 - 1).
+ * @return The DShot value. 0 or 48 to 2047, so the throttle has 2000 steps.
+ */
+[[nodiscard]] uint16_t GetDShotValue(float throttle);
+
+/**
+ * @brief Encode a DShot frame.
+ * The checksum is the XOR of the three nibbles of the value and the telemetry bit.
+ *
+ * @param value The 11 bit value.
+ * @param telemetry Whether to request telemetry from the ESC.
+ * @return The 16 bit frame.
+ */
+[[nodiscard]] uint16_t EncodeDShotFrame(uint16_t value, bool telemetry = false);
+
+/**
+ * @brief Decode a DShot frame.
+ *
+ * @param frame The 16 bit frame.
+ * @param value The 11 bit value.
+ * @return true If the checksum is valid.
+ * @return false If the checksum is invalid.
+ */
+bool DecodeDShotFrame(uint16_t frame, uint16_t &value);
+
+/**
+ * @brief Encode the pulses of a throttle.
+ *
+ * @param protocol The protocol.
+ * @param throttle The throttle (0 - 1).
+ * @param pPulses The output pulses. It must have room for g_MaxRotorPulses pulses.
+ * @return The number of pulses.
+ */
+size_t EncodeRotorPulses(RotorProtocol protocol, float throttle, RotorPulse *pPulses);
+
+/**
+ * @brief Decode the pulses of a throttle.
+ * This is what the ESC does. It's used to check the pulses on the host.
+ *
+ * @param protocol The protocol.
+ * @param pPulses The pulses.
+ * @param count The number of pulses.
+ * @param throttle The decoded throttle (0 - 1).
+ * @return true If the pulses are a valid frame.
+ * @return false If the pulses are not a valid frame.
+ */
+bool DecodeRotorPulses(RotorProtocol protocol, const RotorPulse *pPulses, size_t count, float &throttle);
\ No newline at end of file
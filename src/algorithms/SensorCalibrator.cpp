@@ -0,0 +1,149 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#include "SensorCalibrator.hpp"
+#include "CRC.hpp"
+
+#include "core/Constants.hpp"
+
+#include <math.h>
+
+/**
+ * @brief Compute the checksum of a calibration.
+ *
+ * @param calibration The calibration.
+ * @return The CRC-16 of the calibration.
+ */
+static uint16_t ComputeCalibrationChecksum(const SensorCalibration &calibration)
+{
+	return ComputeCRC16(reinterpret_cast<const uint8_t *>(&calibration), sizeof(calibration));
+}
+
+/**
+ * @brief Check if the largest difference of two vectors is within a limit.
+ *
+ * @param first The first vector.
+ * @param second The second vector.
+ * @param limit The limit.
+ * @return true If the vectors differ by less than the limit on every axis.
+ * @return false If they differ by the limit or more on any axis.
+ */
+static bool IsWithin(Vec3 first, Vec3 second, float limit)
+{
+	const auto difference = first - second;
+	return fabsf(difference.m_X) < limit && fabsf(difference.m_Y) < limit && fabsf(difference.m_Z) < limit;
+}
+
+CalibrationRecord EncodeCalibrationRecord(const SensorCalibration &calibration)
+{
+	CalibrationRecord record;
+	record.m_Calibration = calibration;
+	record.m_Checksum = ComputeCalibrationChecksum(calibration);
+	return record;
+}
+
+bool DecodeCalibrationRecord(const CalibrationRecord &record, SensorCalibration &calibration)
+{
+	if (record.m_Version != g_CalibrationVersion || record.m_Checksum != ComputeCalibrationChecksum(record.m_Calibration))
+		return false;
+
+	calibration = record.m_Calibration;
+	return true;
+}
+
+void SensorCalibrator::setCalibration(const SensorCalibration &calibration)
+{
+	m_Calibration = calibration;
+	m_isCalibrated = true;
+	m_isPending = false;
+}
+
+bool SensorCalibrator::update(const IMUSample &sample, float temperature)
+{
+	if (m_Count == 0)
+	{
+		m_Reference = sample;
+		for (uint8_t i = 0; i < 6; i++)
+		{
+			m_Sums[i] = 0.0f;
+			m_SquareSums[i] = 0.0f;
+		}
+	}
+
+	const float deviations[] = {sample.m_Rate.m_X - m_Reference.m_Rate.m_X, sample.m_Rate.m_Y - m_Reference.m_Rate.m_Y, sample.m_Rate.m_Z - m_Reference.m_Rate.m_Z,
+								sample.m_Acceleration.m_X - m_Reference.m_Acceleration.m_X, sample.m_Acceleration.m_Y - m_Reference.m_Acceleration.m_Y,
+								sample.m_Acceleration.m_Z - m_Reference.m_Acceleration.m_Z};
+
+	for (uint8_t i = 0; i < 6; i++)
+	{
+		m_Sums[i] += deviations[i];
+		m_SquareSums[i] += deviations[i] * deviations[i];
+	}
+
+	if (++m_Count < g_CalibrationWindowSize)
+		return false;
+
+	m_Count = 0;
+	return evaluate(temperature);
+}
+
+bool SensorCalibrator::commit()
+{
+	if (!m_isPending)
+		return false;
+
+	m_Calibration = m_PendingCalibration;
+	m_isCalibrated = true;
+	m_isPending = false;
+	return true;
+}
+
+IMUSample SensorCalibrator::correct(const IMUSample &sample) const
+{
+	IMUSample result = sample;
+	result.m_Rate -= m_Calibration.m_GyroscopeBias;
+	result.m_Acceleration -= m_Calibration.m_AccelerometerOffset;
+	return result;
+}
+
+bool SensorCalibrator::evaluate(float temperature)
+{
+	constexpr auto scale = 1.0f / g_CalibrationWindowSize;
+	constexpr float limits[] = {g_StillGyroscopeDeviation * g_StillGyroscopeDeviation, g_StillAccelerometerDeviation * g_StillAccelerometerDeviation};
+
+	float means[6];
+	for (uint8_t i = 0; i < 6; i++)
+	{
+		means[i] = m_Sums[i] * scale;
+		if ((m_SquareSums[i] * scale) - (means[i] * means[i]) > limits[i / 3])
+			return false;
+	}
+
+	const auto rate = Vec3(m_Reference.m_Rate.m_X + means[0], m_Reference.m_Rate.m_Y + means[1], m_Reference.m_Rate.m_Z + means[2]);
+	const auto acceleration = Vec3(m_Reference.m_Acceleration.m_X + means[3], m_Reference.m_Acceleration.m_Y + means[4], m_Reference.m_Acceleration.m_Z + means[5]);
+
+	// A steady rotation or a push are not still, even if they are smooth. The sensor's Z axis points up, so gravity reads as +1 g on Z.
+	const auto magnitude = sqrtf((acceleration.m_X * acceleration.m_X) + (acceleration.m_Y * acceleration.m_Y) + (acceleration.m_Z * acceleration.m_Z));
+	if (!IsWithin(rate, Vec3(), g_MaxGyroscopeBias) || fabsf(magnitude - g_StandardGravity) > g_MaxAccelerometerOffset)
+		return false;
+
+	if (m_isCalibrated)
+	{
+		const auto isDrifting = !IsWithin(rate, m_Calibration.m_GyroscopeBias, g_GyroscopeDriftThreshold);
+		if (!isDrifting && fabsf(temperature - m_Calibration.m_Temperature) <= g_CalibrationTemperatureChange)
+			return false;
+
+		// The accelerometer offsets barely drift and can only be measured when level, so only the gyroscope bias is measured again.
+		m_PendingCalibration = m_Calibration;
+	}
+	else
+	{
+		const auto level = Vec3(0.0f, 0.0f, g_StandardGravity);
+		m_PendingCalibration.m_AccelerometerOffset = IsWithin(acceleration, level, g_MaxAccelerometerOffset) ? acceleration - level : Vec3();
+	}
+
+	m_PendingCalibration.m_GyroscopeBias = rate;
+	m_PendingCalibration.m_Temperature = temperature;
+	m_isPending = true;
+	return true;
+}
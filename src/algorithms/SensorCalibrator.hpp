@@ -0,0 +1,171 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "core/Types.hpp"
+#include "core/IRecordStorage.hpp"
+
+// The version of the stored calibration. It must be increased when the calibration structure changes, so older ones are measured again.
+constexpr uint16_t g_CalibrationVersion = 1;
+
+// The number of samples of a calibration window (half a second at the sensor's sample rate). The sensor must be still for a whole window.
+constexpr auto g_CalibrationWindowSize = 500;
+
+// The sensor is still when the standard deviation of every axis in a window is below these. They are well above the noise of the sensor
+// and well below the vibrations of the rotors.
+constexpr auto g_StillGyroscopeDeviation = 0.5f; // Degrees per second.
+constexpr auto g_StillAccelerometerDeviation = 0.2f; // Meters per square second.
+
+// The MPU6050's zero rate output tolerance. A larger average rate is a slow, steady rotation, not the bias.
+constexpr auto g_MaxGyroscopeBias = 20.0f; // Degrees per second.
+
+// The accelerometer offsets are only measured when each axis is this close to its level reading (about 9 degrees of tilt), since a tilt
+// can't be told apart from an offset.
+constexpr auto g_MaxAccelerometerOffset = 1.5f; // Meters per square second.
+
+// The gyroscope bias is measured again when a still window differs from it by more than this on any axis, or when the temperature changed
+// by more than this since it was measured.
+constexpr auto g_GyroscopeDriftThreshold = 0.2f; // Degrees per second.
+constexpr auto g_CalibrationTemperatureChange = 5.0f; // Celsius.
+
+/**
+ * @brief Calibration record structure.
+ * This is how the calibration is stored, with its version and a checksum.
+ */
+struct CalibrationRecord final
+{
+	uint16_t m_Version = g_CalibrationVersion;
+	uint16_t m_Checksum = 0;
+
+	SensorCalibration m_Calibration;
+};
+
+/**
+ * @brief Encode a calibration into a record.
+ *
+ * @param calibration The calibration.
+ * @return The record.
+ */
+[[nodiscard]] CalibrationRecord EncodeCalibrationRecord(const SensorCalibration &calibration);
+
+/**
+ * @brief Decode a stored calibration record.
+ *
+ * @param record The record.
+ * @param calibration The decoded calibration.
+ * @return true If the record is intact and of the current version.
+ * @return false If the record is damaged or of another version.
+ */
+bool DecodeCalibrationRecord(const CalibrationRecord &record, SensorCalibration &calibration);
+
+/**
+ * @brief Record codec structure of the sensor calibration.
+ * The calibration is stored as a calibration record.
+ */
+template <>
+struct RecordCodec<SensorCalibration>
+{
+	using Record = CalibrationRecord;
+
+	static Record Encode(const SensorCalibration &calibration) { return EncodeCalibrationRecord(calibration); }
+	static bool Decode(const Record &record, SensorCalibration &calibration) { return DecodeCalibrationRecord(record, calibration); }
+};
+
+/**
+ * @brief Sensor calibrator class.
+ * This measures the gyroscope bias and the accelerometer offsets while the sensor is still, and corrects the samples with them.
+ *
+ * The samples are collected in windows of g_CalibrationWindowSize. A window is still when the rates and the accelerations barely vary and
+ * the average specific force is about gravity. The first still window measures the whole calibration (the accelerometer offsets assume that
+ * the sensor is level). After that, a still window only measures the gyroscope bias again when it drifted or the temperature changed, which
+ * is what the bias depends on. A stored calibration skips the first measurement.
+ *
+ * A new calibration is only used after it's committed, so it can be applied in between two sensor reads.
+ */
+class SensorCalibrator final
+{
+public:
+	/**
+	 * @brief Construct a new Sensor Calibrator object.
+	 */
+	SensorCalibrator() = default;
+
+	/**
+	 * @brief Set the calibration, for example the stored one.
+	 * Any calibration which is not committed yet is dropped.
+	 *
+	 * @param calibration The calibration.
+	 */
+	void setCalibration(const SensorCalibration &calibration);
+
+	/**
+	 * @brief Add an uncorrected sample to the current window.
+	 * The samples of a window must be consecutive, so the window must be restarted when samples are skipped.
+	 *
+	 * @param sample The sample.
+	 * @param temperature The sensor's temperature in celsius.
+	 * @return true If the window completed and a new calibration is ready to be committed.
+	 * @return false If the window is not complete, was not still or the calibration is still valid.
+	 */
+	bool update(const IMUSample &sample, float temperature);
+
+	/**
+	 * @brief Drop the samples of the current window.
+	 */
+	void restart() { m_Count = 0; }
+
+	/**
+	 * @brief Use the new calibration, if there is one.
+	 *
+	 * @return true If the calibration changed.
+	 * @return false If there was no new calibration.
+	 */
+	bool commit();
+
+	/**
+	 * @brief Correct a sample.
+	 *
+	 * @param sample The uncorrected sample.
+	 * @return The corrected sample.
+	 */
+	[[nodiscard]] IMUSample correct(const IMUSample &sample) const;
+
+	/**
+	 * @brief Get the calibration.
+	 *
+	 * @return The calibration which is used to correct the samples.
+	 */
+	[[nodiscard]] const SensorCalibration &getCalibration() const { return m_Calibration; }
+
+	/**
+	 * @brief Check if the sensor is calibrated.
+	 *
+	 * @return true If a calibration was set or committed.
+	 * @return false If the first still window was not measured yet.
+	 */
+	[[nodiscard]] bool isCalibrated() const { return m_isCalibrated; }
+
+private:
+	/**
+	 * @brief Evaluate the completed window.
+	 *
+	 * @param temperature The sensor's temperature in celsius.
+	 * @return true If a new calibration is ready to be committed.
+	 * @return false If the window was not still or the calibration is still valid.
+	 */
+	bool evaluate(float temperature);
+
+private:
+	SensorCalibration m_Calibration;
+	SensorCalibration m_PendingCalibration;
+
+	// The samples are summed relative to the first sample of the window, which keeps the float sums of the squares precise.
+	IMUSample m_Reference;
+	float m_Sums[6] = {};
+	float m_SquareSums[6] = {};
+	uint32_t m_Count = 0;
+
+	bool m_isCalibrated = false;
+	bool m_isPending = false;
+};
\ No newline at end of file
@@ -0,0 +1,114 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#include "SensorFilter.hpp"
+
+#include <algorithm>
+
+/**
+ * @brief Check if a filter frequency is usable.
+ *
+ * @param frequency The frequency in hertz.
+ * @param sampleRate The sample rate in hertz.
+ * @return true If the frequency is above 0 and below half of the sample rate.
+ * @return false If the filter is disabled or the frequency can't be sampled.
+ */
+static bool IsUsable(float frequency, float sampleRate)
+{
+	return frequency > 0.0f && frequency < sampleRate * 0.5f;
+}
+
+/**
+ * @brief Configure the filters of all 3 axes.
+ *
+ * @param filters The filter of each axis.
+ * @param coefficients The coefficients.
+ */
+static void ConfigureAxes(BiquadFilter (&filters)[3], const BiquadCoefficients &coefficients)
+{
+	for (auto &filter : filters)
+	{
+		filter.setCoefficients(coefficients);
+		filter.reset();
+	}
+}
+
+void SensorFilter::configure(const SensorFilterSettings &settings)
+{
+	m_Settings = settings;
+	const auto sampleRate = settings.m_SampleRate;
+
+	m_GyroscopeLowPassStages = IsUsable(settings.m_GyroscopeLowPassCutoff, sampleRate) ? std::min<uint8_t>(settings.m_GyroscopeLowPassStages, g_MaxLowPassStages) : 0;
+	for (uint8_t i = 0; i < m_GyroscopeLowPassStages; i++)
+		ConfigureAxes(m_GyroscopeLowPass[i], ComputeLowPassCoefficients(settings.m_GyroscopeLowPassCutoff, sampleRate));
+
+	m_AccelerometerLowPassStages = IsUsable(settings.m_AccelerometerLowPassCutoff, sampleRate) ? std::min<uint8_t>(settings.m_AccelerometerLowPassStages, g_MaxLowPassStages) : 0;
+	for (uint8_t i = 0; i < m_AccelerometerLowPassStages; i++)
+		ConfigureAxes(m_AccelerometerLowPass[i], ComputeLowPassCoefficients(settings.m_AccelerometerLowPassCutoff, sampleRate));
+
+	// The disabled notches are skipped.
+	m_NotchCount = 0;
+	for (const auto frequency : settings.m_NotchFrequencies)
+	{
+		if (IsUsable(frequency, sampleRate))
+			ConfigureAxes(m_Notches[m_NotchCount++], ComputeNotchCoefficients(frequency, sampleRate, settings.m_NotchQ));
+	}
+
+	// The notches pass everything through until they are placed.
+	ConfigureAxes(m_DynamicNotches, BiquadCoefficients());
+	for (uint8_t i = 0; i < 3; i++)
+	{
+		m_Analyzers[i].configure(sampleRate, settings.m_DynamicNotchMinimum, settings.m_DynamicNotchMaximum);
+		m_DynamicNotchFrequencies[i] = 0.0f;
+	}
+
+	m_AnalyzedAxis = 0;
+}
+
+IMUSample SensorFilter::apply(const IMUSample &sample)
+{
+	float rates[] = {sample.m_Rate.m_X, sample.m_Rate.m_Y, sample.m_Rate.m_Z};
+	float accelerations[] = {sample.m_Acceleration.m_X, sample.m_Acceleration.m_Y, sample.m_Acceleration.m_Z};
+
+	for (uint8_t axis = 0; axis < 3; axis++)
+	{
+		for (uint8_t i = 0; i < m_NotchCount; i++)
+			rates[axis] = m_Notches[i][axis].apply(rates[axis]);
+
+		if (m_Settings.m_isDynamicNotchEnabled)
+		{
+			m_Analyzers[axis].addSample(rates[axis]);
+			rates[axis] = m_DynamicNotches[axis].apply(rates[axis]);
+		}
+
+		for (uint8_t i = 0; i < m_GyroscopeLowPassStages; i++)
+			rates[axis] = m_GyroscopeLowPass[i][axis].apply(rates[axis]);
+
+		for (uint8_t i = 0; i < m_AccelerometerLowPassStages; i++)
+			accelerations[axis] = m_AccelerometerLowPass[i][axis].apply(accelerations[axis]);
+	}
+
+	// Only one axis is analyzed at a time.
+	if (m_Settings.m_isDynamicNotchEnabled && m_Analyzers[m_AnalyzedAxis].step())
+	{
+		updateDynamicNotch(m_AnalyzedAxis);
+		m_AnalyzedAxis = (m_AnalyzedAxis + 1) % 3;
+	}
+
+	IMUSample result;
+	result.m_Acceleration = Vec3(accelerations[0], accelerations[1], accelerations[2]);
+	result.m_Rate = Vec3(rates[0], rates[1], rates[2]);
+	result.m_DeltaTime = sample.m_DeltaTime;
+	return result;
+}
+
+void SensorFilter::updateDynamicNotch(uint8_t axis)
+{
+	const auto peak = m_Analyzers[axis].getPeakFrequency();
+	if (peak <= 0.0f)
+		return;
+
+	auto &frequency = m_DynamicNotchFrequencies[axis];
+	frequency = frequency > 0.0f ? frequency + ((peak - frequency) * g_DynamicNotchSmoothing) : peak;
+	m_DynamicNotches[axis].setCoefficients(ComputeNotchCoefficients(frequency, m_Settings.m_SampleRate, m_Settings.m_DynamicNotchQ));
+}
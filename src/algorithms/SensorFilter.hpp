@@ -0,0 +1,136 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "BiquadFilter.hpp"
+#include "SpectrumAnalyzer.hpp"
+
+#include "core/Constants.hpp"
+#include "core/Types.hpp"
+
+// The maximum number of cascaded low pass filters and static notch filters.
+constexpr auto g_MaxLowPassStages = 2;
+constexpr auto g_MaxStaticNotches = 2;
+
+// The gyroscope low pass filter. The rate loop is what the rotor vibrations disturb the most and what the delay of the filter hurts the
+// most, so it's a single stage a little above the bandwidth of the airframe (about 2 ms of delay at low frequencies).
+constexpr auto g_GyroscopeLowPassCutoff = 100.0f; // Hertz.
+constexpr auto g_GyroscopeLowPassStages = 1;
+
+// The accelerometer low pass filter. The estimators only trust the accelerometer over seconds, so it's filtered much harder.
+constexpr auto g_AccelerometerLowPassCutoff = 25.0f; // Hertz.
+constexpr auto g_AccelerometerLowPassStages = 2;
+
+// The quality factor of the static notch filters, which are meant for a known resonance of the frame.
+constexpr auto g_StaticNotchQ = 3.0f;
+
+// The dynamic notch filter follows the largest peak of the gyroscope spectrum in this range, which covers the rotor speeds from hover to
+// full throttle. The quality factor is higher than that of the static notches, since the notch is kept on the peak.
+constexpr auto g_DynamicNotchMinimum = 80.0f; // Hertz.
+constexpr auto g_DynamicNotchMaximum = 450.0f; // Hertz.
+constexpr auto g_DynamicNotchQ = 4.0f;
+
+// The dynamic notch moves this fraction of the way to every new peak, so a single wrong peak does not throw it off.
+constexpr auto g_DynamicNotchSmoothing = 0.5f;
+
+/**
+ * @brief Sensor filter settings structure.
+ * The defaults are the constants above. A frequency of 0 disables the filter.
+ */
+struct SensorFilterSettings final
+{
+	// The sample rate in hertz.
+	float m_SampleRate = static_cast<float>(g_SensorSampleRate);
+
+	float m_GyroscopeLowPassCutoff = g_GyroscopeLowPassCutoff;
+	uint8_t m_GyroscopeLowPassStages = g_GyroscopeLowPassStages;
+
+	float m_AccelerometerLowPassCutoff = g_AccelerometerLowPassCutoff;
+	uint8_t m_AccelerometerLowPassStages = g_AccelerometerLowPassStages;
+
+	// The center frequencies of the static gyroscope notch filters.
+	float m_NotchFrequencies[g_MaxStaticNotches] = {};
+	float m_NotchQ = g_StaticNotchQ;
+
+	bool m_isDynamicNotchEnabled = true;
+	float m_DynamicNotchMinimum = g_DynamicNotchMinimum;
+	float m_DynamicNotchMaximum = g_DynamicNotchMaximum;
+	float m_DynamicNotchQ = g_DynamicNotchQ;
+};
+
+/**
+ * @brief Sensor filter class.
+ * This is the filter chain in between the (corrected) sensor samples and the attitude estimator. Each gyroscope axis is filtered by the
+ * static notch filters, the dynamic notch filter and the cascaded low pass filters, in this order. The accelerometer is only low pass
+ * filtered.
+ *
+ * The dynamic notch is placed on the largest peak of the spectrum of its axis, which is the vibration of the rotors. The spectrum of each
+ * axis is analyzed after the static notches (see SpectrumAnalyzer), one analysis step per sample and one axis after the other, so the
+ * cost per sample stays about the same and a notch is moved every 3 * g_SpectrumStepCount samples. When an axis has no clear peak (the
+ * rotors are stopped), its notch stays where it was.
+ *
+ * The filters run at the fixed sample rate, in single precision, and nothing is allocated.
+ */
+class SensorFilter final
+{
+public:
+	/**
+	 * @brief Construct a new Sensor Filter object.
+	 * This uses the default settings.
+	 */
+	SensorFilter() { configure(SensorFilterSettings()); }
+
+	/**
+	 * @brief Configure the filters.
+	 * This resets the filters and the dynamic notches.
+	 *
+	 * @param settings The settings. The stage counts are limited to g_MaxLowPassStages.
+	 */
+	void configure(const SensorFilterSettings &settings);
+
+	/**
+	 * @brief Filter a sample.
+	 *
+	 * @param sample The sample.
+	 * @return The filtered sample.
+	 */
+	[[nodiscard]] IMUSample apply(const IMUSample &sample);
+
+	/**
+	 * @brief Get the settings.
+	 *
+	 * @return The settings in use.
+	 */
+	[[nodiscard]] const SensorFilterSettings &getSettings() const { return m_Settings; }
+
+	/**
+	 * @brief Get the center frequencies of the dynamic notches.
+	 *
+	 * @return The frequency of each sensor axis in hertz. 0 if the notch of the axis was not placed yet.
+	 */
+	[[nodiscard]] Vec3 getDynamicNotchFrequencies() const { return Vec3(m_DynamicNotchFrequencies[0], m_DynamicNotchFrequencies[1], m_DynamicNotchFrequencies[2]); }
+
+private:
+	/**
+	 * @brief Move the dynamic notch of an axis to the peak of its last analysis.
+	 *
+	 * @param axis The sensor axis.
+	 */
+	void updateDynamicNotch(uint8_t axis);
+
+private:
+	SensorFilterSettings m_Settings;
+
+	BiquadFilter m_GyroscopeLowPass[g_MaxLowPassStages][3];
+	BiquadFilter m_AccelerometerLowPass[g_MaxLowPassStages][3];
+	BiquadFilter m_Notches[g_MaxStaticNotches][3];
+	BiquadFilter m_DynamicNotches[3];
+	SpectrumAnalyzer m_Analyzers[3];
+
+	float m_DynamicNotchFrequencies[3] = {};
+	uint8_t m_GyroscopeLowPassStages = 0;
+	uint8_t m_AccelerometerLowPassStages = 0;
+	uint8_t m_NotchCount = 0;
+	uint8_t m_AnalyzedAxis = 0;
+};
\ No newline at end of file
@@ -0,0 +1,158 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#include "SpectrumAnalyzer.hpp"
+
+#include "core/Common.hpp"
+#include "core/FastMath.hpp"
+
+#include <math.h>
+
+/**
+ * @brief Spectrum tables structure.
+ * These are shared by all the analyzers and are computed once, when the firmware starts.
+ */
+struct SpectrumTables final
+{
+	SpectrumTables()
+	{
+		// The window is scaled so that the magnitude of a bin is the amplitude of a sine at its frequency (the sum of a Hann window is
+		// half of its size, and a real sine is split in between the positive and the negative frequencies).
+		for (uint32_t i = 0; i < g_SpectrumWindowSize; i++)
+			m_Window[i] = (1.0f - cosf(2.0f * g_Pi * i / g_SpectrumWindowSize)) * (2.0f / g_SpectrumWindowSize);
+
+		for (uint32_t i = 0; i < g_SpectrumWindowSize / 2; i++)
+		{
+			m_Cosines[i] = cosf(2.0f * g_Pi * i / g_SpectrumWindowSize);
+			m_Sines[i] = -sinf(2.0f * g_Pi * i / g_SpectrumWindowSize);
+		}
+
+		for (uint32_t i = 0; i < g_SpectrumWindowSize; i++)
+		{
+			uint32_t reversed = 0;
+			for (uint32_t j = 0; j < g_SpectrumStageCount; j++)
+				reversed |= ((i >> j) & 1) << (g_SpectrumStageCount - 1 - j);
+
+			m_Reversed[i] = static_cast<uint8_t>(reversed);
+		}
+	}
+
+	float m_Window[g_SpectrumWindowSize];
+	float m_Cosines[g_SpectrumWindowSize / 2];
+	float m_Sines[g_SpectrumWindowSize / 2];
+	uint8_t m_Reversed[g_SpectrumWindowSize];
+};
+
+static_assert((1 << g_SpectrumStageCount) == g_SpectrumWindowSize, "The stage count must match the window size!");
+
+static const SpectrumTables s_Tables;
+
+void SpectrumAnalyzer::configure(float sampleRate, float minimum, float maximum)
+{
+	m_BinWidth = sampleRate / g_SpectrumWindowSize;
+
+	// The peak needs a neighbour on both sides for the interpolation.
+	m_MinimumBin = clamp(static_cast<uint32_t>(lroundf(minimum / m_BinWidth)), 1u, static_cast<uint32_t>(g_SpectrumBinCount - 2));
+	m_MaximumBin = clamp(static_cast<uint32_t>(lroundf(maximum / m_BinWidth)), m_MinimumBin, static_cast<uint32_t>(g_SpectrumBinCount - 2));
+
+	m_Step = 0;
+	m_PeakFrequency = 0.0f;
+}
+
+bool SpectrumAnalyzer::step()
+{
+	if (m_Step == 0)
+		loadWindow();
+	else if (m_Step <= g_SpectrumStageCount)
+		computeStage(m_Step - 1);
+	else
+		findPeak();
+
+	if (++m_Step < g_SpectrumStepCount)
+		return false;
+
+	m_Step = 0;
+	return true;
+}
+
+void SpectrumAnalyzer::computePowers()
+{
+	for (uint32_t i = 0; i < g_SpectrumBinCount; i++)
+		m_Powers[i] = (m_Real[i] * m_Real[i]) + (m_Imaginary[i] * m_Imaginary[i]);
+}
+
+void SpectrumAnalyzer::loadWindow()
+{
+	// The head is the oldest sample.
+	for (uint32_t i = 0; i < g_SpectrumWindowSize; i++)
+	{
+		const auto index = s_Tables.m_Reversed[i];
+		m_Real[index] = m_Samples[(m_Head + i) % g_SpectrumWindowSize] * s_Tables.m_Window[i];
+		m_Imaginary[index] = 0.0f;
+	}
+}
+
+void SpectrumAnalyzer::computeStage(uint32_t stage)
+{
+	const uint32_t span = 1 << stage;
+	const uint32_t twiddleStride = g_SpectrumWindowSize / (span * 2);
+
+	for (uint32_t group = 0; group < g_SpectrumWindowSize; group += span * 2)
+	{
+		for (uint32_t i = 0; i < span; i++)
+		{
+			const auto cosine = s_Tables.m_Cosines[i * twiddleStride];
+			const auto sine = s_Tables.m_Sines[i * twiddleStride];
+
+			const auto first = group + i;
+			const auto second = first + span;
+			const auto real = (m_Real[second] * cosine) - (m_Imaginary[second] * sine);
+			const auto imaginary = (m_Real[second] * sine) + (m_Imaginary[second] * cosine);
+
+			m_Real[second] = m_Real[first] - real;
+			m_Imaginary[second] = m_Imaginary[first] - imaginary;
+			m_Real[first] += real;
+			m_Imaginary[first] += imaginary;
+		}
+	}
+}
+
+void SpectrumAnalyzer::findPeak()
+{
+	// The neighbours of the searched bins are needed for the interpolation.
+	auto sum = 0.0f;
+	auto peak = m_MinimumBin;
+	for (uint32_t i = m_MinimumBin - 1; i <= m_MaximumBin + 1; i++)
+	{
+		m_Powers[i] = (m_Real[i] * m_Real[i]) + (m_Imaginary[i] * m_Imaginary[i]);
+		if (i < m_MinimumBin || i > m_MaximumBin)
+			continue;
+
+		sum += m_Powers[i];
+		if (m_Powers[i] > m_Powers[peak])
+			peak = i;
+	}
+
+	const auto mean = sum / static_cast<float>(m_MaximumBin - m_MinimumBin + 1);
+	if (!(m_Powers[peak] > mean * g_SpectrumPeakRatio))
+	{
+		m_PeakFrequency = 0.0f;
+		return;
+	}
+
+	// The logarithm of a Hann windowed peak is close to a parabola. The logarithm of the power is twice that of the magnitude, which
+	// cancels out in the offset.
+	auto offset = 0.0f;
+	const auto previous = m_Powers[peak - 1];
+	const auto next = m_Powers[peak + 1];
+	if (previous > 0.0f && next > 0.0f)
+	{
+		const auto logPrevious = logf(previous);
+		const auto logNext = logf(next);
+		const auto curvature = (2.0f * logf(m_Powers[peak])) - logPrevious - logNext;
+		if (curvature > 0.0f)
+			offset = clamp(0.5f * (logNext - logPrevious) / curvature, -0.5f, 0.5f);
+	}
+
+	m_PeakFrequency = (static_cast<float>(peak) + offset) * m_BinWidth;
+}
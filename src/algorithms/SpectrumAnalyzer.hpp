@@ -0,0 +1,137 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <stdint.h>
+
+// The number of samples of the FFT window. This must be a power of two. At 1 kHz, a window is 64 ms long and the bins are 15.6 Hz apart.
+constexpr auto g_SpectrumWindowSize = 64;
+constexpr auto g_SpectrumBinCount = (g_SpectrumWindowSize / 2) + 1;
+
+// The number of FFT stages, log2(g_SpectrumWindowSize).
+constexpr auto g_SpectrumStageCount = 6;
+
+// The steps of an analysis: the window, each stage of the FFT and the peak search.
+constexpr auto g_SpectrumStepCount = g_SpectrumStageCount + 2;
+
+// The maximum error of a bin's magnitude relative to the largest magnitude of the spectrum, compared with a double precision DFT of the
+// same window (the measured error is about 2e-7). This is checked by the unit tests (test/test_sensor_filter/).
+constexpr auto g_SpectrumMaximumError = 1e-6f;
+
+// The maximum error of the peak frequency of a single tone relative to the bin width (the measured error is about 0.02).
+constexpr auto g_SpectrumPeakMaximumError = 0.05f;
+
+// A peak is only reported when its power is this many times the average power of the searched bins (about 3 times the magnitude).
+// Otherwise the spectrum is just the broadband noise of the sensor.
+constexpr auto g_SpectrumPeakRatio = 10.0f;
+
+/**
+ * @brief Spectrum analyzer class.
+ * This finds the frequency of the largest peak of a signal using a windowed FFT. The last g_SpectrumWindowSize samples are kept in a ring
+ * buffer and analyzed in g_SpectrumStepCount steps, so the cost of a single FFT is spread over that many samples instead of falling
+ * on a single one. The first step copies the samples using a Hann window (in the bit reversed order), the next ones are the radix-2
+ * stages of the FFT and the last one searches the powers of the bins for the peak. A new analysis starts with the next step after the
+ * previous one completed.
+ *
+ * The frequency of the peak is interpolated in between the bins using the powers of its neighbours (a Gaussian fit, which suits the
+ * shape of a Hann windowed peak), so it's much more precise than the bin spacing.
+ *
+ * Everything is computed in single precision, in place, and nothing is allocated.
+ */
+class SpectrumAnalyzer final
+{
+public:
+	/**
+	 * @brief Construct a new Spectrum Analyzer object.
+	 */
+	SpectrumAnalyzer() = default;
+
+	/**
+	 * @brief Configure the analyzer.
+	 * This restarts the analysis.
+	 *
+	 * @param sampleRate The sample rate in hertz.
+	 * @param minimum The lowest frequency of a peak in hertz.
+	 * @param maximum The highest frequency of a peak in hertz. It's limited to the second to last bin.
+	 */
+	void configure(float sampleRate, float minimum, float maximum);
+
+	/**
+	 * @brief Add a sample to the window.
+	 * This must be called for every sample, even when the analysis is not stepped.
+	 *
+	 * @param sample The sample.
+	 */
+	void addSample(float sample)
+	{
+		m_Samples[m_Head] = sample;
+		m_Head = (m_Head + 1) % g_SpectrumWindowSize;
+	}
+
+	/**
+	 * @brief Take the next step of the analysis.
+	 * The analysis uses the window as it was at the first step.
+	 *
+	 * @return true If the analysis completed with this step. The powers and the peak are updated.
+	 * @return false If the analysis is not complete yet.
+	 */
+	bool step();
+
+	/**
+	 * @brief Get the frequency of the peak of the last analysis.
+	 *
+	 * @return The frequency in hertz. 0 if there was no peak in the searched range.
+	 */
+	[[nodiscard]] float getPeakFrequency() const { return m_PeakFrequency; }
+
+	/**
+	 * @brief Get the power of a bin of the last analysis.
+	 * Only the powers of the searched range (and its neighbours) are computed by the analysis, the others can be computed using
+	 * computePowers().
+	 *
+	 * @param bin The bin index (0 - g_SpectrumBinCount - 1). A bin is sampleRate / g_SpectrumWindowSize hertz wide.
+	 * @return The power, the square of the magnitude. The magnitude of a sine is its amplitude.
+	 */
+	[[nodiscard]] float getPower(uint32_t bin) const { return m_Powers[bin]; }
+
+	/**
+	 * @brief Compute the powers of all the bins of the last analysis.
+	 * This is meant for testing.
+	 */
+	void computePowers();
+
+private:
+	/**
+	 * @brief Copy the samples to the FFT buffer.
+	 * The oldest sample is first, every sample is multiplied by the window and the order is bit reversed.
+	 */
+	void loadWindow();
+
+	/**
+	 * @brief Compute a stage of the FFT.
+	 *
+	 * @param stage The stage index (0 - g_SpectrumStageCount - 1).
+	 */
+	void computeStage(uint32_t stage);
+
+	/**
+	 * @brief Search the powers of the bins for the peak.
+	 */
+	void findPeak();
+
+private:
+	float m_Samples[g_SpectrumWindowSize] = {};
+	uint32_t m_Head = 0;
+
+	float m_Real[g_SpectrumWindowSize] = {};
+	float m_Imaginary[g_SpectrumWindowSize] = {};
+	float m_Powers[g_SpectrumBinCount] = {};
+
+	float m_BinWidth = 0.0f;
+	uint32_t m_MinimumBin = 1;
+	uint32_t m_MaximumBin = g_SpectrumBinCount - 2;
+	uint32_t m_Step = 0;
+
+	float m_PeakFrequency = 0.0f;
+};
\ No newline at end of file
@@ -0,0 +1,116 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+
+// Each benchmark is run a few times before measuring so the caches (and the flash cache on the ESP32) are warm.
+constexpr auto g_BenchmarkWarmupRuns = 100;
+constexpr auto g_BenchmarkSamples = 2000;
+
+/**
+ * @brief Benchmark result structure.
+ * The times are in the unit of the benchmark clock (CPU cycles on the ESP32, nanoseconds on the host).
+ */
+struct BenchmarkResult final
+{
+	const char *m_pName = nullptr;
+	uint32_t m_Samples = 0;
+	uint32_t m_Minimum = 0;
+	uint32_t m_Median = 0;
+	uint32_t m_Percentile99 = 0;
+	uint32_t m_Maximum = 0;
+};
+
+/**
+ * @brief Read the benchmark clock.
+ *
+ * @return The current time in the clock's unit.
+ */
+uint32_t ReadBenchmarkClock();
+
+/**
+ * @brief Get the name of the benchmark clock's unit.
+ *
+ * @return The unit name.
+ */
+const char *GetBenchmarkClockUnit();
+
+/**
+ * @brief Get the name of the platform the benchmarks run on.
+ *
+ * @return The platform name.
+ */
+const char *GetBenchmarkPlatform();
+
+/**
+ * @brief Print a benchmark result.
+ * The result is printed as a single line JSON object, so the output of a run can be compared with a previous one.
+ *
+ * @param result The result to print.
+ */
+void PrintBenchmarkResult(const BenchmarkResult &result);
+
+/**
+ * @brief Measure the overhead of reading the benchmark clock.
+ * This is subtracted from every sample.
+ *
+ * @return The smallest time between two clock reads.
+ */
+inline uint32_t MeasureBenchmarkOverhead()
+{
+	auto overhead = UINT32_MAX;
+	for (uint32_t i = 0; i < g_BenchmarkSamples; i++)
+	{
+		const auto start = ReadBenchmarkClock();
+		const auto end = ReadBenchmarkClock();
+		overhead = std::min(overhead, end - start);
+	}
+
+	return overhead;
+}
+
+/**
+ * @brief Run a benchmark.
+ * Every call of the function is timed on its own, so the result shows the distribution of the call times and not just the average.
+ *
+ * @tparam Function The function type. It takes the iteration index, which can be used to pick an input.
+ * @param pName The name of the benchmark.
+ * @param function The function to benchmark.
+ * @return The benchmark result.
+ */
+template <class Function>
+BenchmarkResult RunBenchmark(const char *pName, Function &&function)
+{
+	static uint32_t s_Samples[g_BenchmarkSamples];
+
+	for (uint32_t i = 0; i < g_BenchmarkWarmupRuns; i++)
+		function(i);
+
+	const auto overhead = MeasureBenchmarkOverhead();
+	for (uint32_t i = 0; i < g_BenchmarkSamples; i++)
+	{
+		const auto start = ReadBenchmarkClock();
+		function(i);
+		const auto elapsed = ReadBenchmarkClock() - start;
+
+		s_Samples[i] = elapsed > overhead ? elapsed - overhead : 0;
+	}
+
+	std::sort(s_Samples, s_Samples + g_BenchmarkSamples);
+
+	BenchmarkResult result;
+	result.m_pName = pName;
+	result.m_Samples = g_BenchmarkSamples;
+	result.m_Minimum = s_Samples[0];
+	result.m_Median = s_Samples[g_BenchmarkSamples / 2];
+	result.m_Percentile99 = s_Samples[(g_BenchmarkSamples * 99) / 100];
+	result.m_Maximum = s_Samples[g_BenchmarkSamples - 1];
+
+	PrintBenchmarkResult(result);
+	return result;
+}
\ No newline at end of file
@@ -0,0 +1,437 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+// Microbenchmarks of the control hot path.
+// Every kernel is run with a fixed, repeating set of inputs and the distribution of the call times is printed as JSON lines. On the ESP32
+// the times are in CPU cycles (esp32-benchmark environment, printed over the serial port) and on the host they are in nanoseconds
+// (native-benchmark environment). Use monitor/benchmark_compare.py to compare two runs.
+
+#include "Benchmark.hpp"
+
+#include "algorithms/AttitudeEstimators.hpp"
+#include "algorithms/BlackboxEncoder.hpp"
+#include "algorithms/IBusParser.hpp"
+#include "algorithms/PacketCodec.hpp"
+#include "algorithms/KalmanFilter.hpp"
+#include "algorithms/MahonyFilter.hpp"
+#include "algorithms/Mixer.hpp"
+#include "algorithms/PID.hpp"
+#include "algorithms/RotorProtocols.hpp"
+#include "algorithms/SensorCalibrator.hpp"
+#include "algorithms/SensorFilter.hpp"
+#include "components/AttitudeSensor.hpp"
+#include "components/DefaultDataLink.hpp"
+#include "components/MPU6050.hpp"
+#include "components/ServoRotorOutput.hpp"
+#include "systems/InputSystem.hpp"
+#include "systems/OutputSystem.hpp"
+#include "systems/Stabilizer.hpp"
+#include "core/Constants.hpp"
+#include "core/FastMath.hpp"
+#include "core/GlobalState.hpp"
+#include "core/Scheduler.hpp"
+
+#include <Arduino.h>
+
+#include <math.h>
+
+#ifdef PEREGRINE_NATIVE
+#include <chrono>
+#include <stdio.h>
+
+#endif
+
+// The inputs repeat every few calls. This must be a power of two.
+constexpr auto g_BenchmarkInputCount = 64;
+
+// The benchmarks write their results here so the compiler can't remove the calls.
+volatile float g_BenchmarkSink = 0.0f;
+
+/**
+ * @brief Memory I2C bus class.
+ * This acts as an MPU6050 which always has one new sample (in the FIFO and in the data registers), so the driver can be benchmarked
+ * without the bus transfer time.
+ */
+class MemoryI2CBus final : public II2CBus
+{
+public:
+	/**
+	 * @brief Set the sample returned by the next reads.
+	 *
+	 * @param sample The raw sample.
+	 */
+	void setSample(const RawIMUSample &sample)
+	{
+		for (uint8_t i = 0; i < 3; i++)
+		{
+			m_Record[i * 2] = static_cast<uint8_t>(static_cast<uint16_t>(sample.m_Accelerometer[i]) >> 8);
+			m_Record[(i * 2) + 1] = static_cast<uint8_t>(sample.m_Accelerometer[i] & 0xFF);
+			m_Record[6 + (i * 2)] = static_cast<uint8_t>(static_cast<uint16_t>(sample.m_Gyroscope[i]) >> 8);
+			m_Record[6 + (i * 2) + 1] = static_cast<uint8_t>(sample.m_Gyroscope[i] & 0xFF);
+		}
+	}
+
+	/**
+	 * @brief On write register method.
+	 * The writes are ignored.
+	 *
+	 * @param address The device address.
+	 * @param reg The register to write to.
+	 * @param value The value to write.
+	 * @return true Always.
+	 */
+	bool onWriteRegister(uint8_t address, uint8_t reg, uint8_t value) override { return true; }
+
+	/**
+	 * @brief On read registers method.
+	 * Read the identity, the FIFO count, the FIFO data or the data registers.
+	 *
+	 * @param address The device address.
+	 * @param reg The first register to read from.
+	 * @param pData The buffer to read the data to.
+	 * @param size The number of bytes to read.
+	 * @return true Always.
+	 */
+	bool onReadRegisters(uint8_t address, uint8_t reg, uint8_t *pData, size_t size) override
+	{
+		memset(pData, 0, size);
+
+		switch (static_cast<MPU6050Register>(reg))
+		{
+		case MPU6050Register::WhoAmI:
+			pData[0] = g_MPU6050Identity;
+			break;
+
+		case MPU6050Register::FIFOCount:
+			pData[1] = g_MPU6050FIFORecordSize;
+			break;
+
+		case MPU6050Register::FIFOReadWrite:
+			memcpy(pData, m_Record, std::min(size, sizeof(m_Record)));
+			break;
+
+		case MPU6050Register::AccelerometerX:
+			memcpy(pData, m_Record, 6);
+			memcpy(pData + 8, m_Record + 6, std::min(size, static_cast<size_t>(g_MPU6050BurstSize)) - 8);
+			break;
+
+		default:
+			break;
+		}
+
+		return true;
+	}
+
+private:
+	uint8_t m_Record[g_MPU6050FIFORecordSize] = {};
+};
+
+/**
+ * @brief Get the benchmark time for the schedulers.
+ *
+ * @return The time in microseconds.
+ */
+uint32_t GetBenchmarkTime()
+{
+	return micros();
+}
+
+static MemoryI2CBus s_Bus;
+static DefaultDataLink s_DataLink;
+static ServoRotorOutput s_RotorOutput;
+static float s_Angles[g_BenchmarkInputCount];
+static float s_Rates[g_BenchmarkInputCount];
+static float s_Throttles[g_BenchmarkInputCount];
+static RawIMUSample s_Samples[g_BenchmarkInputCount];
+static uint8_t s_IBusFrames[g_BenchmarkInputCount][g_IBusFrameSize];
+static uint8_t s_ControlPackets[g_BenchmarkInputCount][g_MaxEncodedPacketSize];
+static size_t s_ControlPacketSizes[g_BenchmarkInputCount];
+
+/**
+ * @brief Generate the benchmark inputs.
+ * The inputs are a slow oscillation with a little bit of noise, so the kernels take their usual branches.
+ */
+void GenerateInputs()
+{
+	uint32_t noise = 12345;
+	for (uint32_t i = 0; i < g_BenchmarkInputCount; i++)
+	{
+		noise = (noise * 1103515245u) + 12345u;
+		const auto jitter = static_cast<float>(static_cast<int32_t>(noise >> 16) % 100) * 0.01f;
+		const auto phase = static_cast<float>(i) * (6.2831853f / g_BenchmarkInputCount);
+
+		s_Angles[i] = (20.0f * sinf(phase)) + jitter;
+		s_Rates[i] = (40.0f * cosf(phase)) + jitter;
+		s_Throttles[i] = 0.5f + (s_Angles[i] * 0.02f);
+
+		// 8 g range (4096 LSB/g) and 500 deg/s range (65.5 LSB/deg/s).
+		s_Samples[i].m_Accelerometer[0] = static_cast<int16_t>(4096.0f * sinf(phase) * 0.3f);
+		s_Samples[i].m_Accelerometer[1] = static_cast<int16_t>(4096.0f * cosf(phase) * 0.3f);
+		s_Samples[i].m_Accelerometer[2] = static_cast<int16_t>(4096.0f * 0.95f);
+		s_Samples[i].m_Gyroscope[0] = static_cast<int16_t>(65.5f * s_Rates[i]);
+		s_Samples[i].m_Gyroscope[1] = static_cast<int16_t>(65.5f * -s_Rates[i]);
+		s_Samples[i].m_Gyroscope[2] = static_cast<int16_t>(65.5f * jitter);
+
+		// The sticks follow the angles (1000 to 2000).
+		uint16_t channels[g_IBusChannelCount];
+		for (uint8_t j = 0; j < g_IBusChannelCount; j++)
+			channels[j] = static_cast<uint16_t>(1500.0f + (s_Angles[(i + j) % g_BenchmarkInputCount] * 20.0f));
+
+		EncodeIBusFrame(channels, s_IBusFrames[i]);
+
+		// The same sticks as a control message of the packet data link.
+		TelemetryHeader header;
+		header.m_ID = TelemetryMessageID::Control;
+		header.m_Sequence = static_cast<uint16_t>(i);
+		header.m_Timestamp = i * 4000;
+
+		ControlMessage message;
+		message.m_Thrust = (channels[0] - 1000.0f) / 1000.0f;
+		message.m_Pitch = (channels[1] - 1500.0f) / 500.0f;
+		message.m_Roll = (channels[2] - 1500.0f) / 500.0f;
+		message.m_Yaw = (channels[3] - 1500.0f) / 500.0f;
+		for (uint8_t j = 0; j < g_ControlChannelCount; j++)
+			message.m_Channels[j] = channels[j];
+
+		s_ControlPacketSizes[i] = EncodePacket(header, &message, sizeof(message), s_ControlPackets[i]);
+	}
+}
+
+/**
+ * @brief Benchmark an attitude sensor with the given estimator.
+ *
+ * @tparam Estimator The attitude estimator type.
+ * @param pName The benchmark name.
+ */
+template <class Estimator>
+void BenchmarkAttitudeSensor(const char *pName)
+{
+	static AttitudeSensor<Estimator> s_Sensor;
+	s_Sensor.initialize(&s_Bus);
+
+	RunBenchmark(pName, [](uint32_t i)
+				 { s_Sensor.processSample(s_Samples[i % g_BenchmarkInputCount], 0.001f); });
+}
+
+/**
+ * @brief Run all the benchmarks.
+ */
+void RunBenchmarks()
+{
+	GenerateInputs();
+
+	// The fast math functions and the library functions they replace, and the square roots of the attitude estimators.
+	RunBenchmark("FastAtan2", [](uint32_t i)
+				 { g_BenchmarkSink = FastAtan2(s_Angles[i % g_BenchmarkInputCount], s_Rates[i % g_BenchmarkInputCount]); });
+
+	RunBenchmark("atan2f", [](uint32_t i)
+				 { g_BenchmarkSink = atan2f(s_Angles[i % g_BenchmarkInputCount], s_Rates[i % g_BenchmarkInputCount]); });
+
+	RunBenchmark("sqrtf", [](uint32_t i)
+				 { g_BenchmarkSink = sqrtf(1.0f + (s_Rates[i % g_BenchmarkInputCount] * s_Rates[i % g_BenchmarkInputCount])); });
+
+	RunBenchmark("1/sqrtf", [](uint32_t i)
+				 { g_BenchmarkSink = 1.0f / sqrtf(1.0f + (s_Rates[i % g_BenchmarkInputCount] * s_Rates[i % g_BenchmarkInputCount])); });
+
+	KalmanFilter filter;
+	RunBenchmark("KalmanFilter::compute", [&filter](uint32_t i)
+				 { g_BenchmarkSink = filter.compute(s_Angles[i % g_BenchmarkInputCount], s_Rates[i % g_BenchmarkInputCount], 0.001f); });
+
+	// The attitude estimators. The Kalman filter is run once per axis and the Mahony filter once for all 3 axes.
+	MahonyFilter attitudeFilter;
+	RunBenchmark("MahonyFilter::update", [&attitudeFilter](uint32_t i)
+				 { attitudeFilter.update(Vec3(s_Angles[i % g_BenchmarkInputCount] * 0.01f, 1.0f, 9.8f), Vec3(s_Rates[i % g_BenchmarkInputCount]), 0.001f); });
+
+	RunBenchmark("MahonyFilter::getEulerAngles", [&attitudeFilter](uint32_t i)
+				 { g_BenchmarkSink = attitudeFilter.getEulerAngles().m_Roll; });
+
+	// All 3 axes in a single call, with the gains of the rate loop which runs on every sample.
+	PID controller(Vec3(g_PitchRateKP, g_YawRateKP, g_RollRateKP), Vec3(g_PitchRateKI, g_YawRateKI, g_RollRateKI), Vec3(g_PitchRateKD, g_YawRateKD, g_RollRateKD));
+	RunBenchmark("PID::calculate", [&controller](uint32_t i)
+				 { g_BenchmarkSink = controller.calculate(Vec3(s_Angles[i % g_BenchmarkInputCount], s_Rates[i % g_BenchmarkInputCount], -s_Angles[i % g_BenchmarkInputCount]), Vec3(), 0.002f).m_Pitch; });
+
+	// A whole frame per call, which is what the UART receive event parses.
+	IBusParser parser;
+	RunBenchmark("IBusParser::parse", [&parser](uint32_t i)
+				 {
+					 for (uint8_t j = 0; j < g_IBusFrameSize; j++)
+					 {
+						 if (parser.parse(s_IBusFrames[i % g_BenchmarkInputCount][j], i * 7000))
+							 g_BenchmarkSink = parser.getFrame().m_Channels[0];
+					 } });
+
+	PacketDecoder decoder;
+	RunBenchmark("PacketDecoder::decode", [&decoder](uint32_t i)
+				 {
+					 const auto index = i % g_BenchmarkInputCount;
+					 for (size_t j = 0; j < s_ControlPacketSizes[index]; j++)
+					 {
+						 if (decoder.decode(s_ControlPackets[index][j]))
+							 g_BenchmarkSink = static_cast<float>(decoder.getMessageSize());
+					 } });
+
+	RunBenchmark("Mix", [](uint32_t i)
+				 { float values[g_MixerOutputCount]; Mix(g_CruiseMixer, 90.0f, Vec3(s_Angles[i % g_BenchmarkInputCount], s_Rates[i % g_BenchmarkInputCount], -s_Angles[i % g_BenchmarkInputCount]), values); g_BenchmarkSink = values[2]; });
+
+	RunBenchmark("BlendMixers", [](uint32_t i)
+				 { g_BenchmarkSink = BlendMixers(g_HoverMixer, g_CruiseMixer, s_Throttles[i % g_BenchmarkInputCount]).m_Offsets[2]; });
+
+	// A frame of both rotors per call, which is what the RMT rotor output sends.
+	RunBenchmark("EncodeRotorPulses/DShot600", [](uint32_t i)
+				 { RotorPulse pulses[g_MaxRotorPulses]; g_BenchmarkSink = static_cast<float>(EncodeRotorPulses(RotorProtocol::DShot600, s_Throttles[i % g_BenchmarkInputCount], pulses) + EncodeRotorPulses(RotorProtocol::DShot600, 1.0f - s_Throttles[i % g_BenchmarkInputCount], pulses) + pulses[3].m_High); });
+
+	RunBenchmark("EncodeRotorPulses/OneShot125", [](uint32_t i)
+				 { RotorPulse pulses[g_MaxRotorPulses]; g_BenchmarkSink = static_cast<float>(EncodeRotorPulses(RotorProtocol::OneShot125, s_Throttles[i % g_BenchmarkInputCount], pulses) + EncodeRotorPulses(RotorProtocol::OneShot125, 1.0f - s_Throttles[i % g_BenchmarkInputCount], pulses) + pulses[0].m_High); });
+
+	// A raw sensor record per call, starting a new block whenever one is full.
+	BlackboxEncoder encoder;
+	RunBenchmark("BlackboxEncoder::encode", [&encoder](uint32_t i)
+				 {
+					 const auto &sample = s_Samples[i % g_BenchmarkInputCount];
+					 BlackboxRecord record;
+					 record.m_Timestamp = i * 1000;
+					 for (uint8_t j = 0; j < 3; j++)
+					 {
+						 record.m_Fields[j] = sample.m_Accelerometer[j];
+						 record.m_Fields[3 + j] = sample.m_Gyroscope[j];
+					 }
+
+					 if (!encoder.encode(record))
+					 {
+						 encoder.reset();
+						 encoder.encode(record);
+					 }
+
+					 g_BenchmarkSink = encoder.getBlock()[20]; });
+
+	MPU6050 sensor;
+	sensor.initialize(&s_Bus);
+	RunBenchmark("MPU6050::readData", [&sensor](uint32_t i)
+				 { IMUSample samples[g_MaxFIFORecordsPerRead]; s_Bus.setSample(s_Samples[i % g_BenchmarkInputCount]); g_BenchmarkSink = static_cast<float>(sensor.readData(samples, g_MaxFIFORecordsPerRead)); });
+
+	// The calibrator gets every sample while the rotors are stopped. The samples are converted once, so only the calibrator is measured.
+	static IMUSample s_ConvertedSamples[g_BenchmarkInputCount];
+	for (uint32_t i = 0; i < g_BenchmarkInputCount; i++)
+		s_ConvertedSamples[i] = sensor.convertSample(s_Samples[i], 0.001f);
+
+	SensorCalibrator calibrator;
+	RunBenchmark("SensorCalibrator::update", [&calibrator](uint32_t i)
+				 { g_BenchmarkSink = calibrator.update(s_ConvertedSamples[i % g_BenchmarkInputCount], 25.0f) ? 1.0f : 0.0f; });
+
+	// The whole filter chain of a sample, including a step of the dynamic notch's spectrum analysis.
+	SensorFilter sensorFilter;
+	RunBenchmark("SensorFilter::apply", [&sensorFilter](uint32_t i)
+				 { g_BenchmarkSink = sensorFilter.apply(s_ConvertedSamples[i % g_BenchmarkInputCount]).m_Rate.m_Y; });
+
+	// Every estimator is benchmarked side by side, regardless of the one selected for the controller.
+	BenchmarkAttitudeSensor<KalmanEstimator>("AttitudeSensor<KalmanEstimator>::processSample");
+	BenchmarkAttitudeSensor<ComplementaryEstimator>("AttitudeSensor<ComplementaryEstimator>::processSample");
+	BenchmarkAttitudeSensor<GyroIntegrationEstimator>("AttitudeSensor<GyroIntegrationEstimator>::processSample");
+	BenchmarkAttitudeSensor<MahonyEstimator>("AttitudeSensor<MahonyEstimator>::processSample");
+
+	// The systems are set up the same way as the controller, except for the data link and the sensor bus.
+	Stabilizer::Instance().initialize(&s_Bus);
+	OutputSystem::Instance().initialize(&s_RotorOutput);
+	InputSystem::Instance().initialize(&s_DataLink);
+
+	RunBenchmark("Stabilizer::update", [](uint32_t i)
+				 { s_Bus.setSample(s_Samples[i % g_BenchmarkInputCount]); Stabilizer::Instance().update(); });
+
+	RunBenchmark("Stabilizer::computeOutputs", [](uint32_t i)
+				 { g_BenchmarkSink = Stabilizer::Instance().computeOutputs(500.0f, s_Angles[i % g_BenchmarkInputCount], 0.0f, 0.0f).m_Pitch; });
+
+	g_RequiredFlyMode = FlyMode::Hover;
+	RunBenchmark("OutputSystem::update/hover", [](uint32_t i)
+				 { OutputSystem::Instance().update(); });
+
+	// The transition takes much longer than the benchmark, so the mixer matrices are blended on every call.
+	g_RequiredFlyMode = FlyMode::Cruise;
+	RunBenchmark("OutputSystem::update/transition", [](uint32_t i)
+				 { OutputSystem::Instance().update(); });
+
+	// Complete the transition back to the hover mode.
+	g_RequiredFlyMode = FlyMode::Hover;
+	delay(g_FlyModeTransitionTime / 1000);
+	OutputSystem::Instance().update();
+
+	// One base tick of the whole pipeline: a sensor sample and the control systems that are due.
+	static Scheduler s_Scheduler(g_SchedulerTickRate, &GetBenchmarkTime);
+	static Scheduler s_SensorScheduler(g_SensorSampleRate, &GetBenchmarkTime);
+	s_SensorScheduler.addTask(&Stabilizer::Instance(), g_SensorUpdateDivider);
+	s_Scheduler.addTask(&InputSystem::Instance(), g_InputUpdateDivider, 1);
+	s_Scheduler.addTask(&OutputSystem::Instance(), g_OutputUpdateDivider);
+
+	RunBenchmark("Pipeline::tick", [](uint32_t i)
+				 { s_Bus.setSample(s_Samples[i % g_BenchmarkInputCount]); s_SensorScheduler.tick(1); s_Scheduler.tick(1); });
+}
+
+#ifdef PEREGRINE_NATIVE
+uint32_t ReadBenchmarkClock()
+{
+	const auto time = std::chrono::steady_clock::now().time_since_epoch();
+	return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(time).count());
+}
+
+const char *GetBenchmarkClockUnit()
+{
+	return "ns";
+}
+
+const char *GetBenchmarkPlatform()
+{
+	return "native";
+}
+
+void PrintBenchmarkResult(const BenchmarkResult &result)
+{
+	printf("{\"platform\":\"%s\",\"name\":\"%s\",\"unit\":\"%s\",\"samples\":%u,\"min\":%u,\"median\":%u,\"p99\":%u,\"max\":%u}\n",
+		   GetBenchmarkPlatform(), result.m_pName, GetBenchmarkClockUnit(), static_cast<unsigned>(result.m_Samples), static_cast<unsigned>(result.m_Minimum),
+		   static_cast<unsigned>(result.m_Median), static_cast<unsigned>(result.m_Percentile99), static_cast<unsigned>(result.m_Maximum));
+}
+
+int main()
+{
+	RunBenchmarks();
+	return 0;
+}
+
+#else
+uint32_t ReadBenchmarkClock()
+{
+	return ESP.getCycleCount();
+}
+
+const char *GetBenchmarkClockUnit()
+{
+	return "cycles";
+}
+
+const char *GetBenchmarkPlatform()
+{
+	return "esp32";
+}
+
+void PrintBenchmarkResult(const BenchmarkResult &result)
+{
+	Serial.printf("{\"platform\":\"%s\",\"name\":\"%s\",\"unit\":\"%s\",\"samples\":%u,\"min\":%u,\"median\":%u,\"p99\":%u,\"max\":%u}\n",
+				  GetBenchmarkPlatform(), result.m_pName, GetBenchmarkClockUnit(), static_cast<unsigned>(result.m_Samples), static_cast<unsigned>(result.m_Minimum),
+				  static_cast<unsigned>(result.m_Median), static_cast<unsigned>(result.m_Percentile99), static_cast<unsigned>(result.m_Maximum));
+}
+
+void setup()
+{
+	Serial.begin(115200);
+
+	// Give the monitor some time to connect.
+	delay(2000);
+	Serial.printf("{\"platform\":\"esp32\",\"cpu_frequency\":%u}\n", static_cast<unsigned>(ESP.getCpuFreqMHz()) * 1000000u);
+
+	RunBenchmarks();
+}
+
+void loop()
+{
+	delay(1000);
+}
+
+#endif
@@ -0,0 +1,183 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "MPU6050.hpp"
+
+#include "algorithms/SensorCalibrator.hpp"
+#include "algorithms/SensorFilter.hpp"
+
+/**
+ * @brief Raw sample observer type.
+ * This is called with every raw sample read from the sensor, before it's fed to the estimator.
+ */
+using RawSampleObserver = void (*)(const RawIMUSample &sample, float deltaTime, uint32_t timestamp);
+
+/**
+ * @brief Attitude sensor class.
+ * This reads the samples from the MPU6050 and feeds them to the attitude estimator. The estimator is a template argument (see
+ * algorithms/AttitudeEstimators.hpp), so the calls are resolved at compile time and only the selected estimator is compiled in.
+ *
+ * The samples are corrected by the sensor calibrator and filtered by the sensor filter (which removes the rotor vibrations) before they
+ * are fed to the estimator. While calibrating, the calibrator also gets the uncorrected and unfiltered samples to measure a new
+ * calibration.
+ *
+ * @tparam Estimator The attitude estimator type.
+ */
+template <class Estimator>
+class AttitudeSensor final
+{
+public:
+	/**
+	 * @brief Construct a new Attitude Sensor object.
+	 */
+	AttitudeSensor() = default;
+
+	/**
+	 * @brief Initialize the sensor.
+	 * The calling task will be notified by the data ready interrupt.
+	 *
+	 * @param pBus The I2C bus the sensor is connected to.
+	 */
+	void initialize(II2CBus *pBus) { m_Sensor.initialize(pBus); }
+
+	/**
+	 * @brief Wait for new data.
+	 *
+	 * @return The number of data ready signals since the last call. This is 0 if the wait timed out.
+	 */
+	[[nodiscard]] uint32_t waitForData() { return m_Sensor.waitForData(); }
+
+	/**
+	 * @brief Set the raw sample observer.
+	 *
+	 * @param observer The observer. nullptr removes it.
+	 */
+	void setObserver(RawSampleObserver observer) { m_Observer = observer; }
+
+	/**
+	 * @brief Start or stop measuring the calibration.
+	 * Stopping drops the samples of the current calibration window.
+	 *
+	 * @param isCalibrating Whether the samples should be measured.
+	 */
+	void setCalibrating(bool isCalibrating)
+	{
+		if (!isCalibrating)
+			m_Calibrator.restart();
+
+		m_isCalibrating = isCalibrating;
+	}
+
+	/**
+	 * @brief Read all the new samples and update the attitude.
+	 */
+	void readData()
+	{
+		IMUSample samples[g_MaxFIFORecordsPerRead];
+		RawIMUSample rawSamples[g_MaxFIFORecordsPerRead];
+
+		size_t count = 0;
+		do
+		{
+			count = m_Sensor.readData(samples, g_MaxFIFORecordsPerRead, m_Observer ? rawSamples : nullptr);
+			for (size_t i = 0; i < count; i++)
+			{
+				if (m_Observer)
+					m_Observer(rawSamples[i], samples[i].m_DeltaTime, m_Sensor.getTimestamp());
+
+				if (m_isCalibrating)
+					m_Calibrator.update(samples[i], m_Sensor.getTemperature());
+
+				m_Estimator.update(m_Filter.apply(m_Calibrator.correct(samples[i])));
+			}
+		} while (count == g_MaxFIFORecordsPerRead);
+	}
+
+	/**
+	 * @brief Process a single raw sample.
+	 * This is what readData() does for every sample read from the sensor. It can also be used to feed samples which were recorded or
+	 * generated elsewhere (the sensor must be initialized to set the ranges).
+	 *
+	 * @param sample The raw sample.
+	 * @param deltaTime The time since the previous sample in seconds.
+	 */
+	void processSample(const RawIMUSample &sample, float deltaTime)
+	{
+		const auto converted = m_Sensor.convertSample(sample, deltaTime);
+		if (m_isCalibrating)
+			m_Calibrator.update(converted, m_Sensor.getTemperature());
+
+		m_Estimator.update(m_Filter.apply(m_Calibrator.correct(converted)));
+	}
+
+	/**
+	 * @brief Get the attitude.
+	 *
+	 * The angles are not clamped to the sensor input range. Only the angle loop clamps the pitch and the roll it uses (see Stabilizer).
+	 *
+	 * @return The pitch, yaw and roll angles in degrees.
+	 */
+	[[nodiscard]] Vec3 getAttitude() const { return m_Estimator.getAttitude(); }
+
+	/**
+	 * @brief Get the rotation rate.
+	 *
+	 * The rates are not clamped to the sensor input range, so the rate loop sees everything the gyroscope measures.
+	 *
+	 * @return The pitch, yaw and roll rates in degrees per second.
+	 */
+	[[nodiscard]] Vec3 getRate() const { return m_Estimator.getRate(); }
+
+	/**
+	 * @brief Get the temperature reading.
+	 *
+	 * @return The temperature reading in celsius.
+	 */
+	[[nodiscard]] float getTemperature() const { return m_Sensor.getTemperature(); }
+
+	/**
+	 * @brief Get the time at which the last sample was read.
+	 *
+	 * @return The timestamp in microseconds.
+	 */
+	[[nodiscard]] uint32_t getTimestamp() const { return m_Sensor.getTimestamp(); }
+
+	/**
+	 * @brief Get the number of times the FIFO overflowed.
+	 *
+	 * @return The overflow count.
+	 */
+	[[nodiscard]] uint32_t getFIFOOverflows() const { return m_Sensor.getFIFOOverflows(); }
+
+	/**
+	 * @brief Get the estimator.
+	 *
+	 * @return The estimator.
+	 */
+	[[nodiscard]] Estimator &getEstimator() { return m_Estimator; }
+
+	/**
+	 * @brief Get the calibrator.
+	 *
+	 * @return The sensor calibrator.
+	 */
+	[[nodiscard]] SensorCalibrator &getCalibrator() { return m_Calibrator; }
+
+	/**
+	 * @brief Get the filter.
+	 *
+	 * @return The sensor filter.
+	 */
+	[[nodiscard]] SensorFilter &getFilter() { return m_Filter; }
+
+private:
+	MPU6050 m_Sensor;
+	Estimator m_Estimator;
+	SensorCalibrator m_Calibrator;
+	SensorFilter m_Filter;
+
+	RawSampleObserver m_Observer = nullptr;
+	bool m_isCalibrating = false;
+};
\ No newline at end of file
@@ -6,29 +6,60 @@
 #include "core/Constants.hpp"
 #include "core/Logging.hpp"
 
+#include <Arduino.h>
+
 void FSi6DataLink::onInitialize()
 {
 	PEREGRINE_PRINTLN("Initializing the FS-i6 data link.");
 
-	m_Connection.begin(Serial2);
+	Serial2.onReceive([this]() { onReceive(); });
+	Serial2.begin(g_IBusBaudRate);
 
 	PEREGRINE_PRINTLN("The FS-i6 data link initialized.");
 }
 
 void FSi6DataLink::onUpdate()
 {
+	// Only map the channels when there's a new frame, or when the receiver was lost.
+	if (!m_FrameBuffer.read(m_Frame))
+	{
+		if (m_Frame.m_Sequence == 0 || micros() - m_Frame.m_Timestamp < g_IBusTimeout)
+			return;
+
+		PEREGRINE_LOG_WARNING("The iBus receiver was lost.");
+		m_Frame = IBusFrame();
+	}
+
 	m_Throttle = readChannel(FSi6InputChannel::Throttle, g_ThrottleInputMinimum, g_ThrottleInputMaximum, g_ThrottleInputMinimum);
-	m_Pitch = readChannel(FSi6InputChannel::Pitch, g_PitchInputMinimum, g_PitchInputMaximum, g_PitchInputMinimum);
-	m_Roll = readChannel(FSi6InputChannel::Roll, g_RollInputMinimum, g_RollInputMaximum, g_RollInputMinimum);
-	m_Yaw = readChannel(FSi6InputChannel::Yaw, g_YawInputMinimum, g_YawInputMaximum, g_YawInputMinimum);
-	
-	g_RequiredFlyMode = readChannelBool(FSi6InputChannel::Aux1, true) ? FlyMode::Cruise : FlyMode::Hover;
-	g_CurrentFlyMode = g_RequiredFlyMode;
+	m_Pitch = readChannel(FSi6InputChannel::Pitch, g_PitchInputMinimum, g_PitchInputMaximum, g_PitchInputMiddle);
+	m_Roll = readChannel(FSi6InputChannel::Roll, g_RollInputMinimum, g_RollInputMaximum, g_RollInputMiddle);
+	m_Yaw = readChannel(FSi6InputChannel::Yaw, g_YawInputMinimum, g_YawInputMaximum, g_YawInputMiddle);
+
+	g_RequiredFlyMode = readChannelBool(FSi6InputChannel::Aux1) ? FlyMode::Cruise : FlyMode::Hover;
+
+	g_ControlMode = readChannelBool(FSi6InputChannel::Aux2) ? ControlMode::Rate : ControlMode::Angle;
+}
+
+void FSi6DataLink::onReceive()
+{
+	// The event is raised shortly after the last byte was received, and the bytes before it arrived back to back, one byte time apart. So
+	// every byte is stamped with its own arrival time and a frame gets the time of its last byte, even when a single event drains more
+	// than one frame.
+	const auto timestamp = micros();
+	auto remaining = static_cast<uint32_t>(Serial2.available());
+	while (remaining > 0)
+	{
+		remaining--;
+
+		const auto byteTimestamp = timestamp - ((remaining * g_IBusBitsPerByte * 1000000) / g_IBusBaudRate);
+		if (m_Parser.parse(static_cast<uint8_t>(Serial2.read()), byteTimestamp))
+			m_FrameBuffer.publish(m_Parser.getFrame());
+	}
 }
 
 int FSi6DataLink::readChannel(FSi6InputChannel channel, int minimum, int maximum, int defaultValue)
 {
-	const auto value = m_Connection.readChannel(static_cast<uint8_t>(channel));
+	const auto value = m_Frame.m_Channels[static_cast<uint8_t>(channel)];
 	if (value < 100)
 		return defaultValue;
 
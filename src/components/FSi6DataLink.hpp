@@ -4,9 +4,10 @@
 #pragma once
 
 #include "core/IDataLink.hpp"
+#include "core/SnapshotBuffer.hpp"
+#include "algorithms/IBusParser.hpp"
 
 #include <cstddef>
-#include <IBusBM.h>
 
 /**
  * @brief FS-i6 input channel enum.
@@ -20,7 +21,7 @@ enum class FSi6InputChannel : uint8_t
 	Yaw = 3,
 
 	Aux1 = 4, // This is used to switch between FlyModes.
-	Aux2 = 5,
+	Aux2 = 5, // This is used to switch between the angle and rate (acro) control modes.
 
 	Thrust = Throttle
 };
@@ -28,10 +29,22 @@ enum class FSi6InputChannel : uint8_t
 constexpr auto g_ChannelMinimum = 1000;
 constexpr auto g_ChannelMaximum = 2000;
 
+constexpr auto g_IBusBaudRate = 115200;
+
+// The bits sent per byte (a start bit, 8 data bits and a stop bit), which sets the time it takes to receive a byte.
+constexpr uint32_t g_IBusBitsPerByte = 10;
+
+// The receiver keeps sending frames (with the fail safe values) when the transmitter is lost. If no frame was received for this long,
+// the receiver itself is lost and the channels fall back to their default values (microseconds).
+constexpr uint32_t g_IBusTimeout = 100000;
+
 /**
  * @brief FS-i6 6 channel radio data link class.
  * This class handles input for the FS-i6 controller using the iBus interface.
  *
+ * The bytes are parsed by the UART receive event as soon as they arrive, and every complete frame is handed over to the input system with
+ * its arrival time. The channels are only mapped when a new frame was received.
+ *
  * This data link uses the RX2 pin (GPIO16).
  */
 class FSi6DataLink final : public IDataLink
@@ -86,10 +99,32 @@ public:
 	 */
 	[[nodiscard]] float onGetYaw() override { return m_Yaw; }
 
+	/**
+	 * @brief On get timestamp method.
+	 * Return the arrival time of the last frame.
+	 *
+	 * @return The timestamp. 0 if no frame was received (or the receiver was lost).
+	 */
+	[[nodiscard]] uint32_t onGetTimestamp() override { return m_Frame.m_Timestamp; }
+
+	/**
+	 * @brief Get the last frame used by the data link.
+	 *
+	 * @return The frame. The sequence number is 0 if no frame was received (or the receiver was lost).
+	 */
+	[[nodiscard]] const IBusFrame &getFrame() const { return m_Frame; }
+
 private:
+	/**
+	 * @brief On receive method.
+	 * This is called by the UART receive event when bytes were received (after the line went idle or the FIFO filled up). It runs on the
+	 * UART event task.
+	 */
+	void onReceive();
+
 	/**
 	 * @brief Read data from the iBus interface.
-	 * This returns the value transmitted by the receiver of a given channel.
+	 * This returns the value transmitted by the receiver of a given channel, in the last frame.
 	 *
 	 * @param channel The channel to read.
 	 * @param minimum The channel's minimum value.
@@ -111,7 +146,9 @@ private:
 	[[nodiscard]] bool readChannelBool(FSi6InputChannel channel, bool defaultValue = false);
 
 private:
-	IBusBM m_Connection;
+	IBusParser m_Parser;
+	SnapshotBuffer<IBusFrame> m_FrameBuffer;
+	IBusFrame m_Frame;
 
 	float m_Throttle = 0;
 	float m_Pitch = 0;
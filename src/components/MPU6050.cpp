@@ -3,117 +3,210 @@
 
 #include "MPU6050.hpp"
 
+#include "core/Configuration.hpp"
 #include "core/Constants.hpp"
-#include "core/Common.hpp"
 #include "core/Logging.hpp"
 
-// 1 Rad/s = 57.2957795 deg/s
-constexpr auto g_RadiansToDegrees = 57.2957795f;
+#include <string.h>
+
+// The sensor's sample period in seconds.
+constexpr auto g_SensorSamplePeriod = 1.0f / g_SensorSampleRate;
+
+// The internal sample rate is 1 kHz when the digital low pass filter is enabled.
+constexpr auto g_SampleRateDivider = (1000 / g_SensorSampleRate) - 1;
+
+TaskHandle_t MPU6050::s_TaskHandle = nullptr;
 
 MPU6050::MPU6050()
 	: m_PreviousTime(micros())
 {
 }
 
-void MPU6050::initialize()
+void MPU6050::initialize(II2CBus *pBus)
 {
 	PEREGRINE_PRINTLN("Initializing the MPU6050 sensor.");
+	m_pBus = pBus;
+
+	// Reset the device and wake it up using the gyroscope's clock which is more stable than the internal oscillator.
+	writeRegister(MPU6050Register::PowerManagement1, g_MPU6050DeviceReset);
+	delay(100);
+	writeRegister(MPU6050Register::PowerManagement1, g_MPU6050ClockPLLGyroscopeX);
 
 #ifdef PEREGRINE_DEBUG
-	// Initialize the module.
-	if (!m_Module.begin())
+	// Validate the device identity.
+	uint8_t identity = 0;
+	if (!readRegisters(MPU6050Register::WhoAmI, &identity, 1) || identity != g_MPU6050Identity)
 	{
 		PEREGRINE_PRINTLN("Failed to find MPU6050 chip!");
 		return;
 	}
-	
-#else
-	// Initialize the module.
-	m_Module.begin();
 
 #endif
 
 	// Setup the initial configuration.
-	m_Module.setAccelerometerRange(MPU6050_RANGE_8_G);
-	m_Module.setGyroRange(MPU6050_RANGE_500_DEG);
-	m_Module.setFilterBandwidth(MPU6050_BAND_21_HZ);
+	writeRegister(MPU6050Register::SampleRateDivider, g_SampleRateDivider);
+	writeRegister(MPU6050Register::Configuration, static_cast<uint8_t>(g_MPU6050FilterBandwidth));
+	writeRegister(MPU6050Register::AccelerometerConfiguration, static_cast<uint8_t>(m_AccelerometerRange) << 3);
+	writeRegister(MPU6050Register::GyroscopeConfiguration, static_cast<uint8_t>(m_GyroscopeRange) << 3);
+
+	m_AccelerometerScale = g_StandardGravity / GetMPU6050AccelerometerSensitivity(m_AccelerometerRange);
+	m_GyroscopeScale = 1.0f / GetMPU6050GyroscopeSensitivity(m_GyroscopeRange);
+
+#ifdef PEREGRINE_MPU6050_FIFO
+	// Only the accelerometer and the gyroscope go to the FIFO, the temperature is read separately at a lower rate.
+	writeRegister(MPU6050Register::FIFOEnable, g_MPU6050FIFOAccelerometerAndGyroscope);
+	resetFIFO();
+
+#endif
+
+	// Setup the data ready interrupt (active high, 50 us pulse) and notify the calling task when it fires.
+	s_TaskHandle = xTaskGetCurrentTaskHandle();
+	writeRegister(MPU6050Register::InterruptPinConfiguration, g_MPU6050InterruptClearOnRead);
+	writeRegister(MPU6050Register::InterruptEnable, g_MPU6050InterruptDataReady);
+
+	pinMode(g_MPU6050InterruptPin, INPUT);
+	attachInterrupt(digitalPinToInterrupt(g_MPU6050InterruptPin), &MPU6050::OnDataReady, RISING);
+
+	readTemperature();
+	m_PreviousTime = micros();
 
 	PEREGRINE_PRINTLN("MPU6050 sensor is initialized.");
 }
 
-void MPU6050::readData()
+uint32_t MPU6050::waitForData()
 {
-	// Get the data from the sensor.
-	sensors_event_t accelerometer;
-	sensors_event_t gyroscope;
-	sensors_event_t temperature;
-	m_Module.getEvent(&accelerometer, &gyroscope, &temperature);
-
-	// Process the data.
-	processGyroscopicData(gyroscope);
-	processAccelerometerData(accelerometer);
-	m_Temperature = temperature.temperature;
-
-	// Clamp the values to the required ranges.
-	m_Accelerometer.m_Pitch = clamp(m_Accelerometer.m_Pitch, static_cast<float>(g_SensorInputMinimum), static_cast<float>(g_SensorInputMaximum));
-	m_Accelerometer.m_Yaw = clamp(m_Accelerometer.m_Yaw, static_cast<float>(g_SensorInputMinimum), static_cast<float>(g_SensorInputMaximum));
-	m_Accelerometer.m_Roll = clamp(m_Accelerometer.m_Roll, static_cast<float>(g_SensorInputMinimum), static_cast<float>(g_SensorInputMaximum));
-
-	m_Gyroscope.m_X = clamp(m_Gyroscope.m_X, static_cast<float>(g_SensorInputMinimum), static_cast<float>(g_SensorInputMaximum));
-	m_Gyroscope.m_Y = clamp(m_Gyroscope.m_Y, static_cast<float>(g_SensorInputMinimum), static_cast<float>(g_SensorInputMaximum));
-	m_Gyroscope.m_Z = clamp(m_Gyroscope.m_Z, static_cast<float>(g_SensorInputMinimum), static_cast<float>(g_SensorInputMaximum));
+	// Time out after a few sample periods so that a disconnected sensor does not block the task forever.
+	return ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(g_SensorTimeout));
 }
 
-void MPU6050::processAccelerometerData(sensors_event_t event)
+size_t MPU6050::readData(IMUSample *pSamples, size_t capacity, RawIMUSample *pRawSamples)
 {
+#ifdef PEREGRINE_MPU6050_FIFO
+	return readFIFO(pSamples, capacity, pRawSamples);
+
+#else
+	return capacity > 0 ? readBurst(pSamples, pRawSamples) : 0;
+
+#endif
+}
+
+IMUSample MPU6050::convertSample(const RawIMUSample &sample, float deltaTime) const
+{
+	IMUSample result;
+	result.m_Acceleration = Vec3(sample.m_Accelerometer[0] * m_AccelerometerScale, sample.m_Accelerometer[1] * m_AccelerometerScale, sample.m_Accelerometer[2] * m_AccelerometerScale);
+	result.m_Rate = Vec3(sample.m_Gyroscope[0] * m_GyroscopeScale, sample.m_Gyroscope[1] * m_GyroscopeScale, sample.m_Gyroscope[2] * m_GyroscopeScale);
+	result.m_DeltaTime = deltaTime;
+	return result;
+}
+
+bool MPU6050::writeRegister(MPU6050Register reg, uint8_t value)
+{
+	return m_pBus->onWriteRegister(g_MPU6050Address, static_cast<uint8_t>(reg), value);
+}
+
+bool MPU6050::readRegisters(MPU6050Register reg, uint8_t *pData, size_t size)
+{
+	return m_pBus->onReadRegisters(g_MPU6050Address, static_cast<uint8_t>(reg), pData, size);
+}
+
+size_t MPU6050::readBurst(IMUSample *pSample, RawIMUSample *pRawSample)
+{
+	uint8_t data[g_MPU6050BurstSize];
+	if (!readRegisters(MPU6050Register::AccelerometerX, data, sizeof(data)))
+		return 0;
+
 	const auto currentTime = micros();
-	const auto deltaTime = currentTime - m_PreviousTime;
+	const auto deltaTime = (currentTime - m_PreviousTime) * 1e-6f;
 	m_PreviousTime = currentTime;
 
-	const auto pitch = atan2(event.acceleration.y, event.acceleration.z) * g_RadiansToDegrees;
-	const auto roll = atan2(-event.acceleration.x, sqrt((event.acceleration.y * event.acceleration.y) + (event.acceleration.z * event.acceleration.z))) * g_RadiansToDegrees;
-	m_Accelerometer.m_Y = event.acceleration.y;
+	// The temperature comes with the burst, but it's only converted at the decimated rate.
+	int16_t temperature = 0;
+	const auto sample = DecodeMPU6050Burst(data, &temperature);
+	*pSample = convertSample(sample, deltaTime);
 
-	// This fixes the transition problem when the accelerometer angle jumps between -180 and 180 degrees
-	if ((pitch < -90 && m_Accelerometer.m_Pitch > 90) || (pitch > 90 && m_Accelerometer.m_Pitch < -90))
-	{
-		m_PitchFilter.setAngle(pitch);
+	if (pRawSample)
+		*pRawSample = sample;
+
+	if (++m_SampleCount % g_TemperatureDecimation == 0)
+		m_Temperature = ConvertMPU6050Temperature(temperature);
 
-		m_ComplementaryAngleY = pitch;
-		m_Accelerometer.m_Pitch = pitch;
-		m_Gyroscope.m_Y = pitch;
+	return 1;
+}
+
+size_t MPU6050::readFIFO(IMUSample *pSamples, size_t capacity, RawIMUSample *pRawSamples)
+{
+	// The count is only read once all the records counted by the previous read are consumed.
+	if (m_PendingRecords == 0)
+	{
+		uint8_t countData[2];
+		if (!readRegisters(MPU6050Register::FIFOCount, countData, sizeof(countData)))
+			return 0;
+
+		// When the FIFO overflows, the oldest bytes are dropped and the records are no longer aligned. So we start over.
+		const auto count = static_cast<uint16_t>(DecodeMPU6050Word(countData));
+		if (count >= g_MPU6050FIFOSize)
+		{
+			m_FIFOOverflows++;
+			resetFIFO();
+			return 0;
+		}
+
+		m_PendingRecords = count / g_MPU6050FIFORecordSize;
+		m_PreviousTime = micros();
 	}
-	else
+
+	auto batch = m_PendingRecords < capacity ? m_PendingRecords : capacity;
+	if (batch > g_MaxFIFORecordsPerRead)
+		batch = g_MaxFIFORecordsPerRead;
+
+	if (batch == 0)
+		return 0;
+
+	uint8_t data[g_MaxFIFORecordsPerRead * g_MPU6050FIFORecordSize];
+	if (!readRegisters(MPU6050Register::FIFOReadWrite, data, batch * g_MPU6050FIFORecordSize))
 	{
-		m_Accelerometer.m_Pitch = m_PitchFilter.compute(pitch, m_Gyroscope.m_Pitch, deltaTime); // Calculate the angle using a Kalman filter
+		m_PendingRecords = 0;
+		return 0;
 	}
 
-	if (abs(m_Accelerometer.m_Roll) > 90)
-		m_Gyroscope.m_Roll = -m_Gyroscope.m_Roll; // Invert rate, so it fits the restricted accelerometer reading
+	m_PendingRecords -= batch;
 
-	m_Accelerometer.m_Roll = m_RollFilter.compute(roll, m_Gyroscope.m_Roll, deltaTime); // Calculate the angle using a Kalman filter
+	// The samples in the FIFO are evenly spaced, so the delta time is the sample period.
+	RawIMUSample samples[g_MaxFIFORecordsPerRead];
+	const auto sampleCount = ParseMPU6050FIFO(data, batch * g_MPU6050FIFORecordSize, samples);
+	for (size_t i = 0; i < sampleCount; i++)
+		pSamples[i] = convertSample(samples[i], g_SensorSamplePeriod);
 
-	const auto gyroXRate = m_Gyroscope.m_X;
-	const auto gyroYRate = m_Gyroscope.m_Y;
+	if (pRawSamples)
+		memcpy(pRawSamples, samples, sampleCount * sizeof(RawIMUSample));
 
-	m_Gyroscope.m_X += m_Gyroscope.m_X * deltaTime; // Calculate gyro angle without any filter
-	m_Gyroscope.m_Y += m_Gyroscope.m_Y * deltaTime;
+	m_SampleCount += sampleCount;
+	if (m_PendingRecords == 0 && m_SampleCount >= g_TemperatureDecimation)
+	{
+		m_SampleCount = 0;
+		readTemperature();
+	}
 
-	m_ComplementaryAngleX = 0.93 * (m_ComplementaryAngleX + gyroXRate * deltaTime) + 0.07 * roll; // Calculate the angle using a Complimentary filter
-	m_ComplementaryAngleY = 0.93 * (m_ComplementaryAngleY + gyroYRate * deltaTime) + 0.07 * pitch;
+	return sampleCount;
+}
 
-	// Reset the gyro angle when it has drifted too much
-	if (m_Gyroscope.m_X < -180 || m_Gyroscope.m_X > 180)
-		m_Gyroscope.m_X = m_Accelerometer.m_Pitch;
+void MPU6050::resetFIFO()
+{
+	writeRegister(MPU6050Register::UserControl, g_MPU6050UserControlFIFOEnable | g_MPU6050UserControlFIFOReset);
+}
 
-	if (m_Gyroscope.m_Y < -180 || m_Gyroscope.m_Y > 180)
-		m_Gyroscope.m_Y = m_Accelerometer.m_Roll;
+void MPU6050::readTemperature()
+{
+	uint8_t data[2];
+	if (readRegisters(MPU6050Register::Temperature, data, sizeof(data)))
+		m_Temperature = ConvertMPU6050Temperature(DecodeMPU6050Word(data));
 }
 
-void MPU6050::processGyroscopicData(sensors_event_t event)
+void IRAM_ATTR MPU6050::OnDataReady()
 {
-	// Convert from rad/s to deg/s
-	m_Gyroscope.m_X = event.gyro.x * g_RadiansToDegrees;
-	m_Gyroscope.m_Y = event.gyro.y * g_RadiansToDegrees;
-	m_Gyroscope.m_Z = event.gyro.z * g_RadiansToDegrees;
+	BaseType_t higherPriorityTaskWoken = pdFALSE;
+	vTaskNotifyGiveFromISR(s_TaskHandle, &higherPriorityTaskWoken);
+
+	if (higherPriorityTaskWoken)
+		portYIELD_FROM_ISR();
 }
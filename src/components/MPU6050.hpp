@@ -4,14 +4,28 @@
 #pragma once
 
 #include "core/Types.hpp"
-#include "algorithms/KalmanFilter.hpp"
+#include "core/II2CBus.hpp"
+#include "MPU6050Registers.hpp"
 
-#include <Adafruit_MPU6050.h>
-#include <Adafruit_Sensor.h>
+#include <Arduino.h>
+
+constexpr auto g_MPU6050InterruptPin = 4;
+
+// The maximum number of FIFO records read in a single I2C transaction (the Wire buffer is 128 bytes).
+constexpr auto g_MaxFIFORecordsPerRead = 10;
+
+// The bandwidth of the sensor's digital low pass filter. The vibrations of the rotors are removed in software (see
+// algorithms/SensorFilter.hpp), so this only has to keep them from aliasing. A wider filter delays the samples less: about 2 ms at 184 Hz
+// compared with 8.3 ms at 21 Hz.
+constexpr auto g_MPU6050FilterBandwidth = MPU6050FilterBandwidth::Band184Hz;
 
 /**
  * @brief MPU6050 driver class.
- * This class sets up the connection to the MPU6050 sensor and contains utility methods to read raw and/ or processed data.
+ * This class sets up the connection to the MPU6050 sensor and reads the raw samples, converted to physical units. The attitude is
+ * estimated by the AttitudeSensor component which uses this driver.
+ *
+ * The driver talks to the sensor's registers directly. New samples are signaled by the INT pin (GPIO4) and are either read in a single
+ * burst, or drained from the on-chip FIFO (when PEREGRINE_MPU6050_FIFO is defined) so that no samples are lost.
  */
 class MPU6050 final
 {
@@ -23,13 +37,41 @@ public:
 
 	/**
 	 * @brief Initialize the sensor.
+	 * The calling task will be notified by the data ready interrupt.
+	 *
+	 * @param pBus The I2C bus the sensor is connected to.
 	 */
-	void initialize();
+	void initialize(II2CBus *pBus);
+
+	/**
+	 * @brief Wait for new data.
+	 * This blocks the calling task until the sensor signals that a new sample is ready.
+	 *
+	 * @return The number of data ready signals since the last call. This is 0 if the wait timed out.
+	 */
+	[[nodiscard]] uint32_t waitForData();
 
 	/**
 	 * @brief Read the sensor data.
+	 * When using the FIFO, at most the given number of samples are read and the rest are left in the FIFO for the next call.
+	 *
+	 * @param pSamples The samples to read to.
+	 * @param capacity The maximum number of samples to read. This must not be greater than g_MaxFIFORecordsPerRead.
+	 * @param pRawSamples The raw samples to read to. This is optional.
+	 * @return The number of samples read.
 	 */
-	void readData();
+	[[nodiscard]] size_t readData(IMUSample *pSamples, size_t capacity, RawIMUSample *pRawSamples = nullptr);
+
+	/**
+	 * @brief Convert a raw sample to physical units.
+	 * This is done by readData() for every sample read from the sensor. It can also be used to convert samples which were recorded or
+	 * generated elsewhere (the sensor must be initialized to set the ranges).
+	 *
+	 * @param sample The raw sample.
+	 * @param deltaTime The time since the previous sample in seconds.
+	 * @return The converted sample.
+	 */
+	[[nodiscard]] IMUSample convertSample(const RawIMUSample &sample, float deltaTime) const;
 
 	/**
 	 * @brief Get the temperature reading.
@@ -39,60 +81,106 @@ public:
 	[[nodiscard]] float getTemperature() const { return m_Temperature; }
 
 	/**
-	 * @brief Get the acceleration data.
+	 * @brief Get the time at which the last sample was read.
 	 *
-	 * @return The 3 component vector with the values in meters per square second.
+	 * @return The timestamp in microseconds.
 	 */
-	[[nodiscard]] Vec3 getAcceleration() const { return m_Accelerometer; }
+	[[nodiscard]] uint32_t getTimestamp() const { return m_PreviousTime; }
 
 	/**
-	 * @brief Get the gyroscope data.
+	 * @brief Get the number of times the FIFO overflowed.
 	 *
-	 * @return The 3 component vector with the values in degrees per second (0 - 180).
+	 * @return The overflow count.
 	 */
-	[[nodiscard]] Vec3 getGyration() const { return m_Gyroscope; }
+	[[nodiscard]] uint32_t getFIFOOverflows() const { return m_FIFOOverflows; }
 
 	/**
 	 * @brief Get the Accelerometer Range object.
 	 *
 	 * @return The range.
 	 */
-	[[nodiscard]] mpu6050_accel_range_t getAccelerometerRange() { return m_Module.getAccelerometerRange(); }
+	[[nodiscard]] MPU6050AccelerometerRange getAccelerometerRange() const { return m_AccelerometerRange; }
 
 	/**
 	 * @brief Get the Gyroscope Range object.
 	 *
 	 * @return The range.
 	 */
-	[[nodiscard]] mpu6050_gyro_range_t getGyroscopeRange() { return m_Module.getGyroRange(); }
+	[[nodiscard]] MPU6050GyroscopeRange getGyroscopeRange() const { return m_GyroscopeRange; }
 
 private:
 	/**
-	 * @brief Process the accelerometer data.
+	 * @brief Write a sensor register.
+	 *
+	 * @param reg The register to write.
+	 * @param value The value to write.
+	 * @return true If the write succeeded.
+	 * @return false If the write failed.
+	 */
+	bool writeRegister(MPU6050Register reg, uint8_t value);
+
+	/**
+	 * @brief Read a burst of sensor registers.
 	 *
-	 * @param event The sensor event.
+	 * @param reg The first register to read.
+	 * @param pData The buffer to read to.
+	 * @param size The number of bytes to read.
+	 * @return true If the read succeeded.
+	 * @return false If the read failed.
 	 */
-	void processAccelerometerData(sensors_event_t event);
+	bool readRegisters(MPU6050Register reg, uint8_t *pData, size_t size);
 
 	/**
-	 * @brief Process the gyroscopic data.
+	 * @brief Read the latest sample using a single burst.
 	 *
-	 * @param event The sensor event.
+	 * @param pSample The sample to read to.
+	 * @param pRawSample The raw sample to read to. This is optional.
+	 * @return The number of samples read (0 or 1).
 	 */
-	void processGyroscopicData(sensors_event_t event);
+	size_t readBurst(IMUSample *pSample, RawIMUSample *pRawSample);
+
+	/**
+	 * @brief Read the complete samples in the FIFO.
+	 *
+	 * @param pSamples The samples to read to.
+	 * @param capacity The maximum number of samples to read.
+	 * @param pRawSamples The raw samples to read to. This is optional.
+	 * @return The number of samples read.
+	 */
+	size_t readFIFO(IMUSample *pSamples, size_t capacity, RawIMUSample *pRawSamples);
+
+	/**
+	 * @brief Reset and re-enable the FIFO.
+	 */
+	void resetFIFO();
+
+	/**
+	 * @brief Read the temperature register.
+	 */
+	void readTemperature();
+
+	/**
+	 * @brief Data ready interrupt service routine.
+	 */
+	static void IRAM_ATTR OnDataReady();
 
 private:
-	Adafruit_MPU6050 m_Module;
+	II2CBus *m_pBus = nullptr;
+
+	float m_Temperature = 0.0f;
 
-	KalmanFilter m_PitchFilter;
-	KalmanFilter m_RollFilter;
+	float m_AccelerometerScale = 0.0f;
+	float m_GyroscopeScale = 0.0f;
 
-	Vec3 m_Accelerometer;
-	Vec3 m_Gyroscope;
-	float m_Temperature;
+	MPU6050AccelerometerRange m_AccelerometerRange = MPU6050AccelerometerRange::Range8G;
+	MPU6050GyroscopeRange m_GyroscopeRange = MPU6050GyroscopeRange::Range500Degrees;
 
 	unsigned long m_PreviousTime = 0;
 
-	float m_ComplementaryAngleX = 0.0f;
-	float m_ComplementaryAngleY = 0.0f;
+	size_t m_PendingRecords = 0;
+
+	uint32_t m_SampleCount = 0;
+	uint32_t m_FIFOOverflows = 0;
+
+	static TaskHandle_t s_TaskHandle;
 };
\ No newline at end of file
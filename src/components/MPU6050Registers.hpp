@@ -0,0 +1,192 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Ref: MPU-6000 and MPU-6050 Register Map and Descriptions, Revision 4.2
+
+constexpr uint8_t g_MPU6050Address = 0x68;
+constexpr uint8_t g_MPU6050Identity = 0x68;
+
+// Accelerometer, temperature and gyroscope registers are laid out one after the other, so one burst reads them all.
+constexpr auto g_MPU6050BurstSize = 14;
+
+// Each FIFO record contains the accelerometer and gyroscope data (without the temperature).
+constexpr auto g_MPU6050FIFORecordSize = 12;
+constexpr auto g_MPU6050FIFOSize = 1024;
+
+/**
+ * @brief MPU6050 register enum.
+ * This contains the addresses of the registers used by the driver.
+ */
+enum class MPU6050Register : uint8_t
+{
+	SampleRateDivider = 0x19,
+	Configuration = 0x1A,
+	GyroscopeConfiguration = 0x1B,
+	AccelerometerConfiguration = 0x1C,
+	FIFOEnable = 0x23,
+	InterruptPinConfiguration = 0x37,
+	InterruptEnable = 0x38,
+	InterruptStatus = 0x3A,
+	AccelerometerX = 0x3B,
+	Temperature = 0x41,
+	GyroscopeX = 0x43,
+	UserControl = 0x6A,
+	PowerManagement1 = 0x6B,
+	FIFOCount = 0x72,
+	FIFOReadWrite = 0x74,
+	WhoAmI = 0x75
+};
+
+// Register bit values.
+constexpr uint8_t g_MPU6050DeviceReset = 0x80;
+constexpr uint8_t g_MPU6050ClockPLLGyroscopeX = 0x01;
+constexpr uint8_t g_MPU6050FIFOAccelerometerAndGyroscope = 0x78;
+constexpr uint8_t g_MPU6050UserControlFIFOEnable = 0x40;
+constexpr uint8_t g_MPU6050UserControlFIFOReset = 0x04;
+constexpr uint8_t g_MPU6050InterruptClearOnRead = 0x10;
+constexpr uint8_t g_MPU6050InterruptDataReady = 0x01;
+
+/**
+ * @brief MPU6050 accelerometer range enum.
+ * The value is the AFS_SEL field of the accelerometer configuration register.
+ */
+enum class MPU6050AccelerometerRange : uint8_t
+{
+	Range2G = 0,
+	Range4G = 1,
+	Range8G = 2,
+	Range16G = 3
+};
+
+/**
+ * @brief MPU6050 gyroscope range enum.
+ * The value is the FS_SEL field of the gyroscope configuration register.
+ */
+enum class MPU6050GyroscopeRange : uint8_t
+{
+	Range250Degrees = 0,
+	Range500Degrees = 1,
+	Range1000Degrees = 2,
+	Range2000Degrees = 3
+};
+
+/**
+ * @brief MPU6050 filter bandwidth enum.
+ * The value is the DLPF_CFG field of the configuration register.
+ */
+enum class MPU6050FilterBandwidth : uint8_t
+{
+	Band260Hz = 0,
+	Band184Hz = 1,
+	Band94Hz = 2,
+	Band44Hz = 3,
+	Band21Hz = 4,
+	Band10Hz = 5,
+	Band5Hz = 6
+};
+
+/**
+ * @brief Raw IMU sample structure.
+ * This contains the raw, signed sensor readings in the sensor's axes.
+ */
+struct RawIMUSample final
+{
+	int16_t m_Accelerometer[3] = {0, 0, 0};
+	int16_t m_Gyroscope[3] = {0, 0, 0};
+};
+
+/**
+ * @brief Decode a big-endian 16 bit register pair.
+ *
+ * @param pData The data pointer (high byte first).
+ * @return The decoded value.
+ */
+inline int16_t DecodeMPU6050Word(const uint8_t *pData)
+{
+	return static_cast<int16_t>((static_cast<uint16_t>(pData[0]) << 8) | pData[1]);
+}
+
+/**
+ * @brief Decode a burst read starting at the accelerometer X register.
+ *
+ * @param pData The burst data (g_MPU6050BurstSize bytes).
+ * @param pTemperature The raw temperature output. This is optional.
+ * @return The raw sample.
+ */
+inline RawIMUSample DecodeMPU6050Burst(const uint8_t *pData, int16_t *pTemperature = nullptr)
+{
+	RawIMUSample sample;
+	for (uint8_t i = 0; i < 3; i++)
+	{
+		sample.m_Accelerometer[i] = DecodeMPU6050Word(pData + (i * 2));
+		sample.m_Gyroscope[i] = DecodeMPU6050Word(pData + 8 + (i * 2));
+	}
+
+	if (pTemperature)
+		*pTemperature = DecodeMPU6050Word(pData + 6);
+
+	return sample;
+}
+
+/**
+ * @brief Parse the data read from the FIFO.
+ * Only complete records are parsed, a trailing partial record is ignored.
+ *
+ * @param pData The FIFO data.
+ * @param size The size of the data in bytes.
+ * @param pSamples The samples to write to. It must have room for size / g_MPU6050FIFORecordSize samples.
+ * @return The number of samples parsed.
+ */
+inline size_t ParseMPU6050FIFO(const uint8_t *pData, size_t size, RawIMUSample *pSamples)
+{
+	const auto count = size / g_MPU6050FIFORecordSize;
+	for (size_t i = 0; i < count; i++)
+	{
+		const auto pRecord = pData + (i * g_MPU6050FIFORecordSize);
+		for (uint8_t j = 0; j < 3; j++)
+		{
+			pSamples[i].m_Accelerometer[j] = DecodeMPU6050Word(pRecord + (j * 2));
+			pSamples[i].m_Gyroscope[j] = DecodeMPU6050Word(pRecord + 6 + (j * 2));
+		}
+	}
+
+	return count;
+}
+
+/**
+ * @brief Get the accelerometer sensitivity.
+ *
+ * @param range The accelerometer range.
+ * @return The sensitivity in LSB per g.
+ */
+constexpr float GetMPU6050AccelerometerSensitivity(MPU6050AccelerometerRange range)
+{
+	return static_cast<float>(16384 >> static_cast<uint8_t>(range));
+}
+
+/**
+ * @brief Get the gyroscope sensitivity.
+ *
+ * @param range The gyroscope range.
+ * @return The sensitivity in LSB per degree per second.
+ */
+constexpr float GetMPU6050GyroscopeSensitivity(MPU6050GyroscopeRange range)
+{
+	return 131.0f / static_cast<float>(1 << static_cast<uint8_t>(range));
+}
+
+/**
+ * @brief Convert the raw temperature reading.
+ *
+ * @param raw The raw temperature.
+ * @return The temperature in celsius.
+ */
+constexpr float ConvertMPU6050Temperature(int16_t raw)
+{
+	return (static_cast<float>(raw) / 340.0f) + 36.53f;
+}
\ No newline at end of file
@@ -0,0 +1,82 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "core/IRecordStorage.hpp"
+
+#include <Preferences.h>
+
+// The namespace of the records in the non-volatile storage, and their keys.
+constexpr auto g_StorageNamespace = "peregrine";
+constexpr auto g_CalibrationKey = "calibration";
+constexpr auto g_ParameterKey = "parameters";
+
+/**
+ * @brief NVS record storage class.
+ * This stores a record in the ESP32's non-volatile storage (the NVS partition of the flash), under a key of a namespace. Reading it only
+ * takes a few milliseconds. The stored records can be removed by erasing the flash.
+ *
+ * @tparam Type The stored type. It must have a RecordCodec.
+ */
+template <class Type>
+class NVSRecordStorage final : public IRecordStorage<Type>
+{
+	using Record = typename RecordCodec<Type>::Record;
+
+public:
+	/**
+	 * @brief Construct a new NVS Record Storage object.
+	 *
+	 * @param pNamespace The namespace of the record.
+	 * @param pKey The key of the record in the namespace.
+	 */
+	explicit NVSRecordStorage(const char *pNamespace, const char *pKey) : m_pNamespace(pNamespace), m_pKey(pKey) {}
+
+	/**
+	 * @brief On load method.
+	 * Read the record.
+	 *
+	 * @param value The value to read to.
+	 * @return true If an intact record of the current version was read.
+	 * @return false If there is no record, or it's damaged or of another version.
+	 */
+	bool onLoad(Type &value) override
+	{
+		// Opening a namespace which doesn't exist fails in the read only mode, which is the case on the first boot.
+		Preferences preferences;
+		if (!preferences.begin(m_pNamespace, true))
+			return false;
+
+		Record record;
+		const auto size = preferences.getBytes(m_pKey, &record, sizeof(record));
+		preferences.end();
+
+		return size == sizeof(record) && RecordCodec<Type>::Decode(record, value);
+	}
+
+	/**
+	 * @brief On save method.
+	 * Replace the record.
+	 *
+	 * @param value The value to store.
+	 * @return true If the record was written.
+	 * @return false If the storage could not be opened or is full.
+	 */
+	bool onSave(const Type &value) override
+	{
+		Preferences preferences;
+		if (!preferences.begin(m_pNamespace, false))
+			return false;
+
+		const auto record = RecordCodec<Type>::Encode(value);
+		const auto size = preferences.putBytes(m_pKey, &record, sizeof(record));
+		preferences.end();
+
+		return size == sizeof(record);
+	}
+
+private:
+	const char *m_pNamespace = nullptr;
+	const char *m_pKey = nullptr;
+};
\ No newline at end of file
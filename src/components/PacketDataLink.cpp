@@ -0,0 +1,142 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#include "PacketDataLink.hpp"
+
+#include "core/Common.hpp"
+#include "core/Constants.hpp"
+#include "core/Logging.hpp"
+
+#include <Arduino.h>
+#include <string.h>
+
+// A sequence number further ahead than this is treated as an old message which arrived late (or a duplicate), and is dropped.
+constexpr uint16_t g_MaximumSequenceGap = 0x8000;
+
+// The jitter is smoothed over this many messages (RFC 3550).
+constexpr auto g_JitterSmoothing = 16.0f;
+
+void PacketDataLink::onInitialize()
+{
+	PEREGRINE_PRINTLN("Initializing the packet data link.");
+
+	m_pTransport->onInitialize([this]() { onReceive(); });
+
+	PEREGRINE_PRINTLN("The packet data link initialized.");
+}
+
+void PacketDataLink::onUpdate()
+{
+	if (micros() - m_PreviousReplyTime >= g_LinkQualityInterval)
+		sendLinkQuality();
+
+	// Only map the setpoints when there's a new message, or when the ground station was lost.
+	if (m_FrameBuffer.read(m_Frame))
+	{
+		m_isLost = false;
+	}
+	else
+	{
+		if (m_isLost || m_Frame.m_Timestamp == 0 || micros() - m_Frame.m_Timestamp < g_PacketLinkTimeout)
+			return;
+
+		PEREGRINE_LOG_WARNING("The ground station was lost.");
+		m_Frame.m_Message = ControlMessage();
+		m_isLost = true;
+	}
+
+	const auto &message = m_Frame.m_Message;
+	m_Throttle = map(clamp(message.m_Thrust, 0.0f, 1.0f), 0.0f, 1.0f, g_ThrottleInputMinimum, g_ThrottleInputMaximum);
+	m_Pitch = map(clamp(message.m_Pitch, -1.0f, 1.0f), -1.0f, 1.0f, g_PitchInputMinimum, g_PitchInputMaximum);
+	m_Roll = map(clamp(message.m_Roll, -1.0f, 1.0f), -1.0f, 1.0f, g_RollInputMinimum, g_RollInputMaximum);
+	m_Yaw = map(clamp(message.m_Yaw, -1.0f, 1.0f), -1.0f, 1.0f, g_YawInputMinimum, g_YawInputMaximum);
+
+	g_RequiredFlyMode = message.m_FlyMode == static_cast<uint8_t>(FlyMode::Cruise) ? FlyMode::Cruise : FlyMode::Hover;
+
+	g_ControlMode = message.m_ControlMode == static_cast<uint8_t>(ControlMode::Rate) ? ControlMode::Rate : ControlMode::Angle;
+}
+
+LinkQuality PacketDataLink::onGetLinkQuality()
+{
+	auto quality = m_Frame.m_Quality;
+	if (m_Frame.m_Timestamp != 0)
+		quality.m_Age = micros() - m_Frame.m_Timestamp;
+
+	return quality;
+}
+
+void PacketDataLink::onReceive()
+{
+	// The callback is raised shortly after the last byte was received, so this is the arrival time of the message.
+	const auto timestamp = micros();
+
+	uint8_t buffer[g_MaxEncodedPacketSize];
+	size_t size = 0;
+	while ((size = m_pTransport->onRead(buffer, sizeof(buffer))) > 0)
+	{
+		for (size_t i = 0; i < size; i++)
+		{
+			if (!m_Decoder.decode(buffer[i]))
+				continue;
+
+			const auto &header = m_Decoder.getHeader();
+			if (header.m_ID != TelemetryMessageID::Control || m_Decoder.getMessageSize() != sizeof(ControlMessage))
+				continue;
+
+			ControlMessage message;
+			memcpy(&message, m_Decoder.getMessage(), sizeof(message));
+			handleControl(header, message, timestamp);
+		}
+	}
+}
+
+void PacketDataLink::handleControl(const TelemetryHeader &header, const ControlMessage &message, uint32_t timestamp)
+{
+	auto &quality = m_ReceivedFrame.m_Quality;
+	if (quality.m_Received > 0)
+	{
+		const auto gap = static_cast<uint16_t>(header.m_Sequence - m_PreviousSequence);
+		if (gap == 0 || gap > g_MaximumSequenceGap)
+			return;
+
+		quality.m_Lost += gap - 1;
+
+		// The difference between the time the messages took, which does not depend on the offset between the clocks.
+		const auto difference = static_cast<int32_t>((timestamp - m_ReceivedFrame.m_Timestamp) - (header.m_Timestamp - quality.m_RemoteTimestamp));
+		m_Jitter += (static_cast<float>(difference < 0 ? -difference : difference) - m_Jitter) / g_JitterSmoothing;
+		quality.m_Jitter = static_cast<uint32_t>(m_Jitter);
+	}
+
+	m_PreviousSequence = header.m_Sequence;
+	quality.m_Received++;
+	quality.m_Errors = m_Decoder.getErrors();
+	quality.m_RemoteTimestamp = header.m_Timestamp;
+
+	m_ReceivedFrame.m_Message = message;
+	m_ReceivedFrame.m_Timestamp = timestamp;
+	m_FrameBuffer.publish(m_ReceivedFrame);
+}
+
+void PacketDataLink::sendLinkQuality()
+{
+	m_PreviousReplyTime = micros();
+
+	const auto quality = onGetLinkQuality();
+	LinkQualityMessage message;
+	message.m_Received = quality.m_Received;
+	message.m_Lost = quality.m_Lost;
+	message.m_Errors = quality.m_Errors;
+	message.m_RemoteTimestamp = quality.m_RemoteTimestamp;
+	message.m_Age = quality.m_Age;
+	message.m_Jitter = quality.m_Jitter;
+
+	TelemetryHeader header;
+	header.m_ID = TelemetryMessageID::LinkQuality;
+	header.m_Sequence = m_Sequence++;
+	header.m_Timestamp = m_PreviousReplyTime;
+
+	// The link is not worth a blocking write, if the transmit buffer is full the next reply has the newer statistics anyway.
+	uint8_t encoded[g_MaxEncodedPacketSize];
+	const auto size = EncodePacket(header, &message, sizeof(message), encoded);
+	m_pTransport->onWrite(encoded, size);
+}
@@ -0,0 +1,165 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "core/IDataLink.hpp"
+#include "core/ITransport.hpp"
+#include "core/SnapshotBuffer.hpp"
+#include "algorithms/PacketCodec.hpp"
+
+// The baud rate of the UART transport. The radio modem must be configured to the same rate.
+constexpr auto g_PacketLinkBaudRate = 460800;
+
+// If no control message was received for this long, the ground station is lost and the setpoints fall back to their default values
+// (microseconds).
+constexpr uint32_t g_PacketLinkTimeout = 100000;
+
+// The link quality is sent back to the ground station at this interval (microseconds).
+constexpr uint32_t g_LinkQualityInterval = 100000;
+
+/**
+ * @brief Control frame structure.
+ * This is a control message, with its arrival time and the link statistics at that time.
+ */
+struct ControlFrame final
+{
+	ControlMessage m_Message;
+	LinkQuality m_Quality;
+
+	// The time at which the message was received in microseconds. 0 if no message was received.
+	uint32_t m_Timestamp = 0;
+};
+
+/**
+ * @brief Packet data link class.
+ * This class receives the control messages of a ground station through a byte transport. The messages use the telemetry frames, so they
+ * are checked with a CRC and carry a sequence number and a timestamp. They can be sent at a higher rate than the iBus frames, contain
+ * the setpoints at full resolution, the mode requests and auxiliary channels.
+ *
+ * The bytes are decoded by the transport receive callback as soon as they arrive, and every control message is handed over to the input
+ * system with its arrival time. The lost messages, the damaged frames and the jitter are counted, and the link quality is sent back to
+ * the ground station, which measures the round trip time.
+ */
+class PacketDataLink final : public IDataLink
+{
+public:
+	/**
+	 * @brief Construct a new Packet Data Link object.
+	 *
+	 * @param pTransport The transport to use.
+	 */
+	explicit PacketDataLink(ITransport *pTransport) : m_pTransport(pTransport) {}
+
+	/**
+	 * @brief On initialize method.
+	 * This method is intended to be used to initialize the data link.
+	 */
+	void onInitialize() override;
+
+	/**
+	 * @brief On update method.
+	 * This method is intended to be used to update the data link and to poll the latest information.
+	 */
+	void onUpdate() override;
+
+	/**
+	 * @brief On get thrust method.
+	 * Return the required thrust.
+	 *
+	 * @return The thrust value.
+	 */
+	[[nodiscard]] float onGetThrust() override { return m_Throttle; }
+
+	/**
+	 * @brief On get pitch method.
+	 * Required pitch value.
+	 *
+	 * @return The pitch value.
+	 */
+	[[nodiscard]] float onGetPitch() override { return m_Pitch; }
+
+	/**
+	 * @brief On get roll method.
+	 * Required roll value.
+	 *
+	 * @return The roll value.
+	 */
+	[[nodiscard]] float onGetRoll() override { return m_Roll; }
+
+	/**
+	 * @brief On get yaw method.
+	 * Return the required yaw value.
+	 *
+	 * @return The yaw value.
+	 */
+	[[nodiscard]] float onGetYaw() override { return m_Yaw; }
+
+	/**
+	 * @brief On get timestamp method.
+	 * Return the arrival time of the last control message.
+	 *
+	 * @return The timestamp. 0 if no message was received (or the ground station was lost).
+	 */
+	[[nodiscard]] uint32_t onGetTimestamp() override { return m_isLost ? 0 : m_Frame.m_Timestamp; }
+
+	/**
+	 * @brief On get link quality method.
+	 * Return the link statistics, up to the last control message.
+	 *
+	 * @return The link quality.
+	 */
+	[[nodiscard]] LinkQuality onGetLinkQuality() override;
+
+	/**
+	 * @brief Get an auxiliary channel of the last control message.
+	 *
+	 * @param index The channel index (less than g_ControlChannelCount).
+	 * @return The channel value.
+	 */
+	[[nodiscard]] uint16_t getChannel(uint8_t index) const { return m_Frame.m_Message.m_Channels[index]; }
+
+private:
+	/**
+	 * @brief On receive method.
+	 * This is called by the transport when bytes were received.
+	 */
+	void onReceive();
+
+	/**
+	 * @brief Handle a decoded control message.
+	 * This updates the link statistics and hands the message over to the control core.
+	 *
+	 * @param header The frame header.
+	 * @param message The message.
+	 * @param timestamp The time at which the message was received in microseconds.
+	 */
+	void handleControl(const TelemetryHeader &header, const ControlMessage &message, uint32_t timestamp);
+
+	/**
+	 * @brief Send the link quality to the ground station.
+	 */
+	void sendLinkQuality();
+
+private:
+	ITransport *m_pTransport = nullptr;
+
+	// The receiving side. This is only accessed by the transport callback.
+	PacketDecoder m_Decoder;
+	ControlFrame m_ReceivedFrame;
+	uint16_t m_PreviousSequence = 0;
+	float m_Jitter = 0.0f;
+
+	SnapshotBuffer<ControlFrame> m_FrameBuffer;
+	ControlFrame m_Frame;
+
+	uint16_t m_Sequence = 0;
+	uint32_t m_PreviousReplyTime = 0;
+
+	float m_Throttle = 0;
+	float m_Pitch = 0;
+	float m_Roll = 0;
+	float m_Yaw = 0;
+
+	bool m_isLost = false;
+};
\ No newline at end of file
@@ -0,0 +1,100 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#include "PartitionBlackboxStorage.hpp"
+
+#include "core/Logging.hpp"
+#include "core/StageProfiler.hpp"
+
+#include <Arduino.h>
+
+/**
+ * @brief Check if a sector of the partition is erased.
+ *
+ * @param pPartition The partition.
+ * @param offset The offset of the sector.
+ * @return true If every byte of the sector is erased.
+ * @return false If a byte was programmed, or the sector could not be read.
+ */
+static bool IsErased(const esp_partition_t *pPartition, size_t offset)
+{
+	uint32_t words[g_FlashPageSize / sizeof(uint32_t)];
+	for (size_t page = 0; page < g_FlashSectorSize; page += sizeof(words))
+	{
+		if (esp_partition_read(pPartition, offset + page, words, sizeof(words)) != ESP_OK)
+			return false;
+
+		for (const auto word : words)
+		{
+			if (word != UINT32_MAX)
+				return false;
+		}
+	}
+
+	return true;
+}
+
+bool PartitionBlackboxStorage::onOpen()
+{
+	m_pPartition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, g_BlackboxPartitionLabel);
+	if (!m_pPartition)
+		return false;
+
+	// The blocks are written one after the other and each of them starts with a header, so a log never contains a whole erased sector.
+	m_Start = 0;
+	while (m_Start < m_pPartition->size && !IsErased(m_pPartition, m_Start))
+		m_Start += g_FlashSectorSize;
+
+	if (m_pPartition->size - m_Start < g_MinBlackboxLogSize)
+	{
+		PEREGRINE_LOG_WARNING("The blackbox partition is full, erasing the old logs.");
+		if (esp_partition_erase_range(m_pPartition, 0, m_pPartition->size) != ESP_OK)
+			return false;
+
+		m_Start = 0;
+	}
+
+	// The sectors after the first erased one are only programmed when the partition was written past this log before.
+	for (auto offset = m_Start; offset < m_pPartition->size; offset += g_FlashSectorSize)
+	{
+		if (!IsErased(m_pPartition, offset) && esp_partition_erase_range(m_pPartition, offset, g_FlashSectorSize) != ESP_OK)
+			return false;
+	}
+
+	m_Offset = m_Start;
+	PEREGRINE_LOG_INFO("Recording the blackbox log at %u KB, %u KB are free.", static_cast<unsigned int>(m_Start / 1024),
+					   static_cast<unsigned int>((m_pPartition->size - m_Start) / 1024));
+	return true;
+}
+
+bool PartitionBlackboxStorage::onWrite(const uint8_t *pData, size_t size)
+{
+	if (m_Offset + size > m_pPartition->size)
+		return false;
+
+	while (size > 0)
+	{
+		const auto pageSize = g_FlashPageSize - (m_Offset % g_FlashPageSize);
+		const auto chunkSize = size < pageSize ? size : pageSize;
+
+		{
+			PEREGRINE_PROFILE_STAGE(ProfileStage::BlackboxWrite);
+			if (esp_partition_write(m_pPartition, m_Offset, pData, chunkSize) != ESP_OK)
+				return false;
+		}
+
+		m_Offset += chunkSize;
+		pData += chunkSize;
+		size -= chunkSize;
+
+		// Let the control loop catch up before the cache is disabled again.
+		vTaskDelay(1);
+	}
+
+	return true;
+}
+
+void PartitionBlackboxStorage::onClose()
+{
+	PEREGRINE_LOG_INFO("The blackbox log ended after %u KB.", static_cast<unsigned int>((m_Offset - m_Start) / 1024));
+}
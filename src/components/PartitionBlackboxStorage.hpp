@@ -0,0 +1,71 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "core/IBlackboxStorage.hpp"
+
+#include <esp_partition.h>
+
+// The label of the blackbox partition in the partition table (partitions.csv).
+constexpr auto g_BlackboxPartitionLabel = "blackbox";
+
+// The flash is erased in sectors and programmed in pages.
+constexpr size_t g_FlashSectorSize = 4096;
+constexpr size_t g_FlashPageSize = 256;
+
+// When less than this is left of the partition (about 6 seconds of flight), the old logs are erased and the new one starts at the beginning.
+constexpr size_t g_MinBlackboxLogSize = 64 * g_FlashSectorSize;
+
+/**
+ * @brief Partition blackbox storage class.
+ * This writes the blackbox logs to a raw data partition of the flash, one after the other. Every log starts at the first erased sector
+ * after the previous ones, so its end is where the erased flash starts, and nothing but the blocks is written while recording.
+ *
+ * While the flash is erased or programmed, the flash cache of both cores is disabled and the control loop stalls, since it runs from the
+ * flash. Erasing a sector takes tens of milliseconds, so the free part of the partition is erased when the log is opened, before the
+ * controller starts. The blocks are programmed from the encoder's block in RAM a page at a time, with a scheduler tick in between, so
+ * the control loop only ever waits for a single page (about 0.5 ms, up to 3 ms).
+ *
+ * The partition can be downloaded using "esptool.py read_flash" at the offset and size of partitions.csv.
+ */
+class PartitionBlackboxStorage final : public IBlackboxStorage
+{
+public:
+	/**
+	 * @brief Construct a new Partition Blackbox Storage object.
+	 */
+	PartitionBlackboxStorage() = default;
+
+	/**
+	 * @brief On open method.
+	 * Find the end of the previous logs and erase the rest of the partition. This can take a few seconds after the partition was full.
+	 *
+	 * @return true If the log was created.
+	 * @return false If there is no blackbox partition, or it could not be erased.
+	 */
+	bool onOpen() override;
+
+	/**
+	 * @brief On write method.
+	 * Program the block, a page at a time.
+	 *
+	 * @param pData The block.
+	 * @param size The size of the block.
+	 * @return true If the block was written.
+	 * @return false If the partition is full or the block could not be programmed.
+	 */
+	bool onWrite(const uint8_t *pData, size_t size) override;
+
+	/**
+	 * @brief On close method.
+	 * The end of the log is where the erased flash starts, so there is nothing to commit. This logs the size of the log.
+	 */
+	void onClose() override;
+
+private:
+	const esp_partition_t *m_pPartition = nullptr;
+
+	size_t m_Start = 0;
+	size_t m_Offset = 0;
+};
\ No newline at end of file
@@ -0,0 +1,54 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#include "RMTRotorOutput.hpp"
+
+/**
+ * @brief Set up an RMT channel for transmission.
+ *
+ * @param channel The channel.
+ * @param pin The output pin.
+ */
+static void SetupChannel(rmt_channel_t channel, uint8_t pin)
+{
+	rmt_config_t config = RMT_DEFAULT_CONFIG_TX(static_cast<gpio_num_t>(pin), channel);
+	config.clk_div = 1;
+	config.tx_config.idle_output_en = true;
+	config.tx_config.idle_level = RMT_IDLE_LEVEL_LOW;
+
+	rmt_config(&config);
+	rmt_driver_install(channel, 0, 0);
+}
+
+void RMTRotorOutput::onInitialize(uint8_t leftPin, uint8_t rightPin)
+{
+	SetupChannel(g_LeftRotorChannel, leftPin);
+	SetupChannel(g_RightRotorChannel, rightPin);
+
+	// The ESCs arm after receiving zero throttle for a while, which the output system keeps sending until the throttle is raised.
+	onWrite(0.0f, 0.0f);
+}
+
+void RMTRotorOutput::onWrite(float left, float right)
+{
+	write(g_LeftRotorChannel, left);
+	write(g_RightRotorChannel, right);
+}
+
+void RMTRotorOutput::write(rmt_channel_t channel, float throttle)
+{
+	RotorPulse pulses[g_MaxRotorPulses];
+	const auto count = EncodeRotorPulses(m_Protocol, throttle, pulses);
+
+	rmt_item32_t items[g_MaxRotorPulses];
+	for (size_t i = 0; i < count; i++)
+	{
+		items[i].level0 = 1;
+		items[i].duration0 = pulses[i].m_High;
+		items[i].level1 = 0;
+		items[i].duration1 = pulses[i].m_Low;
+	}
+
+	// The previous frame is much shorter than the output period, so this does not wait.
+	rmt_write_items(channel, items, static_cast<int>(count), false);
+}
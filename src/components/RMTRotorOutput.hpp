@@ -0,0 +1,76 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "core/Configuration.hpp"
+#include "core/IRotorOutput.hpp"
+#include "algorithms/RotorProtocols.hpp"
+
+#include <driver/rmt.h>
+
+// The protocol selected in the configuration.
+#if defined(PEREGRINE_ROTOR_ONESHOT125)
+constexpr auto g_RotorProtocol = RotorProtocol::OneShot125;
+
+#elif defined(PEREGRINE_ROTOR_DSHOT150)
+constexpr auto g_RotorProtocol = RotorProtocol::DShot150;
+
+#elif defined(PEREGRINE_ROTOR_DSHOT300)
+constexpr auto g_RotorProtocol = RotorProtocol::DShot300;
+
+#else
+constexpr auto g_RotorProtocol = RotorProtocol::DShot600;
+
+#endif
+
+// The RMT channels of the left and the right rotor.
+constexpr auto g_LeftRotorChannel = RMT_CHANNEL_0;
+constexpr auto g_RightRotorChannel = RMT_CHANNEL_1;
+
+/**
+ * @brief RMT rotor output class.
+ * This drives the ESCs with a digital protocol (OneShot125 or DShot), which is generated by the RMT peripheral. A new frame is sent on
+ * every write, so the ESCs follow the output rate instead of the 50 Hz of the servo pulses. The RMT sends the frame on its own, so the
+ * write only encodes it.
+ */
+class RMTRotorOutput final : public IRotorOutput
+{
+public:
+	/**
+	 * @brief Construct a new RMT Rotor Output object.
+	 *
+	 * @param protocol The protocol to use. The ESCs must support it.
+	 */
+	explicit RMTRotorOutput(RotorProtocol protocol) : m_Protocol(protocol) {}
+
+	/**
+	 * @brief On initialize method.
+	 * Set up the RMT channels and stop the rotors.
+	 *
+	 * @param leftPin The pin of the left rotor's ESC.
+	 * @param rightPin The pin of the right rotor's ESC.
+	 */
+	void onInitialize(uint8_t leftPin, uint8_t rightPin) override;
+
+	/**
+	 * @brief On write method.
+	 * Send a frame to each ESC.
+	 *
+	 * @param left The left rotor throttle (0 - 1).
+	 * @param right The right rotor throttle (0 - 1).
+	 */
+	void onWrite(float left, float right) override;
+
+private:
+	/**
+	 * @brief Send a frame on a channel.
+	 *
+	 * @param channel The RMT channel.
+	 * @param throttle The throttle (0 - 1).
+	 */
+	void write(rmt_channel_t channel, float throttle);
+
+private:
+	RotorProtocol m_Protocol = RotorProtocol::DShot600;
+};
\ No newline at end of file
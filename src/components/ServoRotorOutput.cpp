@@ -0,0 +1,41 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ServoRotorOutput.hpp"
+
+/**
+ * @brief Get the pulse width of a throttle.
+ *
+ * @param throttle The throttle (0 - 1).
+ * @return The pulse width in microseconds.
+ */
+static int GetPulseWidth(float throttle)
+{
+	const auto clamped = throttle < 0.0f ? 0.0f : (throttle > 1.0f ? 1.0f : throttle);
+	return g_RotorMinimumPulse + static_cast<int>((clamped * (g_RotorMaximumPulse - g_RotorMinimumPulse)) + 0.5f);
+}
+
+void ServoRotorOutput::onInitialize(uint8_t leftPin, uint8_t rightPin)
+{
+	m_LeftRotor.attach(leftPin, g_RotorMinimumPulse, g_RotorMaximumPulse);
+	m_RightRotor.attach(rightPin, g_RotorMinimumPulse, g_RotorMaximumPulse);
+
+	onWrite(0.0f, 0.0f);
+}
+
+void ServoRotorOutput::onWrite(float left, float right)
+{
+	const auto leftPulse = GetPulseWidth(left);
+	if (leftPulse != m_LeftPulse)
+	{
+		m_LeftRotor.writeMicroseconds(leftPulse);
+		m_LeftPulse = leftPulse;
+	}
+
+	const auto rightPulse = GetPulseWidth(right);
+	if (rightPulse != m_RightPulse)
+	{
+		m_RightRotor.writeMicroseconds(rightPulse);
+		m_RightPulse = rightPulse;
+	}
+}
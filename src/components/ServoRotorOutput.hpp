@@ -0,0 +1,51 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "core/IRotorOutput.hpp"
+
+#include <ESP32Servo.h>
+
+// The ESCs are calibrated to this pulse width range (microseconds).
+constexpr auto g_RotorMinimumPulse = 1000;
+constexpr auto g_RotorMaximumPulse = 2000;
+
+/**
+ * @brief Servo rotor output class.
+ * This drives the ESCs with standard servo pulses (1000 to 2000 us at 50 Hz), which every ESC understands. The pulse width is set in
+ * microseconds, but the ESC only sees a new value every 20 ms.
+ */
+class ServoRotorOutput final : public IRotorOutput
+{
+public:
+	/**
+	 * @brief Construct a new Servo Rotor Output object.
+	 */
+	ServoRotorOutput() = default;
+
+	/**
+	 * @brief On initialize method.
+	 * Attach the servos and stop the rotors.
+	 *
+	 * @param leftPin The pin of the left rotor's ESC.
+	 * @param rightPin The pin of the right rotor's ESC.
+	 */
+	void onInitialize(uint8_t leftPin, uint8_t rightPin) override;
+
+	/**
+	 * @brief On write method.
+	 * Set the pulse widths of the throttles. A pulse width is only written when it changed.
+	 *
+	 * @param left The left rotor throttle (0 - 1).
+	 * @param right The right rotor throttle (0 - 1).
+	 */
+	void onWrite(float left, float right) override;
+
+private:
+	Servo m_LeftRotor;
+	Servo m_RightRotor;
+
+	int m_LeftPulse = 0;
+	int m_RightPulse = 0;
+};
\ No newline at end of file
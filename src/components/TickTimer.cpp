@@ -0,0 +1,41 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#include "TickTimer.hpp"
+
+#include "core/Logging.hpp"
+
+// The APB clock is 80 MHz, this divider gives us a 1 MHz timer clock.
+constexpr auto g_TimerPrescaler = 80;
+constexpr auto g_TimerClockRate = 1000000;
+
+TaskHandle_t TickTimer::s_TaskHandle = nullptr;
+
+void TickTimer::start(uint32_t tickRate, uint8_t timerIndex)
+{
+	PEREGRINE_PRINTLN("Starting the tick timer.");
+
+	s_TaskHandle = xTaskGetCurrentTaskHandle();
+
+	m_pTimer = timerBegin(timerIndex, g_TimerPrescaler, true);
+	timerAttachInterrupt(m_pTimer, &TickTimer::OnTick, true);
+	timerAlarmWrite(m_pTimer, g_TimerClockRate / tickRate, true);
+	timerAlarmEnable(m_pTimer);
+
+	PEREGRINE_PRINTLN("The tick timer is started.");
+}
+
+uint32_t TickTimer::wait()
+{
+	// The notification value counts the ticks given by the interrupt, taking it clears the count.
+	return ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+}
+
+void IRAM_ATTR TickTimer::OnTick()
+{
+	BaseType_t higherPriorityTaskWoken = pdFALSE;
+	vTaskNotifyGiveFromISR(s_TaskHandle, &higherPriorityTaskWoken);
+
+	if (higherPriorityTaskWoken)
+		portYIELD_FROM_ISR();
+}
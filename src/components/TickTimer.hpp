@@ -0,0 +1,48 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * @brief Tick timer class.
+ * This class uses one of the ESP32 hardware timers to generate the scheduler's base tick. The timer interrupt notifies the task which
+ * started the timer, which then blocks in wait() until the next tick arrives.
+ */
+class TickTimer final
+{
+public:
+	/**
+	 * @brief Construct a new Tick Timer object.
+	 */
+	TickTimer() = default;
+
+	/**
+	 * @brief Start the timer.
+	 * The calling task will be the one notified on every tick.
+	 *
+	 * @param tickRate The tick rate in hertz.
+	 * @param timerIndex The hardware timer to use (0 - 3).
+	 */
+	void start(uint32_t tickRate, uint8_t timerIndex = 0);
+
+	/**
+	 * @brief Wait until the next tick.
+	 * This blocks the calling task until the timer interrupt fires.
+	 *
+	 * @return The number of ticks that elapsed since the last call (more than one means ticks were missed).
+	 */
+	[[nodiscard]] uint32_t wait();
+
+private:
+	/**
+	 * @brief Timer interrupt service routine.
+	 */
+	static void IRAM_ATTR OnTick();
+
+private:
+	hw_timer_t *m_pTimer = nullptr;
+
+	static TaskHandle_t s_TaskHandle;
+};
\ No newline at end of file
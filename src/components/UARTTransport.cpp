@@ -0,0 +1,25 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#include "UARTTransport.hpp"
+
+void UARTTransport::onInitialize(TransportReceiveCallback callback)
+{
+	m_Serial.onReceive(callback);
+	m_Serial.begin(m_BaudRate);
+}
+
+size_t UARTTransport::onRead(uint8_t *pData, size_t size)
+{
+	size_t count = 0;
+	while (count < size && m_Serial.available() > 0)
+		pData[count++] = static_cast<uint8_t>(m_Serial.read());
+
+	return count;
+}
+
+size_t UARTTransport::onWrite(const uint8_t *pData, size_t size)
+{
+	const auto available = static_cast<size_t>(m_Serial.availableForWrite());
+	return m_Serial.write(pData, size < available ? size : available);
+}
@@ -0,0 +1,57 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "core/ITransport.hpp"
+
+#include <Arduino.h>
+
+/**
+ * @brief UART transport class.
+ * This class implements the byte transport using a hardware serial port. The received bytes are read in the UART receive event, as soon
+ * as the line goes idle after a frame.
+ */
+class UARTTransport final : public ITransport
+{
+public:
+	/**
+	 * @brief Construct a new UART Transport object.
+	 *
+	 * @param serial The serial port.
+	 * @param baudRate The baud rate. It must match the radio modem on the other side.
+	 */
+	UARTTransport(HardwareSerial &serial, uint32_t baudRate) : m_Serial(serial), m_BaudRate(baudRate) {}
+
+	/**
+	 * @brief On initialize method.
+	 * Open the serial port.
+	 *
+	 * @param callback The callback to call when bytes were received. It runs on the UART event task.
+	 */
+	void onInitialize(TransportReceiveCallback callback) override;
+
+	/**
+	 * @brief On read method.
+	 * Read the bytes in the receive buffer.
+	 *
+	 * @param pData The buffer to read the bytes to.
+	 * @param size The size of the buffer.
+	 * @return The number of bytes read.
+	 */
+	size_t onRead(uint8_t *pData, size_t size) override;
+
+	/**
+	 * @brief On write method.
+	 * Write as many bytes as the transmit buffer can take.
+	 *
+	 * @param pData The bytes to write.
+	 * @param size The number of bytes.
+	 * @return The number of bytes written.
+	 */
+	size_t onWrite(const uint8_t *pData, size_t size) override;
+
+private:
+	HardwareSerial &m_Serial;
+	uint32_t m_BaudRate = 0;
+};
\ No newline at end of file
@@ -0,0 +1,42 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#include "WireI2CBus.hpp"
+
+#include "core/Logging.hpp"
+
+#include <Wire.h>
+
+constexpr auto g_SDAPin = 21;
+constexpr auto g_SCLPin = 22;
+
+void WireI2CBus::initialize(uint32_t clockRate)
+{
+	PEREGRINE_PRINTLN("Initializing the I2C bus.");
+
+	Wire.begin(g_SDAPin, g_SCLPin, clockRate);
+
+	PEREGRINE_PRINTLN("The I2C bus is initialized.");
+}
+
+bool WireI2CBus::onWriteRegister(uint8_t address, uint8_t reg, uint8_t value)
+{
+	Wire.beginTransmission(address);
+	Wire.write(reg);
+	Wire.write(value);
+	return Wire.endTransmission() == 0;
+}
+
+bool WireI2CBus::onReadRegisters(uint8_t address, uint8_t reg, uint8_t *pData, size_t size)
+{
+	// Write the register address and read the data back without releasing the bus.
+	Wire.beginTransmission(address);
+	Wire.write(reg);
+	if (Wire.endTransmission(false) != 0)
+		return false;
+
+	if (Wire.requestFrom(address, size) != size)
+		return false;
+
+	return Wire.readBytes(pData, size) == size;
+}
@@ -0,0 +1,53 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "core/II2CBus.hpp"
+
+/**
+ * @brief Wire I2C bus class.
+ * This class implements the I2C bus interface using the Arduino Wire library.
+ *
+ * This bus uses the SDA (GPIO21) and SCL (GPIO22) pins.
+ */
+class WireI2CBus final : public II2CBus
+{
+public:
+	/**
+	 * @brief Construct a new Wire I2C Bus object.
+	 */
+	WireI2CBus() = default;
+
+	/**
+	 * @brief Initialize the bus.
+	 *
+	 * @param clockRate The bus clock rate in hertz.
+	 */
+	void initialize(uint32_t clockRate);
+
+	/**
+	 * @brief On write register method.
+	 * Write a single byte to a device register.
+	 *
+	 * @param address The device address.
+	 * @param reg The register to write to.
+	 * @param value The value to write.
+	 * @return true If the device acknowledged the write.
+	 * @return false If the transfer failed.
+	 */
+	bool onWriteRegister(uint8_t address, uint8_t reg, uint8_t value) override;
+
+	/**
+	 * @brief On read registers method.
+	 * Read a burst of bytes starting from a device register using a repeated start.
+	 *
+	 * @param address The device address.
+	 * @param reg The first register to read from.
+	 * @param pData The buffer to read the data to.
+	 * @param size The number of bytes to read.
+	 * @return true If all the bytes were read.
+	 * @return false If the transfer failed.
+	 */
+	bool onReadRegisters(uint8_t address, uint8_t reg, uint8_t *pData, size_t size) override;
+};
\ No newline at end of file
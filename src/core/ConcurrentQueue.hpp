@@ -0,0 +1,128 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+// Ref: https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+
+/**
+ * @brief Concurrent queue class.
+ * This is a bounded, lock-free multi-producer, multi-consumer queue. Each slot has a sequence number which tells producers and consumers
+ * whether the slot is free or ready, so pushing and popping never block. When the queue is full, the push fails instead of waiting.
+ *
+ * @tparam Type The element type.
+ * @tparam Size The number of slots. It must be a power of two.
+ */
+template <class Type, size_t Size>
+class ConcurrentQueue final
+{
+	static_assert((Size & (Size - 1)) == 0, "The queue size must be a power of two!");
+
+	/**
+	 * @brief Slot structure.
+	 */
+	struct Slot final
+	{
+		std::atomic<size_t> m_Sequence = {0};
+		Type m_Data = {};
+	};
+
+public:
+	/**
+	 * @brief Construct a new Concurrent Queue object.
+	 */
+	ConcurrentQueue()
+	{
+		for (size_t i = 0; i < Size; i++)
+			m_Slots[i].m_Sequence.store(i, std::memory_order_relaxed);
+	}
+
+	/**
+	 * @brief Push an element to the queue.
+	 *
+	 * @param value The value to push.
+	 * @return true If the value was pushed.
+	 * @return false If the queue is full.
+	 */
+	bool push(const Type &value)
+	{
+		auto position = m_EnqueuePosition.load(std::memory_order_relaxed);
+		Slot *pSlot = nullptr;
+
+		while (true)
+		{
+			pSlot = &m_Slots[position & (Size - 1)];
+			const auto difference = static_cast<intptr_t>(pSlot->m_Sequence.load(std::memory_order_acquire)) - static_cast<intptr_t>(position);
+
+			// The slot is free, try to claim it.
+			if (difference == 0)
+			{
+				if (m_EnqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+					break;
+			}
+
+			// The slot still contains an element that was not popped, so the queue is full.
+			else if (difference < 0)
+			{
+				return false;
+			}
+
+			// Another producer claimed the slot, try again with the latest position.
+			else
+			{
+				position = m_EnqueuePosition.load(std::memory_order_relaxed);
+			}
+		}
+
+		pSlot->m_Data = value;
+		pSlot->m_Sequence.store(position + 1, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 * @brief Pop an element from the queue.
+	 *
+	 * @param value The value to pop to.
+	 * @return true If a value was popped.
+	 * @return false If the queue is empty.
+	 */
+	bool pop(Type &value)
+	{
+		auto position = m_DequeuePosition.load(std::memory_order_relaxed);
+		Slot *pSlot = nullptr;
+
+		while (true)
+		{
+			pSlot = &m_Slots[position & (Size - 1)];
+			const auto difference = static_cast<intptr_t>(pSlot->m_Sequence.load(std::memory_order_acquire)) - static_cast<intptr_t>(position + 1);
+
+			if (difference == 0)
+			{
+				if (m_DequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+					break;
+			}
+			else if (difference < 0)
+			{
+				return false;
+			}
+			else
+			{
+				position = m_DequeuePosition.load(std::memory_order_relaxed);
+			}
+		}
+
+		value = pSlot->m_Data;
+		pSlot->m_Sequence.store(position + Size, std::memory_order_release);
+		return true;
+	}
+
+private:
+	Slot m_Slots[Size];
+
+	std::atomic<size_t> m_EnqueuePosition = {0};
+	std::atomic<size_t> m_DequeuePosition = {0};
+};
\ No newline at end of file
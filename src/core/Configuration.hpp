@@ -7,4 +7,63 @@
 #define PEREGRINE_DATA_LINK_FS_I6
 
 // Uncomment this if you're using the NRF24L01 receiver.
-// #define PEREGRINE_DATA_LINK_NRF24L01
\ No newline at end of file
+// #define PEREGRINE_DATA_LINK_NRF24L01
+
+// Uncomment this (and comment out the FS-i6) to receive packets from a ground station through a serial radio modem (on the RX2 and TX2
+// pins). This supports higher rates and more channels than iBus, and reports the link quality.
+// #define PEREGRINE_DATA_LINK_PACKET
+
+// Comment this out to read only the latest sample in a single burst instead of draining the MPU6050's FIFO. The FIFO makes sure no samples
+// are lost when the sensor task is delayed. Defining PEREGRINE_MPU6050_BURST in the build flags does the same (see the native-burst
+// environment).
+#if !defined(PEREGRINE_MPU6050_BURST)
+#define PEREGRINE_MPU6050_FIFO
+
+#endif
+
+// In the hover mode, a positive (nose up) pitch output tilts the rotors forward, which pitches the nose up when the rotors sit below the
+// center of gravity. Uncomment this if they sit above it, so that they tilt back instead. Check the direction on the bench before the
+// first flight (see docs/Hardware Setup.md).
+// #define PEREGRINE_HOVER_PITCH_REVERSED
+
+// Uncomment this to record the flight at the full loop rate to the blackbox partition of the flash (see systems/BlackboxSystem.hpp). The
+// logs can be converted to CSV files using monitor/blackbox_decoder.py.
+// #define PEREGRINE_BLACKBOX
+
+// The rotors are driven with servo pulses (1000 to 2000 us at 50 Hz) by default, which every ESC understands. Uncomment one of these to use
+// a digital ESC protocol instead, which is generated by the RMT peripheral and sent at the output rate. The ESCs must support it.
+// #define PEREGRINE_ROTOR_ONESHOT125
+// #define PEREGRINE_ROTOR_DSHOT150
+// #define PEREGRINE_ROTOR_DSHOT300
+// #define PEREGRINE_ROTOR_DSHOT600
+
+// The attitude is estimated using the per-axis Kalman filters by default. Uncomment one of these to use a different estimator instead, only
+// the selected estimator is compiled in.
+// The quaternion based Mahony filter fuses all 3 gyroscope axes and also estimates the yaw angle.
+// #define PEREGRINE_ATTITUDE_MAHONY
+// The complementary filter is a cheaper alternative to the Kalman filters, with the same axes as the Mahony filter.
+// #define PEREGRINE_ATTITUDE_COMPLEMENTARY
+// The gyroscope integration only integrates the rates, so it drifts. This is meant for testing.
+// #define PEREGRINE_ATTITUDE_GYRO_INTEGRATION
+
+// The setpoint is interpolated in between the receiver's frames, which delays it by a frame period. Uncomment this to extrapolate the
+// latest change instead, which removes the delay but overshoots a little when the sticks stop.
+// #define PEREGRINE_SETPOINT_PREDICTION
+
+// Binary telemetry is streamed over the serial port in the debug and production test builds.
+#if defined(PEREGRINE_DEBUG) || defined(PEREGRINE_PRODUCTION_TEST)
+#define PEREGRINE_TELEMETRY
+
+#endif
+
+// The control loop stages are timed in the debug and production test builds. The timers are compiled out of the release build.
+#if defined(PEREGRINE_DEBUG) || defined(PEREGRINE_PRODUCTION_TEST)
+#define PEREGRINE_PROFILING
+
+#endif
+
+// The digital ESC protocols use the RMT rotor output.
+#if defined(PEREGRINE_ROTOR_ONESHOT125) || defined(PEREGRINE_ROTOR_DSHOT150) || defined(PEREGRINE_ROTOR_DSHOT300) || defined(PEREGRINE_ROTOR_DSHOT600)
+#define PEREGRINE_ROTOR_RMT
+
+#endif
\ No newline at end of file
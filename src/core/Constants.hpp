@@ -33,6 +33,9 @@ constexpr auto g_YawInputMaximum = g_RollInputMaximum;
 constexpr auto g_ServoOutputMinimum = 0;
 constexpr auto g_ServoOutputMaximum = 180;
 
+// The servos get a 50 Hz PWM signal, so a new angle only takes effect at the start of the next frame.
+constexpr auto g_ServoFramePeriod = 20000; // Microseconds.
+
 constexpr auto g_SensorInputMinimum = -90;
 constexpr auto g_SensorInputMiddle = 0;
 constexpr auto g_SensorInputMaximum = 90;
@@ -45,4 +48,60 @@ constexpr auto g_WingServoOffsetHover = 45;
 constexpr auto g_WingServoOffsetCruise = 135;
 
 constexpr auto g_ElevatorOffset = 90;
-constexpr auto g_RudderOffset = 90;
\ No newline at end of file
+constexpr auto g_RudderOffset = 90;
+
+// A change of the fly mode blends the mixing of the two modes over this time, so the wings tilt over smoothly instead of snapping.
+constexpr auto g_FlyModeTransitionTime = 2000000; // Microseconds.
+
+// The sensor pipeline is driven by the MPU6050's data ready interrupt instead of the base tick.
+// The temperature is only needed for calibration so it's read once every few samples.
+
+constexpr auto g_SensorSampleRate = 1000;
+constexpr auto g_SensorTimeout = 10; // Milliseconds.
+constexpr auto g_TemperatureDecimation = 100;
+
+// 1 g = 9.80665 m/s^2
+constexpr auto g_StandardGravity = 9.80665f;
+
+// The MPU6050 is rated for 400 kHz, but works reliably in fast mode plus (1 MHz) with short wires. This keeps a burst read well under
+// the sample period.
+constexpr auto g_I2CClockRate = 1000000;
+
+// The control loop is driven by a fixed base tick. Each system runs once every "divider" ticks.
+// The sensor is read and the rate loop is closed on every sample (on the sensor core), the angle loop and the outputs run at half of that
+// and the inputs are polled at a rate a little faster than the radio frame rate (~7 ms).
+
+constexpr auto g_SchedulerTickRate = 1000;
+
+constexpr auto g_SensorUpdateDivider = 1;
+constexpr auto g_OutputUpdateDivider = 2;
+constexpr auto g_InputUpdateDivider = 4;
+constexpr auto g_TelemetryUpdateDivider = 4;
+
+// The parameters written by the host are published right after the telemetry frames were handled, in between two output updates.
+constexpr auto g_ParameterUpdateDivider = g_TelemetryUpdateDivider;
+
+// The sensor pipeline runs on the PRO CPU (core 0) while the Arduino loop (control and outputs) runs on the APP CPU (core 1).
+constexpr auto g_SensorCore = 0;
+constexpr auto g_SensorTaskPriority = 2;
+constexpr auto g_SensorTaskStackSize = 4096;
+
+// The blackbox writes to the flash on the sensor core as well, below the sensor task, so it only runs while the sensor task waits for a
+// sample. It wakes up every few milliseconds to encode the queued records.
+constexpr auto g_BlackboxTaskPriority = 1;
+constexpr auto g_BlackboxTaskStackSize = 4096;
+constexpr auto g_BlackboxTaskPeriod = 10; // Milliseconds.
+
+// The time budget of each stage of the control loop in microseconds. The stage profiler counts a stage that takes longer as an overrun.
+// Reading the sensor includes the I2C transfer, and the control tick is everything that runs in a single base tick. The rate control runs
+// after every sensor read, so the two together must fit in the sample period.
+constexpr auto g_InputStageBudget = 100;
+constexpr auto g_SensorReadStageBudget = 400;
+constexpr auto g_StabilizationStageBudget = 100;
+constexpr auto g_OutputWriteStageBudget = 100;
+constexpr auto g_ControlTickStageBudget = 1000000 / g_SchedulerTickRate;
+constexpr auto g_RateControlStageBudget = 50;
+
+// Programming a page of the blackbox log stalls both cores, since the flash cache is disabled. A page takes about 0.5 ms, so a longer one
+// delays the control loop by a whole tick.
+constexpr auto g_BlackboxWriteStageBudget = 1000000 / g_SchedulerTickRate;
\ No newline at end of file
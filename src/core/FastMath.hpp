@@ -0,0 +1,50 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+// The ESP32's FPU only supports single precision, double precision math is emulated in software and is an order of magnitude slower.
+// These functions only use single precision and avoid the library calls in the control hot path. The error bounds are checked against
+// the double precision library functions by the unit tests (test/test_fast_math/). The square roots use sqrtf, which was both faster and
+// more accurate than a Newton-Raphson approximation in the benchmarks.
+
+constexpr auto g_Pi = 3.14159265f;
+constexpr auto g_HalfPi = 1.57079633f;
+
+// 1 Rad/s = 57.2957795 deg/s
+constexpr auto g_RadiansToDegrees = 57.2957795f;
+constexpr auto g_DegreesToRadians = 1.0f / g_RadiansToDegrees;
+
+// The maximum absolute error of FastAtan2() in radians, about 0.001 degrees (the measured error is about 1.2e-5).
+constexpr auto g_FastAtan2MaximumError = 2e-5f;
+
+/**
+ * @brief Compute the angle of a vector.
+ * The arguments are reduced to the first octant and the arc tangent is approximated using an odd polynomial (Abramowitz and Stegun,
+ * 4.4.49). The absolute error is less than g_FastAtan2MaximumError.
+ *
+ * @param y The Y component.
+ * @param x The X component.
+ * @return The angle in radians (-pi to pi). This is 0 if both components are 0.
+ */
+inline float FastAtan2(float y, float x)
+{
+	const auto absoluteX = x < 0.0f ? -x : x;
+	const auto absoluteY = y < 0.0f ? -y : y;
+	const auto maximum = absoluteX > absoluteY ? absoluteX : absoluteY;
+	const auto minimum = absoluteX > absoluteY ? absoluteY : absoluteX;
+	if (maximum == 0.0f)
+		return 0.0f;
+
+	const auto ratio = minimum / maximum;
+	const auto square = ratio * ratio;
+	auto angle = ratio * (0.9998660f + (square * (-0.3302995f + (square * (0.1801410f + (square * (-0.0851330f + (square * 0.0208351f))))))));
+
+	if (absoluteY > absoluteX)
+		angle = g_HalfPi - angle;
+
+	if (x < 0.0f)
+		angle = g_Pi - angle;
+
+	return y < 0.0f ? -angle : angle;
+}
\ No newline at end of file
@@ -4,4 +4,5 @@
 #include "GlobalState.hpp"
 
 FlyMode g_CurrentFlyMode = FlyMode::Hover;
-FlyMode g_RequiredFlyMode = FlyMode::Hover;
\ No newline at end of file
+FlyMode g_RequiredFlyMode = FlyMode::Hover;
+ControlMode g_ControlMode = ControlMode::Angle;
\ No newline at end of file
@@ -18,9 +18,25 @@ enum class FlyMode : uint8_t
 	Cruise
 };
 
+/**
+ * @brief Control mode enum.
+ * This defines what the pitch and roll sticks command. The yaw stick always commands the yaw rate.
+ */
+enum class ControlMode : uint8_t
+{
+	// The sticks command the pitch and roll angles, and the drone levels itself when they are centered.
+	Angle,
+
+	// The sticks command the pitch and roll rates (acro mode), and the drone holds its attitude when they are centered.
+	Rate
+};
+
 // This variable stores the current fly mode.
 extern FlyMode g_CurrentFlyMode;
 
 // This variable stores the required fly mode.
 // A change in the this variable will result in a transition (Hover -> Cruise or Cruise -> Hover).
 extern FlyMode g_RequiredFlyMode;
+
+// This variable stores the control mode.
+extern ControlMode g_ControlMode;
\ No newline at end of file
@@ -0,0 +1,49 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Blackbox storage interface class.
+ * The blackbox system writes the encoded blocks of a log through this interface, so the log can be stored in the flash on the aircraft
+ * or in a plain file on the host.
+ */
+class IBlackboxStorage
+{
+public:
+	/**
+	 * @brief Construct a new IBlackboxStorage object.
+	 */
+	IBlackboxStorage() = default;
+
+	/**
+	 * @brief On open pure virtual method.
+	 * This method should create a new log. It's called once, before the first block is written.
+	 *
+	 * @return true If the log was created.
+	 * @return false If the log could not be created.
+	 */
+	virtual bool onOpen() = 0;
+
+	/**
+	 * @brief On write pure virtual method.
+	 * This method should append a block to the log. It may block for a while, so it's never called from the control loop. It should not
+	 * update anything but the data of the log, so the size of the log is only committed when it's closed.
+	 *
+	 * @param pData The block.
+	 * @param size The size of the block.
+	 * @return true If the block was written.
+	 * @return false If the block could not be written (for example, if the storage is full).
+	 */
+	virtual bool onWrite(const uint8_t *pData, size_t size) = 0;
+
+	/**
+	 * @brief On close pure virtual method.
+	 * This method should commit the size of the log. It's called once, when recording stops. The power may be cut before, so the blocks
+	 * which were written must be readable without it.
+	 */
+	virtual void onClose() = 0;
+};
\ No newline at end of file
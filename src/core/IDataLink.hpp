@@ -4,6 +4,7 @@
 #pragma once
 
 #include "GlobalState.hpp"
+#include "Types.hpp"
 
 /**
  * @brief Data link interface class.
@@ -61,4 +62,21 @@ public:
 	 * @return The yaw value.
 	 */
 	[[nodiscard]] virtual float onGetYaw() = 0;
+
+	/**
+	 * @brief On get timestamp virtual method.
+	 * When this method is called the data link should return the time at which the current inputs were received. The input system only
+	 * reads the inputs when this changes, and interpolates them in between.
+	 *
+	 * @return The timestamp in microseconds. 0 if the inputs are not timestamped, then they are read on every update.
+	 */
+	[[nodiscard]] virtual uint32_t onGetTimestamp() { return 0; }
+
+	/**
+	 * @brief On get link quality virtual method.
+	 * When this method is called the data link should return the statistics of the link, so the link can be monitored and tuned.
+	 *
+	 * @return The link quality. The statistics which the link can not measure are 0.
+	 */
+	[[nodiscard]] virtual LinkQuality onGetLinkQuality() { return LinkQuality(); }
 };
\ No newline at end of file
@@ -0,0 +1,45 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief I2C bus interface class.
+ * Device drivers talk to their devices through this interface, so a driver can run on the real bus or on a fake one on the host.
+ */
+class II2CBus
+{
+public:
+	/**
+	 * @brief Construct a new II2CBus object.
+	 */
+	II2CBus() = default;
+
+	/**
+	 * @brief On write register pure virtual method.
+	 * This method should write a single byte to a device register.
+	 *
+	 * @param address The device address.
+	 * @param reg The register to write to.
+	 * @param value The value to write.
+	 * @return true If the device acknowledged the write.
+	 * @return false If the transfer failed.
+	 */
+	virtual bool onWriteRegister(uint8_t address, uint8_t reg, uint8_t value) = 0;
+
+	/**
+	 * @brief On read registers pure virtual method.
+	 * This method should read a burst of bytes starting from a device register in a single transaction.
+	 *
+	 * @param address The device address.
+	 * @param reg The first register to read from.
+	 * @param pData The buffer to read the data to.
+	 * @param size The number of bytes to read.
+	 * @return true If all the bytes were read.
+	 * @return false If the transfer failed.
+	 */
+	virtual bool onReadRegisters(uint8_t address, uint8_t reg, uint8_t *pData, size_t size) = 0;
+};
\ No newline at end of file
@@ -0,0 +1,59 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "Types.hpp"
+
+/**
+ * @brief Record codec structure.
+ * This is specialized for every type which is stored, next to the record it's stored as. A specialization defines the record type and how
+ * a value is encoded into it and decoded from it:
+ *
+ * using Record = ...;
+ * static Record Encode(const Type &value);
+ * static bool Decode(const Record &record, Type &value);
+ *
+ * @tparam Type The stored type.
+ */
+template <class Type>
+struct RecordCodec;
+
+/**
+ * @brief Record storage interface class.
+ * The controller keeps the values which must survive a reboot (the sensor calibration and the parameters) through this interface, so
+ * they are loaded on the next boot. They are stored in the non-volatile storage on the aircraft and in plain files on the host, as the
+ * record of their RecordCodec, with its version and a checksum.
+ *
+ * @tparam Type The stored type.
+ */
+template <class Type>
+class IRecordStorage
+{
+public:
+	/**
+	 * @brief Construct a new IRecordStorage object.
+	 */
+	IRecordStorage() = default;
+
+	/**
+	 * @brief On load pure virtual method.
+	 * This method should read the stored value. It's called once, while the controller starts.
+	 *
+	 * @param value The value to read to.
+	 * @return true If a valid value was read.
+	 * @return false If nothing is stored, or the stored record is damaged or of an older version.
+	 */
+	virtual bool onLoad(Type &value) = 0;
+
+	/**
+	 * @brief On save pure virtual method.
+	 * This method should replace the stored value. It may block for a few milliseconds, but it's only called while the aircraft is on the
+	 * ground.
+	 *
+	 * @param value The value to store.
+	 * @return true If the value was stored.
+	 * @return false If the value could not be stored.
+	 */
+	virtual bool onSave(const Type &value) = 0;
+};
\ No newline at end of file
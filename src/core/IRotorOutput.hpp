@@ -0,0 +1,38 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @brief Rotor output interface class.
+ * The output system drives the rotors (through their ESCs) using this interface, so the ESC protocol can be changed without changing the
+ * mixing.
+ */
+class IRotorOutput
+{
+public:
+	/**
+	 * @brief Construct a new IRotorOutput object.
+	 */
+	IRotorOutput() = default;
+
+	/**
+	 * @brief On initialize pure virtual method.
+	 * This method should set up the outputs and stop the rotors.
+	 *
+	 * @param leftPin The pin of the left rotor's ESC.
+	 * @param rightPin The pin of the right rotor's ESC.
+	 */
+	virtual void onInitialize(uint8_t leftPin, uint8_t rightPin) = 0;
+
+	/**
+	 * @brief On write pure virtual method.
+	 * This method should send the throttles to the ESCs. It's called at the output rate.
+	 *
+	 * @param left The left rotor throttle (0 - 1).
+	 * @param right The right rotor throttle (0 - 1).
+	 */
+	virtual void onWrite(float left, float right) = 0;
+};
\ No newline at end of file
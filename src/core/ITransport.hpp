@@ -0,0 +1,57 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <functional>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Transport receive callback type.
+ * This is called by the transport when bytes were received.
+ */
+using TransportReceiveCallback = std::function<void()>;
+
+/**
+ * @brief Byte transport interface class.
+ * Packet oriented data links send and receive their frames through this interface, so the same link can run over a UART on the aircraft
+ * or over a socket on the host. The frames are delimited by the data link, so the transport only moves bytes.
+ */
+class ITransport
+{
+public:
+	/**
+	 * @brief Construct a new ITransport object.
+	 */
+	ITransport() = default;
+
+	/**
+	 * @brief On initialize pure virtual method.
+	 * This method should open the transport.
+	 *
+	 * @param callback The callback to call when bytes were received. It may be called from another task, so it should only read the
+	 * transport.
+	 */
+	virtual void onInitialize(TransportReceiveCallback callback) = 0;
+
+	/**
+	 * @brief On read pure virtual method.
+	 * This method should read the received bytes without blocking.
+	 *
+	 * @param pData The buffer to read the bytes to.
+	 * @param size The size of the buffer.
+	 * @return The number of bytes read. 0 if nothing was received.
+	 */
+	virtual size_t onRead(uint8_t *pData, size_t size) = 0;
+
+	/**
+	 * @brief On write pure virtual method.
+	 * This method should queue bytes for transmission without blocking.
+	 *
+	 * @param pData The bytes to write.
+	 * @param size The number of bytes.
+	 * @return The number of bytes written. This is less than the size when the transmit buffer is full.
+	 */
+	virtual size_t onWrite(const uint8_t *pData, size_t size) = 0;
+};
\ No newline at end of file
@@ -11,14 +11,207 @@
  */
 inline void NoOp() {}
 
-#if defined(PEREGRINE_DEBUG) || defined(PEREGRINE_PRODUCTION_TEST)
+/**
+ * @brief Log level enum.
+ * Logs below the compile time level (PEREGRINE_LOG_LEVEL) are compiled out.
+ */
+enum class LogLevel : uint8_t
+{
+	Debug = 0,
+	Info = 1,
+	Warning = 2,
+	Error = 3
+};
+
+/**
+ * @brief Log argument type enum.
+ */
+enum class LogArgumentType : uint8_t
+{
+	Integer,
+	Unsigned,
+	Float,
+	String
+};
+
+/**
+ * @brief Log argument structure.
+ * Arguments are stored raw and are only formatted when the entry is transmitted.
+ */
+struct LogArgument final
+{
+	LogArgumentType m_Type = LogArgumentType::Integer;
+	union
+	{
+		int32_t m_Integer = 0;
+		uint32_t m_Unsigned;
+		float m_Float;
+		const char *m_String;
+	};
+};
+
+// The maximum number of arguments a single log entry can have.
+constexpr auto g_MaxLogArguments = 4;
+
+/**
+ * @brief Log entry structure.
+ * The format string is never copied, its address is the ID of the message. So the format and any string arguments must be string
+ * literals (or have a static lifetime).
+ */
+struct LogEntry final
+{
+	const char *m_pFormat = nullptr;
+	uint32_t m_Timestamp = 0;
+
+	LogArgument m_Arguments[g_MaxLogArguments];
+	uint8_t m_ArgumentCount = 0;
+
+	LogLevel m_Level = LogLevel::Info;
+	bool m_NewLine = true;
+};
+
+inline LogArgument MakeLogArgument(const char *value)
+{
+	LogArgument argument;
+	argument.m_Type = LogArgumentType::String;
+	argument.m_String = value;
+	return argument;
+}
+
+inline LogArgument MakeLogArgument(float value)
+{
+	LogArgument argument;
+	argument.m_Type = LogArgumentType::Float;
+	argument.m_Float = value;
+	return argument;
+}
+
+inline LogArgument MakeLogArgument(double value) { return MakeLogArgument(static_cast<float>(value)); }
+
+inline LogArgument MakeLogArgument(long value)
+{
+	LogArgument argument;
+	argument.m_Type = LogArgumentType::Integer;
+	argument.m_Integer = static_cast<int32_t>(value);
+	return argument;
+}
+
+inline LogArgument MakeLogArgument(unsigned long value)
+{
+	LogArgument argument;
+	argument.m_Type = LogArgumentType::Unsigned;
+	argument.m_Unsigned = static_cast<uint32_t>(value);
+	return argument;
+}
+
+inline LogArgument MakeLogArgument(int value) { return MakeLogArgument(static_cast<long>(value)); }
+inline LogArgument MakeLogArgument(unsigned int value) { return MakeLogArgument(static_cast<unsigned long>(value)); }
+
+/**
+ * @brief Submit a log entry.
+ * This is implemented by the logging system and never blocks. If the log buffer is full the entry is dropped and counted.
+ *
+ * @param entry The entry to submit.
+ */
+void SubmitLogEntry(const LogEntry &entry);
+
+/**
+ * @brief Record a log entry.
+ *
+ * @tparam Arguments The argument types.
+ * @param level The log level.
+ * @param newLine Whether a new line should be added after the entry.
+ * @param pFormat The printf style format string.
+ * @param arguments The arguments.
+ */
+template <class... Arguments>
+inline void RecordLog(LogLevel level, bool newLine, const char *pFormat, Arguments... arguments)
+{
+	static_assert(sizeof...(Arguments) <= g_MaxLogArguments, "Too many log arguments!");
+
+	LogEntry entry;
+	entry.m_pFormat = pFormat;
+	entry.m_Timestamp = micros();
+	entry.m_Level = level;
+	entry.m_NewLine = newLine;
+
+	const LogArgument packed[] = {MakeLogArgument(arguments)..., LogArgument()};
+	for (uint8_t i = 0; i < sizeof...(Arguments); i++)
+		entry.m_Arguments[i] = packed[i];
+
+	entry.m_ArgumentCount = sizeof...(Arguments);
+	SubmitLogEntry(entry);
+}
+
+/**
+ * @brief Record a single value.
+ * This keeps the Serial.print style of the PEREGRINE_PRINT macros.
+ *
+ * @param newLine Whether a new line should be added after the value.
+ */
+inline void RecordPrint(bool newLine) { RecordLog(LogLevel::Info, newLine, ""); }
+inline void RecordPrint(bool newLine, const char *value) { RecordLog(LogLevel::Info, newLine, "%s", value); }
+inline void RecordPrint(bool newLine, float value) { RecordLog(LogLevel::Info, newLine, "%.2f", value); }
+inline void RecordPrint(bool newLine, double value) { RecordLog(LogLevel::Info, newLine, "%.2f", value); }
+inline void RecordPrint(bool newLine, int value) { RecordLog(LogLevel::Info, newLine, "%d", value); }
+inline void RecordPrint(bool newLine, unsigned int value) { RecordLog(LogLevel::Info, newLine, "%u", value); }
+inline void RecordPrint(bool newLine, long value) { RecordLog(LogLevel::Info, newLine, "%d", value); }
+inline void RecordPrint(bool newLine, unsigned long value) { RecordLog(LogLevel::Info, newLine, "%u", value); }
+
+// The compile time log level. Debug builds log everything, production test builds log information and above.
+#ifndef PEREGRINE_LOG_LEVEL
+#if defined(PEREGRINE_DEBUG)
+#define PEREGRINE_LOG_LEVEL 0
+
+#elif defined(PEREGRINE_PRODUCTION_TEST)
+#define PEREGRINE_LOG_LEVEL 1
+
+#else
+#define PEREGRINE_LOG_LEVEL 4
+
+#endif
+#endif
+
+#if PEREGRINE_LOG_LEVEL < 4
 #define PEREGRINE_SETUP_LOGGING(bound) Serial.begin(bound)
-#define PEREGRINE_PRINT(...) Serial.print(__VA_ARGS__)
-#define PEREGRINE_PRINTLN(...) Serial.println(__VA_ARGS__)
 
 #else
 #define PEREGRINE_SETUP_LOGGING(bound) NoOp()
+
+#endif
+
+#if PEREGRINE_LOG_LEVEL <= 0
+#define PEREGRINE_LOG_DEBUG(...) RecordLog(LogLevel::Debug, true, __VA_ARGS__)
+
+#else
+#define PEREGRINE_LOG_DEBUG(...) NoOp()
+
+#endif
+
+#if PEREGRINE_LOG_LEVEL <= 1
+#define PEREGRINE_LOG_INFO(...) RecordLog(LogLevel::Info, true, __VA_ARGS__)
+#define PEREGRINE_PRINT(...) RecordPrint(false, ##__VA_ARGS__)
+#define PEREGRINE_PRINTLN(...) RecordPrint(true, ##__VA_ARGS__)
+
+#else
+#define PEREGRINE_LOG_INFO(...) NoOp()
 #define PEREGRINE_PRINT(...) NoOp()
 #define PEREGRINE_PRINTLN(...) NoOp()
 
+#endif
+
+#if PEREGRINE_LOG_LEVEL <= 2
+#define PEREGRINE_LOG_WARNING(...) RecordLog(LogLevel::Warning, true, __VA_ARGS__)
+
+#else
+#define PEREGRINE_LOG_WARNING(...) NoOp()
+
+#endif
+
+#if PEREGRINE_LOG_LEVEL <= 3
+#define PEREGRINE_LOG_ERROR(...) RecordLog(LogLevel::Error, true, __VA_ARGS__)
+
+#else
+#define PEREGRINE_LOG_ERROR(...) NoOp()
+
 #endif
\ No newline at end of file
@@ -0,0 +1,102 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Ring buffer class.
+ * This is a lock-free single-producer, single-consumer byte ring buffer. Writes never block, if there is not enough room the write is
+ * rejected and the caller decides what to do (usually count a drop).
+ *
+ * @tparam Size The buffer size in bytes. It must be a power of two.
+ */
+template <size_t Size>
+class RingBuffer final
+{
+	static_assert((Size & (Size - 1)) == 0, "The ring buffer size must be a power of two!");
+
+public:
+	/**
+	 * @brief Construct a new Ring Buffer object.
+	 */
+	RingBuffer() = default;
+
+	/**
+	 * @brief Write data to the buffer.
+	 * The data is either written completely, or not at all. This must only be called by the producer.
+	 *
+	 * @param pData The data to write.
+	 * @param size The size of the data.
+	 * @return true If the data was written.
+	 * @return false If there was not enough room.
+	 */
+	bool write(const uint8_t *pData, size_t size)
+	{
+		const auto head = m_Head.load(std::memory_order_relaxed);
+		const auto tail = m_Tail.load(std::memory_order_acquire);
+		if (Size - (head - tail) < size)
+			return false;
+
+		for (size_t i = 0; i < size; i++)
+			m_Data[(head + i) & (Size - 1)] = pData[i];
+
+		m_Head.store(head + size, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 * @brief Peek the contiguous readable region.
+	 * This must only be called by the consumer.
+	 *
+	 * @param ppData The pointer to set to the start of the readable data.
+	 * @return The number of contiguous bytes that can be read.
+	 */
+	size_t peek(const uint8_t **ppData) const
+	{
+		const auto tail = m_Tail.load(std::memory_order_relaxed);
+		const auto head = m_Head.load(std::memory_order_acquire);
+		const auto offset = tail & (Size - 1);
+
+		const auto used = head - tail;
+		const auto contiguous = Size - offset;
+
+		*ppData = m_Data + offset;
+		return used < contiguous ? used : contiguous;
+	}
+
+	/**
+	 * @brief Consume bytes that were peeked.
+	 * This must only be called by the consumer.
+	 *
+	 * @param size The number of bytes to consume.
+	 */
+	void consume(size_t size)
+	{
+		m_Tail.store(m_Tail.load(std::memory_order_relaxed) + size, std::memory_order_release);
+	}
+
+	/**
+	 * @brief Get the number of bytes in the buffer.
+	 *
+	 * @return The used size.
+	 */
+	[[nodiscard]] size_t getUsedSize() const { return m_Head.load(std::memory_order_acquire) - m_Tail.load(std::memory_order_acquire); }
+
+	/**
+	 * @brief Get the number of bytes that can be written.
+	 *
+	 * @return The free size.
+	 */
+	[[nodiscard]] size_t getFreeSize() const { return Size - getUsedSize(); }
+
+private:
+	uint8_t m_Data[Size] = {};
+
+	// The indexes are free running and are wrapped when accessing the data.
+	std::atomic<size_t> m_Head = {0};
+	std::atomic<size_t> m_Tail = {0};
+};
\ No newline at end of file
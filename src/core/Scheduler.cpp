@@ -0,0 +1,103 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Scheduler.hpp"
+
+Scheduler::Scheduler(uint32_t tickRate, ClockFunction clock)
+	: m_Clock(clock), m_TickPeriod(1000000 / tickRate)
+{
+}
+
+bool Scheduler::addTask(ISystem *pSystem, uint32_t divider, uint32_t phase)
+{
+	if (!pSystem || divider == 0 || phase >= divider || m_TaskCount == g_MaxScheduledTasks)
+		return false;
+
+	auto &task = m_Tasks[m_TaskCount++];
+	task.m_pSystem = pSystem;
+	task.m_Divider = divider;
+	task.m_Period = divider * m_TickPeriod;
+	task.m_NextRelease = m_TickCount + phase;
+
+	return true;
+}
+
+void Scheduler::tick(uint32_t pendingTicks)
+{
+	if (pendingTicks == 0)
+		return;
+
+	const auto releaseTime = m_Clock();
+	m_MissedTicks += pendingTicks - 1;
+
+	// The current tick is the last pending one, everything before it was missed.
+	const auto currentTick = m_TickCount + pendingTicks - 1;
+	m_TickCount += pendingTicks;
+
+	for (uint8_t i = 0; i < m_TaskCount; i++)
+	{
+		auto &task = m_Tasks[i];
+
+		// Signed difference so that the tick counter can wrap around.
+		if (static_cast<int32_t>(currentTick - task.m_NextRelease) < 0)
+			continue;
+
+		// Move the next release past the current tick, counting the releases we could not service.
+		task.m_NextRelease += task.m_Divider;
+		while (static_cast<int32_t>(currentTick - task.m_NextRelease) >= 0)
+		{
+			task.m_NextRelease += task.m_Divider;
+			task.m_Statistics.m_SkippedReleases++;
+		}
+
+		runTask(task, releaseTime);
+	}
+
+	if (m_pIdleTask)
+		m_pIdleTask->update();
+}
+
+void Scheduler::resetStatistics()
+{
+	for (uint8_t i = 0; i < m_TaskCount; i++)
+	{
+		m_Tasks[i].m_Statistics = TaskStatistics();
+		m_Tasks[i].m_HasStarted = false;
+	}
+
+	m_MissedTicks = 0;
+}
+
+void Scheduler::runTask(Task &task, uint32_t releaseTime)
+{
+	const auto startTime = m_Clock();
+	task.m_pSystem->update();
+	const auto endTime = m_Clock();
+
+	auto &statistics = task.m_Statistics;
+	statistics.m_Runs++;
+
+	// A task overruns when it does not complete before its next release.
+	statistics.m_LastExecutionTime = endTime - startTime;
+	if (statistics.m_LastExecutionTime > statistics.m_MaxExecutionTime)
+		statistics.m_MaxExecutionTime = statistics.m_LastExecutionTime;
+
+	if (endTime - releaseTime > task.m_Period)
+		statistics.m_Overruns++;
+
+	// Measure the jitter using the time between two consecutive starts.
+	if (task.m_HasStarted)
+	{
+		const auto jitter = static_cast<int32_t>(startTime - task.m_PreviousStart) - static_cast<int32_t>(task.m_Period);
+		if (jitter < statistics.m_MinJitter)
+			statistics.m_MinJitter = jitter;
+
+		if (jitter > statistics.m_MaxJitter)
+			statistics.m_MaxJitter = jitter;
+
+		statistics.m_AbsoluteJitterSum += jitter < 0 ? -jitter : jitter;
+	}
+
+	task.m_PreviousStart = startTime;
+	task.m_HasStarted = true;
+}
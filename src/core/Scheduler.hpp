@@ -0,0 +1,162 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "System.hpp"
+
+#include <stdint.h>
+
+// The maximum number of systems a single scheduler can run.
+constexpr auto g_MaxScheduledTasks = 8;
+
+/**
+ * @brief Task statistics structure.
+ * This contains the timing information of a single scheduled task. All the times are in microseconds.
+ */
+struct TaskStatistics final
+{
+	uint32_t m_Runs = 0;
+	uint32_t m_Overruns = 0;
+	uint32_t m_SkippedReleases = 0;
+
+	uint32_t m_LastExecutionTime = 0;
+	uint32_t m_MaxExecutionTime = 0;
+
+	// Jitter is the difference between the measured period and the nominal period of the task.
+	int32_t m_MinJitter = 0;
+	int32_t m_MaxJitter = 0;
+	uint32_t m_AbsoluteJitterSum = 0;
+};
+
+/**
+ * @brief Scheduler class.
+ * The scheduler runs a set of systems at fixed rates. It is driven by a base tick (usually a hardware timer) and every task runs once
+ * every `divider` ticks. The scheduler itself does not depend on any hardware, time is provided by the clock function so it can be
+ * driven by a virtual clock as well.
+ */
+class Scheduler final
+{
+public:
+	/**
+	 * @brief Clock function type.
+	 * The clock function must return a monotonic timestamp in microseconds.
+	 */
+	using ClockFunction = uint32_t (*)();
+
+	/**
+	 * @brief Construct a new Scheduler object.
+	 *
+	 * @param tickRate The base tick rate in hertz.
+	 * @param clock The clock function used to measure time.
+	 */
+	explicit Scheduler(uint32_t tickRate, ClockFunction clock);
+
+	/**
+	 * @brief Add a task to the scheduler.
+	 * The task will be run at tickRate / divider hertz. The phase can be used to spread tasks with the same divider across ticks.
+	 *
+	 * @param pSystem The system to update.
+	 * @param divider The rate divider (1 runs the system on every tick).
+	 * @param phase The tick offset of the first release. It must be less than the divider.
+	 * @return true If the task was added.
+	 * @return false If the task table is full or the arguments are invalid.
+	 */
+	bool addTask(ISystem *pSystem, uint32_t divider, uint32_t phase = 0);
+
+	/**
+	 * @brief Set the idle task.
+	 * The idle task runs after all the due tasks of every tick. It's meant for low priority work, which must bound the time it takes.
+	 *
+	 * @param pSystem The system to update.
+	 */
+	void setIdleTask(ISystem *pSystem) { m_pIdleTask = pSystem; }
+
+	/**
+	 * @brief Tick the scheduler.
+	 * This runs all the tasks which were released since the last tick. If more than one tick is pending (because the previous tick took
+	 * too long), the missed ticks are counted and every task runs at most once to catch up.
+	 *
+	 * @param pendingTicks The number of base ticks that elapsed since the last call.
+	 */
+	void tick(uint32_t pendingTicks = 1);
+
+	/**
+	 * @brief Reset all the statistics.
+	 */
+	void resetStatistics();
+
+	/**
+	 * @brief Get the task statistics.
+	 *
+	 * @param index The task index (in the order of addition).
+	 * @return The statistics.
+	 */
+	[[nodiscard]] const TaskStatistics &getStatistics(uint8_t index) const { return m_Tasks[index].m_Statistics; }
+
+	/**
+	 * @brief Get the number of tasks.
+	 *
+	 * @return The task count.
+	 */
+	[[nodiscard]] uint8_t getTaskCount() const { return m_TaskCount; }
+
+	/**
+	 * @brief Get the number of base ticks processed.
+	 *
+	 * @return The tick count.
+	 */
+	[[nodiscard]] uint32_t getTickCount() const { return m_TickCount; }
+
+	/**
+	 * @brief Get the number of base ticks that were missed because the scheduler was busy.
+	 *
+	 * @return The missed tick count.
+	 */
+	[[nodiscard]] uint32_t getMissedTicks() const { return m_MissedTicks; }
+
+	/**
+	 * @brief Get the base tick period.
+	 *
+	 * @return The period in microseconds.
+	 */
+	[[nodiscard]] uint32_t getTickPeriod() const { return m_TickPeriod; }
+
+private:
+	/**
+	 * @brief Task structure.
+	 * This contains information about a single scheduled system.
+	 */
+	struct Task final
+	{
+		ISystem *m_pSystem = nullptr;
+
+		uint32_t m_Divider = 1;
+		uint32_t m_Period = 0;
+		uint32_t m_NextRelease = 0;
+
+		uint32_t m_PreviousStart = 0;
+		bool m_HasStarted = false;
+
+		TaskStatistics m_Statistics;
+	};
+
+	/**
+	 * @brief Run a single task and record its statistics.
+	 *
+	 * @param task The task to run.
+	 * @param releaseTime The time at which the tick was released.
+	 */
+	void runTask(Task &task, uint32_t releaseTime);
+
+private:
+	Task m_Tasks[g_MaxScheduledTasks];
+	ISystem *m_pIdleTask = nullptr;
+	ClockFunction m_Clock = nullptr;
+
+	uint32_t m_TickPeriod = 0;
+	uint32_t m_TickCount = 0;
+	uint32_t m_MissedTicks = 0;
+
+	uint8_t m_TaskCount = 0;
+};
\ No newline at end of file
@@ -0,0 +1,83 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+/**
+ * @brief Snapshot buffer class.
+ * This is a lock-free single-producer, single-consumer triple buffer. The producer always has a buffer to write to and the consumer always
+ * gets the latest complete snapshot, so neither of them ever blocks or waits for the other. Older snapshots are overwritten, which is the
+ * required behavior when handing sensor data from one core to another.
+ *
+ * @tparam Type The snapshot type. It must be trivially copyable.
+ */
+template <class Type>
+class SnapshotBuffer final
+{
+	// The shared index contains the buffer index in the lower bits and this flag when the buffer contains a snapshot the consumer has not seen.
+	static constexpr uint8_t g_FreshFlag = 0x80;
+	static constexpr uint8_t g_IndexMask = 0x03;
+
+public:
+	/**
+	 * @brief Construct a new Snapshot Buffer object.
+	 */
+	SnapshotBuffer() = default;
+
+	/**
+	 * @brief Publish a new snapshot.
+	 * This must only be called by the producer.
+	 *
+	 * @param value The value to publish.
+	 */
+	void publish(const Type &value)
+	{
+		m_Buffers[m_WriteIndex] = value;
+
+		// Swap the freshly written buffer with the shared one. The release makes the write visible before the index.
+		const auto previous = m_SharedIndex.exchange(static_cast<uint8_t>(m_WriteIndex | g_FreshFlag), std::memory_order_acq_rel);
+		m_WriteIndex = previous & g_IndexMask;
+	}
+
+	/**
+	 * @brief Check if a snapshot was published after the last read.
+	 * This must only be called by the consumer. It lets a consumer skip copying large snapshots which rarely change.
+	 *
+	 * @return true If the next read returns a new snapshot.
+	 * @return false If the next read returns the same snapshot as the last one.
+	 */
+	[[nodiscard]] bool isFresh() const { return (m_SharedIndex.load(std::memory_order_relaxed) & g_FreshFlag) != 0; }
+
+	/**
+	 * @brief Read the latest snapshot.
+	 * This must only be called by the consumer.
+	 *
+	 * @param value The value to copy the snapshot to.
+	 * @return true If the snapshot was published after the last read.
+	 * @return false If the snapshot is the same as the last one that was read.
+	 */
+	bool read(Type &value)
+	{
+		const auto isFresh = (m_SharedIndex.load(std::memory_order_relaxed) & g_FreshFlag) != 0;
+		if (isFresh)
+		{
+			// Take the latest buffer and give our old one back to the producer.
+			const auto previous = m_SharedIndex.exchange(m_ReadIndex, std::memory_order_acq_rel);
+			m_ReadIndex = previous & g_IndexMask;
+		}
+
+		value = m_Buffers[m_ReadIndex];
+		return isFresh;
+	}
+
+private:
+	Type m_Buffers[3] = {};
+	std::atomic<uint8_t> m_SharedIndex = {1};
+
+	// Each of these indexes is only accessed by one side.
+	uint8_t m_WriteIndex = 0;
+	uint8_t m_ReadIndex = 2;
+};
\ No newline at end of file
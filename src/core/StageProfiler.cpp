@@ -0,0 +1,26 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#include "StageProfiler.hpp"
+#include "Constants.hpp"
+
+StageStatistics StageProfiler::s_Statistics[g_ProfileStageCount];
+uint32_t StageProfiler::s_CPUFrequency = 240;
+
+void StageProfiler::Initialize()
+{
+	s_CPUFrequency = ESP.getCpuFreqMHz();
+
+	const uint32_t budgets[g_ProfileStageCount] = {g_InputStageBudget, g_SensorReadStageBudget, g_StabilizationStageBudget, g_OutputWriteStageBudget, g_ControlTickStageBudget, g_RateControlStageBudget, g_BlackboxWriteStageBudget};
+	for (uint8_t i = 0; i < g_ProfileStageCount; i++)
+		s_Statistics[i].m_Budget = budgets[i] * s_CPUFrequency;
+}
+
+float StageProfiler::GetRate(ProfileStage stage)
+{
+	const auto &statistics = s_Statistics[static_cast<uint8_t>(stage)];
+	if (statistics.m_Count < 2 || statistics.m_Period == 0)
+		return 0.0f;
+
+	return (static_cast<float>(s_CPUFrequency) * 1000000.0f) / static_cast<float>(statistics.m_Period);
+}
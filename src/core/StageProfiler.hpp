@@ -0,0 +1,165 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "core/Configuration.hpp"
+
+#include <Arduino.h>
+
+// Each histogram bucket covers twice the time of the previous one. The first bucket holds everything below 2^8 cycles (about 1 us at
+// 240 MHz) and the last one everything above 2^22 cycles (about 17 ms).
+constexpr auto g_StageHistogramBuckets = 16;
+constexpr auto g_StageHistogramShift = 7;
+
+// The rate estimate is an exponential moving average of the period with a weight of 1 / 2^g_StageRateSmoothing.
+constexpr auto g_StageRateSmoothing = 4;
+
+/**
+ * @brief Profile stage enum.
+ * These are the timed stages of the control loop.
+ */
+enum class ProfileStage : uint8_t
+{
+	Input,
+	SensorRead,
+	Stabilization,
+	OutputWrite,
+	ControlTick,
+	RateControl,
+	BlackboxWrite
+};
+
+constexpr auto g_ProfileStageCount = 7;
+
+/**
+ * @brief Stage statistics structure.
+ * All the times are in CPU cycles. The counts are cumulative and wrap around, so the reader should use the difference between two
+ * readings. The maximum is kept until it's reset by the reader.
+ */
+struct StageStatistics final
+{
+	uint32_t m_Count = 0;
+	uint32_t m_Overruns = 0;
+	uint32_t m_Maximum = 0;
+	uint32_t m_Budget = UINT32_MAX;
+	uint32_t m_Period = 0;
+	uint32_t m_PreviousStart = 0;
+	uint16_t m_Histogram[g_StageHistogramBuckets] = {};
+};
+
+/**
+ * @brief Stage profiler class.
+ * This records the execution time of the stages of the control loop using the CPU cycle counter. Recording a stage only costs a few
+ * cycles (no division, no locks), so it can stay enabled during flight testing. Every stage is only recorded from one core.
+ *
+ * The stages are timed using the PEREGRINE_PROFILE_STAGE macro which compiles to nothing unless PEREGRINE_PROFILING is defined.
+ */
+class StageProfiler final
+{
+public:
+	/**
+	 * @brief Initialize the profiler.
+	 * This sets the time budget of every stage. A stage that takes longer than its budget is counted as an overrun.
+	 */
+	static void Initialize();
+
+	/**
+	 * @brief Record the execution of a stage.
+	 *
+	 * @param stage The stage.
+	 * @param start The cycle count at the start of the stage.
+	 * @param end The cycle count at the end of the stage.
+	 */
+	static void Record(ProfileStage stage, uint32_t start, uint32_t end)
+	{
+		auto &statistics = s_Statistics[static_cast<uint8_t>(stage)];
+		const auto elapsed = end - start;
+
+		// The bucket is the position of the highest set bit, which is a single instruction.
+		auto bucket = 31 - __builtin_clz(elapsed | 1) - g_StageHistogramShift;
+		bucket = bucket < 0 ? 0 : (bucket >= g_StageHistogramBuckets ? g_StageHistogramBuckets - 1 : bucket);
+		statistics.m_Histogram[bucket]++;
+
+		if (elapsed > statistics.m_Maximum)
+			statistics.m_Maximum = elapsed;
+
+		if (elapsed > statistics.m_Budget)
+			statistics.m_Overruns++;
+
+		const auto period = start - statistics.m_PreviousStart;
+		if (statistics.m_Count > 1)
+			statistics.m_Period += static_cast<int32_t>(period - statistics.m_Period) >> g_StageRateSmoothing;
+		else if (statistics.m_Count == 1)
+			statistics.m_Period = period;
+
+		statistics.m_PreviousStart = start;
+		statistics.m_Count++;
+	}
+
+	/**
+	 * @brief Get the statistics of a stage.
+	 *
+	 * @param stage The stage.
+	 * @return The statistics.
+	 */
+	[[nodiscard]] static const StageStatistics &GetStatistics(ProfileStage stage) { return s_Statistics[static_cast<uint8_t>(stage)]; }
+
+	/**
+	 * @brief Reset the maximum execution time of a stage.
+	 *
+	 * @param stage The stage.
+	 */
+	static void ResetMaximum(ProfileStage stage) { s_Statistics[static_cast<uint8_t>(stage)].m_Maximum = 0; }
+
+	/**
+	 * @brief Get the rate at which a stage runs.
+	 *
+	 * @param stage The stage.
+	 * @return The rate in hertz. 0 if the stage has not run enough times.
+	 */
+	[[nodiscard]] static float GetRate(ProfileStage stage);
+
+	/**
+	 * @brief Get the CPU frequency used to convert the cycles.
+	 *
+	 * @return The frequency in megahertz.
+	 */
+	[[nodiscard]] static uint32_t GetCPUFrequency() { return s_CPUFrequency; }
+
+private:
+	static StageStatistics s_Statistics[g_ProfileStageCount];
+	static uint32_t s_CPUFrequency;
+};
+
+/**
+ * @brief Scoped stage timer class.
+ * This records the time from its construction to its destruction.
+ */
+class ScopedStageTimer final
+{
+public:
+	/**
+	 * @brief Construct a new Scoped Stage Timer object.
+	 *
+	 * @param stage The stage to time.
+	 */
+	explicit ScopedStageTimer(ProfileStage stage) : m_Start(ESP.getCycleCount()), m_Stage(stage) {}
+
+	/**
+	 * @brief Destroy the Scoped Stage Timer object.
+	 */
+	~ScopedStageTimer() { StageProfiler::Record(m_Stage, m_Start, ESP.getCycleCount()); }
+
+private:
+	uint32_t m_Start = 0;
+	ProfileStage m_Stage;
+};
+
+#ifdef PEREGRINE_PROFILING
+#define PEREGRINE_PROFILE_STAGE(stage) const ScopedStageTimer stageTimer(stage)
+
+#else
+#define PEREGRINE_PROFILE_STAGE(stage) static_cast<void>(0)
+
+#endif
\ No newline at end of file
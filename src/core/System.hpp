@@ -3,7 +3,24 @@
 
 #pragma once
 
-#include <Arduino.h>
+/**
+ * @brief System interface class.
+ * This is the type-erased base of all the systems, which allows the scheduler to update them without knowing the derived type.
+ */
+class ISystem
+{
+public:
+	/**
+	 * @brief Destroy the ISystem object.
+	 */
+	virtual ~ISystem() = default;
+
+	/**
+	 * @brief Update pure virtual method.
+	 * This method is called by the scheduler and the derived class must use this method to update itself.
+	 */
+	virtual void update() = 0;
+};
 
 /**
  * @brief Main system class.
@@ -12,7 +29,7 @@
  * @tparam Derived The derived type.
  */
 template <class Derived>
-class System
+class System : public ISystem
 {
 protected:
 	/**
@@ -36,10 +53,4 @@ public:
 		static Derived instance;
 		return instance;
 	}
-
-	/**
-	 * @brief Update pure virtual method.
-	 * This method is called by the loop function and the derived class must use this method to update itself.
-	 */
-	virtual void update() = 0;
 };
\ No newline at end of file
@@ -0,0 +1,246 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "Types.hpp"
+
+#include <stdint.h>
+
+// All the telemetry messages are packed, little-endian structures. The same frames are used by the packet data link, which sends the
+// control messages from the ground station and the link quality back. The version must be incremented whenever a message layout changes,
+// and monitor/telemetry_decoder.py must be updated to match.
+constexpr uint8_t g_TelemetryVersion = 5;
+
+/**
+ * @brief Telemetry message ID enum.
+ * Messages below Subscribe are sent by the controller, the rest are sent by the host.
+ */
+enum class TelemetryMessageID : uint8_t
+{
+	Setpoints = 0,
+	Attitude = 1,
+	PIDTerms = 2,
+	ActuatorCommands = 3,
+	StageTimings = 4,
+	LinkQuality = 5,
+	Calibration = 6,
+	AutoTune = 7,
+	Parameter = 8,
+
+	Subscribe = 0x80,
+	Control = 0x81,
+	AutoTuneCommand = 0x82,
+	ParameterCommand = 0x83
+};
+
+// The number of messages sent by the controller.
+constexpr auto g_TelemetryMessageCount = 9;
+
+// The number of auxiliary channels of the control message.
+constexpr auto g_ControlChannelCount = 12;
+
+/**
+ * @brief Telemetry header structure.
+ * Every frame starts with this header, followed by the message and a CRC-16 of both. The whole frame is then COBS encoded and delimited
+ * with zeros.
+ */
+struct __attribute__((packed)) TelemetryHeader final
+{
+	uint8_t m_Version = g_TelemetryVersion;
+	TelemetryMessageID m_ID = TelemetryMessageID::Setpoints;
+	uint16_t m_Sequence = 0;
+	uint32_t m_Timestamp = 0;
+};
+
+/**
+ * @brief Setpoints message structure.
+ * This contains the inputs the controller is trying to follow.
+ */
+struct __attribute__((packed)) SetpointsMessage final
+{
+	float m_Thrust = 0.0f;
+	float m_Pitch = 0.0f;
+	float m_Roll = 0.0f;
+	float m_Yaw = 0.0f;
+	uint8_t m_FlyMode = 0;
+};
+
+/**
+ * @brief Attitude message structure.
+ * This contains the attitude and rotation rate used by the stabilizer.
+ */
+struct __attribute__((packed)) AttitudeMessage final
+{
+	float m_Pitch = 0.0f;
+	float m_Roll = 0.0f;
+	float m_Yaw = 0.0f;
+
+	float m_PitchRate = 0.0f;
+	float m_RollRate = 0.0f;
+	float m_YawRate = 0.0f;
+};
+
+/**
+ * @brief PID terms message structure.
+ * This contains the individual PID terms and the output of each axis (pitch, roll, yaw).
+ */
+struct __attribute__((packed)) PIDTermsMessage final
+{
+	float m_Proportional[3] = {0.0f, 0.0f, 0.0f};
+	float m_Integral[3] = {0.0f, 0.0f, 0.0f};
+	float m_Derivative[3] = {0.0f, 0.0f, 0.0f};
+	float m_Output[3] = {0.0f, 0.0f, 0.0f};
+};
+
+/**
+ * @brief Actuator commands message structure.
+ * This contains the values written to the rotors and servos (0 - 180).
+ */
+struct __attribute__((packed)) ActuatorCommandsMessage final
+{
+	uint8_t m_LeftRotor = 0;
+	uint8_t m_RightRotor = 0;
+	uint8_t m_LeftWing = 0;
+	uint8_t m_RightWing = 0;
+	uint8_t m_Elevator = 0;
+	uint8_t m_Rudder = 0;
+};
+
+/**
+ * @brief Stage timings message structure.
+ * This contains the execution time statistics of a single control loop stage. The stages are sent one after the other. The counts are
+ * cumulative and wrap around, the maximum is the longest execution since the previous message of the stage.
+ */
+struct __attribute__((packed)) StageTimingsMessage final
+{
+	uint8_t m_Stage = 0;
+	uint8_t m_CPUFrequency = 0; // Megahertz, to convert the histogram buckets (in cycles) to time.
+	float m_Rate = 0.0f; // Hertz.
+	uint32_t m_Count = 0;
+	uint32_t m_Overruns = 0;
+	uint16_t m_Budget = 0; // Microseconds.
+	uint16_t m_Maximum = 0; // Microseconds.
+
+	// Bucket i counts the executions shorter than 2^(i + 8) cycles (and longer than the previous bucket's limit). The last bucket counts
+	// everything longer than that.
+	uint16_t m_Histogram[16] = {};
+};
+
+/**
+ * @brief Link quality message structure.
+ * This contains the statistics of the data link. The packet data link also sends it back to the ground station, which can measure the
+ * round trip time from the echoed timestamp: the current time, minus the remote timestamp, minus the age.
+ */
+struct __attribute__((packed)) LinkQualityMessage final
+{
+	uint32_t m_Received = 0;
+	uint32_t m_Lost = 0;
+	uint32_t m_Errors = 0;
+	uint32_t m_RemoteTimestamp = 0; // The sender's timestamp of the last frame, in the sender's clock.
+	uint32_t m_Age = 0;				// Microseconds since the last frame was received.
+	uint32_t m_Jitter = 0;			// Microseconds.
+};
+
+/**
+ * @brief Calibration message structure.
+ * This contains the sensor calibration which is used (in the sensor frame) and how long the controller took to arm after the boot.
+ */
+struct __attribute__((packed)) CalibrationMessage final
+{
+	float m_GyroscopeBias[3] = {0.0f, 0.0f, 0.0f}; // Degrees per second.
+	float m_AccelerometerOffset[3] = {0.0f, 0.0f, 0.0f}; // Meters per square second.
+	float m_Temperature = 0.0f; // Celsius, when the gyroscope bias was measured.
+	uint32_t m_ArmTime = 0; // Milliseconds from the boot until the controller armed, 0 while it's not armed.
+	uint16_t m_Calibrations = 0; // The number of calibrations measured since the boot.
+	uint8_t m_Loaded = 0; // 1 if the stored calibration was loaded on the boot.
+};
+
+/**
+ * @brief Auto tune message structure.
+ * This contains the progress of the last relay feedback experiment and the gains it applied (see Stabilizer::startAutoTune).
+ */
+struct __attribute__((packed)) AutoTuneMessage final
+{
+	uint8_t m_Loop = 0; // The TuningLoop value.
+	uint8_t m_Axis = 0; // The TuningAxis value.
+	uint8_t m_Rule = 0; // The TuningRule value.
+	uint8_t m_State = 0; // The RelayTunerState value.
+	uint16_t m_Cycles = 0;
+	float m_UltimateGain = 0.0f;
+	float m_UltimatePeriod = 0.0f; // Seconds.
+
+	// The proportional, integral (per second) and derivative (seconds) gains. These are the gains before the experiment until it completes.
+	float m_Gains[3] = {0.0f, 0.0f, 0.0f};
+};
+
+/**
+ * @brief Parameter message structure.
+ * This answers a parameter command with the value of the parameter after the command (see ParameterSystem). It's sent for every command,
+ * whether the host is subscribed or not.
+ */
+struct __attribute__((packed)) ParameterMessage final
+{
+	uint8_t m_ID = 0; // The ParameterID value.
+	uint8_t m_Type = 0; // The ParameterType value.
+	uint8_t m_Action = 0; // The ParameterAction value of the command.
+	uint8_t m_Status = 0; // The ParameterStatus value.
+	ParameterValue m_Value = {0.0f};
+};
+
+/**
+ * @brief Subscribe message structure.
+ * The host sends this to set the rate of a message.
+ */
+struct __attribute__((packed)) SubscribeMessage final
+{
+	TelemetryMessageID m_ID = TelemetryMessageID::Setpoints;
+
+	// The minimum interval between two messages in milliseconds. 0 unsubscribes.
+	uint16_t m_Interval = 0;
+};
+
+/**
+ * @brief Control message structure.
+ * The ground station sends this to the packet data link. The header's sequence numbers are used to count the lost messages and its
+ * timestamps (in the ground station's clock) to measure the jitter.
+ */
+struct __attribute__((packed)) ControlMessage final
+{
+	// The setpoints, as a fraction of the full stick deflection. The thrust is 0 to 1, the pitch, roll and yaw are -1 to 1.
+	float m_Thrust = 0.0f;
+	float m_Pitch = 0.0f;
+	float m_Roll = 0.0f;
+	float m_Yaw = 0.0f;
+
+	// The required fly mode and control mode (the FlyMode and ControlMode values).
+	uint8_t m_FlyMode = 0;
+	uint8_t m_ControlMode = 0;
+
+	// Auxiliary channels, which are not used by the controller.
+	uint16_t m_Channels[g_ControlChannelCount] = {};
+};
+
+/**
+ * @brief Auto tune command message structure.
+ * The host sends this to start or stop a relay feedback experiment.
+ */
+struct __attribute__((packed)) AutoTuneCommandMessage final
+{
+	uint8_t m_Loop = 0; // The TuningLoop value.
+	uint8_t m_Axis = 0; // The TuningAxis value.
+	uint8_t m_Rule = 0; // The TuningRule value.
+	uint8_t m_Start = 0; // 1 to start the experiment, 0 to stop it.
+};
+
+/**
+ * @brief Parameter command message structure.
+ * The host sends this to read or write a parameter, or to save or reset all of them. The controller answers with a parameter message.
+ */
+struct __attribute__((packed)) ParameterCommandMessage final
+{
+	uint8_t m_Action = 0; // The ParameterAction value.
+	uint8_t m_ID = 0; // The ParameterID value. The saves and resets answer with this parameter.
+	uint8_t m_Type = 0; // The ParameterType value of the written value.
+	ParameterValue m_Value = {0.0f}; // The value to write.
+};
\ No newline at end of file
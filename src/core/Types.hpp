@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <stdint.h>
+
 /**
  * @brief Vec3 type.
  * This is a 3 component vector type.
@@ -38,4 +40,169 @@ struct Vec3 final
 			float m_Roll;
 		};
 	};
+};
+
+/**
+ * @brief IMU sample structure.
+ * This is a single sample of the inertial sensor, converted to physical units. The vectors are in the sensor frame: X points to the
+ * right wing, Y to the front and Z up.
+ */
+struct IMUSample final
+{
+	// The specific force in meters per square second.
+	Vec3 m_Acceleration;
+
+	// The rotation rate in degrees per second.
+	Vec3 m_Rate;
+
+	// The time since the previous sample in seconds.
+	float m_DeltaTime = 0.0f;
+};
+
+/**
+ * @brief Sensor calibration structure.
+ * These are subtracted from the samples of the inertial sensor, in the sensor frame.
+ */
+struct SensorCalibration final
+{
+	// The gyroscope reading at rest in degrees per second.
+	Vec3 m_GyroscopeBias;
+
+	// The difference of the accelerometer reading to gravity when level, in meters per square second.
+	Vec3 m_AccelerometerOffset;
+
+	// The sensor's temperature when the gyroscope bias was measured in celsius. The bias drifts with the temperature.
+	float m_Temperature = 0.0f;
+};
+
+/**
+ * @brief Attitude sample structure.
+ * This is the snapshot the sensor pipeline hands to the stabilizer.
+ */
+struct AttitudeSample final
+{
+	// The filtered attitude in degrees.
+	Vec3 m_Attitude;
+
+	// The rotation rate in degrees per second.
+	Vec3 m_Rate;
+
+	// The time at which the sample was taken in microseconds.
+	uint32_t m_Timestamp = 0;
+};
+
+/**
+ * @brief Rate control sample structure.
+ * This is the snapshot the rate controller (on the sensor side) hands to the stabilizer.
+ */
+struct RateControlSample final
+{
+	// The PID outputs.
+	Vec3 m_Output;
+
+	// The PID terms which make up the outputs.
+	Vec3 m_Proportional;
+	Vec3 m_Integral;
+	Vec3 m_Derivative;
+};
+
+/**
+ * @brief Setpoint structure.
+ * These are the inputs of the pilot for a single control tick.
+ */
+struct Setpoint final
+{
+	// The thrust (0 - 1000).
+	float m_Thrust = 0.0f;
+
+	// The pitch, roll and yaw (-45 - 45, unless the input ranges were changed, see ParameterSet).
+	float m_Pitch = 0.0f;
+	float m_Roll = 0.0f;
+	float m_Yaw = 0.0f;
+};
+
+/**
+ * @brief Link quality structure.
+ * These are the statistics of a data link, which are counted since it was initialized.
+ */
+struct LinkQuality final
+{
+	// The number of valid frames received.
+	uint32_t m_Received = 0;
+
+	// The number of frames which never arrived (or were damaged), from the gaps in the sequence numbers.
+	uint32_t m_Lost = 0;
+
+	// The number of damaged frames which were dropped.
+	uint32_t m_Errors = 0;
+
+	// The sender's timestamp of the last frame in microseconds, in the sender's clock.
+	uint32_t m_RemoteTimestamp = 0;
+
+	// The time since the last frame was received in microseconds.
+	uint32_t m_Age = 0;
+
+	// The interarrival jitter in microseconds: the mean deviation of the time between two frames from the time between their timestamps.
+	uint32_t m_Jitter = 0;
+};
+
+/**
+ * @brief PID gains structure.
+ * These are the gains of a single axis.
+ */
+struct PIDGains final
+{
+	float m_KP = 0.0f;
+	float m_KI = 0.0f;
+	float m_KD = 0.0f;
+};
+
+/**
+ * @brief Parameter type enum.
+ */
+enum class ParameterType : uint8_t
+{
+	Float,
+	Integer
+};
+
+/**
+ * @brief Parameter value union.
+ * A single parameter, which is read as the member of its type.
+ */
+union ParameterValue
+{
+	float m_Float;
+	int32_t m_Integer;
+};
+
+/**
+ * @brief Parameter set structure.
+ * These are the settings which can be changed without building the controller again (see ParameterSystem). The defaults are the constants
+ * they replace.
+ */
+struct ParameterSet final
+{
+	// The gains of the angle and the rate loops. The integral gains are per second and the derivative gains are in seconds.
+	PIDGains m_PitchAngle;
+	PIDGains m_RollAngle;
+	PIDGains m_PitchRate;
+	PIDGains m_RollRate;
+	PIDGains m_YawRate;
+
+	// The servo angles of the centered controls (see g_WingServoOffsetHover).
+	int32_t m_WingServoOffsetHover = 0;
+	int32_t m_WingServoOffsetCruise = 0;
+	int32_t m_ElevatorOffset = 0;
+	int32_t m_RudderOffset = 0;
+
+	// The pitch, roll and yaw inputs at the full stick deflection (see g_PitchInputMaximum).
+	int32_t m_PitchInputRange = 0;
+	int32_t m_RollInputRange = 0;
+	int32_t m_YawInputRange = 0;
+
+	// The process and the measurement noise of the Kalman filters (see KalmanFilter::tune).
+	float m_KalmanAngleNoise = 0.0f;
+	float m_KalmanBiasNoise = 0.0f;
+	float m_KalmanMeasurementNoise = 0.0f;
 };
\ No newline at end of file
@@ -4,12 +4,38 @@
 #include "systems/OutputSystem.hpp"
 #include "systems/Stabilizer.hpp"
 #include "systems/InputSystem.hpp"
+#include "systems/TelemetrySystem.hpp"
+#include "systems/LoggingSystem.hpp"
+#include "systems/BlackboxSystem.hpp"
+#include "systems/ParameterSystem.hpp"
 #include "core/Configuration.hpp"
+#include "core/Constants.hpp"
+#include "core/Scheduler.hpp"
+#include "core/StageProfiler.hpp"
+#include "components/TickTimer.hpp"
+#include "components/WireI2CBus.hpp"
+#include "components/NVSRecordStorage.hpp"
+
+#if defined(PEREGRINE_ROTOR_RMT)
+#include "components/RMTRotorOutput.hpp"
+RMTRotorOutput g_RotorOutput(g_RotorProtocol);
+
+#else
+#include "components/ServoRotorOutput.hpp"
+ServoRotorOutput g_RotorOutput;
+
+#endif
 
 #if defined(PEREGRINE_DATA_LINK_FS_I6)
 #include "components/FSi6DataLink.hpp"
 FSi6DataLink g_CurrentDataLink;
 
+#elif defined(PEREGRINE_DATA_LINK_PACKET)
+#include "components/PacketDataLink.hpp"
+#include "components/UARTTransport.hpp"
+UARTTransport g_LinkTransport(Serial2, g_PacketLinkBaudRate);
+PacketDataLink g_CurrentDataLink(&g_LinkTransport);
+
 #elif defined(PEREGRINE_DATA_LINK_NRF24L01)
 #include "components/DefaultDataLink.hpp"
 DefaultDataLink g_CurrentDataLink;
@@ -20,34 +46,125 @@ DefaultDataLink g_CurrentDataLink;
 
 #endif
 
+#if defined(PEREGRINE_BLACKBOX)
+#include "components/PartitionBlackboxStorage.hpp"
+PartitionBlackboxStorage g_BlackboxStorage;
+
+#endif
+
 #include "core/Logging.hpp"
 
+/**
+ * @brief Get the scheduler time.
+ *
+ * @return The time in microseconds.
+ */
+uint32_t GetSchedulerTime()
+{
+	return micros();
+}
+
+Scheduler g_Scheduler(g_SchedulerTickRate, &GetSchedulerTime);
+Scheduler g_SensorScheduler(g_SensorSampleRate, &GetSchedulerTime);
+TickTimer g_TickTimer;
+WireI2CBus g_I2CBus;
+NVSRecordStorage<SensorCalibration> g_CalibrationStorage(g_StorageNamespace, g_CalibrationKey);
+NVSRecordStorage<ParameterSet> g_ParameterStorage(g_StorageNamespace, g_ParameterKey);
+
+/**
+ * @brief Sensor task function.
+ * This runs the sensor pipeline on its own core, independent of the control loop. The sensor is initialized here so its interrupt
+ * notifies this task, and every data ready signal is a tick of the sensor scheduler.
+ *
+ * @param pParameter The task parameter (unused).
+ */
+void SensorTask(void *pParameter)
+{
+	// Initialize the stabilizer. This loads the sensor calibration.
+	g_I2CBus.initialize(g_I2CClockRate);
+	Stabilizer::Instance().initialize(&g_I2CBus, &g_CalibrationStorage);
+
+	while (true)
+		g_SensorScheduler.tick(Stabilizer::Instance().waitForSensorData());
+}
+
+#if defined(PEREGRINE_BLACKBOX)
+/**
+ * @brief Blackbox task function.
+ * This writes the recorded blocks to the flash, which takes a few tens of milliseconds per block. The records are queued in the meantime.
+ *
+ * @param pParameter The task parameter (unused).
+ */
+void BlackboxTask(void *pParameter)
+{
+	while (true)
+	{
+		BlackboxSystem::Instance().update();
+		vTaskDelay(pdMS_TO_TICKS(g_BlackboxTaskPeriod));
+	}
+}
+
+#endif
+
 void setup()
 {
 	PEREGRINE_SETUP_LOGGING(115200);
 	PEREGRINE_PRINTLN("Welcome to Peregrine!");
 	PEREGRINE_PRINTLN("Initializing the controller.");
 
-	// Initialize the stabilizer.
-	Stabilizer::Instance().initialize();
+	// Set the stage budgets of the profiler.
+	StageProfiler::Initialize();
+
+	// Initialize the telemetry system.
+	TelemetrySystem::Instance().initialize();
+
+	// Initialize the parameter system. This loads the stored parameters, so the outputs start with the stored servo offsets.
+	ParameterSystem::Instance().initialize(&g_ParameterStorage);
 
 	// Initialize the output system.
-	OutputSystem::Instance().initialize();
+	OutputSystem::Instance().initialize(&g_RotorOutput);
 
 	// Initialize the input system.
 	InputSystem::Instance().initialize(&g_CurrentDataLink);
 
+#if defined(PEREGRINE_BLACKBOX)
+	// Initialize the blackbox system. This erases the free part of the blackbox partition, which stalls both cores, so it's done before
+	// any task starts.
+	BlackboxSystem::Instance().initialize(&g_BlackboxStorage);
+
+#endif
+
+	// Schedule the systems. The order of addition is the order of execution within a tick.
+	// The stabilizer's update reads the sensor, so it runs on the sensor core and hands the attitude over to the control core.
+	g_SensorScheduler.addTask(&Stabilizer::Instance(), g_SensorUpdateDivider);
+	g_Scheduler.addTask(&InputSystem::Instance(), g_InputUpdateDivider, 1);
+	g_Scheduler.addTask(&OutputSystem::Instance(), g_OutputUpdateDivider);
+	g_Scheduler.addTask(&TelemetrySystem::Instance(), g_TelemetryUpdateDivider, 3);
+	g_Scheduler.addTask(&ParameterSystem::Instance(), g_ParameterUpdateDivider, 3);
+
+	// The logs are formatted in the idle slot of the control loop.
+	g_Scheduler.setIdleTask(&LoggingSystem::Instance());
+
+	// Create the sensor task. This also initializes the stabilizer.
+	xTaskCreatePinnedToCore(&SensorTask, "Sensor", g_SensorTaskStackSize, nullptr, g_SensorTaskPriority, nullptr, g_SensorCore);
+
+#if defined(PEREGRINE_BLACKBOX)
+	// Create the blackbox task.
+	xTaskCreatePinnedToCore(&BlackboxTask, "Blackbox", g_BlackboxTaskStackSize, nullptr, g_BlackboxTaskPriority, nullptr, g_SensorCore);
+
+#endif
+
+	// Start the base tick. The timer notifies this (the loop) task.
+	g_TickTimer.start(g_SchedulerTickRate);
+
 	PEREGRINE_PRINTLN("The controller initialized. Entering the main loop.");
 }
 
 void loop()
 {
-	// Update the input system.
-	InputSystem::Instance().update();
-
-	// Update the stabilization.
-	Stabilizer::Instance().update();
+	// Wait for the next tick and run all the systems that are due.
+	const auto pendingTicks = g_TickTimer.wait();
 
-	// Update the output system.
-	OutputSystem::Instance().update();
+	PEREGRINE_PROFILE_STAGE(ProfileStage::ControlTick);
+	g_Scheduler.tick(pendingTicks);
 }
\ No newline at end of file
@@ -0,0 +1,344 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+// Blackbox log replay.
+// The recorded sensor samples and data link frames of a flight are fed through the controller's systems again: the MPU6050 driver (behind
+// the I2C bus interface), the attitude estimator, the stabilizer and the output mixing. Every record is replayed at its recorded time on a
+// virtual clock and in the order of the log, so a replay runs much faster than real time and always produces the same actuator commands.
+//
+// Usage: program <log> [--blackbox file] [--angle-kp pitch,yaw,roll] [--angle-ki pitch,yaw,roll] [--angle-kd pitch,yaw,roll]
+//                      [--rate-kp pitch,yaw,roll] [--rate-ki pitch,yaw,roll] [--rate-kd pitch,yaw,roll]
+// The replayed actuator commands are written to the standard output as CSV, and compared to the recorded ones. The replays of two builds
+// or of two sets of gains can be compared using monitor/replay_compare.py. The replayed flight can also be recorded to a new log.
+
+#include "ReplayDataLink.hpp"
+#include "ReplayI2CBus.hpp"
+#include "ReplayLog.hpp"
+
+#include "sim/FileBlackboxStorage.hpp"
+#include "sim/HostPlatform.hpp"
+
+#include "systems/BlackboxSystem.hpp"
+#include "systems/InputSystem.hpp"
+#include "systems/OutputSystem.hpp"
+#include "systems/Stabilizer.hpp"
+#include "components/ServoRotorOutput.hpp"
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+/**
+ * @brief Replay options structure.
+ * The gains are the ones of the build by default.
+ */
+struct ReplayOptions final
+{
+	const char *m_pLogFile = nullptr;
+	const char *m_pBlackboxFile = nullptr;
+
+	Vec3 m_AngleKP = Vec3(g_PitchAngleKP, 0.0f, g_RollAngleKP);
+	Vec3 m_AngleKI = Vec3(g_PitchAngleKI, 0.0f, g_RollAngleKI);
+	Vec3 m_AngleKD = Vec3(g_PitchAngleKD, 0.0f, g_RollAngleKD);
+
+	Vec3 m_RateKP = Vec3(g_PitchRateKP, g_YawRateKP, g_RollRateKP);
+	Vec3 m_RateKI = Vec3(g_PitchRateKI, g_YawRateKI, g_RollRateKI);
+	Vec3 m_RateKD = Vec3(g_PitchRateKD, g_YawRateKD, g_RollRateKD);
+};
+
+/**
+ * @brief Replay statistics structure.
+ * The replayed actuator commands are compared to the recorded ones, in the resolution of the log.
+ */
+struct ReplayStatistics final
+{
+	uint32_t m_Frames = 0;
+	uint32_t m_MatchingFrames = 0;
+	uint32_t m_FirstMismatch = 0;
+	float m_MaximumRotorDifference = 0.0f;
+	int m_MaximumServoDifference = 0;
+};
+
+ReplayI2CBus g_ReplayBus;
+ReplayDataLink g_ReplayDataLink;
+ServoRotorOutput g_RotorOutput;
+
+/**
+ * @brief Parse the pitch, yaw and roll components of a vector.
+ *
+ * @param pValue The value, separated by commas.
+ * @param vector The vector to write to.
+ * @return true If the value has 3 components.
+ * @return false If the value is invalid.
+ */
+bool ParseVector(const char *pValue, Vec3 &vector)
+{
+	float pitch = 0.0f, yaw = 0.0f, roll = 0.0f;
+	if (sscanf(pValue, "%f,%f,%f", &pitch, &yaw, &roll) != 3)
+		return false;
+
+	vector = Vec3(pitch, yaw, roll);
+	return true;
+}
+
+/**
+ * @brief Parse the command line options.
+ *
+ * @param argc The argument count.
+ * @param argv The arguments.
+ * @param options The options to write to.
+ * @return true If the options are valid.
+ * @return false If the log is missing, or an option is unknown, invalid or is missing its value.
+ */
+bool ParseOptions(int argc, char **argv, ReplayOptions &options)
+{
+	if (argc < 2 || argv[1][0] == '-')
+		return false;
+
+	options.m_pLogFile = argv[1];
+	for (int i = 2; i < argc; i++)
+	{
+		if (i + 1 >= argc)
+			return false;
+
+		const char *pValue = argv[++i];
+		auto isValid = true;
+		if (strcmp(argv[i - 1], "--blackbox") == 0)
+			options.m_pBlackboxFile = pValue;
+		else if (strcmp(argv[i - 1], "--angle-kp") == 0)
+			isValid = ParseVector(pValue, options.m_AngleKP);
+		else if (strcmp(argv[i - 1], "--angle-ki") == 0)
+			isValid = ParseVector(pValue, options.m_AngleKI);
+		else if (strcmp(argv[i - 1], "--angle-kd") == 0)
+			isValid = ParseVector(pValue, options.m_AngleKD);
+		else if (strcmp(argv[i - 1], "--rate-kp") == 0)
+			isValid = ParseVector(pValue, options.m_RateKP);
+		else if (strcmp(argv[i - 1], "--rate-ki") == 0)
+			isValid = ParseVector(pValue, options.m_RateKI);
+		else if (strcmp(argv[i - 1], "--rate-kd") == 0)
+			isValid = ParseVector(pValue, options.m_RateKD);
+		else
+			return false;
+
+		if (!isValid)
+			return false;
+	}
+
+	return true;
+}
+
+/**
+ * @brief Move the virtual clock to the time of a record.
+ * The records are in time order, so the clock only moves forward (and wraps around like the controller's clock).
+ *
+ * @param timestamp The time in microseconds.
+ */
+void SetReplayTime(uint32_t timestamp)
+{
+	AdvanceHostTime(timestamp - static_cast<uint32_t>(micros()));
+}
+
+/**
+ * @brief Get the raw sensor sample of an IMU record.
+ *
+ * @param record The record.
+ * @return The raw sample.
+ */
+RawIMUSample GetRawSample(const BlackboxRecord &record)
+{
+	RawIMUSample sample;
+	for (uint8_t i = 0; i < 3; i++)
+	{
+		sample.m_Accelerometer[i] = static_cast<int16_t>(record.m_Fields[i]);
+		sample.m_Gyroscope[i] = static_cast<int16_t>(record.m_Fields[3 + i]);
+	}
+
+	return sample;
+}
+
+/**
+ * @brief Replay the data link frame of an inputs record.
+ *
+ * @param record The record.
+ */
+void ReplayInputs(const BlackboxRecord &record)
+{
+	Setpoint inputs;
+	inputs.m_Thrust = DecodeBlackboxFloat(record.m_Fields[0]);
+	inputs.m_Pitch = DecodeBlackboxFloat(record.m_Fields[1]);
+	inputs.m_Roll = DecodeBlackboxFloat(record.m_Fields[2]);
+	inputs.m_Yaw = DecodeBlackboxFloat(record.m_Fields[3]);
+
+	g_ReplayDataLink.setFrame(inputs, static_cast<uint32_t>(record.m_Fields[4]), static_cast<FlyMode>(record.m_Fields[5]), static_cast<ControlMode>(record.m_Fields[6]));
+	InputSystem::Instance().update();
+}
+
+/**
+ * @brief Replay a calibration record.
+ * The recorded calibration is used from the next sensor read on, instead of calibrating the replayed samples again.
+ *
+ * @param record The record.
+ */
+void ReplayCalibration(const BlackboxRecord &record)
+{
+	SensorCalibration calibration;
+	calibration.m_GyroscopeBias = Vec3(DecodeBlackboxFloat(record.m_Fields[0]), DecodeBlackboxFloat(record.m_Fields[1]), DecodeBlackboxFloat(record.m_Fields[2]));
+	calibration.m_AccelerometerOffset = Vec3(DecodeBlackboxFloat(record.m_Fields[3]), DecodeBlackboxFloat(record.m_Fields[4]), DecodeBlackboxFloat(record.m_Fields[5]));
+	calibration.m_Temperature = DecodeBlackboxFloat(record.m_Fields[6]);
+	Stabilizer::Instance().setCalibration(calibration);
+}
+
+/**
+ * @brief Replay the output update of an actuators record, write the commands and compare them to the recorded ones.
+ *
+ * @param record The record.
+ * @param statistics The statistics to update.
+ */
+void ReplayActuators(const BlackboxRecord &record, ReplayStatistics &statistics)
+{
+	auto &outputSystem = OutputSystem::Instance();
+	outputSystem.update();
+
+	// The rotors are written with all the digits a float needs, so two replays can be compared exactly.
+	const auto &frame = outputSystem.getMixedFrame();
+	printf("%u,%.9g,%.9g,%d,%d,%d,%d,%d\n", static_cast<unsigned int>(record.m_Timestamp), static_cast<double>(frame.m_LeftRotor),
+		   static_cast<double>(frame.m_RightRotor), frame.m_LeftWing, frame.m_RightWing, frame.m_Elevator, frame.m_Rudder, static_cast<int>(g_CurrentFlyMode));
+
+	const int servos[] = {frame.m_LeftWing, frame.m_RightWing, frame.m_Elevator, frame.m_Rudder};
+	bool isMatching = EncodeBlackboxFixed(frame.m_LeftRotor) == record.m_Fields[0] && EncodeBlackboxFixed(frame.m_RightRotor) == record.m_Fields[1] &&
+					  static_cast<int32_t>(g_CurrentFlyMode) == record.m_Fields[6];
+
+	for (uint8_t i = 0; i < 4; i++)
+	{
+		const auto difference = abs(servos[i] - record.m_Fields[2 + i]);
+		statistics.m_MaximumServoDifference = difference > statistics.m_MaximumServoDifference ? difference : statistics.m_MaximumServoDifference;
+		isMatching = isMatching && difference == 0;
+	}
+
+	const float rotorDifferences[] = {fabsf(frame.m_LeftRotor - DecodeBlackboxFixed(record.m_Fields[0])), fabsf(frame.m_RightRotor - DecodeBlackboxFixed(record.m_Fields[1]))};
+	for (const auto difference : rotorDifferences)
+		statistics.m_MaximumRotorDifference = difference > statistics.m_MaximumRotorDifference ? difference : statistics.m_MaximumRotorDifference;
+
+	if (isMatching)
+		statistics.m_MatchingFrames++;
+	else if (statistics.m_MatchingFrames == statistics.m_Frames)
+		statistics.m_FirstMismatch = record.m_Timestamp;
+
+	statistics.m_Frames++;
+}
+
+int main(int argc, char **argv)
+{
+	ReplayOptions options;
+	if (!ParseOptions(argc, argv, options))
+	{
+		fprintf(stderr, "Usage: %s <log> [--blackbox file] [--angle-kp pitch,yaw,roll] [--angle-ki pitch,yaw,roll] [--angle-kd pitch,yaw,roll] "
+						"[--rate-kp pitch,yaw,roll] [--rate-ki pitch,yaw,roll] [--rate-kd pitch,yaw,roll]\n",
+				argv[0]);
+		return 2;
+	}
+
+	ReplayLog log;
+	if (!log.load(options.m_pLogFile))
+	{
+		fprintf(stderr, "Failed to read the log %s!\n", options.m_pLogFile);
+		return 2;
+	}
+
+	const auto &records = log.getRecords();
+	if (records.empty())
+	{
+		fprintf(stderr, "The log %s has no records!\n", options.m_pLogFile);
+		return 2;
+	}
+
+	FileBlackboxStorage blackboxStorage(options.m_pBlackboxFile);
+	if (options.m_pBlackboxFile)
+	{
+		BlackboxSystem::Instance().initialize(&blackboxStorage);
+		if (!BlackboxSystem::Instance().isRecording())
+		{
+			fprintf(stderr, "Failed to open the blackbox file %s!\n", options.m_pBlackboxFile);
+			return 2;
+		}
+	}
+
+	// The same setup as the controller, but the systems are updated at the recorded times instead of by the schedulers.
+	OutputSystem::Instance().initialize(&g_RotorOutput);
+	InputSystem::Instance().initialize(&g_ReplayDataLink);
+	Stabilizer::Instance().initialize(&g_ReplayBus);
+	Stabilizer::Instance().tuneAngleLoop(options.m_AngleKP, options.m_AngleKI, options.m_AngleKD);
+	Stabilizer::Instance().tuneRateLoop(options.m_RateKP, options.m_RateKI, options.m_RateKD);
+
+	// The setup takes time on the virtual clock as well (the sensor is reset), which the flight did before recording.
+	const auto startTimestamp = records.front().m_Timestamp;
+	if (static_cast<int32_t>(startTimestamp - static_cast<uint32_t>(micros())) < 0)
+	{
+		fprintf(stderr, "The log starts before the controller was set up!\n");
+		return 2;
+	}
+
+	printf("timestamp,left_rotor,right_rotor,left_wing,right_wing,elevator,rudder,fly_mode\n");
+
+	const auto startTime = std::chrono::steady_clock::now();
+	ReplayStatistics statistics;
+	std::vector<RawIMUSample> samples;
+
+	for (const auto &record : records)
+	{
+		switch (record.m_Type)
+		{
+		case BlackboxRecordType::IMU:
+			// The samples of a sensor read are followed by the attitude it produced.
+			samples.push_back(GetRawSample(record));
+			break;
+
+		case BlackboxRecordType::Attitude:
+			SetReplayTime(record.m_Timestamp);
+			g_ReplayBus.setSamples(samples.data(), samples.size());
+			samples.clear();
+			Stabilizer::Instance().update();
+			break;
+
+		case BlackboxRecordType::Inputs:
+			SetReplayTime(record.m_Timestamp);
+			ReplayInputs(record);
+			break;
+
+		case BlackboxRecordType::Actuators:
+			SetReplayTime(record.m_Timestamp);
+			ReplayActuators(record, statistics);
+			break;
+
+		case BlackboxRecordType::Calibration:
+			ReplayCalibration(record);
+			break;
+
+		default:
+			break;
+		}
+
+		BlackboxSystem::Instance().update();
+	}
+
+	BlackboxSystem::Instance().stop();
+
+	const auto duration = (records.back().m_Timestamp - startTimestamp) * 1e-6;
+	const auto wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+	fprintf(stderr, "Replayed %.1f s in %.3f s (%.0fx real time).\n", duration, wallTime, duration / wallTime);
+
+	if (log.getDamagedBlocks() > 0 || log.getLostBlocks() > 0)
+		fprintf(stderr, "%u damaged and %u lost blocks were skipped.\n", static_cast<unsigned int>(log.getDamagedBlocks()), static_cast<unsigned int>(log.getLostBlocks()));
+
+	fprintf(stderr, "%u of %u actuator frames match the log (maximum difference: rotors %.2f, servos %d).", static_cast<unsigned int>(statistics.m_MatchingFrames),
+			static_cast<unsigned int>(statistics.m_Frames), static_cast<double>(statistics.m_MaximumRotorDifference), statistics.m_MaximumServoDifference);
+
+	if (statistics.m_MatchingFrames != statistics.m_Frames)
+		fprintf(stderr, " The first mismatch is at %u us.", static_cast<unsigned int>(statistics.m_FirstMismatch));
+
+	fprintf(stderr, "\n");
+	return 0;
+}
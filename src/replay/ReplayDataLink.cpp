@@ -0,0 +1,18 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ReplayDataLink.hpp"
+
+void ReplayDataLink::setFrame(const Setpoint &inputs, uint32_t timestamp, FlyMode flyMode, ControlMode controlMode)
+{
+	m_Inputs = inputs;
+	m_Timestamp = timestamp;
+	m_FlyMode = flyMode;
+	m_ControlMode = controlMode;
+}
+
+void ReplayDataLink::onUpdate()
+{
+	g_RequiredFlyMode = m_FlyMode;
+	g_ControlMode = m_ControlMode;
+}
@@ -0,0 +1,84 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "core/IDataLink.hpp"
+
+/**
+ * @brief Replay data link class.
+ * This returns the recorded inputs of the data link frames. The fly mode and the control mode are set on the update, like the real data
+ * links do.
+ */
+class ReplayDataLink final : public IDataLink
+{
+public:
+	/**
+	 * @brief Construct a new Replay Data Link object.
+	 */
+	ReplayDataLink() = default;
+
+	/**
+	 * @brief Set the frame returned by the next updates.
+	 *
+	 * @param inputs The inputs.
+	 * @param timestamp The data link's timestamp of the frame.
+	 * @param flyMode The required fly mode.
+	 * @param controlMode The control mode.
+	 */
+	void setFrame(const Setpoint &inputs, uint32_t timestamp, FlyMode flyMode, ControlMode controlMode);
+
+	/**
+	 * @brief On initialize method.
+	 * There is nothing to initialize.
+	 */
+	void onInitialize() override {}
+
+	/**
+	 * @brief On update method.
+	 * Set the fly mode and the control mode of the frame.
+	 */
+	void onUpdate() override;
+
+	/**
+	 * @brief On get thrust method.
+	 *
+	 * @return The recorded thrust.
+	 */
+	[[nodiscard]] float onGetThrust() override { return m_Inputs.m_Thrust; }
+
+	/**
+	 * @brief On get pitch method.
+	 *
+	 * @return The recorded pitch.
+	 */
+	[[nodiscard]] float onGetPitch() override { return m_Inputs.m_Pitch; }
+
+	/**
+	 * @brief On get roll method.
+	 *
+	 * @return The recorded roll.
+	 */
+	[[nodiscard]] float onGetRoll() override { return m_Inputs.m_Roll; }
+
+	/**
+	 * @brief On get yaw method.
+	 *
+	 * @return The recorded yaw.
+	 */
+	[[nodiscard]] float onGetYaw() override { return m_Inputs.m_Yaw; }
+
+	/**
+	 * @brief On get timestamp method.
+	 *
+	 * @return The recorded timestamp of the frame.
+	 */
+	[[nodiscard]] uint32_t onGetTimestamp() override { return m_Timestamp; }
+
+private:
+	Setpoint m_Inputs;
+	uint32_t m_Timestamp = 0;
+
+	FlyMode m_FlyMode = FlyMode::Hover;
+	ControlMode m_ControlMode = ControlMode::Angle;
+};
\ No newline at end of file
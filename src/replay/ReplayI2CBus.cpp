@@ -0,0 +1,74 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ReplayI2CBus.hpp"
+
+#include <string.h>
+
+/**
+ * @brief Write a value as a big endian word, like the sensor's registers.
+ *
+ * @param value The value.
+ * @param pData The output.
+ */
+static void EncodeWord(int16_t value, uint8_t *pData)
+{
+	pData[0] = static_cast<uint8_t>(static_cast<uint16_t>(value) >> 8);
+	pData[1] = static_cast<uint8_t>(static_cast<uint16_t>(value) & 0xFF);
+}
+
+void ReplayI2CBus::setSamples(const RawIMUSample *pSamples, size_t count)
+{
+	m_FIFOSize = 0;
+	m_FIFOHead = 0;
+
+	for (size_t i = 0; i < count && m_FIFOSize + g_MPU6050FIFORecordSize <= sizeof(m_FIFO); i++)
+	{
+		// The FIFO records are the accelerometer and the gyroscope. The burst has the temperature in between, which is not recorded.
+		for (uint8_t j = 0; j < 3; j++)
+		{
+			EncodeWord(pSamples[i].m_Accelerometer[j], m_FIFO + m_FIFOSize + (j * 2));
+			EncodeWord(pSamples[i].m_Gyroscope[j], m_FIFO + m_FIFOSize + 6 + (j * 2));
+		}
+
+		memcpy(m_Burst, m_FIFO + m_FIFOSize, 6);
+		memcpy(m_Burst + 8, m_FIFO + m_FIFOSize + 6, 6);
+		m_FIFOSize += g_MPU6050FIFORecordSize;
+	}
+}
+
+bool ReplayI2CBus::onReadRegisters(uint8_t address, uint8_t reg, uint8_t *pData, size_t size)
+{
+	if (address != g_MPU6050Address)
+		return false;
+
+	memset(pData, 0, size);
+
+	switch (static_cast<MPU6050Register>(reg))
+	{
+	case MPU6050Register::WhoAmI:
+		pData[0] = g_MPU6050Identity;
+		break;
+
+	case MPU6050Register::FIFOCount:
+		if (size >= 2)
+			EncodeWord(static_cast<int16_t>(m_FIFOSize - m_FIFOHead), pData);
+
+		break;
+
+	case MPU6050Register::FIFOReadWrite:
+		for (size_t i = 0; i < size && m_FIFOHead < m_FIFOSize; i++)
+			pData[i] = m_FIFO[m_FIFOHead++];
+
+		break;
+
+	case MPU6050Register::AccelerometerX:
+		memcpy(pData, m_Burst, size < sizeof(m_Burst) ? size : sizeof(m_Burst));
+		break;
+
+	default:
+		break;
+	}
+
+	return true;
+}
@@ -0,0 +1,62 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "core/II2CBus.hpp"
+#include "components/MPU6050Registers.hpp"
+
+/**
+ * @brief Replay I2C bus class.
+ * This acts as an MPU6050 which returns recorded samples, so they go through the driver the same way as in flight. The samples of a
+ * sensor read are put into the FIFO, and the last one also into the data registers (which is what a burst read returns).
+ */
+class ReplayI2CBus final : public II2CBus
+{
+public:
+	/**
+	 * @brief Construct a new Replay I2C Bus object.
+	 */
+	ReplayI2CBus() = default;
+
+	/**
+	 * @brief Set the samples returned by the next reads.
+	 * The samples which were not read yet are dropped.
+	 *
+	 * @param pSamples The raw samples.
+	 * @param count The number of samples. The ones which don't fit into the FIFO are dropped.
+	 */
+	void setSamples(const RawIMUSample *pSamples, size_t count);
+
+	/**
+	 * @brief On write register method.
+	 * The writes are ignored.
+	 *
+	 * @param address The device address.
+	 * @param reg The register to write to.
+	 * @param value The value to write.
+	 * @return true If the address is the sensor's.
+	 * @return false If the address is not the sensor's.
+	 */
+	bool onWriteRegister(uint8_t address, uint8_t reg, uint8_t value) override { return address == g_MPU6050Address; }
+
+	/**
+	 * @brief On read registers method.
+	 * Read the identity, the FIFO count, the FIFO data or the data registers. The other registers read as 0.
+	 *
+	 * @param address The device address.
+	 * @param reg The first register to read from.
+	 * @param pData The buffer to read the data to.
+	 * @param size The number of bytes to read.
+	 * @return true If the address is the sensor's.
+	 * @return false If the address is not the sensor's.
+	 */
+	bool onReadRegisters(uint8_t address, uint8_t reg, uint8_t *pData, size_t size) override;
+
+private:
+	uint8_t m_FIFO[g_MPU6050FIFOSize] = {};
+	size_t m_FIFOSize = 0;
+	size_t m_FIFOHead = 0;
+
+	uint8_t m_Burst[g_MPU6050BurstSize] = {};
+};
\ No newline at end of file
@@ -0,0 +1,109 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ReplayLog.hpp"
+
+#include <algorithm>
+#include <stdio.h>
+#include <string.h>
+
+bool ReplayLog::load(const char *pPath)
+{
+	FILE *pFile = fopen(pPath, "rb");
+	if (!pFile)
+		return false;
+
+	std::vector<uint8_t> data;
+	uint8_t buffer[g_BlackboxBlockSize];
+	size_t size = 0;
+	while ((size = fread(buffer, 1, sizeof(buffer), pFile)) > 0)
+		data.insert(data.end(), buffer, buffer + size);
+
+	fclose(pFile);
+
+	m_Records.clear();
+	m_DamagedBlocks = 0;
+	m_LostBlocks = 0;
+
+	// The records are sorted by their time since the start of the log, so the clock can wrap around.
+	std::vector<int64_t> times;
+	int64_t time = 0;
+	uint32_t previousTimestamp = 0;
+
+	const uint8_t magic[] = {'P', 'B', 'B', 'X'};
+	BlackboxDecoder decoder;
+	bool hasSequence = false;
+	uint32_t sequence = 0;
+	size_t offset = 0;
+	while (offset + sizeof(magic) <= data.size())
+	{
+		const auto pStart = std::search(data.begin() + offset, data.end(), magic, magic + sizeof(magic));
+		if (pStart == data.end())
+			break;
+
+		offset = pStart - data.begin();
+		const auto blockSize = decoder.setBlock(data.data() + offset, data.size() - offset);
+		if (blockSize == 0)
+		{
+			m_DamagedBlocks++;
+			offset++;
+			continue;
+		}
+
+		std::vector<BlackboxRecord> records;
+		BlackboxRecord record;
+		while (decoder.decode(record))
+			records.push_back(record);
+
+		if (decoder.isDamaged())
+		{
+			m_DamagedBlocks++;
+			offset++;
+			continue;
+		}
+
+		// A download of the blackbox partition holds every log since it was erased, and the blocks of every log are numbered from 0. Only
+		// the last log is kept.
+		const auto &header = decoder.getHeader();
+		if (hasSequence && header.m_Sequence == 0)
+		{
+			m_Records.clear();
+			times.clear();
+			time = 0;
+			m_DamagedBlocks = 0;
+			m_LostBlocks = 0;
+		}
+		else if (hasSequence && header.m_Sequence > sequence)
+			m_LostBlocks += header.m_Sequence - sequence - 1;
+
+		hasSequence = true;
+		sequence = header.m_Sequence;
+
+		for (const auto &decoded : records)
+		{
+			if (!m_Records.empty())
+				time += static_cast<int32_t>(decoded.m_Timestamp - previousTimestamp);
+
+			previousTimestamp = decoded.m_Timestamp;
+			times.push_back(time);
+			m_Records.push_back(decoded);
+		}
+
+		offset += blockSize;
+	}
+
+	std::vector<size_t> order(m_Records.size());
+	for (size_t i = 0; i < order.size(); i++)
+		order[i] = i;
+
+	std::stable_sort(order.begin(), order.end(), [&times](size_t first, size_t second)
+					 { return times[first] < times[second]; });
+
+	std::vector<BlackboxRecord> sorted;
+	sorted.reserve(m_Records.size());
+	for (const auto index : order)
+		sorted.push_back(m_Records[index]);
+
+	m_Records.swap(sorted);
+	return true;
+}
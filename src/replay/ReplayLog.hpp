@@ -0,0 +1,59 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "algorithms/BlackboxDecoder.hpp"
+
+#include <vector>
+
+/**
+ * @brief Replay log class.
+ * This loads a whole blackbox log and decodes it. When the file holds several logs (a download of the blackbox partition), the last one is
+ * loaded. Damaged blocks are skipped and counted. The records of both cores are mixed in the log,
+ * so they are put back in time order (the records with the same time keep the order of the log).
+ */
+class ReplayLog final
+{
+public:
+	/**
+	 * @brief Construct a new Replay Log object.
+	 */
+	ReplayLog() = default;
+
+	/**
+	 * @brief Load and decode a log.
+	 *
+	 * @param pPath The path of the log file.
+	 * @return true If the file was read.
+	 * @return false If the file could not be read.
+	 */
+	bool load(const char *pPath);
+
+	/**
+	 * @brief Get the records.
+	 *
+	 * @return The records in time order.
+	 */
+	[[nodiscard]] const std::vector<BlackboxRecord> &getRecords() const { return m_Records; }
+
+	/**
+	 * @brief Get the number of damaged blocks.
+	 *
+	 * @return The damaged block count.
+	 */
+	[[nodiscard]] uint32_t getDamagedBlocks() const { return m_DamagedBlocks; }
+
+	/**
+	 * @brief Get the number of blocks which are missing from the sequence (they could not be written).
+	 *
+	 * @return The lost block count.
+	 */
+	[[nodiscard]] uint32_t getLostBlocks() const { return m_LostBlocks; }
+
+private:
+	std::vector<BlackboxRecord> m_Records;
+
+	uint32_t m_DamagedBlocks = 0;
+	uint32_t m_LostBlocks = 0;
+};
\ No newline at end of file
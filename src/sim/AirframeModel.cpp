@@ -0,0 +1,192 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#include "AirframeModel.hpp"
+
+constexpr auto g_DegreesToRadians = 0.017453292519943295;
+
+// A touchdown faster than this is considered a crash (m/s).
+constexpr auto g_CrashVelocity = 2.0;
+
+/**
+ * @brief Move a value towards a target by a limited step.
+ *
+ * @param current The current value.
+ * @param target The target value.
+ * @param maximumStep The maximum step.
+ * @return The new value.
+ */
+static double MoveTowards(double current, double target, double maximumStep)
+{
+	if (target > current + maximumStep)
+		return current + maximumStep;
+
+	if (target < current - maximumStep)
+		return current - maximumStep;
+
+	return target;
+}
+
+AirframeModel::AirframeModel(const AirframeParameters &parameters)
+	: m_Parameters(parameters)
+{
+	m_State.m_SpecificForce = {0, 0, -g_SimulatedGravity};
+}
+
+void AirframeModel::step(const ActuatorCommands &commands, double deltaTime)
+{
+	updateActuators(commands, deltaTime);
+
+	Vector3 force;
+	Vector3 moment;
+	computeForces(force, moment);
+
+	const auto acceleration = (Rotate(m_State.m_Orientation, force) * (1.0 / m_Parameters.m_Mass)) + Vector3{0, 0, g_SimulatedGravity};
+
+	// Resting on the ground until the forces are enough to lift off. The ground pushes back against gravity.
+	if (m_State.m_OnGround && acceleration.m_Z >= 0)
+	{
+		m_State.m_Velocity = {};
+		m_State.m_AngularVelocity = {};
+		m_State.m_SpecificForce = InverseRotate(m_State.m_Orientation, {0, 0, -g_SimulatedGravity});
+		return;
+	}
+
+	m_State.m_OnGround = false;
+	m_State.m_SpecificForce = force * (1.0 / m_Parameters.m_Mass);
+
+	// Semi-implicit Euler integration.
+	m_State.m_Velocity += acceleration * deltaTime;
+	m_State.m_Position += m_State.m_Velocity * deltaTime;
+
+	const auto &inertia = m_Parameters.m_Inertia;
+	const auto &rate = m_State.m_AngularVelocity;
+	const auto torque = moment - Cross(rate, Scale(inertia, rate));
+	m_State.m_AngularVelocity += Vector3{torque.m_X / inertia.m_X, torque.m_Y / inertia.m_Y, torque.m_Z / inertia.m_Z} * deltaTime;
+
+	const auto halfStep = m_State.m_AngularVelocity * (0.5 * deltaTime);
+	const auto derivative = m_State.m_Orientation * Quaternion{0, halfStep.m_X, halfStep.m_Y, halfStep.m_Z};
+	m_State.m_Orientation = Normalize({m_State.m_Orientation.m_W + derivative.m_W, m_State.m_Orientation.m_X + derivative.m_X, m_State.m_Orientation.m_Y + derivative.m_Y, m_State.m_Orientation.m_Z + derivative.m_Z});
+
+	handleGroundContact();
+}
+
+void AirframeModel::updateActuators(const ActuatorCommands &commands, double deltaTime)
+{
+	const double rotorCommands[] = {commands.m_LeftRotor, commands.m_RightRotor};
+	const auto pulseRange = static_cast<double>(m_Parameters.m_RotorMaximumPulse - m_Parameters.m_RotorMinimumPulse);
+	const auto rotorResponse = deltaTime / (m_Parameters.m_RotorTimeConstant + deltaTime);
+
+	for (int i = 0; i < 2; i++)
+	{
+		auto throttle = (rotorCommands[i] - m_Parameters.m_RotorMinimumPulse) / pulseRange;
+		throttle = throttle < 0 ? 0 : (throttle > 1 ? 1 : throttle);
+
+		// The static thrust is proportional to the square of the rotor speed, which is roughly proportional to the throttle.
+		const auto targetThrust = m_Parameters.m_MaximumThrust * throttle * throttle;
+		m_Thrust[i] += (targetThrust - m_Thrust[i]) * rotorResponse;
+	}
+
+	// The right wing servo is mounted mirrored.
+	const auto servoStep = m_Parameters.m_ServoRate * deltaTime;
+	const auto tiltScale = 90.0 / (m_Parameters.m_WingCruiseAngle - m_Parameters.m_WingHoverAngle);
+	const double wingAngles[] = {
+		getServoAngle(commands.m_LeftWing, m_Parameters.m_WingHoverAngle),
+		180.0 - getServoAngle(commands.m_RightWing, 180.0 - m_Parameters.m_WingHoverAngle)};
+
+	for (int i = 0; i < 2; i++)
+		m_Tilt[i] = MoveTowards(m_Tilt[i], (wingAngles[i] - m_Parameters.m_WingHoverAngle) * tiltScale, servoStep * tiltScale);
+
+	m_Elevator = MoveTowards(m_Elevator, getServoAngle(commands.m_Elevator, m_Parameters.m_SurfaceCenterAngle) - m_Parameters.m_SurfaceCenterAngle, servoStep);
+	m_Rudder = MoveTowards(m_Rudder, getServoAngle(commands.m_Rudder, m_Parameters.m_SurfaceCenterAngle) - m_Parameters.m_SurfaceCenterAngle, servoStep);
+}
+
+void AirframeModel::computeForces(Vector3 &force, Vector3 &moment) const
+{
+	force = {};
+	moment = {};
+
+	for (int i = 0; i < 2; i++)
+	{
+		const auto side = i == 0 ? -1.0 : 1.0;
+		const auto tilt = m_Tilt[i] * g_DegreesToRadians;
+
+		// The rotor thrust tilts forward with the wing half.
+		const Vector3 direction = {sin(tilt), 0, -cos(tilt)};
+		const Vector3 rotorPosition = {m_Parameters.m_RotorPosition.m_X, m_Parameters.m_RotorPosition.m_Y * side, m_Parameters.m_RotorPosition.m_Z};
+		const auto thrust = direction * m_Thrust[i];
+		force += thrust;
+		moment += Cross(rotorPosition, thrust);
+
+		// The rotors are counter rotating, so the reaction torques cancel out when the thrust is equal.
+		moment += direction * (side * m_Parameters.m_RotorTorqueCoefficient * m_Thrust[i]);
+
+		// The wing's chord is perpendicular to the rotor axis.
+		const Vector3 wingPosition = {m_Parameters.m_WingPosition.m_X, m_Parameters.m_WingPosition.m_Y * side, m_Parameters.m_WingPosition.m_Z};
+		const auto wingForce = computeSurfaceForce(wingPosition, (90.0 - m_Tilt[i]) * g_DegreesToRadians, m_Parameters.m_WingArea, false);
+		force += wingForce;
+		moment += Cross(wingPosition, wingForce);
+	}
+
+	// Positive elevator angles raise the trailing edge (nose up) and positive rudder angles yaw the nose to the right.
+	const auto tailForce = computeSurfaceForce(m_Parameters.m_TailPosition, -m_Elevator * m_Parameters.m_SurfaceEffectiveness * g_DegreesToRadians, m_Parameters.m_TailArea, false);
+	force += tailForce;
+	moment += Cross(m_Parameters.m_TailPosition, tailForce);
+
+	const auto finForce = computeSurfaceForce(m_Parameters.m_FinPosition, m_Rudder * m_Parameters.m_SurfaceEffectiveness * g_DegreesToRadians, m_Parameters.m_FinArea, true);
+	force += finForce;
+	moment += Cross(m_Parameters.m_FinPosition, finForce);
+
+	moment -= Scale(m_Parameters.m_AngularDamping, m_State.m_AngularVelocity);
+}
+
+Vector3 AirframeModel::computeSurfaceForce(const Vector3 &position, double incidence, double area, bool isVertical) const
+{
+	// The velocity of the surface through the (still) air.
+	const auto velocity = InverseRotate(m_State.m_Orientation, m_State.m_Velocity) + Cross(m_State.m_AngularVelocity, position);
+	const auto normal = isVertical ? velocity.m_Y : velocity.m_Z;
+
+	const auto speed = sqrt((velocity.m_X * velocity.m_X) + (normal * normal));
+	if (speed < 0.1)
+		return {};
+
+	// Flat plate like coefficients which are valid through the whole range of angles, since the wing sees 90 degrees when hovering.
+	const auto angleOfAttack = atan2(normal, velocity.m_X) + incidence;
+	const auto lift = 0.5 * m_Parameters.m_LiftSlope * sin(2.0 * angleOfAttack);
+	const auto drag = m_Parameters.m_ZeroLiftDrag + (m_Parameters.m_MaximumDrag * sin(angleOfAttack) * sin(angleOfAttack));
+
+	// The lift is perpendicular to the velocity and the drag is against it.
+	const auto scale = 0.5 * m_Parameters.m_AirDensity * speed * area;
+	const auto forward = ((normal * lift) - (velocity.m_X * drag)) * scale;
+	const auto across = ((-velocity.m_X * lift) - (normal * drag)) * scale;
+
+	if (isVertical)
+		return {forward, across, 0};
+
+	return {forward, 0, across};
+}
+
+void AirframeModel::handleGroundContact()
+{
+	if (m_State.m_Position.m_Z < 0)
+		return;
+
+	if (m_State.m_Velocity.m_Z > g_CrashVelocity)
+		m_HasCrashed = true;
+
+	// Land on the landing gear, keeping the heading.
+	const auto angles = GetEulerAngles(m_State.m_Orientation);
+	m_State.m_Position.m_Z = 0;
+	m_State.m_Velocity = {};
+	m_State.m_AngularVelocity = {};
+	m_State.m_Orientation = MakeQuaternion(0, 0, angles.m_Z);
+	m_State.m_OnGround = true;
+}
+
+double AirframeModel::getServoAngle(int pulseWidth, double defaultAngle) const
+{
+	if (pulseWidth <= 0)
+		return defaultAngle;
+
+	return (pulseWidth - m_Parameters.m_ServoMinimumPulse) * 180.0 / (m_Parameters.m_ServoMaximumPulse - m_Parameters.m_ServoMinimumPulse);
+}
@@ -0,0 +1,186 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "SimMath.hpp"
+
+// The world frame is north-east-down and the body frame is forward-right-down, with the origin at the center of gravity.
+constexpr auto g_SimulatedGravity = 9.80665;
+
+/**
+ * @brief Airframe parameters structure.
+ * The defaults describe a small (~1.2 kg) two rotor tilt-wing. Positions are given for the right side, the left side is mirrored.
+ */
+struct AirframeParameters final
+{
+	double m_Mass = 1.2; // kg
+	Vector3 m_Inertia = {0.025, 0.018, 0.040}; // kg m^2 (roll, pitch, yaw)
+	Vector3 m_AngularDamping = {0.015, 0.020, 0.015}; // N m s/rad
+	double m_AirDensity = 1.225; // kg/m^3
+
+	// Rotors.
+	Vector3 m_RotorPosition = {0.0, 0.32, -0.04}; // m
+	double m_MaximumThrust = 10.0; // N, per rotor at full throttle.
+	double m_RotorTimeConstant = 0.04; // s
+	double m_RotorTorqueCoefficient = 0.016; // m, reaction torque per Newton of thrust.
+	int m_RotorMinimumPulse = 1000; // us
+	int m_RotorMaximumPulse = 2000; // us
+
+	// Servos. The wing servos are linked so that the rotors point up at the hover angle and forward at the cruise angle.
+	int m_ServoMinimumPulse = 544; // us
+	int m_ServoMaximumPulse = 2400; // us
+	double m_ServoRate = 600.0; // deg/s
+	double m_WingHoverAngle = 22.5; // deg
+	double m_WingCruiseAngle = 157.5; // deg
+	double m_SurfaceCenterAngle = 90.0; // deg
+
+	// Aerodynamic surfaces. Each wing half tilts with its rotor.
+	Vector3 m_WingPosition = {-0.02, 0.25, -0.04}; // m
+	double m_WingArea = 0.09; // m^2, per half.
+	Vector3 m_TailPosition = {-0.55, 0.0, -0.02}; // m
+	double m_TailArea = 0.035; // m^2
+	Vector3 m_FinPosition = {-0.55, 0.0, -0.10}; // m
+	double m_FinArea = 0.02; // m^2
+	double m_LiftSlope = 4.5; // 1/rad
+	double m_ZeroLiftDrag = 0.04;
+	double m_MaximumDrag = 1.2;
+	double m_SurfaceEffectiveness = 0.5; // The change in the angle of attack per control surface deflection.
+};
+
+/**
+ * @brief Actuator commands structure.
+ * These are the pulse widths of the actuators as written by the controller.
+ */
+struct ActuatorCommands final
+{
+	// The rotor pulses are not rounded, so the resolution of the digital ESC protocols reaches the model.
+	double m_LeftRotor = 0;
+	double m_RightRotor = 0;
+	int m_LeftWing = 0;
+	int m_RightWing = 0;
+	int m_Elevator = 0;
+	int m_Rudder = 0;
+};
+
+/**
+ * @brief Airframe state structure.
+ */
+struct AirframeState final
+{
+	Vector3 m_Position; // World frame, m.
+	Vector3 m_Velocity; // World frame, m/s.
+	Quaternion m_Orientation; // Body to world.
+	Vector3 m_AngularVelocity; // Body frame, rad/s.
+	Vector3 m_SpecificForce; // Body frame, m/s^2. This is what an accelerometer measures.
+	bool m_OnGround = true;
+};
+
+/**
+ * @brief Airframe model class.
+ * This is a 6 degrees of freedom rigid body model of the tilt-wing. It models the rotor thrust (with the motor lag), the wing tilt, the
+ * lift and drag of the wing halves, tail and fin, the elevator and rudder, and a flat ground. The actuators move towards the commanded
+ * positions at a limited rate, like the real servos.
+ */
+class AirframeModel final
+{
+public:
+	/**
+	 * @brief Construct a new Airframe Model object.
+	 *
+	 * @param parameters The airframe parameters.
+	 */
+	explicit AirframeModel(const AirframeParameters &parameters = AirframeParameters());
+
+	/**
+	 * @brief Step the model.
+	 *
+	 * @param commands The actuator commands.
+	 * @param deltaTime The time step in seconds.
+	 */
+	void step(const ActuatorCommands &commands, double deltaTime);
+
+	/**
+	 * @brief Get the state.
+	 *
+	 * @return The airframe state.
+	 */
+	[[nodiscard]] const AirframeState &getState() const { return m_State; }
+
+	/**
+	 * @brief Get the thrust of a rotor.
+	 *
+	 * @param rotor The rotor index (0 = left, 1 = right).
+	 * @return The thrust in Newtons.
+	 */
+	[[nodiscard]] double getThrust(int rotor) const { return m_Thrust[rotor]; }
+
+	/**
+	 * @brief Get the tilt of a wing half.
+	 *
+	 * @param wing The wing index (0 = left, 1 = right).
+	 * @return The tilt angle from the vertical in degrees (0 = hover, 90 = cruise).
+	 */
+	[[nodiscard]] double getTilt(int wing) const { return m_Tilt[wing]; }
+
+	/**
+	 * @brief Check if the airframe hit the ground too hard.
+	 *
+	 * @return true If the airframe crashed.
+	 * @return false If the airframe did not crash.
+	 */
+	[[nodiscard]] bool hasCrashed() const { return m_HasCrashed; }
+
+private:
+	/**
+	 * @brief Move the actuators towards the commanded positions.
+	 *
+	 * @param commands The actuator commands.
+	 * @param deltaTime The time step in seconds.
+	 */
+	void updateActuators(const ActuatorCommands &commands, double deltaTime);
+
+	/**
+	 * @brief Compute the force and the moment acting on the airframe in the body frame (without gravity).
+	 *
+	 * @param force The computed force.
+	 * @param moment The computed moment around the center of gravity.
+	 */
+	void computeForces(Vector3 &force, Vector3 &moment) const;
+
+	/**
+	 * @brief Compute the aerodynamic force of a lifting surface.
+	 *
+	 * @param position The position of the surface.
+	 * @param incidence The incidence angle of the surface in radians.
+	 * @param area The area of the surface.
+	 * @param isVertical Whether the surface is vertical (the fin).
+	 * @return The force in the body frame.
+	 */
+	[[nodiscard]] Vector3 computeSurfaceForce(const Vector3 &position, double incidence, double area, bool isVertical) const;
+
+	/**
+	 * @brief Handle the contact with the ground.
+	 */
+	void handleGroundContact();
+
+	/**
+	 * @brief Convert a servo pulse width to an angle.
+	 *
+	 * @param pulseWidth The pulse width in microseconds.
+	 * @param defaultAngle The angle to use when the servo is not driven.
+	 * @return The angle in degrees.
+	 */
+	[[nodiscard]] double getServoAngle(int pulseWidth, double defaultAngle) const;
+
+private:
+	AirframeParameters m_Parameters;
+	AirframeState m_State;
+
+	double m_Thrust[2] = {};
+	double m_Tilt[2] = {};
+	double m_Elevator = 0;
+	double m_Rudder = 0;
+
+	bool m_HasCrashed = false;
+};
\ No newline at end of file
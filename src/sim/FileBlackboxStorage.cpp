@@ -0,0 +1,29 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#include "FileBlackboxStorage.hpp"
+
+FileBlackboxStorage::~FileBlackboxStorage()
+{
+	if (m_pFile)
+		fclose(m_pFile);
+}
+
+bool FileBlackboxStorage::onOpen()
+{
+	m_pFile = fopen(m_pPath, "wb");
+	return m_pFile != nullptr;
+}
+
+bool FileBlackboxStorage::onWrite(const uint8_t *pData, size_t size)
+{
+	return fwrite(pData, 1, size, m_pFile) == size;
+}
+
+void FileBlackboxStorage::onClose()
+{
+	if (m_pFile)
+		fclose(m_pFile);
+
+	m_pFile = nullptr;
+}
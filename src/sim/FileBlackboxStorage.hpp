@@ -0,0 +1,59 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "core/IBlackboxStorage.hpp"
+
+#include <stdio.h>
+
+/**
+ * @brief File blackbox storage class.
+ * This stores the blackbox log in a plain file on the host, so the whole recorder runs in the simulation and the logs can be decoded and
+ * replayed like the ones downloaded from the aircraft.
+ */
+class FileBlackboxStorage final : public IBlackboxStorage
+{
+public:
+	/**
+	 * @brief Construct a new File Blackbox Storage object.
+	 *
+	 * @param pPath The path of the log file. It's replaced if it exists.
+	 */
+	explicit FileBlackboxStorage(const char *pPath) : m_pPath(pPath) {}
+
+	/**
+	 * @brief Destroy the File Blackbox Storage object.
+	 */
+	~FileBlackboxStorage();
+
+	/**
+	 * @brief On open method.
+	 * Create the log file.
+	 *
+	 * @return true If the file was created.
+	 * @return false If the file could not be created.
+	 */
+	bool onOpen() override;
+
+	/**
+	 * @brief On write method.
+	 * Append the block to the log file.
+	 *
+	 * @param pData The block.
+	 * @param size The size of the block.
+	 * @return true If the block was written.
+	 * @return false If the block could not be written.
+	 */
+	bool onWrite(const uint8_t *pData, size_t size) override;
+
+	/**
+	 * @brief On close method.
+	 * Close the log file.
+	 */
+	void onClose() override;
+
+private:
+	const char *m_pPath = nullptr;
+	FILE *m_pFile = nullptr;
+};
\ No newline at end of file
@@ -0,0 +1,72 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "core/IRecordStorage.hpp"
+
+#include <stdio.h>
+
+/**
+ * @brief File record storage class.
+ * This stores a record in a plain file on the host, so a simulation starts with the calibration and the parameters of a previous run, like
+ * the aircraft does after the first boot.
+ *
+ * @tparam Type The stored type. It must have a RecordCodec.
+ */
+template <class Type>
+class FileRecordStorage final : public IRecordStorage<Type>
+{
+	using Record = typename RecordCodec<Type>::Record;
+
+public:
+	/**
+	 * @brief Construct a new File Record Storage object.
+	 *
+	 * @param pPath The path of the file. It's created when the value is first stored.
+	 */
+	explicit FileRecordStorage(const char *pPath) : m_pPath(pPath) {}
+
+	/**
+	 * @brief On load method.
+	 * Read the record from the file.
+	 *
+	 * @param value The value to read to.
+	 * @return true If an intact record of the current version was read.
+	 * @return false If the file doesn't exist, or the record is damaged or of another version.
+	 */
+	bool onLoad(Type &value) override
+	{
+		auto pFile = fopen(m_pPath, "rb");
+		if (!pFile)
+			return false;
+
+		Record record;
+		const auto size = fread(&record, 1, sizeof(record), pFile);
+		fclose(pFile);
+
+		return size == sizeof(record) && RecordCodec<Type>::Decode(record, value);
+	}
+
+	/**
+	 * @brief On save method.
+	 * Replace the file with the record.
+	 *
+	 * @param value The value to store.
+	 * @return true If the file was written.
+	 * @return false If the file could not be written.
+	 */
+	bool onSave(const Type &value) override
+	{
+		auto pFile = fopen(m_pPath, "wb");
+		if (!pFile)
+			return false;
+
+		const auto record = RecordCodec<Type>::Encode(value);
+		const auto size = fwrite(&record, 1, sizeof(record), pFile);
+		return fclose(pFile) == 0 && size == sizeof(record);
+	}
+
+private:
+	const char *m_pPath = nullptr;
+};
\ No newline at end of file
@@ -0,0 +1,112 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#include "GroundStation.hpp"
+
+#include <string.h>
+
+void GroundStation::send(const ControlMessage &message, uint64_t time)
+{
+	TelemetryHeader header;
+	header.m_ID = TelemetryMessageID::Control;
+	header.m_Sequence = m_Sequence++;
+	header.m_Timestamp = static_cast<uint32_t>(time);
+
+	FrameInFlight frame;
+	frame.m_Data.resize(g_MaxEncodedPacketSize);
+	frame.m_Data.resize(EncodePacket(header, &message, sizeof(message), frame.m_Data.data()));
+	frame.m_DeliveryTime = getDeliveryTime(m_Uplink, time);
+	m_Sent++;
+
+	const auto error = std::uniform_real_distribution<double>(0.0, 1.0)(m_Random);
+	if (error < g_GroundStationLossRate)
+	{
+		m_Lost++;
+		return;
+	}
+
+	// Flip a bit in between the delimiters.
+	if (error < g_GroundStationLossRate + g_GroundStationErrorRate)
+	{
+		const auto index = 1 + (m_Random() % (frame.m_Data.size() - 2));
+		frame.m_Data[index] ^= static_cast<uint8_t>(1 << (m_Random() % 8));
+		m_Damaged++;
+	}
+
+	m_Uplink.push_back(std::move(frame));
+}
+
+void GroundStation::update(uint64_t time)
+{
+	while (!m_Uplink.empty() && m_Uplink.front().m_DeliveryTime <= time)
+	{
+		const auto &frame = m_Uplink.front();
+		m_Transport.inject(frame.m_Data.data(), frame.m_Data.size());
+		m_Uplink.pop_front();
+	}
+
+	// The replies of the controller go through the radio too.
+	uint8_t buffer[g_LoopbackBufferSize];
+	const auto size = m_Transport.drain(buffer, sizeof(buffer));
+	if (size > 0)
+	{
+		FrameInFlight frame;
+		frame.m_Data.assign(buffer, buffer + size);
+		frame.m_DeliveryTime = getDeliveryTime(m_Downlink, time);
+		m_Downlink.push_back(std::move(frame));
+	}
+
+	while (!m_Downlink.empty() && m_Downlink.front().m_DeliveryTime <= time)
+	{
+		for (const auto value : m_Downlink.front().m_Data)
+		{
+			if (m_Decoder.decode(value))
+				handleReport(time);
+		}
+
+		m_Downlink.pop_front();
+	}
+}
+
+void GroundStation::printStatistics(FILE *pFile) const
+{
+	fprintf(pFile, "Ground station: sent %u control messages, %u were lost and %u were damaged on the way.\n", m_Sent, m_Lost, m_Damaged);
+	if (m_Reports == 0)
+	{
+		fprintf(pFile, "Ground station: no link quality report was received.\n");
+		return;
+	}
+
+	fprintf(pFile, "Controller: received %u, lost %u, errors %u, jitter %u us (last report).\n", m_Report.m_Received, m_Report.m_Lost,
+			m_Report.m_Errors, m_Report.m_Jitter);
+	fprintf(pFile, "Round trip time: %u / %llu / %u us (minimum / mean / maximum of %u reports).\n", m_MinimumRoundTrip,
+			static_cast<unsigned long long>(m_TotalRoundTrip / m_Reports), m_MaximumRoundTrip, m_Reports);
+}
+
+uint64_t GroundStation::getDeliveryTime(const std::deque<FrameInFlight> &link, uint64_t time)
+{
+	const auto jitter = std::uniform_int_distribution<uint32_t>(0, g_GroundStationJitter)(m_Random);
+	const auto deliveryTime = time + g_GroundStationLatency + jitter;
+
+	if (!link.empty() && deliveryTime < link.back().m_DeliveryTime)
+		return link.back().m_DeliveryTime;
+
+	return deliveryTime;
+}
+
+void GroundStation::handleReport(uint64_t time)
+{
+	if (m_Decoder.getHeader().m_ID != TelemetryMessageID::LinkQuality || m_Decoder.getMessageSize() != sizeof(LinkQualityMessage))
+		return;
+
+	memcpy(&m_Report, m_Decoder.getMessage(), sizeof(m_Report));
+	if (m_Report.m_Received == 0)
+		return;
+
+	// The time since the echoed control message was sent, minus the time the controller held on to it.
+	const auto roundTrip = static_cast<uint32_t>(time) - m_Report.m_RemoteTimestamp - m_Report.m_Age;
+	m_MinimumRoundTrip = roundTrip < m_MinimumRoundTrip ? roundTrip : m_MinimumRoundTrip;
+	m_MaximumRoundTrip = roundTrip > m_MaximumRoundTrip ? roundTrip : m_MaximumRoundTrip;
+	m_TotalRoundTrip += roundTrip;
+	m_Reports++;
+}
@@ -0,0 +1,141 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "LoopbackTransport.hpp"
+
+#include "algorithms/PacketCodec.hpp"
+
+#include <deque>
+#include <random>
+#include <stdio.h>
+#include <vector>
+
+// The ground station sends a control message every 4 ms, almost twice as often as the iBus receiver.
+constexpr uint32_t g_GroundStationPeriod = 4000;
+
+// The radio delays the frames by 2 ms plus up to 3 ms of jitter in each direction (microseconds).
+constexpr uint32_t g_GroundStationLatency = 2000;
+constexpr uint32_t g_GroundStationJitter = 3000;
+
+// A fraction of the control messages is lost, and another fraction is damaged (a bit is flipped).
+constexpr auto g_GroundStationLossRate = 0.02;
+constexpr auto g_GroundStationErrorRate = 0.01;
+
+/**
+ * @brief Ground station class.
+ * This is the simulation's stand-in for a ground station connected through a radio modem. It sends the control messages through the
+ * loopback transport, loses and damages some of them on the way, and receives the link quality reports of the controller to measure the
+ * round trip time. At the end, the statistics of both sides can be compared.
+ */
+class GroundStation final
+{
+	/**
+	 * @brief Frame in flight structure.
+	 * This is a frame which is on its way through the radio.
+	 */
+	struct FrameInFlight final
+	{
+		uint64_t m_DeliveryTime = 0;
+		std::vector<uint8_t> m_Data;
+	};
+
+public:
+	/**
+	 * @brief Construct a new Ground Station object.
+	 *
+	 * @param transport The controller's transport.
+	 * @param seed The seed of the radio errors.
+	 */
+	GroundStation(LoopbackTransport &transport, uint64_t seed) : m_Transport(transport), m_Random(seed) {}
+
+	/**
+	 * @brief Send a control message.
+	 *
+	 * @param message The message.
+	 * @param time The ground station time in microseconds.
+	 */
+	void send(const ControlMessage &message, uint64_t time);
+
+	/**
+	 * @brief Deliver the frames which went through the radio in both directions.
+	 * This should be called on every simulation step.
+	 *
+	 * @param time The ground station time in microseconds.
+	 */
+	void update(uint64_t time);
+
+	/**
+	 * @brief Print the link statistics.
+	 *
+	 * @param pFile The file to print to.
+	 */
+	void printStatistics(FILE *pFile) const;
+
+	/**
+	 * @brief Get the last link quality report received from the controller.
+	 *
+	 * @return The report.
+	 */
+	[[nodiscard]] const LinkQualityMessage &getReport() const { return m_Report; }
+
+	/**
+	 * @brief Get the number of link quality reports which were used to measure the round trip time.
+	 *
+	 * @return The report count.
+	 */
+	[[nodiscard]] uint32_t getReportCount() const { return m_Reports; }
+
+	/**
+	 * @brief Get the shortest round trip time.
+	 *
+	 * @return The round trip time in microseconds.
+	 */
+	[[nodiscard]] uint32_t getMinimumRoundTrip() const { return m_MinimumRoundTrip; }
+
+	/**
+	 * @brief Get the longest round trip time.
+	 *
+	 * @return The round trip time in microseconds.
+	 */
+	[[nodiscard]] uint32_t getMaximumRoundTrip() const { return m_MaximumRoundTrip; }
+
+private:
+	/**
+	 * @brief Get the delivery time of a frame.
+	 * The frames of a direction are delivered in order.
+	 *
+	 * @param link The frames in flight in the direction of the frame.
+	 * @param time The time at which the frame is sent.
+	 * @return The delivery time.
+	 */
+	[[nodiscard]] uint64_t getDeliveryTime(const std::deque<FrameInFlight> &link, uint64_t time);
+
+	/**
+	 * @brief Handle a link quality report received from the controller.
+	 *
+	 * @param time The ground station time in microseconds.
+	 */
+	void handleReport(uint64_t time);
+
+private:
+	LoopbackTransport &m_Transport;
+	std::mt19937_64 m_Random;
+
+	std::deque<FrameInFlight> m_Uplink;
+	std::deque<FrameInFlight> m_Downlink;
+
+	PacketDecoder m_Decoder;
+	LinkQualityMessage m_Report;
+
+	uint16_t m_Sequence = 0;
+	uint32_t m_Sent = 0;
+	uint32_t m_Lost = 0;
+	uint32_t m_Damaged = 0;
+
+	uint32_t m_Reports = 0;
+	uint32_t m_MinimumRoundTrip = UINT32_MAX;
+	uint32_t m_MaximumRoundTrip = 0;
+	uint64_t m_TotalRoundTrip = 0;
+};
\ No newline at end of file
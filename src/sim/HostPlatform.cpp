@@ -0,0 +1,246 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#include "HostPlatform.hpp"
+
+#include <Arduino.h>
+#include <ESP32Servo.h>
+
+// The maximum number of items recorded per RMT channel.
+constexpr auto g_MaxRMTItems = 64;
+
+// The UART's transmit FIFO is 128 bytes deep.
+constexpr auto g_SerialTransmitBufferSize = 128;
+
+// 8 data bits, a start bit and a stop bit.
+constexpr auto g_SerialBitsPerByte = 10;
+
+static uint64_t s_HostTime = 0;
+static void (*s_InterruptHandlers[g_MaxHostPins])() = {};
+static int s_PulseWidths[g_MaxHostPins] = {};
+static uint32_t s_TaskNotifications = 0;
+static FILE *s_pSerialOutput = nullptr;
+
+static int s_RMTPins[RMT_CHANNEL_MAX] = {-1, -1, -1, -1, -1, -1, -1, -1};
+static rmt_item32_t s_RMTItems[RMT_CHANNEL_MAX][g_MaxRMTItems] = {};
+static size_t s_RMTItemCounts[RMT_CHANNEL_MAX] = {};
+
+// The serial port is rate limited like the real one, so the telemetry sees the same back pressure as it does on the controller.
+static unsigned long s_SerialBaudRate = 115200;
+static uint64_t s_SerialIdleTime = 0;
+
+HardwareSerial Serial(0);
+HardwareSerial Serial2(2);
+EspClass ESP;
+
+void AdvanceHostTime(uint32_t microseconds)
+{
+	s_HostTime += microseconds;
+}
+
+uint64_t GetHostTime()
+{
+	return s_HostTime;
+}
+
+void RaiseHostInterrupt(uint8_t pin)
+{
+	if (pin < g_MaxHostPins && s_InterruptHandlers[pin])
+		s_InterruptHandlers[pin]();
+}
+
+int GetHostPulseWidth(uint8_t pin)
+{
+	return pin < g_MaxHostPins ? s_PulseWidths[pin] : 0;
+}
+
+void SetHostPulseWidth(uint8_t pin, int pulseWidth)
+{
+	if (pin < g_MaxHostPins)
+		s_PulseWidths[pin] = pulseWidth;
+}
+
+size_t GetHostRMTItems(uint8_t pin, rmt_item32_t *pItems, size_t size)
+{
+	for (uint8_t i = 0; i < RMT_CHANNEL_MAX; i++)
+	{
+		if (s_RMTPins[i] != pin)
+			continue;
+
+		const auto count = s_RMTItemCounts[i] < size ? s_RMTItemCounts[i] : size;
+		memcpy(pItems, s_RMTItems[i], count * sizeof(rmt_item32_t));
+		return count;
+	}
+
+	return 0;
+}
+
+void SetHostSerialOutput(FILE *pFile)
+{
+	s_pSerialOutput = pFile;
+}
+
+unsigned long micros()
+{
+	// The controller's clock is 32 bits wide, so it wraps around the same way.
+	return static_cast<uint32_t>(s_HostTime);
+}
+
+unsigned long millis()
+{
+	return static_cast<uint32_t>(s_HostTime / 1000);
+}
+
+void delay(uint32_t milliseconds)
+{
+	AdvanceHostTime(milliseconds * 1000);
+}
+
+void delayMicroseconds(uint32_t microseconds)
+{
+	AdvanceHostTime(microseconds);
+}
+
+long map(long x, long in_min, long in_max, long out_min, long out_max)
+{
+	return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+}
+
+void attachInterrupt(uint8_t interrupt, void (*pCallback)(), int mode)
+{
+	if (interrupt < g_MaxHostPins)
+		s_InterruptHandlers[interrupt] = pCallback;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle()
+{
+	// The simulation runs every task on the same thread, so there's only one task to notify.
+	return &s_TaskNotifications;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearCountOnExit, TickType_t ticksToWait)
+{
+	// Nothing else can raise a notification while waiting, so this never blocks.
+	const auto notifications = s_TaskNotifications;
+	s_TaskNotifications = clearCountOnExit ? 0 : (notifications > 0 ? notifications - 1 : 0);
+	return notifications;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t taskHandle, BaseType_t *pHigherPriorityTaskWoken)
+{
+	if (taskHandle)
+		s_TaskNotifications++;
+}
+
+void HardwareSerial::begin(unsigned long baud)
+{
+	if (m_Port == 0)
+		s_SerialBaudRate = baud;
+}
+
+int HardwareSerial::available()
+{
+	return static_cast<int>(m_ReceiveCount);
+}
+
+int HardwareSerial::read()
+{
+	if (m_ReceiveCount == 0)
+		return -1;
+
+	const auto value = m_ReceiveBuffer[m_ReceiveHead];
+	m_ReceiveHead = (m_ReceiveHead + 1) % g_SerialReceiveBufferSize;
+	m_ReceiveCount--;
+	return value;
+}
+
+int HardwareSerial::availableForWrite()
+{
+	if (m_Port != 0)
+		return g_SerialTransmitBufferSize;
+
+	// The bytes still in the transmit buffer are the ones that could not be shifted out since the line went idle.
+	const auto byteTime = 1000000 * g_SerialBitsPerByte / s_SerialBaudRate;
+	const auto pending = s_SerialIdleTime > s_HostTime ? (s_SerialIdleTime - s_HostTime + byteTime - 1) / byteTime : 0;
+	return pending < g_SerialTransmitBufferSize ? static_cast<int>(g_SerialTransmitBufferSize - pending) : 0;
+}
+
+size_t HardwareSerial::write(const uint8_t *pData, size_t size)
+{
+	if (m_Port != 0)
+		return size;
+
+	const auto byteTime = 1000000 * g_SerialBitsPerByte / s_SerialBaudRate;
+	s_SerialIdleTime = (s_SerialIdleTime > s_HostTime ? s_SerialIdleTime : s_HostTime) + (byteTime * size);
+
+	if (s_pSerialOutput)
+		fwrite(pData, 1, size, s_pSerialOutput);
+
+	return size;
+}
+
+void HardwareSerial::receive(const uint8_t *pData, size_t size)
+{
+	// The bytes which do not fit in the buffer are lost, like on the UART.
+	for (size_t i = 0; i < size && m_ReceiveCount < g_SerialReceiveBufferSize; i++)
+		m_ReceiveBuffer[(m_ReceiveHead + m_ReceiveCount++) % g_SerialReceiveBufferSize] = pData[i];
+
+	if (m_ReceiveCallback)
+		m_ReceiveCallback();
+}
+
+uint32_t EspClass::getCycleCount()
+{
+	return static_cast<uint32_t>(s_HostTime * g_HostCPUFrequency);
+}
+
+int Servo::attach(int pin, int minimum, int maximum)
+{
+	m_Pin = pin;
+	m_Minimum = minimum;
+	m_Maximum = maximum;
+	return pin;
+}
+
+void Servo::write(int value)
+{
+	// Same as the library, small values are angles and the rest are pulse widths.
+	if (value < m_Minimum)
+	{
+		value = value < 0 ? 0 : (value > 180 ? 180 : value);
+		value = static_cast<int>(::map(value, 0, 180, m_Minimum, m_Maximum));
+	}
+
+	writeMicroseconds(value);
+}
+
+void Servo::writeMicroseconds(int value)
+{
+	m_PulseWidth = value < m_Minimum ? m_Minimum : (value > m_Maximum ? m_Maximum : value);
+
+	if (m_Pin >= 0)
+		SetHostPulseWidth(static_cast<uint8_t>(m_Pin), m_PulseWidth);
+}
+
+esp_err_t rmt_config(const rmt_config_t *pConfig)
+{
+	s_RMTPins[pConfig->channel] = pConfig->gpio_num;
+	return ESP_OK;
+}
+
+esp_err_t rmt_driver_install(rmt_channel_t channel, size_t rxBufferSize, int interruptFlags)
+{
+	return ESP_OK;
+}
+
+esp_err_t rmt_write_items(rmt_channel_t channel, const rmt_item32_t *pItems, int itemCount, bool waitTransmitDone)
+{
+	const auto count = static_cast<size_t>(itemCount) < g_MaxRMTItems ? static_cast<size_t>(itemCount) : g_MaxRMTItems;
+	memcpy(s_RMTItems[channel], pItems, count * sizeof(rmt_item32_t));
+	s_RMTItemCounts[channel] = count;
+	return ESP_OK;
+}
@@ -0,0 +1,74 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <driver/rmt.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// The simulation's side of the host platform (see include/Arduino.h). The controller only sees the Arduino, FreeRTOS and Servo
+// interfaces while the simulation drives the virtual clock, raises the interrupts, reads the actuators (servo pulses and RMT frames) and sends the receiver's frames to
+// the serial port.
+
+constexpr auto g_MaxHostPins = 40;
+
+/**
+ * @brief Advance the virtual clock.
+ * Nothing happens on its own when the time advances, the simulation decides what to run.
+ *
+ * @param microseconds The time to advance by.
+ */
+void AdvanceHostTime(uint32_t microseconds);
+
+/**
+ * @brief Get the virtual time.
+ * Unlike micros(), this does not wrap around.
+ *
+ * @return The time in microseconds since the start of the simulation.
+ */
+[[nodiscard]] uint64_t GetHostTime();
+
+/**
+ * @brief Raise an interrupt on a pin.
+ * This calls the interrupt handler attached to the pin (if any).
+ *
+ * @param pin The pin to raise the interrupt on.
+ */
+void RaiseHostInterrupt(uint8_t pin);
+
+/**
+ * @brief Get the pulse width last written to a pin.
+ *
+ * @param pin The pin to read.
+ * @return The pulse width in microseconds. 0 if nothing was written to the pin.
+ */
+[[nodiscard]] int GetHostPulseWidth(uint8_t pin);
+
+/**
+ * @brief Set the pulse width of a pin.
+ * This is used by the Servo class.
+ *
+ * @param pin The pin to write.
+ * @param pulseWidth The pulse width in microseconds.
+ */
+void SetHostPulseWidth(uint8_t pin, int pulseWidth);
+
+/**
+ * @brief Get the items last written to the RMT channel of a pin.
+ *
+ * @param pin The pin to read.
+ * @param pItems The buffer to copy the items to.
+ * @param size The size of the buffer in items.
+ * @return The number of items. 0 if nothing was written to the pin.
+ */
+[[nodiscard]] size_t GetHostRMTItems(uint8_t pin, rmt_item32_t *pItems, size_t size);
+
+/**
+ * @brief Set the file the serial output is written to.
+ * The output is discarded when the file is nullptr (the default).
+ *
+ * @param pFile The file pointer.
+ */
+void SetHostSerialOutput(FILE *pFile);
\ No newline at end of file
@@ -0,0 +1,111 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "core/ITransport.hpp"
+#include "core/RingBuffer.hpp"
+
+// The size of the loopback buffers in each direction.
+constexpr auto g_LoopbackBufferSize = 1024;
+
+/**
+ * @brief Loopback transport class.
+ * This connects the controller to the simulation. The simulation injects the bytes sent by the ground station, which raises the receive
+ * callback immediately like the UART receive event, and drains the bytes the controller sends back.
+ */
+class LoopbackTransport final : public ITransport
+{
+public:
+	/**
+	 * @brief Construct a new Loopback Transport object.
+	 */
+	LoopbackTransport() = default;
+
+	/**
+	 * @brief On initialize method.
+	 *
+	 * @param callback The callback to call when bytes were injected.
+	 */
+	void onInitialize(TransportReceiveCallback callback) override { m_ReceiveCallback = callback; }
+
+	/**
+	 * @brief On read method.
+	 * Read the injected bytes.
+	 *
+	 * @param pData The buffer to read the bytes to.
+	 * @param size The size of the buffer.
+	 * @return The number of bytes read.
+	 */
+	size_t onRead(uint8_t *pData, size_t size) override { return transfer(m_ReceiveBuffer, pData, size); }
+
+	/**
+	 * @brief On write method.
+	 * Queue the bytes for the simulation.
+	 *
+	 * @param pData The bytes to write.
+	 * @param size The number of bytes.
+	 * @return The number of bytes written. 0 if there was not enough room.
+	 */
+	size_t onWrite(const uint8_t *pData, size_t size) override { return m_TransmitBuffer.write(pData, size) ? size : 0; }
+
+	/**
+	 * @brief Inject bytes sent to the controller.
+	 * The bytes which do not fit are dropped.
+	 *
+	 * @param pData The bytes.
+	 * @param size The number of bytes.
+	 */
+	void inject(const uint8_t *pData, size_t size)
+	{
+		if (m_ReceiveBuffer.write(pData, size) && m_ReceiveCallback)
+			m_ReceiveCallback();
+	}
+
+	/**
+	 * @brief Drain the bytes sent by the controller.
+	 *
+	 * @param pData The buffer to read the bytes to.
+	 * @param size The size of the buffer.
+	 * @return The number of bytes read.
+	 */
+	size_t drain(uint8_t *pData, size_t size) { return transfer(m_TransmitBuffer, pData, size); }
+
+private:
+	/**
+	 * @brief Move bytes out of a buffer.
+	 *
+	 * @param buffer The buffer to read from.
+	 * @param pData The buffer to read the bytes to.
+	 * @param size The size of the buffer.
+	 * @return The number of bytes read.
+	 */
+	static size_t transfer(RingBuffer<g_LoopbackBufferSize> &buffer, uint8_t *pData, size_t size)
+	{
+		size_t count = 0;
+		const uint8_t *pSource = nullptr;
+		while (count < size)
+		{
+			auto available = buffer.peek(&pSource);
+			if (available == 0)
+				break;
+
+			if (available > size - count)
+				available = size - count;
+
+			for (size_t i = 0; i < available; i++)
+				pData[count + i] = pSource[i];
+
+			buffer.consume(available);
+			count += available;
+		}
+
+		return count;
+	}
+
+private:
+	TransportReceiveCallback m_ReceiveCallback;
+
+	RingBuffer<g_LoopbackBufferSize> m_ReceiveBuffer;
+	RingBuffer<g_LoopbackBufferSize> m_TransmitBuffer;
+};
\ No newline at end of file
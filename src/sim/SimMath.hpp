@@ -0,0 +1,122 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <math.h>
+
+// The simulation runs on the host, so the physics is computed in double precision.
+
+/**
+ * @brief 3D vector structure.
+ */
+struct Vector3 final
+{
+	double m_X = 0;
+	double m_Y = 0;
+	double m_Z = 0;
+};
+
+inline Vector3 operator+(const Vector3 &lhs, const Vector3 &rhs) { return {lhs.m_X + rhs.m_X, lhs.m_Y + rhs.m_Y, lhs.m_Z + rhs.m_Z}; }
+inline Vector3 operator-(const Vector3 &lhs, const Vector3 &rhs) { return {lhs.m_X - rhs.m_X, lhs.m_Y - rhs.m_Y, lhs.m_Z - rhs.m_Z}; }
+inline Vector3 operator*(const Vector3 &lhs, double rhs) { return {lhs.m_X * rhs, lhs.m_Y * rhs, lhs.m_Z * rhs}; }
+inline Vector3 &operator+=(Vector3 &lhs, const Vector3 &rhs) { return lhs = lhs + rhs; }
+inline Vector3 &operator-=(Vector3 &lhs, const Vector3 &rhs) { return lhs = lhs - rhs; }
+
+inline double Dot(const Vector3 &lhs, const Vector3 &rhs) { return (lhs.m_X * rhs.m_X) + (lhs.m_Y * rhs.m_Y) + (lhs.m_Z * rhs.m_Z); }
+inline double Length(const Vector3 &vector) { return sqrt(Dot(vector, vector)); }
+
+inline Vector3 Cross(const Vector3 &lhs, const Vector3 &rhs)
+{
+	return {(lhs.m_Y * rhs.m_Z) - (lhs.m_Z * rhs.m_Y), (lhs.m_Z * rhs.m_X) - (lhs.m_X * rhs.m_Z), (lhs.m_X * rhs.m_Y) - (lhs.m_Y * rhs.m_X)};
+}
+
+// Element wise product.
+inline Vector3 Scale(const Vector3 &lhs, const Vector3 &rhs) { return {lhs.m_X * rhs.m_X, lhs.m_Y * rhs.m_Y, lhs.m_Z * rhs.m_Z}; }
+
+/**
+ * @brief Quaternion structure.
+ * This is used as the rotation from the body frame to the world frame.
+ */
+struct Quaternion final
+{
+	double m_W = 1;
+	double m_X = 0;
+	double m_Y = 0;
+	double m_Z = 0;
+};
+
+inline Quaternion operator*(const Quaternion &lhs, const Quaternion &rhs)
+{
+	return {
+		(lhs.m_W * rhs.m_W) - (lhs.m_X * rhs.m_X) - (lhs.m_Y * rhs.m_Y) - (lhs.m_Z * rhs.m_Z),
+		(lhs.m_W * rhs.m_X) + (lhs.m_X * rhs.m_W) + (lhs.m_Y * rhs.m_Z) - (lhs.m_Z * rhs.m_Y),
+		(lhs.m_W * rhs.m_Y) - (lhs.m_X * rhs.m_Z) + (lhs.m_Y * rhs.m_W) + (lhs.m_Z * rhs.m_X),
+		(lhs.m_W * rhs.m_Z) + (lhs.m_X * rhs.m_Y) - (lhs.m_Y * rhs.m_X) + (lhs.m_Z * rhs.m_W)};
+}
+
+inline Quaternion Normalize(const Quaternion &quaternion)
+{
+	const auto length = sqrt((quaternion.m_W * quaternion.m_W) + (quaternion.m_X * quaternion.m_X) + (quaternion.m_Y * quaternion.m_Y) + (quaternion.m_Z * quaternion.m_Z));
+	return {quaternion.m_W / length, quaternion.m_X / length, quaternion.m_Y / length, quaternion.m_Z / length};
+}
+
+/**
+ * @brief Rotate a vector by a quaternion (body to world).
+ *
+ * @param quaternion The rotation.
+ * @param vector The vector to rotate.
+ * @return The rotated vector.
+ */
+inline Vector3 Rotate(const Quaternion &quaternion, const Vector3 &vector)
+{
+	const Vector3 axis = {quaternion.m_X, quaternion.m_Y, quaternion.m_Z};
+	const auto t = Cross(axis, vector) * 2.0;
+	return vector + (t * quaternion.m_W) + Cross(axis, t);
+}
+
+/**
+ * @brief Rotate a vector by the inverse of a quaternion (world to body).
+ *
+ * @param quaternion The rotation.
+ * @param vector The vector to rotate.
+ * @return The rotated vector.
+ */
+inline Vector3 InverseRotate(const Quaternion &quaternion, const Vector3 &vector)
+{
+	return Rotate({quaternion.m_W, -quaternion.m_X, -quaternion.m_Y, -quaternion.m_Z}, vector);
+}
+
+/**
+ * @brief Create a quaternion from Euler angles (Z-Y-X order).
+ *
+ * @param roll The roll angle in radians.
+ * @param pitch The pitch angle in radians.
+ * @param yaw The yaw angle in radians.
+ * @return The quaternion.
+ */
+inline Quaternion MakeQuaternion(double roll, double pitch, double yaw)
+{
+	const auto cr = cos(roll * 0.5), sr = sin(roll * 0.5);
+	const auto cp = cos(pitch * 0.5), sp = sin(pitch * 0.5);
+	const auto cy = cos(yaw * 0.5), sy = sin(yaw * 0.5);
+
+	return {(cr * cp * cy) + (sr * sp * sy), (sr * cp * cy) - (cr * sp * sy), (cr * sp * cy) + (sr * cp * sy), (cr * cp * sy) - (sr * sp * cy)};
+}
+
+/**
+ * @brief Get the Euler angles (Z-Y-X order) of a quaternion.
+ *
+ * @param quaternion The quaternion.
+ * @return The roll (X), pitch (Y) and yaw (Z) angles in radians.
+ */
+inline Vector3 GetEulerAngles(const Quaternion &quaternion)
+{
+	const auto &q = quaternion;
+	const auto sinPitch = 2.0 * ((q.m_W * q.m_Y) - (q.m_Z * q.m_X));
+
+	return {
+		atan2(2.0 * ((q.m_W * q.m_X) + (q.m_Y * q.m_Z)), 1.0 - (2.0 * ((q.m_X * q.m_X) + (q.m_Y * q.m_Y)))),
+		asin(sinPitch < -1.0 ? -1.0 : (sinPitch > 1.0 ? 1.0 : sinPitch)),
+		atan2(2.0 * ((q.m_W * q.m_Z) + (q.m_X * q.m_Y)), 1.0 - (2.0 * ((q.m_Y * q.m_Y) + (q.m_Z * q.m_Z))))};
+}
\ No newline at end of file
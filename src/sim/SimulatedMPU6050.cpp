@@ -0,0 +1,194 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#include "SimulatedMPU6050.hpp"
+#include "HostPlatform.hpp"
+
+#include "components/MPU6050.hpp"
+
+constexpr auto g_RadiansToDegrees = 57.29577951308232;
+
+// The internal sample rate when the digital low pass filter is enabled.
+constexpr auto g_InternalSampleRate = 1000;
+
+// Noise densities from the datasheet (RMS over the filter bandwidth).
+constexpr auto g_AccelerometerNoiseDensity = 400e-6 * g_SimulatedGravity; // m/s^2 per sqrt(Hz)
+constexpr auto g_GyroscopeNoiseDensity = 0.005; // deg/s per sqrt(Hz)
+
+// The vibration of each sensor axis relative to the roll rate (Y). The specific force vibrates by this much per degree per second.
+constexpr Vector3 g_VibrationRateShape = {0.4, 1.0, 0.6};
+constexpr Vector3 g_VibrationForceShape = {0.02, 0.02, 0.05};
+
+// The bandwidth of the accelerometer for each DLPF_CFG value.
+constexpr double g_FilterBandwidths[] = {260, 184, 94, 44, 21, 10, 5, 260};
+
+SimulatedMPU6050::SimulatedMPU6050(uint64_t seed)
+	: m_NoiseState(seed ? seed : 1)
+{
+	m_Registers[static_cast<uint8_t>(MPU6050Register::WhoAmI)] = g_MPU6050Identity;
+}
+
+void SimulatedMPU6050::sample(const AirframeState &state)
+{
+	// The sensor is asleep until the clock is selected.
+	if (getRegister(MPU6050Register::PowerManagement1) & 0x40)
+		return;
+
+	// The body frame is forward-right-down, the sensor's X is to the right, Y to the front and Z up.
+	Vector3 force = {state.m_SpecificForce.m_Y, state.m_SpecificForce.m_X, -state.m_SpecificForce.m_Z};
+	Vector3 rate = Vector3{state.m_AngularVelocity.m_Y, state.m_AngularVelocity.m_X, -state.m_AngularVelocity.m_Z} * g_RadiansToDegrees;
+
+	const auto period = getSamplePeriod() * 1e-6;
+	m_VibrationPhase = fmod(m_VibrationPhase + (2.0 * M_PI * m_VibrationFrequency * period), 2.0 * M_PI);
+
+	const auto vibration = sin(m_VibrationPhase) * m_VibrationAmplitude;
+	rate += g_VibrationRateShape * vibration;
+	force += g_VibrationForceShape * vibration;
+
+	// The digital low pass filter, approximated by a first order filter.
+	const auto bandwidth = g_FilterBandwidths[getRegister(MPU6050Register::Configuration) & 0x07];
+	const auto response = 1.0 - exp(-2.0 * M_PI * bandwidth * period);
+	m_FilteredForce += (force - m_FilteredForce) * response;
+	m_FilteredRate += (rate - m_FilteredRate) * response;
+
+	const auto accelerometerRange = static_cast<MPU6050AccelerometerRange>((getRegister(MPU6050Register::AccelerometerConfiguration) >> 3) & 0x03);
+	const auto gyroscopeRange = static_cast<MPU6050GyroscopeRange>((getRegister(MPU6050Register::GyroscopeConfiguration) >> 3) & 0x03);
+	const auto accelerometerScale = GetMPU6050AccelerometerSensitivity(accelerometerRange) / g_SimulatedGravity;
+	const auto gyroscopeScale = static_cast<double>(GetMPU6050GyroscopeSensitivity(gyroscopeRange));
+
+	const auto accelerometerNoise = g_AccelerometerNoiseDensity * sqrt(bandwidth);
+	const auto gyroscopeNoise = g_GyroscopeNoiseDensity * sqrt(bandwidth);
+	const auto accelerometer = Vector3{m_FilteredForce.m_X + (getNoise() * accelerometerNoise), m_FilteredForce.m_Y + (getNoise() * accelerometerNoise), m_FilteredForce.m_Z + (getNoise() * accelerometerNoise)} * accelerometerScale;
+	const auto gyroscope = (m_FilteredRate + m_GyroscopeBias + Vector3{getNoise() * gyroscopeNoise, getNoise() * gyroscopeNoise, getNoise() * gyroscopeNoise}) * gyroscopeScale;
+
+	writeWord(MPU6050Register::AccelerometerX, lround(accelerometer.m_X));
+	writeWord(static_cast<MPU6050Register>(0x3D), lround(accelerometer.m_Y));
+	writeWord(static_cast<MPU6050Register>(0x3F), lround(accelerometer.m_Z));
+	writeWord(MPU6050Register::Temperature, lround((m_Temperature - 36.53) * 340.0));
+	writeWord(MPU6050Register::GyroscopeX, lround(gyroscope.m_X));
+	writeWord(static_cast<MPU6050Register>(0x45), lround(gyroscope.m_Y));
+	writeWord(static_cast<MPU6050Register>(0x47), lround(gyroscope.m_Z));
+
+	// Queue the accelerometer and gyroscope registers (without the temperature), in the register order.
+	if ((getRegister(MPU6050Register::UserControl) & g_MPU6050UserControlFIFOEnable) && getRegister(MPU6050Register::FIFOEnable) == g_MPU6050FIFOAccelerometerAndGyroscope)
+	{
+		for (uint8_t i = 0; i < 6; i++)
+			pushFIFO(m_Registers[static_cast<uint8_t>(MPU6050Register::AccelerometerX) + i]);
+
+		for (uint8_t i = 0; i < 6; i++)
+			pushFIFO(m_Registers[static_cast<uint8_t>(MPU6050Register::GyroscopeX) + i]);
+	}
+
+	if (getRegister(MPU6050Register::InterruptEnable) & g_MPU6050InterruptDataReady)
+	{
+		m_Registers[static_cast<uint8_t>(MPU6050Register::InterruptStatus)] |= g_MPU6050InterruptDataReady;
+		RaiseHostInterrupt(g_MPU6050InterruptPin);
+	}
+}
+
+uint32_t SimulatedMPU6050::getSamplePeriod() const
+{
+	return (1000000 / g_InternalSampleRate) * (1 + getRegister(MPU6050Register::SampleRateDivider));
+}
+
+bool SimulatedMPU6050::onWriteRegister(uint8_t address, uint8_t reg, uint8_t value)
+{
+	if (address != g_MPU6050Address || reg >= sizeof(m_Registers))
+		return false;
+
+	if (reg == static_cast<uint8_t>(MPU6050Register::PowerManagement1) && (value & g_MPU6050DeviceReset))
+	{
+		// Everything goes back to the power on state, which is asleep.
+		memset(m_Registers, 0, sizeof(m_Registers));
+		m_Registers[static_cast<uint8_t>(MPU6050Register::WhoAmI)] = g_MPU6050Identity;
+		m_Registers[reg] = 0x40;
+		m_FIFOCount = 0;
+		return true;
+	}
+
+	if (reg == static_cast<uint8_t>(MPU6050Register::UserControl) && (value & g_MPU6050UserControlFIFOReset))
+	{
+		m_FIFOCount = 0;
+		value &= ~g_MPU6050UserControlFIFOReset;
+	}
+
+	m_Registers[reg] = value;
+	return true;
+}
+
+bool SimulatedMPU6050::onReadRegisters(uint8_t address, uint8_t reg, uint8_t *pData, size_t size)
+{
+	if (address != g_MPU6050Address)
+		return false;
+
+	for (size_t i = 0; i < size; i++)
+	{
+		// The FIFO data register does not auto increment.
+		if (reg == static_cast<uint8_t>(MPU6050Register::FIFOReadWrite))
+		{
+			pData[i] = 0;
+			if (m_FIFOCount > 0)
+			{
+				pData[i] = m_FIFO[m_FIFOHead];
+				m_FIFOHead = (m_FIFOHead + 1) % g_MPU6050FIFOSize;
+				m_FIFOCount--;
+			}
+
+			continue;
+		}
+
+		const auto current = static_cast<uint8_t>(reg + i);
+		if (current >= sizeof(m_Registers))
+			return false;
+
+		if (current == static_cast<uint8_t>(MPU6050Register::FIFOCount))
+			pData[i] = static_cast<uint8_t>(m_FIFOCount >> 8);
+		else if (current == static_cast<uint8_t>(MPU6050Register::FIFOCount) + 1)
+			pData[i] = static_cast<uint8_t>(m_FIFOCount & 0xFF);
+		else
+			pData[i] = m_Registers[current];
+	}
+
+	// The interrupt status is cleared on any read when the latch clear mode is set.
+	if (getRegister(MPU6050Register::InterruptPinConfiguration) & g_MPU6050InterruptClearOnRead)
+		m_Registers[static_cast<uint8_t>(MPU6050Register::InterruptStatus)] = 0;
+
+	return true;
+}
+
+double SimulatedMPU6050::getNoise()
+{
+	// xorshift64* and the Box-Muller transform. This is deterministic, unlike the standard library's distributions.
+	const auto next = [this]()
+	{
+		m_NoiseState ^= m_NoiseState >> 12;
+		m_NoiseState ^= m_NoiseState << 25;
+		m_NoiseState ^= m_NoiseState >> 27;
+		return static_cast<double>((m_NoiseState * 0x2545F4914F6CDD1DULL) >> 11) * (1.0 / 9007199254740992.0);
+	};
+
+	const auto first = next();
+	const auto second = next();
+	return sqrt(-2.0 * log(first + 1e-300)) * cos(2.0 * M_PI * second);
+}
+
+void SimulatedMPU6050::writeWord(MPU6050Register reg, int value)
+{
+	value = value < -32768 ? -32768 : (value > 32767 ? 32767 : value);
+
+	const auto index = static_cast<uint8_t>(reg);
+	m_Registers[index] = static_cast<uint8_t>((value >> 8) & 0xFF);
+	m_Registers[index + 1] = static_cast<uint8_t>(value & 0xFF);
+}
+
+void SimulatedMPU6050::pushFIFO(uint8_t value)
+{
+	if (m_FIFOCount == g_MPU6050FIFOSize)
+	{
+		m_FIFOHead = (m_FIFOHead + 1) % g_MPU6050FIFOSize;
+		m_FIFOCount--;
+	}
+
+	m_FIFO[(m_FIFOHead + m_FIFOCount) % g_MPU6050FIFOSize] = value;
+	m_FIFOCount++;
+}
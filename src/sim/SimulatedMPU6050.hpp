@@ -0,0 +1,145 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "AirframeModel.hpp"
+
+#include "core/II2CBus.hpp"
+#include "components/MPU6050Registers.hpp"
+
+/**
+ * @brief Simulated MPU6050 class.
+ * This is a register level model of the MPU6050 behind the I2C bus interface, so the real driver runs on top of it. Every sample is
+ * computed from the airframe state (and the vibration of the rotors), passed through the configured digital low pass filter, offset by
+ * the gyroscope bias, made noisy and quantized. The samples are queued in the FIFO (when enabled) and the data ready interrupt is raised like on the real sensor.
+ *
+ * The sensor is mounted with X along the right wing, Y to the front and Z up.
+ */
+class SimulatedMPU6050 final : public II2CBus
+{
+public:
+	/**
+	 * @brief Construct a new Simulated MPU6050 object.
+	 *
+	 * @param seed The noise seed. The same seed always produces the same samples.
+	 */
+	explicit SimulatedMPU6050(uint64_t seed = 1);
+
+	/**
+	 * @brief Sample the airframe.
+	 * This should be called once every sample period (see getSamplePeriod()).
+	 *
+	 * @param state The airframe state.
+	 */
+	void sample(const AirframeState &state);
+
+	/**
+	 * @brief Set the gyroscope bias.
+	 *
+	 * @param bias The bias of each sensor axis in degrees per second.
+	 */
+	void setGyroscopeBias(const Vector3 &bias) { m_GyroscopeBias = bias; }
+
+	/**
+	 * @brief Set the die temperature.
+	 *
+	 * @param temperature The temperature in celsius.
+	 */
+	void setTemperature(double temperature) { m_Temperature = temperature; }
+
+	/**
+	 * @brief Set the vibration of the rotors.
+	 * The vibration is a sine which is added to the rates and the specific force. It's strongest on the roll axis, since the rotors are
+	 * at the wing tips.
+	 *
+	 * @param frequency The frequency in hertz.
+	 * @param amplitude The amplitude of the roll rate in degrees per second.
+	 */
+	void setVibration(double frequency, double amplitude)
+	{
+		m_VibrationFrequency = frequency;
+		m_VibrationAmplitude = amplitude;
+	}
+
+	/**
+	 * @brief Get the sample period set by the sample rate divider.
+	 *
+	 * @return The period in microseconds.
+	 */
+	[[nodiscard]] uint32_t getSamplePeriod() const;
+
+	/**
+	 * @brief On write register method.
+	 * Write a single byte to a device register.
+	 *
+	 * @param address The device address.
+	 * @param reg The register to write to.
+	 * @param value The value to write.
+	 * @return true If the device acknowledged the write.
+	 * @return false If the transfer failed.
+	 */
+	bool onWriteRegister(uint8_t address, uint8_t reg, uint8_t value) override;
+
+	/**
+	 * @brief On read registers method.
+	 * Read a burst of bytes starting from a device register. Reading the FIFO data register pops the bytes from the FIFO.
+	 *
+	 * @param address The device address.
+	 * @param reg The first register to read from.
+	 * @param pData The buffer to read the data to.
+	 * @param size The number of bytes to read.
+	 * @return true If all the bytes were read.
+	 * @return false If the transfer failed.
+	 */
+	bool onReadRegisters(uint8_t address, uint8_t reg, uint8_t *pData, size_t size) override;
+
+private:
+	/**
+	 * @brief Get a normally distributed random number.
+	 *
+	 * @return The random number (zero mean, unit variance).
+	 */
+	[[nodiscard]] double getNoise();
+
+	/**
+	 * @brief Write a 16 bit value to a register pair.
+	 *
+	 * @param reg The first (high byte) register.
+	 * @param value The value to write.
+	 */
+	void writeWord(MPU6050Register reg, int value);
+
+	/**
+	 * @brief Push a byte to the FIFO.
+	 * The oldest byte is dropped when the FIFO is full.
+	 *
+	 * @param value The byte to push.
+	 */
+	void pushFIFO(uint8_t value);
+
+	/**
+	 * @brief Read a register.
+	 *
+	 * @param reg The register.
+	 * @return The register value.
+	 */
+	[[nodiscard]] uint8_t getRegister(MPU6050Register reg) const { return m_Registers[static_cast<uint8_t>(reg)]; }
+
+private:
+	uint8_t m_Registers[128] = {};
+	uint8_t m_FIFO[g_MPU6050FIFOSize] = {};
+	size_t m_FIFOHead = 0;
+	size_t m_FIFOCount = 0;
+
+	Vector3 m_FilteredForce = {0, 0, g_SimulatedGravity};
+	Vector3 m_FilteredRate;
+	Vector3 m_GyroscopeBias;
+	double m_Temperature = 25.0;
+
+	double m_VibrationFrequency = 0.0;
+	double m_VibrationAmplitude = 0.0;
+	double m_VibrationPhase = 0.0;
+
+	uint64_t m_NoiseState = 0;
+};
\ No newline at end of file
@@ -0,0 +1,729 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+// Software in the loop simulation.
+// The controller's systems run unmodified against the airframe model. The sensor is simulated at the register level (behind the I2C bus
+// interface), the actuators are read back from the servo pins and the transmitter sticks are moved by a scripted pilot. Everything runs
+// on a virtual clock, as fast as the host can go, and the result only depends on the seed.
+//
+// Usage: program [--duration seconds] [--seed number] [--rate hertz] [--serial file] [--udp port] [--blackbox file]
+//                [--calibration file] [--gyro-bias x,y,z] [--temperature celsius] [--vibration degrees-per-second]
+//                [--autotune loop,axis,rule] [--parameters file] [--set name=value ...]
+// The airframe state is written to the standard output as CSV, and the controller's serial output (telemetry) to the serial file.
+// With the packet data link, the ground station can be replaced by a real one which sends its packets to a UDP port. The simulation then
+// runs in real time. The blackbox log is written to the blackbox file, which can be converted with monitor/blackbox_decoder.py.
+// The sensor calibration is stored in the calibration file and loaded from it on the next run. The simulated gyroscope has a bias (in
+// degrees per second, in the sensor frame) and a temperature, which the calibration measures. The rotors shake the sensor at their rotation
+// frequency, with the given roll rate amplitude at full throttle, which the sensor filter removes.
+// The auto tune of a loop (rate or angle) and axis (pitch, roll or yaw) is started in the hover, with a tuning rule (ziegler-nichols,
+// ziegler-nichols-pi, tyreus-luyben, some-overshoot or no-overshoot). The pilot centers the sticks until the experiment ends, and the rest
+// of the flight uses the new gains.
+// The parameters are loaded from the parameter file, and stored in it when the host saves them. Without the file, the defaults are used.
+// A parameter (named like in monitor/telemetry_decoder.py) can be written at the start, like the host writes it, and it's then saved to
+// the parameter file.
+
+#include "AirframeModel.hpp"
+#include "HostPlatform.hpp"
+#include "SimulatedMPU6050.hpp"
+#include "FileBlackboxStorage.hpp"
+#include "FileRecordStorage.hpp"
+
+#include "systems/OutputSystem.hpp"
+#include "systems/Stabilizer.hpp"
+#include "systems/InputSystem.hpp"
+#include "systems/TelemetrySystem.hpp"
+#include "systems/LoggingSystem.hpp"
+#include "systems/BlackboxSystem.hpp"
+#include "systems/ParameterSystem.hpp"
+#include "core/Configuration.hpp"
+#include "core/Constants.hpp"
+#include "core/Scheduler.hpp"
+#include "core/StageProfiler.hpp"
+#include "algorithms/IBusParser.hpp"
+#include "components/FSi6DataLink.hpp"
+
+#if defined(PEREGRINE_ROTOR_RMT)
+#include "algorithms/RotorProtocols.hpp"
+#include "components/RMTRotorOutput.hpp"
+#include "components/ServoRotorOutput.hpp"
+RMTRotorOutput g_RotorOutput(g_RotorProtocol);
+
+#else
+#include "components/ServoRotorOutput.hpp"
+ServoRotorOutput g_RotorOutput;
+
+#endif
+
+#if defined(PEREGRINE_DATA_LINK_FS_I6)
+FSi6DataLink g_CurrentDataLink;
+
+#elif defined(PEREGRINE_DATA_LINK_PACKET)
+#include "GroundStation.hpp"
+#include "UDPTransport.hpp"
+#include "components/PacketDataLink.hpp"
+LoopbackTransport g_LinkTransport;
+PacketDataLink g_CurrentDataLink(&g_LinkTransport);
+
+#else
+#include "components/DefaultDataLink.hpp"
+DefaultDataLink g_CurrentDataLink;
+
+#endif
+
+#include "core/Logging.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// The physics is stepped a few times per controller tick to keep the integration stable.
+constexpr auto g_PhysicsSubsteps = 4;
+
+// One controller tick.
+constexpr uint32_t g_SimulationStep = 1000000 / g_SchedulerTickRate;
+
+// The pilot holds the altitude by moving the throttle stick around the commanded throttle (us per m and us per m/s).
+constexpr auto g_PilotAltitudeGain = 40.0;
+constexpr auto g_PilotClimbRateGain = 60.0;
+
+// The rotation frequency of the rotors at full throttle. The thrust grows with the square of the speed.
+constexpr auto g_MaximumRotorFrequency = 300.0;
+
+// The altitude of a pilot command which only moves the sticks.
+constexpr auto g_NoAltitude = -1.0;
+
+// The receiver sends an iBus frame every 7 ms. A fraction of the frames is damaged (a bit is flipped or the frame is cut short), so the
+// data link's error handling runs in every simulation.
+constexpr uint32_t g_ReceiverFramePeriod = 7000;
+constexpr auto g_ReceiverErrorRate = 0.02;
+
+/**
+ * @brief Pilot command structure.
+ * These are the iBus channel values (1000 to 2000) at a point in time. The sticks move linearly from one command to the next. When both
+ * commands have an altitude, the pilot also holds the (interpolated) altitude using the throttle stick, like a human pilot would. A fixed
+ * throttle stick never matches the hover thrust exactly, so the airframe would otherwise keep climbing or sinking.
+ */
+struct PilotCommand final
+{
+	double m_Time;
+	uint16_t m_Throttle;
+	uint16_t m_Pitch;
+	uint16_t m_Roll;
+	uint16_t m_Yaw;
+	uint16_t m_Mode;
+	double m_Altitude;
+};
+
+// Spool up, lift off and climb to 2 m, then step the pitch, roll and yaw sticks one at a time and land.
+constexpr PilotCommand g_PilotProfile[] = {
+	{0.0, 1000, 1500, 1500, 1500, 1000, g_NoAltitude},
+	{1.0, 1000, 1500, 1500, 1500, 1000, g_NoAltitude},
+	{3.0, 1780, 1500, 1500, 1500, 1000, 0.0},
+	{5.0, 1780, 1500, 1500, 1500, 1000, 2.0},
+	{6.0, 1780, 1500, 1500, 1500, 1000, 2.0},
+	{6.2, 1780, 1600, 1500, 1500, 1000, 2.0},
+	{8.0, 1780, 1600, 1500, 1500, 1000, 2.0},
+	{8.2, 1780, 1500, 1500, 1500, 1000, 2.0},
+	{10.0, 1780, 1500, 1500, 1500, 1000, 2.0},
+	{10.2, 1780, 1500, 1600, 1500, 1000, 2.0},
+	{12.0, 1780, 1500, 1600, 1500, 1000, 2.0},
+	{12.2, 1780, 1500, 1500, 1500, 1000, 2.0},
+	{14.0, 1780, 1500, 1500, 1500, 1000, 2.0},
+	{14.2, 1780, 1500, 1500, 1600, 1000, 2.0},
+	{16.0, 1780, 1500, 1500, 1600, 1000, 2.0},
+	{16.2, 1780, 1500, 1500, 1500, 1000, 2.0},
+	{18.0, 1780, 1500, 1500, 1500, 1000, 2.0},
+	{22.0, 1700, 1500, 1500, 1500, 1000, 0.0},
+	{24.0, 1700, 1500, 1500, 1500, 1000, g_NoAltitude},
+	{25.0, 1000, 1500, 1500, 1500, 1000, g_NoAltitude}};
+
+/**
+ * @brief Simulation options structure.
+ */
+struct SimulationOptions final
+{
+	double m_Duration = 25.0;
+	uint64_t m_Seed = 1;
+	double m_OutputRate = 50.0;
+	const char *m_pSerialFile = nullptr;
+	uint16_t m_UDPPort = 0;
+	const char *m_pBlackboxFile = nullptr;
+	const char *m_pCalibrationFile = nullptr;
+	const char *m_pParameterFile = nullptr;
+	Vector3 m_GyroscopeBias;
+	double m_Temperature = 25.0;
+	double m_Vibration = 0.0;
+
+	bool m_isAutoTuning = false;
+	TuningLoop m_TuningLoop = TuningLoop::Rate;
+	TuningAxis m_TuningAxis = TuningAxis::Pitch;
+	TuningRule m_TuningRule = TuningRule::ZieglerNichols;
+
+	ParameterID m_ParameterIDs[g_ParameterCount] = {};
+	ParameterValue m_ParameterValues[g_ParameterCount] = {};
+	uint8_t m_ParameterCount = 0;
+};
+
+// The auto tune starts once the airframe climbed to the hover altitude.
+constexpr auto g_AutoTuneStartTime = 5.0; // Seconds.
+
+// The names of the auto tune options, in the order of the enums.
+const char *const g_TuningLoopOptions[] = {"rate", "angle"};
+const char *const g_TuningAxisOptions[] = {"pitch", "roll", "yaw"};
+const char *const g_TuningRuleOptions[g_TuningRuleCount] = {"ziegler-nichols", "ziegler-nichols-pi", "tyreus-luyben", "some-overshoot", "no-overshoot"};
+
+/**
+ * @brief Find a name in a list.
+ *
+ * @tparam Count The name count.
+ * @param names The names.
+ * @param pName The name to find.
+ * @param index The index of the name.
+ * @return true If the name was found.
+ * @return false If the name is not in the list.
+ */
+template <size_t Count>
+bool FindName(const char *const (&names)[Count], const char *pName, uint8_t &index)
+{
+	for (size_t i = 0; i < Count; i++)
+	{
+		if (strcmp(names[i], pName) == 0)
+		{
+			index = static_cast<uint8_t>(i);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * @brief Parse the auto tune option.
+ *
+ * @param pValue The option value, as loop,axis,rule.
+ * @param options The options to write to.
+ * @return true If the value is valid.
+ * @return false If a name is unknown.
+ */
+bool ParseAutoTune(const char *pValue, SimulationOptions &options)
+{
+	char loop[16] = {};
+	char axis[16] = {};
+	char rule[32] = {};
+	if (sscanf(pValue, "%15[^,],%15[^,],%31s", loop, axis, rule) != 3)
+		return false;
+
+	uint8_t loopIndex = 0;
+	uint8_t axisIndex = 0;
+	uint8_t ruleIndex = 0;
+	if (!FindName(g_TuningLoopOptions, loop, loopIndex) || !FindName(g_TuningAxisOptions, axis, axisIndex) || !FindName(g_TuningRuleOptions, rule, ruleIndex))
+		return false;
+
+	options.m_isAutoTuning = true;
+	options.m_TuningLoop = static_cast<TuningLoop>(loopIndex);
+	options.m_TuningAxis = static_cast<TuningAxis>(axisIndex);
+	options.m_TuningRule = static_cast<TuningRule>(ruleIndex);
+	return true;
+}
+
+/**
+ * @brief Parse a parameter option.
+ *
+ * @param pValue The option value, as name=value.
+ * @param options The options to write to.
+ * @return true If the parameter exists.
+ * @return false If the parameter is unknown, or too many parameters were given.
+ */
+bool ParseParameter(const char *pValue, SimulationOptions &options)
+{
+	char name[32] = {};
+	char value[32] = {};
+	if (sscanf(pValue, "%31[^=]=%31s", name, value) != 2 || options.m_ParameterCount >= g_ParameterCount)
+		return false;
+
+	for (uint8_t i = 0; i < g_ParameterCount; i++)
+	{
+		const auto id = static_cast<ParameterID>(i);
+		const auto &descriptor = GetParameterDescriptor(id);
+		if (strcmp(descriptor.m_pName, name) != 0)
+			continue;
+
+		auto &parameter = options.m_ParameterValues[options.m_ParameterCount];
+		if (descriptor.m_Type == ParameterType::Float)
+			parameter.m_Float = static_cast<float>(atof(value));
+		else
+			parameter.m_Integer = atoi(value);
+
+		options.m_ParameterIDs[options.m_ParameterCount++] = id;
+		return true;
+	}
+
+	return false;
+}
+
+/**
+ * @brief Get the scheduler time.
+ *
+ * @return The virtual time in microseconds.
+ */
+uint32_t GetSchedulerTime()
+{
+	return micros();
+}
+
+Scheduler g_Scheduler(g_SchedulerTickRate, &GetSchedulerTime);
+Scheduler g_SensorScheduler(g_SensorSampleRate, &GetSchedulerTime);
+SimulatedMPU6050 g_SimulatedSensor;
+
+uint16_t g_ReceiverChannels[g_IBusChannelCount] = {};
+
+/**
+ * @brief Parse the command line options.
+ *
+ * @param argc The argument count.
+ * @param argv The arguments.
+ * @param options The options to write to.
+ * @return true If the options are valid.
+ * @return false If an option is unknown or is missing its value.
+ */
+bool ParseOptions(int argc, char **argv, SimulationOptions &options)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		if (i + 1 >= argc)
+			return false;
+
+		const char *pValue = argv[++i];
+		if (strcmp(argv[i - 1], "--duration") == 0)
+			options.m_Duration = atof(pValue);
+		else if (strcmp(argv[i - 1], "--seed") == 0)
+			options.m_Seed = strtoull(pValue, nullptr, 10);
+		else if (strcmp(argv[i - 1], "--rate") == 0)
+			options.m_OutputRate = atof(pValue);
+		else if (strcmp(argv[i - 1], "--serial") == 0)
+			options.m_pSerialFile = pValue;
+		else if (strcmp(argv[i - 1], "--udp") == 0)
+			options.m_UDPPort = static_cast<uint16_t>(atoi(pValue));
+		else if (strcmp(argv[i - 1], "--blackbox") == 0)
+			options.m_pBlackboxFile = pValue;
+		else if (strcmp(argv[i - 1], "--calibration") == 0)
+			options.m_pCalibrationFile = pValue;
+		else if (strcmp(argv[i - 1], "--parameters") == 0)
+			options.m_pParameterFile = pValue;
+		else if (strcmp(argv[i - 1], "--gyro-bias") == 0)
+		{
+			if (sscanf(pValue, "%lf,%lf,%lf", &options.m_GyroscopeBias.m_X, &options.m_GyroscopeBias.m_Y, &options.m_GyroscopeBias.m_Z) != 3)
+				return false;
+		}
+		else if (strcmp(argv[i - 1], "--temperature") == 0)
+			options.m_Temperature = atof(pValue);
+		else if (strcmp(argv[i - 1], "--vibration") == 0)
+			options.m_Vibration = atof(pValue);
+		else if (strcmp(argv[i - 1], "--autotune") == 0)
+		{
+			if (!ParseAutoTune(pValue, options))
+				return false;
+		}
+		else if (strcmp(argv[i - 1], "--set") == 0)
+		{
+			if (!ParseParameter(pValue, options))
+				return false;
+		}
+		else
+			return false;
+	}
+
+	return options.m_Duration > 0 && options.m_OutputRate > 0;
+}
+
+/**
+ * @brief Move the transmitter sticks according to the pilot profile.
+ *
+ * @param time The simulation time in seconds.
+ * @param state The airframe state.
+ */
+void UpdatePilot(double time, const AirframeState &state)
+{
+	constexpr auto commandCount = sizeof(g_PilotProfile) / sizeof(g_PilotProfile[0]);
+
+	size_t next = 0;
+	while (next < commandCount && g_PilotProfile[next].m_Time <= time)
+		next++;
+
+	const auto &previous = g_PilotProfile[next > 0 ? next - 1 : 0];
+	const auto &current = g_PilotProfile[next < commandCount ? next : commandCount - 1];
+	const auto span = current.m_Time - previous.m_Time;
+	const auto blend = span > 0 ? (time - previous.m_Time) / span : 0.0;
+	const auto interpolate = [blend](uint16_t from, uint16_t to)
+	{ return static_cast<uint16_t>(from + ((to - from) * blend)); };
+
+	auto throttle = interpolate(previous.m_Throttle, current.m_Throttle);
+	if (previous.m_Altitude != g_NoAltitude && current.m_Altitude != g_NoAltitude)
+	{
+		// The world frame is north-east-down.
+		const auto altitude = previous.m_Altitude + ((current.m_Altitude - previous.m_Altitude) * blend);
+		const auto correction = (g_PilotAltitudeGain * (altitude + state.m_Position.m_Z)) + (g_PilotClimbRateGain * state.m_Velocity.m_Z);
+		throttle = static_cast<uint16_t>(std::clamp(throttle + correction, 1000.0, 2000.0));
+	}
+
+	g_ReceiverChannels[static_cast<uint8_t>(FSi6InputChannel::Throttle)] = throttle;
+	g_ReceiverChannels[static_cast<uint8_t>(FSi6InputChannel::Pitch)] = interpolate(previous.m_Pitch, current.m_Pitch);
+	g_ReceiverChannels[static_cast<uint8_t>(FSi6InputChannel::Roll)] = interpolate(previous.m_Roll, current.m_Roll);
+	g_ReceiverChannels[static_cast<uint8_t>(FSi6InputChannel::Yaw)] = interpolate(previous.m_Yaw, current.m_Yaw);
+	g_ReceiverChannels[static_cast<uint8_t>(FSi6InputChannel::Aux1)] = previous.m_Mode;
+}
+
+/**
+ * @brief Send the receiver's iBus frame to the serial port.
+ * The frame contains the current stick positions and is damaged now and then.
+ *
+ * @param random The random number generator.
+ */
+void SendReceiverFrame(std::mt19937_64 &random)
+{
+	uint8_t frame[g_IBusFrameSize];
+	EncodeIBusFrame(g_ReceiverChannels, frame);
+
+	size_t size = g_IBusFrameSize;
+	const auto error = std::uniform_real_distribution<double>(0.0, 1.0)(random);
+	if (error < g_ReceiverErrorRate / 2)
+		frame[random() % g_IBusFrameSize] ^= static_cast<uint8_t>(1 << (random() % 8));
+	else if (error < g_ReceiverErrorRate)
+		size = random() % g_IBusFrameSize;
+
+	Serial2.receive(frame, size);
+}
+
+#ifdef PEREGRINE_DATA_LINK_PACKET
+/**
+ * @brief Get the ground station's control message.
+ * This contains the same stick positions as the receiver's frames.
+ *
+ * @return The control message.
+ */
+ControlMessage GetControlMessage()
+{
+	const auto channel = [](FSi6InputChannel channel)
+	{ return static_cast<float>(g_ReceiverChannels[static_cast<uint8_t>(channel)]); };
+
+	ControlMessage message;
+	message.m_Thrust = (channel(FSi6InputChannel::Throttle) - 1000.0f) / 1000.0f;
+	message.m_Pitch = (channel(FSi6InputChannel::Pitch) - 1500.0f) / 500.0f;
+	message.m_Roll = (channel(FSi6InputChannel::Roll) - 1500.0f) / 500.0f;
+	message.m_Yaw = (channel(FSi6InputChannel::Yaw) - 1500.0f) / 500.0f;
+	message.m_FlyMode = static_cast<uint8_t>(channel(FSi6InputChannel::Aux1) > 1500.0f ? FlyMode::Cruise : FlyMode::Hover);
+	message.m_ControlMode = static_cast<uint8_t>(channel(FSi6InputChannel::Aux2) > 1500.0f ? ControlMode::Rate : ControlMode::Angle);
+	return message;
+}
+
+/**
+ * @brief Forward the packets between the UDP socket and the controller.
+ *
+ * @param transport The UDP transport.
+ */
+void ForwardPackets(UDPTransport &transport)
+{
+	transport.poll();
+
+	uint8_t buffer[g_LoopbackBufferSize];
+	const auto size = g_LinkTransport.drain(buffer, sizeof(buffer));
+	if (size > 0)
+		transport.onWrite(buffer, size);
+}
+
+#endif
+
+/**
+ * @brief Read the pulse width of a rotor.
+ * With a digital ESC protocol, the last RMT frame of the pin is decoded like the ESC does, and the throttle is converted to the equivalent
+ * servo pulse width. An invalid frame stops the rotor.
+ *
+ * @param pin The rotor pin.
+ * @return The pulse width in microseconds.
+ */
+double ReadRotor(uint8_t pin)
+{
+#if defined(PEREGRINE_ROTOR_RMT)
+	rmt_item32_t items[g_MaxRotorPulses];
+	RotorPulse pulses[g_MaxRotorPulses];
+	const auto count = GetHostRMTItems(pin, items, g_MaxRotorPulses);
+	for (size_t i = 0; i < count; i++)
+		pulses[i] = {static_cast<uint16_t>(items[i].duration0), static_cast<uint16_t>(items[i].duration1)};
+
+	float throttle = 0.0f;
+	if (!DecodeRotorPulses(g_RotorProtocol, pulses, count, throttle))
+		throttle = 0.0f;
+
+	return g_RotorMinimumPulse + (throttle * static_cast<double>(g_RotorMaximumPulse - g_RotorMinimumPulse));
+
+#else
+	return GetHostPulseWidth(pin);
+
+#endif
+}
+
+/**
+ * @brief Read the actuator commands from the servo pins.
+ *
+ * @return The actuator commands.
+ */
+ActuatorCommands ReadActuators()
+{
+	ActuatorCommands commands;
+	commands.m_LeftRotor = ReadRotor(g_LeftRotorPin);
+	commands.m_RightRotor = ReadRotor(g_RightRotorPin);
+	commands.m_LeftWing = GetHostPulseWidth(g_LeftWingServoPin);
+	commands.m_RightWing = GetHostPulseWidth(g_RightWingServoPin);
+	commands.m_Elevator = GetHostPulseWidth(g_ElevatorServoPin);
+	commands.m_Rudder = GetHostPulseWidth(g_RudderServoPin);
+	return commands;
+}
+
+/**
+ * @brief Write the airframe state as a CSV row.
+ *
+ * @param time The simulation time in seconds.
+ * @param model The airframe model.
+ */
+void WriteState(double time, const AirframeModel &model)
+{
+	constexpr auto radiansToDegrees = 57.29577951308232;
+
+	const auto &state = model.getState();
+	const auto angles = GetEulerAngles(state.m_Orientation) * radiansToDegrees;
+	printf("%.3f,%.3f,%.3f,%.3f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.1f,%.1f\n", time, state.m_Position.m_X, state.m_Position.m_Y, -state.m_Position.m_Z,
+		   angles.m_X, angles.m_Y, angles.m_Z, state.m_AngularVelocity.m_X * radiansToDegrees, state.m_AngularVelocity.m_Y * radiansToDegrees,
+		   model.getThrust(0), model.getThrust(1), model.getTilt(0), model.getTilt(1));
+}
+
+// The unit tests ("pio test -e native") link the simulation as well, but have a main function of their own.
+#if !defined(PIO_UNIT_TESTING)
+int main(int argc, char **argv)
+{
+	SimulationOptions options;
+	if (!ParseOptions(argc, argv, options))
+	{
+		fprintf(stderr, "Usage: %s [--duration seconds] [--seed number] [--rate hertz] [--serial file] [--udp port] [--blackbox file] "
+						"[--calibration file] [--gyro-bias x,y,z] [--temperature celsius] [--vibration degrees-per-second] [--autotune loop,axis,rule] "
+					"[--parameters file] [--set name=value ...]\n",
+				argv[0]);
+		return 2;
+	}
+
+	FILE *pSerialFile = nullptr;
+	if (options.m_pSerialFile)
+	{
+		pSerialFile = fopen(options.m_pSerialFile, "wb");
+		if (!pSerialFile)
+		{
+			fprintf(stderr, "Failed to open the serial output file %s!\n", options.m_pSerialFile);
+			return 2;
+		}
+
+		SetHostSerialOutput(pSerialFile);
+	}
+
+	AirframeModel model;
+	g_SimulatedSensor = SimulatedMPU6050(options.m_Seed);
+	g_SimulatedSensor.setGyroscopeBias(options.m_GyroscopeBias);
+	g_SimulatedSensor.setTemperature(options.m_Temperature);
+	std::mt19937_64 receiverRandom(options.m_Seed);
+	UpdatePilot(0, model.getState());
+
+#ifdef PEREGRINE_DATA_LINK_PACKET
+	GroundStation groundStation(g_LinkTransport, options.m_Seed);
+	UDPTransport udpTransport(options.m_UDPPort);
+	if (options.m_UDPPort != 0)
+	{
+		udpTransport.onInitialize(
+			[&udpTransport]()
+			{
+				uint8_t buffer[g_LoopbackBufferSize];
+				size_t size = 0;
+				while ((size = udpTransport.onRead(buffer, sizeof(buffer))) > 0)
+					g_LinkTransport.inject(buffer, size);
+			});
+
+		if (!udpTransport.isOpen())
+			return 2;
+
+		fprintf(stderr, "Waiting for the ground station on UDP port %u.\n", options.m_UDPPort);
+	}
+
+#else
+	if (options.m_UDPPort != 0)
+	{
+		fprintf(stderr, "The UDP ground station requires the packet data link (PEREGRINE_DATA_LINK_PACKET)!\n");
+		return 2;
+	}
+
+#endif
+
+	// The same setup as the controller, but everything runs on this thread.
+	PEREGRINE_SETUP_LOGGING(115200);
+
+	FileBlackboxStorage blackboxStorage(options.m_pBlackboxFile);
+	if (options.m_pBlackboxFile)
+	{
+		BlackboxSystem::Instance().initialize(&blackboxStorage);
+		if (!BlackboxSystem::Instance().isRecording())
+		{
+			fprintf(stderr, "Failed to open the blackbox file %s!\n", options.m_pBlackboxFile);
+			return 2;
+		}
+	}
+
+	StageProfiler::Initialize();
+	TelemetrySystem::Instance().initialize();
+
+	FileRecordStorage<ParameterSet> parameterStorage(options.m_pParameterFile);
+	auto &parameterSystem = ParameterSystem::Instance();
+	parameterSystem.initialize(options.m_pParameterFile ? &parameterStorage : nullptr);
+
+	// The parameters of the options are written like the host writes them, and saved while the aircraft is still on the ground.
+	for (uint8_t i = 0; i < options.m_ParameterCount; i++)
+	{
+		if (!parameterSystem.set(options.m_ParameterIDs[i], options.m_ParameterValues[i]))
+		{
+			fprintf(stderr, "The parameter %s is out of its range!\n", GetParameterDescriptor(options.m_ParameterIDs[i]).m_pName);
+			return 2;
+		}
+	}
+
+	if (options.m_ParameterCount > 0)
+	{
+		if (options.m_pParameterFile && !parameterSystem.save())
+		{
+			fprintf(stderr, "Failed to store the parameters in %s!\n", options.m_pParameterFile);
+			return 2;
+		}
+
+		parameterSystem.update();
+	}
+
+	OutputSystem::Instance().initialize(&g_RotorOutput);
+	InputSystem::Instance().initialize(&g_CurrentDataLink);
+
+	g_SensorScheduler.addTask(&Stabilizer::Instance(), g_SensorUpdateDivider);
+	g_Scheduler.addTask(&InputSystem::Instance(), g_InputUpdateDivider, 1);
+	g_Scheduler.addTask(&OutputSystem::Instance(), g_OutputUpdateDivider);
+	g_Scheduler.addTask(&TelemetrySystem::Instance(), g_TelemetryUpdateDivider, 3);
+	g_Scheduler.addTask(&ParameterSystem::Instance(), g_ParameterUpdateDivider, 3);
+	g_Scheduler.setIdleTask(&LoggingSystem::Instance());
+
+	FileRecordStorage<SensorCalibration> calibrationStorage(options.m_pCalibrationFile);
+	Stabilizer::Instance().initialize(&g_SimulatedSensor, options.m_pCalibrationFile ? &calibrationStorage : nullptr);
+
+	printf("time,north,east,altitude,roll,pitch,yaw,roll_rate,pitch_rate,left_thrust,right_thrust,left_tilt,right_tilt\n");
+
+	const auto startTime = std::chrono::steady_clock::now();
+	const auto startHostTime = GetHostTime();
+	const auto steps = static_cast<uint64_t>(options.m_Duration * g_SchedulerTickRate);
+	const auto outputInterval = static_cast<uint64_t>(g_SchedulerTickRate / options.m_OutputRate);
+	const auto maximumThrust = AirframeParameters().m_MaximumThrust;
+
+	for (uint64_t step = 0; step < steps; step++)
+	{
+		const auto time = (GetHostTime() - startHostTime) * 1e-6;
+		UpdatePilot(time, model.getState());
+
+		// The host's auto tune command is handled on the control core. The pilot keeps the sticks centered while the experiment runs.
+		if (options.m_isAutoTuning && step == static_cast<uint64_t>(g_AutoTuneStartTime * g_SchedulerTickRate))
+			Stabilizer::Instance().startAutoTune(options.m_TuningLoop, options.m_TuningAxis, options.m_TuningRule);
+
+		if (Stabilizer::Instance().getAutoTune().m_State == static_cast<uint8_t>(RelayTunerState::Running))
+		{
+			g_ReceiverChannels[static_cast<uint8_t>(FSi6InputChannel::Pitch)] = 1500;
+			g_ReceiverChannels[static_cast<uint8_t>(FSi6InputChannel::Roll)] = 1500;
+			g_ReceiverChannels[static_cast<uint8_t>(FSi6InputChannel::Yaw)] = 1500;
+		}
+
+		// The actuators hold the last written commands for the whole tick.
+		const auto commands = ReadActuators();
+		for (int i = 0; i < g_PhysicsSubsteps; i++)
+			model.step(commands, g_SimulationStep * 1e-6 / g_PhysicsSubsteps);
+
+		AdvanceHostTime(g_SimulationStep);
+
+		if (GetHostTime() % g_SimulatedSensor.getSamplePeriod() == 0)
+		{
+			// The rotors are about the same speed, so they shake the sensor at a single frequency.
+			const auto speed = sqrt(std::max(0.0, (model.getThrust(0) + model.getThrust(1)) / (2.0 * maximumThrust)));
+			g_SimulatedSensor.setVibration(g_MaximumRotorFrequency * speed, options.m_Vibration * speed);
+			g_SimulatedSensor.sample(model.getState());
+		}
+
+#ifdef PEREGRINE_DATA_LINK_PACKET
+		if (options.m_UDPPort != 0)
+		{
+			ForwardPackets(udpTransport);
+		}
+		else
+		{
+			if (GetHostTime() % g_GroundStationPeriod == 0)
+				groundStation.send(GetControlMessage(), GetHostTime());
+
+			groundStation.update(GetHostTime());
+		}
+
+#else
+		if (GetHostTime() % g_ReceiverFramePeriod == 0)
+			SendReceiverFrame(receiverRandom);
+
+#endif
+
+		g_SensorScheduler.tick(Stabilizer::Instance().waitForSensorData());
+
+		{
+			PEREGRINE_PROFILE_STAGE(ProfileStage::ControlTick);
+			g_Scheduler.tick(1);
+		}
+
+		// The blackbox task runs whenever the control core is idle, which is once per tick here.
+		BlackboxSystem::Instance().update();
+
+		if (outputInterval == 0 || step % outputInterval == 0)
+			WriteState(time, model);
+
+		// A real ground station needs the controller to run in real time.
+		if (options.m_UDPPort != 0)
+			std::this_thread::sleep_until(startTime + std::chrono::microseconds(GetHostTime() - startHostTime));
+	}
+
+	const auto wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+	fprintf(stderr, "Simulated %.1f s in %.3f s (%.0fx real time).%s\n", options.m_Duration, wallTime, options.m_Duration / wallTime, model.hasCrashed() ? " The airframe crashed!" : "");
+
+	if (Stabilizer::Instance().isArmed())
+		fprintf(stderr, "The controller armed %.1f ms after the start.\n", Stabilizer::Instance().getArmTime() * 1e-3);
+	else
+		fprintf(stderr, "The controller never armed!\n");
+
+	if (options.m_isAutoTuning)
+	{
+		const auto &autoTune = Stabilizer::Instance().getAutoTune();
+		if (autoTune.m_State == static_cast<uint8_t>(RelayTunerState::Completed))
+			fprintf(stderr, "The auto tune completed after %u cycles: Ku %.4f, Tu %.4f s, KP %.4f, KI %.4f, KD %.5f.\n", autoTune.m_Cycles, autoTune.m_UltimateGain,
+					autoTune.m_UltimatePeriod, autoTune.m_Gains[0], autoTune.m_Gains[1], autoTune.m_Gains[2]);
+		else
+			fprintf(stderr, "The auto tune did not complete (state %u after %u cycles)!\n", autoTune.m_State, autoTune.m_Cycles);
+	}
+
+#ifdef PEREGRINE_DATA_LINK_PACKET
+	if (options.m_UDPPort == 0)
+		groundStation.printStatistics(stderr);
+
+#endif
+
+	BlackboxSystem::Instance().stop();
+
+	if (pSerialFile)
+		fclose(pSerialFile);
+
+	return model.hasCrashed() ? 1 : 0;
+}
+
+#endif
@@ -0,0 +1,91 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#include "UDPTransport.hpp"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+UDPTransport::~UDPTransport()
+{
+	if (m_Socket >= 0)
+		close(m_Socket);
+}
+
+void UDPTransport::onInitialize(TransportReceiveCallback callback)
+{
+	m_ReceiveCallback = callback;
+
+	m_Socket = socket(AF_INET, SOCK_DGRAM, 0);
+	if (m_Socket < 0)
+	{
+		perror("Failed to create the UDP socket");
+		return;
+	}
+
+	sockaddr_in address = {};
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_ANY);
+	address.sin_port = htons(m_Port);
+
+	if (bind(m_Socket, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) < 0 || fcntl(m_Socket, F_SETFL, O_NONBLOCK) < 0)
+	{
+		perror("Failed to bind the UDP socket");
+		close(m_Socket);
+		m_Socket = -1;
+	}
+}
+
+size_t UDPTransport::onRead(uint8_t *pData, size_t size)
+{
+	if (m_DatagramOffset == m_DatagramSize && !receive())
+		return 0;
+
+	auto count = m_DatagramSize - m_DatagramOffset;
+	if (count > size)
+		count = size;
+
+	memcpy(pData, m_Datagram + m_DatagramOffset, count);
+	m_DatagramOffset += count;
+	return count;
+}
+
+size_t UDPTransport::onWrite(const uint8_t *pData, size_t size)
+{
+	if (m_Socket < 0 || !m_hasRemote)
+		return 0;
+
+	const auto sent = sendto(m_Socket, pData, size, 0, reinterpret_cast<const sockaddr *>(&m_RemoteAddress), sizeof(m_RemoteAddress));
+	return sent > 0 ? static_cast<size_t>(sent) : 0;
+}
+
+void UDPTransport::poll()
+{
+	if (m_DatagramOffset == m_DatagramSize && !receive())
+		return;
+
+	if (m_ReceiveCallback)
+		m_ReceiveCallback();
+}
+
+bool UDPTransport::receive()
+{
+	if (m_Socket < 0)
+		return false;
+
+	sockaddr_in address = {};
+	socklen_t addressSize = sizeof(address);
+	const auto received = recvfrom(m_Socket, m_Datagram, sizeof(m_Datagram), 0, reinterpret_cast<sockaddr *>(&address), &addressSize);
+	if (received <= 0)
+		return false;
+
+	m_DatagramSize = static_cast<size_t>(received);
+	m_DatagramOffset = 0;
+	m_RemoteAddress = address;
+	m_hasRemote = true;
+	return true;
+}
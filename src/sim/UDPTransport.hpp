@@ -0,0 +1,98 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "core/ITransport.hpp"
+
+#include <netinet/in.h>
+
+// The size of the largest datagram which can be received.
+constexpr auto g_MaxDatagramSize = 1024;
+
+/**
+ * @brief UDP transport class.
+ * This implements the byte transport using a non-blocking UDP socket on the host, so a ground station on the same or on another computer
+ * can talk to the simulated controller. The replies are sent to the address of the last received datagram.
+ *
+ * A socket can not raise the receive callback by itself, so poll() must be called regularly.
+ */
+class UDPTransport final : public ITransport
+{
+public:
+	/**
+	 * @brief Construct a new UDP Transport object.
+	 *
+	 * @param port The local port to listen on.
+	 */
+	explicit UDPTransport(uint16_t port) : m_Port(port) {}
+
+	/**
+	 * @brief Destroy the UDP Transport object.
+	 */
+	~UDPTransport();
+
+	/**
+	 * @brief On initialize method.
+	 * Open and bind the socket.
+	 *
+	 * @param callback The callback to call when a datagram was received.
+	 */
+	void onInitialize(TransportReceiveCallback callback) override;
+
+	/**
+	 * @brief On read method.
+	 * Read the bytes of the received datagrams.
+	 *
+	 * @param pData The buffer to read the bytes to.
+	 * @param size The size of the buffer.
+	 * @return The number of bytes read.
+	 */
+	size_t onRead(uint8_t *pData, size_t size) override;
+
+	/**
+	 * @brief On write method.
+	 * Send the bytes as a datagram to the ground station. Nothing is sent until a datagram was received.
+	 *
+	 * @param pData The bytes to write.
+	 * @param size The number of bytes.
+	 * @return The number of bytes written.
+	 */
+	size_t onWrite(const uint8_t *pData, size_t size) override;
+
+	/**
+	 * @brief Check the socket for received datagrams.
+	 * This raises the receive callback if there is one.
+	 */
+	void poll();
+
+	/**
+	 * @brief Check if the socket is open.
+	 *
+	 * @return true If the socket is bound to the port.
+	 * @return false If the socket could not be opened.
+	 */
+	[[nodiscard]] bool isOpen() const { return m_Socket >= 0; }
+
+private:
+	/**
+	 * @brief Receive the next datagram into the buffer.
+	 *
+	 * @return true If a datagram was received.
+	 * @return false If there was nothing to receive.
+	 */
+	bool receive();
+
+private:
+	TransportReceiveCallback m_ReceiveCallback;
+
+	uint8_t m_Datagram[g_MaxDatagramSize] = {};
+	size_t m_DatagramSize = 0;
+	size_t m_DatagramOffset = 0;
+
+	sockaddr_in m_RemoteAddress = {};
+	int m_Socket = -1;
+	uint16_t m_Port = 0;
+
+	bool m_hasRemote = false;
+};
\ No newline at end of file
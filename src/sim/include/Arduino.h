@@ -0,0 +1,103 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+// Host replacement of the parts of the Arduino core (and FreeRTOS) used by the controller.
+// This header is only on the include path of the native build. The functions are implemented in sim/HostPlatform.cpp and are backed by
+// the simulation's virtual clock, so the controller code runs unmodified and deterministically on the host.
+
+#include <functional>
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define IRAM_ATTR
+
+#define INPUT 0x01
+#define OUTPUT 0x03
+
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+
+unsigned long micros();
+unsigned long millis();
+void delay(uint32_t milliseconds);
+void delayMicroseconds(uint32_t microseconds);
+
+long map(long x, long in_min, long in_max, long out_min, long out_max);
+
+void pinMode(uint8_t pin, uint8_t mode);
+inline uint8_t digitalPinToInterrupt(uint8_t pin) { return pin; }
+void attachInterrupt(uint8_t interrupt, void (*pCallback)(), int mode);
+
+using TaskHandle_t = void *;
+using BaseType_t = int;
+using TickType_t = uint32_t;
+
+#define pdFALSE 0
+#define pdTRUE 1
+#define portMAX_DELAY 0xFFFFFFFF
+#define pdMS_TO_TICKS(milliseconds) (milliseconds)
+#define portYIELD_FROM_ISR() ((void)0)
+
+TaskHandle_t xTaskGetCurrentTaskHandle();
+uint32_t ulTaskNotifyTake(BaseType_t clearCountOnExit, TickType_t ticksToWait);
+void vTaskNotifyGiveFromISR(TaskHandle_t taskHandle, BaseType_t *pHigherPriorityTaskWoken);
+
+using OnReceiveCb = std::function<void(void)>;
+
+// The UART's receive buffer is 256 bytes deep.
+constexpr auto g_SerialReceiveBufferSize = 256;
+
+/**
+ * @brief Hardware serial class.
+ * The written bytes are forwarded to the simulation's serial output (if any) and the received bytes come from the simulation (see
+ * receive()).
+ */
+class HardwareSerial final
+{
+public:
+	explicit HardwareSerial(uint8_t port) : m_Port(port) {}
+
+	void begin(unsigned long baud);
+	void onReceive(OnReceiveCb callback, bool onlyOnTimeout = false) { m_ReceiveCallback = callback; }
+	int available();
+	int read();
+	int availableForWrite();
+	size_t write(uint8_t byte) { return write(&byte, 1); }
+	size_t write(const uint8_t *pData, size_t size);
+
+	// Host only. Queue received bytes and raise the receive event.
+	void receive(const uint8_t *pData, size_t size);
+
+private:
+	uint8_t m_Port = 0;
+
+	OnReceiveCb m_ReceiveCallback;
+	uint8_t m_ReceiveBuffer[g_SerialReceiveBufferSize] = {};
+	size_t m_ReceiveHead = 0;
+	size_t m_ReceiveCount = 0;
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial2;
+
+// The simulated CPU frequency in megahertz.
+constexpr uint32_t g_HostCPUFrequency = 240;
+
+/**
+ * @brief ESP class.
+ * The cycle counter runs on the virtual clock.
+ */
+class EspClass final
+{
+public:
+	uint32_t getCycleCount();
+	uint32_t getCpuFreqMHz() { return g_HostCPUFrequency; }
+};
+
+extern EspClass ESP;
\ No newline at end of file
@@ -0,0 +1,29 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+// Host replacement of the ESP32Servo library. The pulse widths are recorded per pin so the simulation can read the actuator commands.
+
+#include <Arduino.h>
+
+/**
+ * @brief Servo class.
+ */
+class Servo final
+{
+public:
+	int attach(int pin) { return attach(pin, 544, 2400); }
+	int attach(int pin, int minimum, int maximum);
+
+	void write(int value);
+	void writeMicroseconds(int value);
+
+	int readMicroseconds() const { return m_PulseWidth; }
+
+private:
+	int m_Pin = -1;
+	int m_Minimum = 544;
+	int m_Maximum = 2400;
+	int m_PulseWidth = 0;
+};
\ No newline at end of file
@@ -0,0 +1,79 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+// Host replacement of the ESP-IDF RMT driver (the legacy API of arduino-esp32 2.x). The items written to every channel are recorded, so
+// the simulation can decode the frames sent to the ESCs.
+
+#include <stddef.h>
+#include <stdint.h>
+
+using esp_err_t = int;
+constexpr esp_err_t ESP_OK = 0;
+
+using gpio_num_t = int;
+
+enum rmt_channel_t
+{
+	RMT_CHANNEL_0,
+	RMT_CHANNEL_1,
+	RMT_CHANNEL_2,
+	RMT_CHANNEL_3,
+	RMT_CHANNEL_4,
+	RMT_CHANNEL_5,
+	RMT_CHANNEL_6,
+	RMT_CHANNEL_7,
+	RMT_CHANNEL_MAX
+};
+
+enum rmt_mode_t
+{
+	RMT_MODE_TX,
+	RMT_MODE_RX
+};
+
+enum rmt_idle_level_t
+{
+	RMT_IDLE_LEVEL_LOW,
+	RMT_IDLE_LEVEL_HIGH
+};
+
+struct rmt_item32_t
+{
+	union
+	{
+		struct
+		{
+			uint32_t duration0 : 15;
+			uint32_t level0 : 1;
+			uint32_t duration1 : 15;
+			uint32_t level1 : 1;
+		};
+
+		uint32_t val;
+	};
+};
+
+struct rmt_tx_config_t
+{
+	bool idle_output_en = true;
+	rmt_idle_level_t idle_level = RMT_IDLE_LEVEL_LOW;
+};
+
+struct rmt_config_t
+{
+	rmt_mode_t rmt_mode = RMT_MODE_TX;
+	rmt_channel_t channel = RMT_CHANNEL_0;
+	gpio_num_t gpio_num = 0;
+	uint8_t clk_div = 80;
+	uint8_t mem_block_num = 1;
+	rmt_tx_config_t tx_config;
+};
+
+#define RMT_DEFAULT_CONFIG_TX(gpio, channel_id) \
+	rmt_config_t { RMT_MODE_TX, channel_id, gpio, 80, 1, rmt_tx_config_t() }
+
+esp_err_t rmt_config(const rmt_config_t *pConfig);
+esp_err_t rmt_driver_install(rmt_channel_t channel, size_t rxBufferSize, int interruptFlags);
+esp_err_t rmt_write_items(rmt_channel_t channel, const rmt_item32_t *pItems, int itemCount, bool waitTransmitDone);
\ No newline at end of file
@@ -0,0 +1,192 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#include "BlackboxSystem.hpp"
+#include "OutputSystem.hpp"
+
+#include "core/GlobalState.hpp"
+#include "core/Logging.hpp"
+
+#include <Arduino.h>
+
+void BlackboxSystem::initialize(IBlackboxStorage *pStorage)
+{
+	PEREGRINE_PRINTLN("Initializing the blackbox system.");
+
+	m_pStorage = pStorage;
+	if (!m_pStorage->onOpen())
+	{
+		PEREGRINE_LOG_ERROR("Failed to create the blackbox log!");
+		return;
+	}
+
+	m_isRecording.store(true, std::memory_order_relaxed);
+	PEREGRINE_PRINTLN("The blackbox system is recording.");
+}
+
+void BlackboxSystem::update()
+{
+	if (!isRecording())
+		return;
+
+	BlackboxRecord record;
+	while (m_Queue.pop(record))
+	{
+		if (m_Encoder.encode(record))
+			continue;
+
+		writeBlock();
+		m_Encoder.encode(record);
+	}
+
+	if (!m_Encoder.isEmpty() && micros() - m_Encoder.getTimestamp() >= g_BlackboxFlushInterval)
+		writeBlock();
+
+	const auto droppedRecords = m_DroppedRecords.load(std::memory_order_relaxed);
+	if (droppedRecords != m_ReportedDroppedRecords)
+	{
+		PEREGRINE_LOG_WARNING("%u blackbox records dropped.", static_cast<unsigned int>(droppedRecords - m_ReportedDroppedRecords));
+		m_ReportedDroppedRecords = droppedRecords;
+	}
+}
+
+void BlackboxSystem::stop()
+{
+	update();
+
+	if (!isRecording())
+		return;
+
+	if (!m_Encoder.isEmpty())
+		writeBlock();
+
+	m_isRecording.store(false, std::memory_order_relaxed);
+	m_pStorage->onClose();
+}
+
+void BlackboxSystem::recordIMU(const RawIMUSample &sample, float deltaTime, uint32_t timestamp)
+{
+	if (!isRecording())
+		return;
+
+	BlackboxRecord record;
+	record.m_Type = BlackboxRecordType::IMU;
+	record.m_Timestamp = timestamp;
+	for (uint8_t i = 0; i < 3; i++)
+	{
+		record.m_Fields[i] = sample.m_Accelerometer[i];
+		record.m_Fields[3 + i] = sample.m_Gyroscope[i];
+	}
+
+	record.m_Fields[6] = EncodeBlackboxFloat(deltaTime);
+	this->record(record);
+}
+
+void BlackboxSystem::recordAttitude(const AttitudeSample &sample)
+{
+	if (!isRecording())
+		return;
+
+	BlackboxRecord record;
+	record.m_Type = BlackboxRecordType::Attitude;
+	record.m_Timestamp = sample.m_Timestamp;
+	record.m_Fields[0] = EncodeBlackboxFixed(sample.m_Attitude.m_Pitch);
+	record.m_Fields[1] = EncodeBlackboxFixed(sample.m_Attitude.m_Yaw);
+	record.m_Fields[2] = EncodeBlackboxFixed(sample.m_Attitude.m_Roll);
+	record.m_Fields[3] = EncodeBlackboxFixed(sample.m_Rate.m_Pitch);
+	record.m_Fields[4] = EncodeBlackboxFixed(sample.m_Rate.m_Yaw);
+	record.m_Fields[5] = EncodeBlackboxFixed(sample.m_Rate.m_Roll);
+	this->record(record);
+}
+
+void BlackboxSystem::recordRateControl(uint32_t timestamp, Vec3 setpoints, const RateControlSample &control)
+{
+	if (!isRecording())
+		return;
+
+	BlackboxRecord record;
+	record.m_Type = BlackboxRecordType::RateControl;
+	record.m_Timestamp = timestamp;
+
+	const Vec3 values[] = {setpoints, control.m_Proportional, control.m_Integral, control.m_Derivative};
+	for (uint8_t i = 0; i < 4; i++)
+	{
+		record.m_Fields[(i * 3) + 0] = EncodeBlackboxFixed(values[i].m_Pitch);
+		record.m_Fields[(i * 3) + 1] = EncodeBlackboxFixed(values[i].m_Yaw);
+		record.m_Fields[(i * 3) + 2] = EncodeBlackboxFixed(values[i].m_Roll);
+	}
+
+	this->record(record);
+}
+
+void BlackboxSystem::recordInputs(uint32_t timestamp, const Setpoint &inputs, uint32_t frameTimestamp)
+{
+	if (!isRecording())
+		return;
+
+	BlackboxRecord record;
+	record.m_Type = BlackboxRecordType::Inputs;
+	record.m_Timestamp = timestamp;
+	record.m_Fields[0] = EncodeBlackboxFloat(inputs.m_Thrust);
+	record.m_Fields[1] = EncodeBlackboxFloat(inputs.m_Pitch);
+	record.m_Fields[2] = EncodeBlackboxFloat(inputs.m_Roll);
+	record.m_Fields[3] = EncodeBlackboxFloat(inputs.m_Yaw);
+	record.m_Fields[4] = static_cast<int32_t>(frameTimestamp);
+	record.m_Fields[5] = static_cast<int32_t>(g_RequiredFlyMode);
+	record.m_Fields[6] = static_cast<int32_t>(g_ControlMode);
+	this->record(record);
+}
+
+void BlackboxSystem::recordActuators(uint32_t timestamp, const ActuatorFrame &frame)
+{
+	if (!isRecording())
+		return;
+
+	BlackboxRecord record;
+	record.m_Type = BlackboxRecordType::Actuators;
+	record.m_Timestamp = timestamp;
+	record.m_Fields[0] = EncodeBlackboxFixed(frame.m_LeftRotor);
+	record.m_Fields[1] = EncodeBlackboxFixed(frame.m_RightRotor);
+	record.m_Fields[2] = frame.m_LeftWing;
+	record.m_Fields[3] = frame.m_RightWing;
+	record.m_Fields[4] = frame.m_Elevator;
+	record.m_Fields[5] = frame.m_Rudder;
+	record.m_Fields[6] = static_cast<int32_t>(g_CurrentFlyMode);
+	this->record(record);
+}
+
+void BlackboxSystem::recordCalibration(uint32_t timestamp, const SensorCalibration &calibration)
+{
+	if (!isRecording())
+		return;
+
+	BlackboxRecord record;
+	record.m_Type = BlackboxRecordType::Calibration;
+	record.m_Timestamp = timestamp;
+	record.m_Fields[0] = EncodeBlackboxFloat(calibration.m_GyroscopeBias.m_X);
+	record.m_Fields[1] = EncodeBlackboxFloat(calibration.m_GyroscopeBias.m_Y);
+	record.m_Fields[2] = EncodeBlackboxFloat(calibration.m_GyroscopeBias.m_Z);
+	record.m_Fields[3] = EncodeBlackboxFloat(calibration.m_AccelerometerOffset.m_X);
+	record.m_Fields[4] = EncodeBlackboxFloat(calibration.m_AccelerometerOffset.m_Y);
+	record.m_Fields[5] = EncodeBlackboxFloat(calibration.m_AccelerometerOffset.m_Z);
+	record.m_Fields[6] = EncodeBlackboxFloat(calibration.m_Temperature);
+	this->record(record);
+}
+
+void BlackboxSystem::record(const BlackboxRecord &record)
+{
+	if (!m_Queue.push(record))
+		m_DroppedRecords.fetch_add(1, std::memory_order_relaxed);
+}
+
+void BlackboxSystem::writeBlock()
+{
+	const auto size = m_Encoder.finish(m_Sequence++);
+	if (!m_pStorage->onWrite(m_Encoder.getBlock(), size))
+	{
+		m_isRecording.store(false, std::memory_order_relaxed);
+		PEREGRINE_LOG_ERROR("Failed to write to the blackbox log, recording stopped.");
+	}
+
+	m_Encoder.reset();
+}
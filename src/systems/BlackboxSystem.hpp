@@ -0,0 +1,151 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "core/System.hpp"
+#include "core/ConcurrentQueue.hpp"
+#include "core/IBlackboxStorage.hpp"
+#include "core/Types.hpp"
+#include "algorithms/BlackboxEncoder.hpp"
+#include "components/MPU6050Registers.hpp"
+
+// The queue holds about 140 ms of records at the full loop rate, which covers the time it takes to write a block to the flash a page at a
+// time (about 25 ms, and up to 65 ms with the slowest pages).
+constexpr auto g_BlackboxQueueSize = 512;
+
+// A block which is not full yet is written after this time, so at most this much of the log is lost when the power is cut (microseconds).
+constexpr uint32_t g_BlackboxFlushInterval = 1000000;
+
+struct ActuatorFrame;
+
+/**
+ * @brief Blackbox system class.
+ * This records the flight at the full loop rate: the raw sensor samples, the data link inputs, the estimated attitude, the rate controller
+ * terms, the actuator commands and the sensor calibrations. The systems record from both cores into a lock-free queue, which only costs a
+ * copy. The update encodes the records into blocks (see BlackboxEncoder) and writes the full blocks to the storage, so it must run in a
+ * task of its own, where waiting for the flash does not delay the control loop.
+ *
+ * Nothing is recorded until the system is initialized. When the queue is full, the records are dropped and counted.
+ */
+class BlackboxSystem final : public System<BlackboxSystem>
+{
+public:
+	/**
+	 * @brief Construct a new Blackbox System object.
+	 */
+	BlackboxSystem() = default;
+
+	/**
+	 * @brief Initialize the blackbox system and start recording.
+	 *
+	 * @param pStorage The storage pointer.
+	 */
+	void initialize(IBlackboxStorage *pStorage);
+
+	/**
+	 * @brief Update the blackbox system.
+	 * This encodes the queued records and writes the blocks which are full or due.
+	 */
+	void update() override;
+
+	/**
+	 * @brief Write the records which are not written yet and close the log.
+	 * This should be called when the recording ends, for example at the end of a simulation. Nothing is recorded afterwards.
+	 */
+	void stop();
+
+	/**
+	 * @brief Record a raw sensor sample.
+	 *
+	 * @param sample The raw sample.
+	 * @param deltaTime The time since the previous sample in seconds.
+	 * @param timestamp The time at which the sample was read in microseconds.
+	 */
+	void recordIMU(const RawIMUSample &sample, float deltaTime, uint32_t timestamp);
+
+	/**
+	 * @brief Record an attitude sample.
+	 *
+	 * @param sample The attitude sample.
+	 */
+	void recordAttitude(const AttitudeSample &sample);
+
+	/**
+	 * @brief Record a rate controller update.
+	 *
+	 * @param timestamp The time of the sample which was controlled in microseconds.
+	 * @param setpoints The rate setpoints.
+	 * @param control The rate controller outputs and terms.
+	 */
+	void recordRateControl(uint32_t timestamp, Vec3 setpoints, const RateControlSample &control);
+
+	/**
+	 * @brief Record the inputs of a new data link frame.
+	 * The fly mode and the control mode are recorded from the global state.
+	 *
+	 * @param timestamp The time at which the frame was read in microseconds.
+	 * @param inputs The inputs.
+	 * @param frameTimestamp The data link's timestamp of the frame.
+	 */
+	void recordInputs(uint32_t timestamp, const Setpoint &inputs, uint32_t frameTimestamp);
+
+	/**
+	 * @brief Record the actuator commands.
+	 * The current fly mode is recorded from the global state.
+	 *
+	 * @param timestamp The time at which the commands were mixed in microseconds.
+	 * @param frame The actuator commands.
+	 */
+	void recordActuators(uint32_t timestamp, const ActuatorFrame &frame);
+
+	/**
+	 * @brief Record the sensor calibration.
+	 * This is recorded when the calibration changes and once when recording starts, so a replay corrects the samples the same way.
+	 *
+	 * @param timestamp The time from which the calibration is used in microseconds.
+	 * @param calibration The calibration.
+	 */
+	void recordCalibration(uint32_t timestamp, const SensorCalibration &calibration);
+
+	/**
+	 * @brief Check if the system is recording.
+	 *
+	 * @return true If the records are kept.
+	 * @return false If the records are ignored.
+	 */
+	[[nodiscard]] bool isRecording() const { return m_isRecording.load(std::memory_order_relaxed); }
+
+	/**
+	 * @brief Get the number of records dropped because the queue was full.
+	 *
+	 * @return The dropped record count.
+	 */
+	[[nodiscard]] uint32_t getDroppedRecords() const { return m_DroppedRecords.load(std::memory_order_relaxed); }
+
+private:
+	/**
+	 * @brief Queue a record.
+	 *
+	 * @param record The record.
+	 */
+	void record(const BlackboxRecord &record);
+
+	/**
+	 * @brief Write the current block to the storage and start the next one.
+	 * Recording stops when the storage fails.
+	 */
+	void writeBlock();
+
+private:
+	ConcurrentQueue<BlackboxRecord, g_BlackboxQueueSize> m_Queue;
+	BlackboxEncoder m_Encoder;
+
+	IBlackboxStorage *m_pStorage = nullptr;
+	uint32_t m_Sequence = 0;
+
+	std::atomic<uint32_t> m_DroppedRecords = {0};
+	uint32_t m_ReportedDroppedRecords = 0;
+
+	std::atomic<bool> m_isRecording = {false};
+};
\ No newline at end of file
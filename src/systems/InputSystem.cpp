@@ -2,8 +2,31 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "InputSystem.hpp"
+#include "TelemetrySystem.hpp"
+#include "BlackboxSystem.hpp"
 
+#include "core/Configuration.hpp"
+#include "core/Constants.hpp"
 #include "core/Logging.hpp"
+#include "core/StageProfiler.hpp"
+
+/**
+ * @brief Interpolate between two setpoints.
+ *
+ * @param from The setpoint at 0.
+ * @param to The setpoint at 1.
+ * @param blend The blend factor. Values above 1 extrapolate.
+ * @return The interpolated setpoint.
+ */
+static Setpoint Interpolate(const Setpoint &from, const Setpoint &to, float blend)
+{
+	Setpoint setpoint;
+	setpoint.m_Thrust = from.m_Thrust + ((to.m_Thrust - from.m_Thrust) * blend);
+	setpoint.m_Pitch = from.m_Pitch + ((to.m_Pitch - from.m_Pitch) * blend);
+	setpoint.m_Roll = from.m_Roll + ((to.m_Roll - from.m_Roll) * blend);
+	setpoint.m_Yaw = from.m_Yaw + ((to.m_Yaw - from.m_Yaw) * blend);
+	return setpoint;
+}
 
 void InputSystem::initialize(IDataLink *pDataLink)
 {
@@ -28,6 +51,8 @@ void InputSystem::initialize(IDataLink *pDataLink)
 
 void InputSystem::update()
 {
+	PEREGRINE_PROFILE_STAGE(ProfileStage::Input);
+
 #ifdef PEREGRINE_DEBUG
 	// Validate the data link pointer.
 	if (!m_pDataLink)
@@ -39,4 +64,81 @@ void InputSystem::update()
 #endif
 
 	m_pDataLink->onUpdate();
+	publishLinkQuality();
+
+	// Only read the inputs when the data link received new ones.
+	const auto timestamp = m_pDataLink->onGetTimestamp();
+	if (timestamp != 0 && timestamp == m_LatestTimestamp)
+		return;
+
+	const auto period = timestamp - m_LatestTimestamp;
+	m_FramePeriod = (timestamp == 0 || m_LatestTimestamp == 0 || period > g_MaximumInputFramePeriod) ? 0 : period;
+	m_LatestTimestamp = timestamp;
+
+	const auto inputs = readInputs();
+	m_PreviousInputs = m_FramePeriod == 0 ? inputs : m_LatestInputs;
+	m_LatestInputs = inputs;
+
+	// The scaled inputs are recorded, so a replay with the default input ranges reproduces them.
+	BlackboxSystem::Instance().recordInputs(micros(), inputs, timestamp);
+}
+
+Setpoint InputSystem::getSetpoint(uint32_t time)
+{
+	auto setpoint = m_LatestInputs;
+	if (m_FramePeriod > 0)
+	{
+		const auto elapsed = time - m_LatestTimestamp;
+		const auto blend = elapsed < m_FramePeriod ? static_cast<float>(elapsed) / m_FramePeriod : 1.0f;
+
+#ifdef PEREGRINE_SETPOINT_PREDICTION
+		// Continue the latest change for up to one frame period, which is where the next frame is expected to be.
+		setpoint = Interpolate(m_PreviousInputs, m_LatestInputs, 1.0f + blend);
+
+#else
+		// Move from the previous inputs to the latest ones over one frame period.
+		setpoint = Interpolate(m_PreviousInputs, m_LatestInputs, blend);
+
+#endif
+	}
+
+	m_isSetpointUnchanged = setpoint.m_Thrust == m_Setpoint.m_Thrust && setpoint.m_Pitch == m_Setpoint.m_Pitch && setpoint.m_Roll == m_Setpoint.m_Roll &&
+							setpoint.m_Yaw == m_Setpoint.m_Yaw;
+	m_Setpoint = setpoint;
+
+	return setpoint;
+}
+
+Setpoint InputSystem::readInputs()
+{
+	Setpoint inputs;
+	inputs.m_Thrust = m_pDataLink->onGetThrust();
+	inputs.m_Pitch = m_pDataLink->onGetPitch() * m_PitchScale;
+	inputs.m_Roll = m_pDataLink->onGetRoll() * m_RollScale;
+	inputs.m_Yaw = m_pDataLink->onGetYaw() * m_YawScale;
+	return inputs;
+}
+
+void InputSystem::setParameters(const ParameterSet &parameters)
+{
+	m_PitchScale = static_cast<float>(parameters.m_PitchInputRange) / g_PitchInputMaximum;
+	m_RollScale = static_cast<float>(parameters.m_RollInputRange) / g_RollInputMaximum;
+	m_YawScale = static_cast<float>(parameters.m_YawInputRange) / g_YawInputMaximum;
+}
+
+void InputSystem::publishLinkQuality()
+{
+	auto &telemetrySystem = TelemetrySystem::Instance();
+	if (!telemetrySystem.isSubscribed(TelemetryMessageID::LinkQuality))
+		return;
+
+	const auto quality = m_pDataLink->onGetLinkQuality();
+	LinkQualityMessage message;
+	message.m_Received = quality.m_Received;
+	message.m_Lost = quality.m_Lost;
+	message.m_Errors = quality.m_Errors;
+	message.m_RemoteTimestamp = quality.m_RemoteTimestamp;
+	message.m_Age = quality.m_Age;
+	message.m_Jitter = quality.m_Jitter;
+	telemetrySystem.publish(TelemetryMessageID::LinkQuality, message);
 }
@@ -5,6 +5,11 @@
 
 #include "core/System.hpp"
 #include "core/IDataLink.hpp"
+#include "core/Types.hpp"
+
+// Frames which are further apart than this are not interpolated and the setpoint steps to the latest inputs (microseconds). This happens
+// on the first frame and after frames were lost.
+constexpr uint32_t g_MaximumInputFramePeriod = 25000;
 
 /**
  * @brief Input system class.
@@ -31,37 +36,61 @@ public:
 	void update() override;
 
 	/**
-	 * @brief Get thrust method.
-	 * Return the required thrust.
+	 * @brief Get the setpoint for a control tick.
+	 * The inputs only change when a new frame arrives (every few milliseconds), so the setpoint is moved from the previous inputs to the
+	 * latest ones over one frame period instead of stepping. When PEREGRINE_SETPOINT_PREDICTION is defined, the latest change is
+	 * extrapolated instead, which removes the delay of a frame period but overshoots when the sticks stop.
 	 *
-	 * @return The trust value (0 - 1000).
+	 * @param time The time of the control tick in microseconds.
+	 * @return The setpoint.
 	 */
-	[[nodiscard]] float getThrust() { return m_pDataLink->onGetThrust(); }
+	[[nodiscard]] Setpoint getSetpoint(uint32_t time);
 
 	/**
-	 * @brief Get pitch method.
-	 * Required pitch value.
+	 * @brief Check if the last setpoint is the same as the one before it.
+	 * This can be used to skip the work which only depends on the setpoint.
 	 *
-	 * @return The pitch value (-90 - 90).
+	 * @return true If the setpoint did not change.
+	 * @return false If the setpoint changed.
 	 */
-	[[nodiscard]] float getPitch() { return m_pDataLink->onGetPitch(); }
+	[[nodiscard]] bool isSetpointUnchanged() const { return m_isSetpointUnchanged; }
 
 	/**
-	 * @brief Get roll method.
-	 * Required roll value.
+	 * @brief Use new input ranges.
+	 * The pitch, roll and yaw of the data link are scaled from their default range to these, from the next frame on. It must be called in
+	 * between the updates.
 	 *
-	 * @return The roll value (-90 - 90).
+	 * @param parameters The parameters.
 	 */
-	[[nodiscard]] float getRoll() { return m_pDataLink->onGetRoll(); }
+	void setParameters(const ParameterSet &parameters);
 
+private:
 	/**
-	 * @brief Get yaw method.
-	 * Return the required yaw value.
+	 * @brief Read the inputs from the data link.
 	 *
-	 * @return The yaw value (-90 - 90).
+	 * @return The inputs.
+	 */
+	[[nodiscard]] Setpoint readInputs();
+
+	/**
+	 * @brief Publish the link quality of the data link.
 	 */
-	[[nodiscard]] float getYaw() { return m_pDataLink->onGetYaw(); }
+	void publishLinkQuality();
 
 private:
 	IDataLink *m_pDataLink = nullptr;
+
+	Setpoint m_PreviousInputs;
+	Setpoint m_LatestInputs;
+	Setpoint m_Setpoint;
+
+	uint32_t m_LatestTimestamp = 0;
+	uint32_t m_FramePeriod = 0;
+
+	bool m_isSetpointUnchanged = false;
+
+	// The scales from the default input ranges to the ranges of the parameters.
+	float m_PitchScale = 1.0f;
+	float m_RollScale = 1.0f;
+	float m_YawScale = 1.0f;
 };
\ No newline at end of file
@@ -0,0 +1,133 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#include "LoggingSystem.hpp"
+#include "TelemetrySystem.hpp"
+
+#include <stdio.h>
+#include <string.h>
+
+constexpr char g_LogLevelCharacters[] = {'D', 'I', 'W', 'E'};
+
+void SubmitLogEntry(const LogEntry &entry)
+{
+	LoggingSystem::Instance().submit(entry);
+}
+
+void LoggingSystem::update()
+{
+	auto &telemetry = TelemetrySystem::Instance();
+	char line[g_MaxLogLineSize];
+
+	// Report the dropped entries first, so the gap in the log is visible.
+	const auto droppedEntries = m_DroppedEntries.load(std::memory_order_relaxed);
+	if (droppedEntries != m_ReportedDroppedEntries && telemetry.getTransmitFreeSize() >= g_MaxLogLineSize)
+	{
+		const auto size = snprintf(line, sizeof(line), "%s[%lu entries dropped]\n", m_isLineStart ? "" : "\n", static_cast<unsigned long>(droppedEntries - m_ReportedDroppedEntries));
+		telemetry.sendText(line, size);
+
+		m_ReportedDroppedEntries = droppedEntries;
+		m_isLineStart = true;
+	}
+
+	// Only take an entry when there is room to transmit it, so that entries are never lost after being taken.
+	LogEntry entry;
+	for (uint8_t i = 0; i < g_MaxLogEntriesPerUpdate; i++)
+	{
+		if (telemetry.getTransmitFreeSize() < g_MaxLogLineSize || !m_Queue.pop(entry))
+			break;
+
+		const auto size = format(entry, line, sizeof(line));
+		telemetry.sendText(line, size);
+	}
+}
+
+void LoggingSystem::submit(const LogEntry &entry)
+{
+	if (!m_Queue.push(entry))
+		m_DroppedEntries.fetch_add(1, std::memory_order_relaxed);
+}
+
+size_t LoggingSystem::format(const LogEntry &entry, char *pBuffer, size_t size)
+{
+	// Leave room for the new line and the terminator.
+	const auto limit = size - 2;
+	size_t length = 0;
+
+	const auto append = [&](int written)
+	{
+		if (written > 0)
+			length += static_cast<size_t>(written);
+
+		if (length > limit)
+			length = limit;
+	};
+
+	// Prefix each line with the time in milliseconds and the level.
+	if (m_isLineStart)
+		append(snprintf(pBuffer, size, "[%lu.%03lu] %c: ", static_cast<unsigned long>(entry.m_Timestamp / 1000000), static_cast<unsigned long>((entry.m_Timestamp / 1000) % 1000), g_LogLevelCharacters[static_cast<uint8_t>(entry.m_Level)]));
+
+	uint8_t argumentIndex = 0;
+	for (auto pCharacter = entry.m_pFormat; *pCharacter != '\0' && length < limit; pCharacter++)
+	{
+		if (*pCharacter != '%')
+		{
+			pBuffer[length++] = *pCharacter;
+			continue;
+		}
+
+		if (*(pCharacter + 1) == '%')
+		{
+			pBuffer[length++] = '%';
+			pCharacter++;
+			continue;
+		}
+
+		// Copy the flags, width and precision of the specifier, the length modifier and the conversion are chosen by the argument type.
+		char specifier[16] = {'%'};
+		uint8_t specifierLength = 1;
+		pCharacter++;
+		while (*pCharacter != '\0' && strchr("-+ #0123456789.", *pCharacter) && specifierLength < sizeof(specifier) - 4)
+			specifier[specifierLength++] = *pCharacter++;
+
+		while (*pCharacter != '\0' && strchr("hlLqjzt", *pCharacter))
+			pCharacter++;
+
+		const auto conversion = *pCharacter;
+		if (conversion == '\0' || argumentIndex == entry.m_ArgumentCount)
+			break;
+
+		const auto &argument = entry.m_Arguments[argumentIndex++];
+		switch (argument.m_Type)
+		{
+		case LogArgumentType::Integer:
+			specifier[specifierLength++] = 'l';
+			specifier[specifierLength++] = 'd';
+			append(snprintf(pBuffer + length, size - length, specifier, static_cast<long>(argument.m_Integer)));
+			break;
+
+		case LogArgumentType::Unsigned:
+			specifier[specifierLength++] = 'l';
+			specifier[specifierLength++] = strchr("xXo", conversion) ? conversion : 'u';
+			append(snprintf(pBuffer + length, size - length, specifier, static_cast<unsigned long>(argument.m_Unsigned)));
+			break;
+
+		case LogArgumentType::Float:
+			specifier[specifierLength++] = strchr("eEgG", conversion) ? conversion : 'f';
+			append(snprintf(pBuffer + length, size - length, specifier, static_cast<double>(argument.m_Float)));
+			break;
+
+		case LogArgumentType::String:
+			specifier[specifierLength++] = 's';
+			append(snprintf(pBuffer + length, size - length, specifier, argument.m_String));
+			break;
+		}
+	}
+
+	if (entry.m_NewLine)
+		pBuffer[length++] = '\n';
+
+	m_isLineStart = entry.m_NewLine;
+	pBuffer[length] = '\0';
+	return length;
+}
@@ -0,0 +1,68 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "core/System.hpp"
+#include "core/ConcurrentQueue.hpp"
+#include "core/Logging.hpp"
+
+constexpr auto g_LogQueueSize = 64;
+constexpr auto g_MaxLogLineSize = 128;
+
+// The maximum number of entries formatted in a single update, to keep the idle slot short.
+constexpr auto g_MaxLogEntriesPerUpdate = 4;
+
+/**
+ * @brief Logging system class.
+ * The logging macros only record the format string and the raw arguments into a lock-free queue, which can be done from any task on any
+ * core. This system then formats the entries and hands them to the telemetry system for transmission. It's intended to run in the idle
+ * slot of the control loop, so logging costs the same few cycles in every build.
+ */
+class LoggingSystem final : public System<LoggingSystem>
+{
+public:
+	/**
+	 * @brief Construct a new Logging System object.
+	 */
+	LoggingSystem() = default;
+
+	/**
+	 * @brief Update the logging system.
+	 * This formats and transmits the queued entries.
+	 */
+	void update() override;
+
+	/**
+	 * @brief Submit a log entry.
+	 *
+	 * @param entry The entry to submit.
+	 */
+	void submit(const LogEntry &entry);
+
+	/**
+	 * @brief Get the number of entries dropped because the queue was full.
+	 *
+	 * @return The dropped entry count.
+	 */
+	[[nodiscard]] uint32_t getDroppedEntries() const { return m_DroppedEntries.load(std::memory_order_relaxed); }
+
+private:
+	/**
+	 * @brief Format a log entry.
+	 *
+	 * @param entry The entry to format.
+	 * @param pBuffer The buffer to format to.
+	 * @param size The size of the buffer.
+	 * @return The formatted size.
+	 */
+	size_t format(const LogEntry &entry, char *pBuffer, size_t size);
+
+private:
+	ConcurrentQueue<LogEntry, g_LogQueueSize> m_Queue;
+
+	std::atomic<uint32_t> m_DroppedEntries = {0};
+	uint32_t m_ReportedDroppedEntries = 0;
+
+	bool m_isLineStart = true;
+};
\ No newline at end of file
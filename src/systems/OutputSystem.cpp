@@ -5,43 +5,40 @@
 
 #include "InputSystem.hpp"
 #include "Stabilizer.hpp"
+#include "TelemetrySystem.hpp"
+#include "BlackboxSystem.hpp"
 
 #include "core/Common.hpp"
-#include "core/Constants.hpp"
 #include "core/GlobalState.hpp"
 #include "core/Logging.hpp"
-
-constexpr auto g_RotorMinPWM = 1000;
-constexpr auto g_RotorMaxPWM = 2000;
+#include "core/StageProfiler.hpp"
 
 constexpr auto g_ServoMinimum = 0;
 constexpr auto g_ServoMaximum = 180;
 
 constexpr auto g_InputMidValue = 90;
 
-void OutputSystem::initialize()
+void OutputSystem::initialize(IRotorOutput *pRotorOutput)
 {
 	PEREGRINE_PRINTLN("Initializing the output system.");
+	m_pRotorOutput = pRotorOutput;
 
-	// Attach the rotors.
-	m_LeftRotor.attach(g_LeftRotorPin, g_RotorMinPWM, g_RotorMaxPWM);
-	m_RightRotor.attach(g_RightRotorPin, g_RotorMinPWM, g_RotorMaxPWM);
+	// Initialize the rotor output. This stops the rotors.
+	m_pRotorOutput->onInitialize(g_LeftRotorPin, g_RightRotorPin);
 
 	// Attach the wing servos.
 	m_LeftWingServo.attach(g_LeftWingServoPin);
 	m_RightWingServo.attach(g_RightWingServoPin);
-	// pinMode(g_LeftWingServoPin, OUTPUT);
-	// pinMode(g_RightWingServoPin, OUTPUT);
 
 	// Attach the elevator and rudder.
 	m_ElevatorServo.attach(g_ElevatorServoPin);
 	m_RudderServo.attach(g_RudderServoPin);
 
-	// Write the default values to the servos.
-	m_LeftWingServo.write(g_WingServoOffsetHover);
-	m_RightWingServo.write(g_WingServoOffsetHover);
-	m_ElevatorServo.write(g_ElevatorOffset);
-	m_RudderServo.write(g_RudderOffset);
+	// Write the hover mode's resting position to the servos. The PWM frames start when the servos are attached, so the commits are
+	// aligned with them.
+	mixOutputs(0.0f, Vec3());
+	commitFrame(true);
+	m_CommitTime = micros();
 
 	PEREGRINE_PRINTLN("Output system initialized.");
 }
@@ -49,162 +46,147 @@ void OutputSystem::initialize()
 void OutputSystem::update()
 {
 	// Control algorithm
-	// Throttle is controlled by the rotor speed.
-	//
-	// Hover mode:
-	// * Pitch is controlled by the wing servos. The servos can both move front or back depending on the pitch.
-	// * Roll is controlled by the rotors. More thrust in either one of the rotors will result in the roll.
-	// * Yaw is controlled by the wing servos. The servos will move in opposite directions and thus rotating the drone.
-	// * The wing servos have an offset of 45 degrees.
-	// * The elevator and rudder servos are disabled (not used).
-	//
-	// Cruise mode:
-	// * Pitch is controlled by the wing servos. The servos can both move up or down depending on the pitch. The elevator will also help with pitch.
-	// * Roll is controlled by the wing servos. The servos will move in opposite directions (up and down) and thus rolling the drone.
-	// * Yaw is controlled by the rotors. More thrust in either one of the rotors will result in teh roll. The rudder will also help with yaw.
-	// * The wing servos have an offset of 135 degrees.
-
-	const auto inputThrust = InputSystem::Instance().getThrust();
-	const auto inputPitch = InputSystem::Instance().getPitch();
-	const auto inputRoll = InputSystem::Instance().getRoll();
-	const auto inputYaw = InputSystem::Instance().getYaw();
-
-	const auto outputs = Stabilizer::Instance().computeOutputs(inputThrust, inputPitch, inputRoll, inputYaw);
-
-	if (g_CurrentFlyMode == FlyMode::Hover)
-		handleHoverMode(inputThrust, outputs);
+	// Throttle is controlled by the rotor speed. The rest is described by the mixer matrices (g_HoverMixer and g_CruiseMixer).
+
+	const auto currentTime = micros();
+	updateTransition(currentTime);
+
+	auto &inputSystem = InputSystem::Instance();
+	const auto setpoint = inputSystem.getSetpoint(currentTime);
+
+	// The thrust only needs to be mapped when the setpoint changed.
+	if (!inputSystem.isSetpointUnchanged())
+		m_MappedThrust = map(setpoint.m_Thrust, g_ThrottleInputMinimum, g_ThrottleInputMaximum, g_ServoMinimum, g_ServoMaximum);
+
+	auto &stabilizer = Stabilizer::Instance();
+	const auto outputs = stabilizer.computeOutputs(setpoint.m_Thrust, setpoint.m_Pitch, setpoint.m_Roll, setpoint.m_Yaw);
+
+	SetpointsMessage setpoints;
+	setpoints.m_Thrust = setpoint.m_Thrust;
+	setpoints.m_Pitch = setpoint.m_Pitch;
+	setpoints.m_Roll = setpoint.m_Roll;
+	setpoints.m_Yaw = setpoint.m_Yaw;
+	setpoints.m_FlyMode = static_cast<uint8_t>(g_CurrentFlyMode);
+	TelemetrySystem::Instance().publish(TelemetryMessageID::Setpoints, setpoints);
+
+	// The rotors stay stopped until the controller is armed.
+	mixOutputs(stabilizer.isArmed() ? m_MappedThrust : 0.0f, outputs);
+	BlackboxSystem::Instance().recordActuators(currentTime, m_Frames[m_PendingFrame]);
+
+	commitOutputs(currentTime);
+}
+
+void OutputSystem::setParameters(const ParameterSet &parameters)
+{
+	const auto elevator = static_cast<float>(parameters.m_ElevatorOffset);
+	const auto rudder = static_cast<float>(parameters.m_RudderOffset);
+
+	// The offsets are set up like the ones of g_HoverMixer and g_CruiseMixer.
+	auto &hover = m_HoverMixer.m_Offsets;
+	hover[static_cast<uint8_t>(MixerOutput::LeftWing)] = parameters.m_WingServoOffsetHover / 2.0f;
+	hover[static_cast<uint8_t>(MixerOutput::RightWing)] = 180.0f - (parameters.m_WingServoOffsetHover / 2.0f);
+	hover[static_cast<uint8_t>(MixerOutput::Elevator)] = elevator;
+	hover[static_cast<uint8_t>(MixerOutput::Rudder)] = rudder;
+
+	auto &cruise = m_CruiseMixer.m_Offsets;
+	cruise[static_cast<uint8_t>(MixerOutput::LeftWing)] = 90.0f + (parameters.m_WingServoOffsetCruise / 2.0f);
+	cruise[static_cast<uint8_t>(MixerOutput::RightWing)] = 90.0f - (parameters.m_WingServoOffsetCruise / 2.0f);
+	cruise[static_cast<uint8_t>(MixerOutput::Elevator)] = elevator;
+	cruise[static_cast<uint8_t>(MixerOutput::Rudder)] = rudder;
+
+	m_Mixer = BlendMixers(m_HoverMixer, m_CruiseMixer, m_TransitionProgress);
+}
+
+void OutputSystem::updateTransition(uint32_t time)
+{
+	const auto delta = m_PreviousTime == 0 ? 0 : time - m_PreviousTime;
+	m_PreviousTime = time;
+
+	const auto target = g_RequiredFlyMode == FlyMode::Cruise ? 1.0f : 0.0f;
+	if (m_TransitionProgress == target)
+		return;
+
+	const auto step = static_cast<float>(delta) / g_FlyModeTransitionTime;
+	if (m_TransitionProgress < target)
+		m_TransitionProgress = m_TransitionProgress + step < target ? m_TransitionProgress + step : target;
 	else
-		handleCruiseMode(inputThrust, outputs);
+		m_TransitionProgress = m_TransitionProgress - step > target ? m_TransitionProgress - step : target;
+
+	m_Mixer = BlendMixers(m_HoverMixer, m_CruiseMixer, m_TransitionProgress);
+
+	// The fly mode only changes when the wings reached the new position. A transition can be reversed at any point.
+	if (m_TransitionProgress == target)
+	{
+		g_CurrentFlyMode = g_RequiredFlyMode;
+		PEREGRINE_PRINTLN(g_CurrentFlyMode == FlyMode::Cruise ? "Transitioned to the cruise mode." : "Transitioned to the hover mode.");
+	}
+}
+
+void OutputSystem::mixOutputs(float thrust, Vec3 outputs)
+{
+	float values[g_MixerOutputCount];
+	Mix(m_Mixer, thrust, outputs, values);
+
+	const auto servo = [&values](MixerOutput output)
+	{
+		return static_cast<int>(values[static_cast<uint8_t>(output)] + 0.5f);
+	};
+
+	m_MixedFrame = m_PendingFrame;
+
+	auto &frame = m_Frames[m_PendingFrame];
+	frame.m_LeftRotor = values[static_cast<uint8_t>(MixerOutput::LeftRotor)];
+	frame.m_RightRotor = values[static_cast<uint8_t>(MixerOutput::RightRotor)];
+	frame.m_LeftWing = servo(MixerOutput::LeftWing);
+	frame.m_RightWing = servo(MixerOutput::RightWing);
+	frame.m_Elevator = servo(MixerOutput::Elevator);
+	frame.m_Rudder = servo(MixerOutput::Rudder);
 }
 
-void OutputSystem::handleHoverMode(float thrust, Vec3 outputs)
+void OutputSystem::commitOutputs(uint32_t time)
 {
-	const auto mappedThrust = map(thrust, g_ThrottleInputMinimum, g_ThrottleInputMaximum, g_ServoMinimum, g_ServoMaximum);
-
-	float leftRotorThrust = mappedThrust;
-	float rightRotorThrust = mappedThrust;
-
-	float leftWingAngle = g_WingServoOffsetHover;
-	float rightWingAngle = g_WingServoOffsetHover;
-
-	// Handle pitch
-	leftWingAngle += outputs.m_Pitch;
-	rightWingAngle += outputs.m_Pitch;
-
-	// Handle yaw
-	leftWingAngle += outputs.m_Yaw;
-	rightWingAngle -= outputs.m_Yaw;
-
-	// Handle roll
-	leftRotorThrust += outputs.m_Roll;
-	rightRotorThrust -= outputs.m_Roll;
-
-	// Clamp the values to the required ranges.
-	leftWingAngle = clamp(static_cast<int>(leftWingAngle), g_ServoMinimum, g_ServoMaximum);
-	rightWingAngle = clamp(static_cast<int>(rightWingAngle), g_ServoMinimum, g_ServoMaximum);
-
-	leftRotorThrust = clamp(static_cast<int>(leftRotorThrust), g_ServoMinimum, g_ServoMaximum);
-	rightRotorThrust = clamp(static_cast<int>(rightRotorThrust), g_ServoMinimum, g_ServoMaximum);
-
-	// Print everything.
-	PEREGRINE_PRINT("FlyMode: Hover");
-	PEREGRINE_PRINT(" | LMT: ");
-	PEREGRINE_PRINT(leftRotorThrust);
-	PEREGRINE_PRINT(" | RMT: ");
-	PEREGRINE_PRINT(rightRotorThrust);
-	PEREGRINE_PRINT(" | LWA: ");
-	PEREGRINE_PRINT(leftWingAngle);
-	PEREGRINE_PRINT(" | RWA: ");
-	PEREGRINE_PRINT(rightWingAngle);
-	PEREGRINE_PRINT(" | Pitch: ");
-	PEREGRINE_PRINT(outputs.m_Pitch);
-	PEREGRINE_PRINT(" | Roll: ");
-	PEREGRINE_PRINT(outputs.m_Roll);
-	PEREGRINE_PRINT(" | Yaw: ");
-	PEREGRINE_PRINT(outputs.m_Yaw);
-	PEREGRINE_PRINTLN();
-
-	// Write to the rotors
-	m_LeftRotor.write(leftRotorThrust);
-	m_RightRotor.write(rightRotorThrust);
+	PEREGRINE_PROFILE_STAGE(ProfileStage::OutputWrite);
 
-	// Write to the wing servos.
-	m_LeftWingServo.write(map(leftWingAngle, 0, 180, 0, 90));
-	m_RightWingServo.write(180 - map(rightWingAngle, 0, 180, 0, 90));
+	// The rotors get the commands of every tick.
+	const auto &pending = m_Frames[m_PendingFrame];
+	m_pRotorOutput->onWrite(pending.m_LeftRotor / g_ServoMaximum, pending.m_RightRotor / g_ServoMaximum);
 
-	// Write to the elevator and rudder.
-	m_ElevatorServo.write(g_ElevatorOffset);
-	m_RudderServo.write(g_RudderOffset);
+	if (time - m_CommitTime < g_ServoFramePeriod)
+		return;
+
+	// Stay aligned with the frames, unless a whole frame was missed.
+	m_CommitTime = time - m_CommitTime < 2 * g_ServoFramePeriod ? m_CommitTime + g_ServoFramePeriod : time;
+	commitFrame(false);
 }
 
-void OutputSystem::handleCruiseMode(float thrust, Vec3 outputs)
+void OutputSystem::commitFrame(bool force)
 {
-	const auto mappedThrust = map(thrust, g_ThrottleInputMinimum, g_ThrottleInputMaximum, g_ServoMinimum, g_ServoMaximum);
-
-	float leftRotorThrust = mappedThrust;
-	float rightRotorThrust = mappedThrust;
-
-	float leftWingAngle = g_WingServoOffsetCruise;
-	float rightWingAngle = g_WingServoOffsetCruise;
-
-	float elevatorAngle = g_ElevatorOffset;
-	float rudderAngle = g_RudderOffset;
-
-	// Handle pitch
-	leftWingAngle += outputs.m_Pitch;
-	rightWingAngle += outputs.m_Pitch;
-	elevatorAngle += outputs.m_Pitch;
-
-	// Handle yaw
-	leftRotorThrust += outputs.m_Yaw;
-	rightRotorThrust -= outputs.m_Yaw;
-	rudderAngle += outputs.m_Pitch;
-
-	// Handle roll
-	leftWingAngle += outputs.m_Roll;
-	rightWingAngle -= outputs.m_Roll;
-
-	// Clamp the values to the required ranges.
-	leftWingAngle = clamp(static_cast<int>(leftWingAngle), g_ServoMinimum, g_ServoMaximum);
-	rightWingAngle = clamp(static_cast<int>(rightWingAngle), g_ServoMinimum, g_ServoMaximum);
-
-	leftRotorThrust = clamp(static_cast<int>(leftRotorThrust), g_ServoMinimum, g_ServoMaximum);
-	rightRotorThrust = clamp(static_cast<int>(rightRotorThrust), g_ServoMinimum, g_ServoMaximum);
-
-	elevatorAngle = clamp(static_cast<int>(elevatorAngle), g_ServoMinimum, g_ServoMaximum);
-	rudderAngle = clamp(static_cast<int>(rudderAngle), g_ServoMinimum, g_ServoMaximum);
-
-	// Print everything.
-	PEREGRINE_PRINT("FlyMode: Cruise");
-	PEREGRINE_PRINT(" | LMT: ");
-	PEREGRINE_PRINT(leftRotorThrust);
-	PEREGRINE_PRINT(" | RMT: ");
-	PEREGRINE_PRINT(rightRotorThrust);
-	PEREGRINE_PRINT(" | LWA: ");
-	PEREGRINE_PRINT(leftWingAngle);
-	PEREGRINE_PRINT(" | RWA: ");
-	PEREGRINE_PRINT(rightWingAngle);
-	PEREGRINE_PRINT(" | Elevator: ");
-	PEREGRINE_PRINT(elevatorAngle);
-	PEREGRINE_PRINT(" | Rudder: ");
-	PEREGRINE_PRINT(rudderAngle);
-	PEREGRINE_PRINT(" | Pitch: ");
-	PEREGRINE_PRINT(outputs.m_Pitch);
-	PEREGRINE_PRINT(" | Roll: ");
-	PEREGRINE_PRINT(outputs.m_Roll);
-	PEREGRINE_PRINT(" | Yaw: ");
-	PEREGRINE_PRINT(outputs.m_Yaw);
-	PEREGRINE_PRINTLN();
-
-	// Write to the rotors
-	m_LeftRotor.write(leftRotorThrust);
-	m_RightRotor.write(rightRotorThrust);
+	const auto &pending = m_Frames[m_PendingFrame];
+	const auto &committed = m_Frames[m_PendingFrame ^ 1];
 
 	// Write to the wing servos.
-	m_LeftWingServo.write(map(leftWingAngle, 0, 180, 90, 180));
-	m_RightWingServo.write(180 - map(rightWingAngle, 0, 180, 90, 180));
+	if (force || pending.m_LeftWing != committed.m_LeftWing)
+		m_LeftWingServo.write(pending.m_LeftWing);
+
+	if (force || pending.m_RightWing != committed.m_RightWing)
+		m_RightWingServo.write(pending.m_RightWing);
 
 	// Write to the elevator and rudder.
-	m_ElevatorServo.write(map(elevatorAngle, 0, 180, 45, 135));
-	m_RudderServo.write(map(rudderAngle, 0, 180, 45, 135));
+	if (force || pending.m_Elevator != committed.m_Elevator)
+		m_ElevatorServo.write(pending.m_Elevator);
+
+	if (force || pending.m_Rudder != committed.m_Rudder)
+		m_RudderServo.write(pending.m_Rudder);
+
+	ActuatorCommandsMessage commands;
+	commands.m_LeftRotor = static_cast<uint8_t>(pending.m_LeftRotor + 0.5f);
+	commands.m_RightRotor = static_cast<uint8_t>(pending.m_RightRotor + 0.5f);
+	commands.m_LeftWing = pending.m_LeftWing;
+	commands.m_RightWing = pending.m_RightWing;
+	commands.m_Elevator = pending.m_Elevator;
+	commands.m_Rudder = pending.m_Rudder;
+	TelemetrySystem::Instance().publish(TelemetryMessageID::ActuatorCommands, commands);
+
+	// The pending frame becomes the committed frame, and the next tick overwrites the previous one.
+	m_PendingFrame ^= 1;
 }
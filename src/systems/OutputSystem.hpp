@@ -3,8 +3,12 @@
 
 #pragma once
 
+#include "core/Configuration.hpp"
 #include "core/System.hpp"
+#include "core/IRotorOutput.hpp"
 #include "core/Types.hpp"
+#include "core/Constants.hpp"
+#include "algorithms/Mixer.hpp"
 
 #include <ESP32Servo.h>
 
@@ -16,9 +20,71 @@ constexpr auto g_RightWingServoPin = 26;
 constexpr auto g_ElevatorServoPin = 27;
 constexpr auto g_RudderServoPin = 14;
 
+// In the hover mode, a positive (nose up) pitch output tilts both rotors forward, or back when PEREGRINE_HOVER_PITCH_REVERSED is defined
+// (see core/Configuration.hpp).
+#ifdef PEREGRINE_HOVER_PITCH_REVERSED
+constexpr auto g_HoverPitchDirection = -1.0f;
+
+#else
+constexpr auto g_HoverPitchDirection = 1.0f;
+
+#endif
+
+// The mixer matrices of the fly modes (the columns are the thrust, pitch, roll and yaw). The wing servos travel 90 degrees in each mode,
+// so the wing controls move them by half of the control angle, and the right wing servo is mounted mirrored. The elevator and the rudder
+// travel 45 degrees to each side.
+//
+// In the hover mode, the roll is controlled by the rotors, and the pitch and yaw by tilting the wings together or in opposite directions.
+// The elevator and the rudder are centered.
+constexpr MixerMatrix g_HoverMixer = {
+	{{1.0f, 0.0f, 1.0f, 0.0f},
+	 {1.0f, 0.0f, -1.0f, 0.0f},
+	 {0.0f, 0.5f * g_HoverPitchDirection, 0.0f, 0.5f},
+	 {0.0f, -0.5f * g_HoverPitchDirection, 0.0f, 0.5f},
+	 {0.0f, 0.0f, 0.0f, 0.0f},
+	 {0.0f, 0.0f, 0.0f, 0.0f}},
+	{0.0f, 0.0f, g_WingServoOffsetHover / 2.0f, 180.0f - (g_WingServoOffsetHover / 2.0f), g_ElevatorOffset, g_RudderOffset},
+	{0.0f, 0.0f, 0.0f, 90.0f, 45.0f, 45.0f},
+	{180.0f, 180.0f, 90.0f, 180.0f, 135.0f, 135.0f}};
+
+// In the cruise mode, the yaw is controlled by the rotors and the rudder, the pitch by tilting the wings together and the elevator, and the
+// roll by tilting the wings in opposite directions.
+constexpr MixerMatrix g_CruiseMixer = {
+	{{1.0f, 0.0f, 0.0f, 1.0f},
+	 {1.0f, 0.0f, 0.0f, -1.0f},
+	 {0.0f, 0.5f, 0.5f, 0.0f},
+	 {0.0f, -0.5f, 0.5f, 0.0f},
+	 {0.0f, 0.5f, 0.0f, 0.0f},
+	 {0.0f, 0.0f, 0.0f, 0.5f}},
+	{0.0f, 0.0f, 90.0f + (g_WingServoOffsetCruise / 2.0f), 90.0f - (g_WingServoOffsetCruise / 2.0f), g_ElevatorOffset, g_RudderOffset},
+	{0.0f, 0.0f, 90.0f, 0.0f, 45.0f, 45.0f},
+	{180.0f, 180.0f, 180.0f, 90.0f, 135.0f, 135.0f}};
+
+/**
+ * @brief Actuator frame structure.
+ * These are the commands of all the actuators from a single control tick. The rotor values are not rounded, so the digital ESC protocols
+ * get their full resolution, and the servo angles are rounded to what the servos are written with. All the values are in the range of
+ * 0 - 180.
+ */
+struct ActuatorFrame final
+{
+	float m_LeftRotor = 0.0f;
+	float m_RightRotor = 0.0f;
+	int m_LeftWing = 0;
+	int m_RightWing = 0;
+	int m_Elevator = 0;
+	int m_Rudder = 0;
+};
+
 /**
  * @brief Output system class.
- * This class manages all the outputs, including the rotors and controlling servos.
+ * This class manages all the outputs, including the rotors and controlling servos. The stabilizer outputs are mixed into the actuator
+ * values using the mixer matrix of the current fly mode. When the required fly mode changes, the matrices are blended over the transition
+ * time, and the current fly mode changes once the transition is complete.
+ *
+ * The actuator commands are double buffered. Every update fills the pending frame, which is committed once per servo frame period, so all
+ * the servos get the commands of the same control tick and only the commands which changed are written. The rotors are written at the
+ * output rate, since the ESCs are much faster than the servos and the rotor outputs only send the throttles which changed.
  */
 class OutputSystem final : public System<OutputSystem>
 {
@@ -30,36 +96,65 @@ public:
 
 	/**
 	 * @brief Initialize the output system.
+	 *
+	 * @param pRotorOutput The rotor output pointer.
 	 */
-	void initialize();
+	void initialize(IRotorOutput *pRotorOutput);
 
 	/**
 	 * @brief Update the output system.
 	 */
 	void update() override;
 
+	/**
+	 * @brief Get the actuator commands mixed by the latest update.
+	 * The rotors are written on every update, the servos only at the next servo frame.
+	 *
+	 * @return The actuator commands.
+	 */
+	[[nodiscard]] const ActuatorFrame &getMixedFrame() const { return m_Frames[m_MixedFrame]; }
+
+	/**
+	 * @brief Use new servo offsets.
+	 * This replaces the offsets of the mixer matrices of both fly modes. It must be called in between the updates.
+	 *
+	 * @param parameters The parameters.
+	 */
+	void setParameters(const ParameterSet &parameters);
+
 private:
 	/**
-	 * @brief Handle the hover mode outputs.
-	 * This method gets called when the drone is in hover mode.
+	 * @brief Move the fly mode transition towards the required fly mode.
+	 * The mixer matrix is only blended while the transition is in progress.
+	 *
+	 * @param time The current time in microseconds.
+	 */
+	void updateTransition(uint32_t time);
+
+	/**
+	 * @brief Mix the thrust and the stabilizer outputs into the pending frame.
 	 *
-	 * @param thrust The input thrust.
-	 * @param outputs The PID outputs.
+	 * @param thrust The mapped thrust.
+	 * @param outputs The stabilizer outputs.
 	 */
-	void handleHoverMode(float thrust, Vec3 outputs);
+	void mixOutputs(float thrust, Vec3 outputs);
 
 	/**
-	 * @brief Handle the cruise mode outputs.
-	 * This method gets called when the drone is in cruise mode.
+	 * @brief Commit the pending frame if the next servo frame is due.
 	 *
-	 * @param thrust The input thrust.
-	 * @param outputs The PID outputs.
+	 * @param time The current time in microseconds.
 	 */
-	void handleCruiseMode(float thrust, Vec3 outputs);
+	void commitOutputs(uint32_t time);
+
+	/**
+	 * @brief Write the commands of the pending frame which differ from the committed frame, and make it the committed frame.
+	 *
+	 * @param force Whether to write all the commands.
+	 */
+	void commitFrame(bool force);
 
 private:
-	Servo m_LeftRotor;
-	Servo m_RightRotor;
+	IRotorOutput *m_pRotorOutput = nullptr;
 
 	Servo m_LeftWingServo;
 	Servo m_RightWingServo;
@@ -67,12 +162,20 @@ private:
 	Servo m_ElevatorServo;
 	Servo m_RudderServo;
 
-	int m_LeftRotorThrust = 0;
-	int m_RightRotorThrust = 0;
+	// The mixer matrices of the fly modes, with the offsets of the parameters, and the blended matrix which is used.
+	MixerMatrix m_HoverMixer = g_HoverMixer;
+	MixerMatrix m_CruiseMixer = g_CruiseMixer;
+	MixerMatrix m_Mixer = g_HoverMixer;
+
+	ActuatorFrame m_Frames[2];
+	uint8_t m_PendingFrame = 0;
+	uint8_t m_MixedFrame = 0;
+
+	uint32_t m_CommitTime = 0;
 
-	int m_LeftWingAngle = 90;
-	int m_RightWingAngle = 90;
+	float m_MappedThrust = 0.0f;
 
-	int m_ElevatorAngle = 90;
-	int m_RudderAngle = 90;
+	// The progress of the transition from the hover mode (0) to the cruise mode (1).
+	float m_TransitionProgress = 0.0f;
+	uint32_t m_PreviousTime = 0;
 };
\ No newline at end of file
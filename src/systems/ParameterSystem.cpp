@@ -0,0 +1,101 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ParameterSystem.hpp"
+
+#include "InputSystem.hpp"
+#include "OutputSystem.hpp"
+
+#include "core/Logging.hpp"
+
+void ParameterSystem::initialize(IRecordStorage<ParameterSet> *pStorage)
+{
+	PEREGRINE_PRINTLN("Initializing the parameter system.");
+	m_pStorage = pStorage;
+
+	ParameterSet parameters;
+	if (m_pStorage && m_pStorage->onLoad(parameters))
+	{
+		m_Parameters = parameters;
+		m_Shadow = parameters;
+		PEREGRINE_LOG_INFO("Loaded the stored parameters.");
+	}
+
+	apply();
+
+	PEREGRINE_PRINTLN("The parameter system is initialized.");
+}
+
+void ParameterSystem::update()
+{
+	// Store a new sensor calibration here, on the control core, so the sensor task never waits for the flash.
+	Stabilizer::Instance().storeCalibration();
+
+	if (!m_isChanged)
+		return;
+
+	m_Parameters = m_Shadow;
+	m_isChanged = false;
+	apply();
+}
+
+bool ParameterSystem::set(ParameterID id, ParameterValue value)
+{
+	if (!SetParameter(m_Shadow, id, value))
+		return false;
+
+	m_isChanged = true;
+	return true;
+}
+
+void ParameterSystem::setGains(TuningLoop loop, TuningAxis axis, const PIDGains &gains)
+{
+	if (loop == TuningLoop::Angle && axis == TuningAxis::Pitch)
+		m_Shadow.m_PitchAngle = gains;
+	else if (loop == TuningLoop::Angle && axis == TuningAxis::Roll)
+		m_Shadow.m_RollAngle = gains;
+	else if (loop == TuningLoop::Rate && axis == TuningAxis::Pitch)
+		m_Shadow.m_PitchRate = gains;
+	else if (loop == TuningLoop::Rate && axis == TuningAxis::Roll)
+		m_Shadow.m_RollRate = gains;
+	else if (loop == TuningLoop::Rate && axis == TuningAxis::Yaw)
+		m_Shadow.m_YawRate = gains;
+	else
+		return;
+
+	m_isChanged = true;
+}
+
+void ParameterSystem::reset()
+{
+	m_Shadow = g_DefaultParameters;
+	m_isChanged = true;
+}
+
+bool ParameterSystem::save()
+{
+	if (!m_pStorage)
+		return false;
+
+	if (!Stabilizer::Instance().isThrustLow())
+	{
+		PEREGRINE_LOG_WARNING("The parameters can only be saved on the ground!");
+		return false;
+	}
+
+	if (!m_pStorage->onSave(m_Shadow))
+	{
+		PEREGRINE_LOG_WARNING("Failed to store the parameters!");
+		return false;
+	}
+
+	PEREGRINE_LOG_INFO("Stored the parameters.");
+	return true;
+}
+
+void ParameterSystem::apply()
+{
+	InputSystem::Instance().setParameters(m_Parameters);
+	OutputSystem::Instance().setParameters(m_Parameters);
+	Stabilizer::Instance().setParameters(m_Parameters);
+}
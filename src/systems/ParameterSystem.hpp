@@ -0,0 +1,154 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "Stabilizer.hpp"
+
+#include "core/System.hpp"
+#include "core/Constants.hpp"
+#include "core/IRecordStorage.hpp"
+#include "algorithms/KalmanFilter.hpp"
+#include "algorithms/ParameterRegistry.hpp"
+
+// The default parameters are the constants, so a controller without stored parameters flies like it was built.
+constexpr ParameterSet g_DefaultParameters = {
+	{g_PitchAngleKP, g_PitchAngleKI, g_PitchAngleKD},
+	{g_RollAngleKP, g_RollAngleKI, g_RollAngleKD},
+	{g_PitchRateKP, g_PitchRateKI, g_PitchRateKD},
+	{g_RollRateKP, g_RollRateKI, g_RollRateKD},
+	{g_YawRateKP, g_YawRateKI, g_YawRateKD},
+	g_WingServoOffsetHover,
+	g_WingServoOffsetCruise,
+	g_ElevatorOffset,
+	g_RudderOffset,
+	g_PitchInputMaximum,
+	g_RollInputMaximum,
+	g_YawInputMaximum,
+	g_KalmanAngleNoise,
+	g_KalmanBiasNoise,
+	g_KalmanMeasurementNoise};
+
+/**
+ * @brief Parameter action enum.
+ * These are the parameter commands of the host.
+ */
+enum class ParameterAction : uint8_t
+{
+	Read,
+	Write,
+	Save,
+	Reset
+};
+
+/**
+ * @brief Parameter status enum.
+ */
+enum class ParameterStatus : uint8_t
+{
+	// The command was carried out.
+	Done,
+
+	// The parameter ID, the value type or the action is unknown.
+	Invalid,
+
+	// The value is out of the range of the parameter, or the parameters could not be saved.
+	Rejected
+};
+
+/**
+ * @brief Parameter system class.
+ * This keeps the parameters which can be changed without building the controller again (see ParameterSet and algorithms/ParameterRegistry.hpp).
+ * The host reads and writes them with parameter command frames, and they are stored in the non-volatile storage and loaded on the boot.
+ *
+ * The parameters are written to a shadow copy, which is published when the system updates, right after the telemetry system handled the
+ * frames of the host. Publishing hands the parameters to the systems which use them, in between their updates, so all the parameters
+ * written in a tick take effect together and the control loops read their gains and offsets like before (the rate loop gets them
+ * through a snapshot buffer, see Stabilizer::setParameters).
+ */
+class ParameterSystem final : public System<ParameterSystem>
+{
+public:
+	/**
+	 * @brief Construct a new Parameter System object.
+	 */
+	ParameterSystem() = default;
+
+	/**
+	 * @brief Initialize the parameter system.
+	 * This loads the stored parameters and hands them to the systems, so it must be called before the output system is initialized.
+	 *
+	 * @param pStorage The storage of the parameters. This is optional, without it the defaults are used and can't be saved.
+	 */
+	void initialize(IRecordStorage<ParameterSet> *pStorage = nullptr);
+
+	/**
+	 * @brief Update the parameter system.
+	 * This publishes the shadow copy if a parameter changed, and stores a new sensor calibration (see Stabilizer::storeCalibration()).
+	 */
+	void update() override;
+
+	/**
+	 * @brief Set a parameter.
+	 * The new value is used from the next update on.
+	 *
+	 * @param id The parameter ID.
+	 * @param value The value, of the type of the parameter.
+	 * @return true If the value was set.
+	 * @return false If the value is out of the range of the parameter.
+	 */
+	bool set(ParameterID id, ParameterValue value);
+
+	/**
+	 * @brief Get a parameter.
+	 *
+	 * @param id The parameter ID.
+	 * @return The latest value, which may not be published yet.
+	 */
+	[[nodiscard]] ParameterValue get(ParameterID id) const { return GetParameter(m_Shadow, id); }
+
+	/**
+	 * @brief Set the gains of a loop axis.
+	 * The auto tune keeps the gains it measured here, so they can be saved.
+	 *
+	 * @param loop The loop.
+	 * @param axis The axis. The angle loop does not have a yaw axis.
+	 * @param gains The gains.
+	 */
+	void setGains(TuningLoop loop, TuningAxis axis, const PIDGains &gains);
+
+	/**
+	 * @brief Replace the parameters with the defaults.
+	 * The stored parameters stay until they are saved.
+	 */
+	void reset();
+
+	/**
+	 * @brief Store the parameters.
+	 * Writing to the flash blocks the control loop for a few milliseconds, so this is only done while the thrust is low.
+	 *
+	 * @return true If the parameters were stored.
+	 * @return false If there is no storage, the aircraft is flying or the storage failed.
+	 */
+	bool save();
+
+	/**
+	 * @brief Get the published parameters.
+	 *
+	 * @return The parameters.
+	 */
+	[[nodiscard]] const ParameterSet &getParameters() const { return m_Parameters; }
+
+private:
+	/**
+	 * @brief Hand the published parameters to the systems which use them.
+	 */
+	void apply();
+
+private:
+	IRecordStorage<ParameterSet> *m_pStorage = nullptr;
+
+	ParameterSet m_Parameters = g_DefaultParameters;
+	ParameterSet m_Shadow = g_DefaultParameters;
+	bool m_isChanged = false;
+};
\ No newline at end of file
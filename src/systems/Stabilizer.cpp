@@ -2,39 +2,585 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "Stabilizer.hpp"
+#include "TelemetrySystem.hpp"
+#include "BlackboxSystem.hpp"
+#include "ParameterSystem.hpp"
 
+#include "core/Common.hpp"
 #include "core/Constants.hpp"
+#include "core/GlobalState.hpp"
 #include "core/Logging.hpp"
+#include "core/StageProfiler.hpp"
+
+#include <Arduino.h>
+#include <math.h>
+#include <type_traits>
+
+// The nominal time between two angle loop calculations in seconds.
+constexpr auto g_AngleLoopPeriod = static_cast<float>(g_OutputUpdateDivider) / g_SchedulerTickRate;
+
+// The nominal time between two rate loop calculations in seconds.
+constexpr auto g_RateLoopPeriod = static_cast<float>(g_SensorUpdateDivider) / g_SensorSampleRate;
+
+/**
+ * @brief Record a raw sensor sample to the blackbox.
+ *
+ * @param sample The raw sample.
+ * @param deltaTime The time since the previous sample in seconds.
+ * @param timestamp The time at which the sample was read in microseconds.
+ */
+static void RecordRawSample(const RawIMUSample &sample, float deltaTime, uint32_t timestamp)
+{
+	BlackboxSystem::Instance().recordIMU(sample, deltaTime, timestamp);
+}
+
+/**
+ * @brief Tune the attitude estimator using the parameters.
+ * Only the Kalman estimator has parameters, so the other estimators are left as they are.
+ *
+ * @tparam Estimator The attitude estimator type.
+ * @param estimator The estimator to tune.
+ * @param parameters The parameters.
+ */
+template <class Estimator>
+static void TuneEstimator(Estimator &estimator, const ParameterSet &parameters)
+{
+	if constexpr (std::is_same_v<Estimator, KalmanEstimator>)
+		estimator.tune(parameters.m_KalmanAngleNoise, parameters.m_KalmanBiasNoise, parameters.m_KalmanMeasurementNoise);
+}
+
+// The names of the tuning loops and axes, for the logs.
+static const char *const s_TuningLoopNames[] = {"rate", "angle"};
+static const char *const s_TuningAxisNames[] = {"pitch", "roll", "yaw"};
+
+/**
+ * @brief Get the PID controller axis of a tuning axis.
+ *
+ * @param axis The tuning axis.
+ * @return The axis index of the PID controller.
+ */
+static uint8_t GetControllerAxis(TuningAxis axis)
+{
+	switch (axis)
+	{
+	case TuningAxis::Pitch:
+		return 0;
+
+	case TuningAxis::Yaw:
+		return 1;
+
+	default:
+		return 2;
+	}
+}
+
+/**
+ * @brief Get a component of a vector.
+ *
+ * @param vector The vector.
+ * @param axis The axis index of the PID controller.
+ * @return The component.
+ */
+static float &GetComponent(Vec3 &vector, uint8_t axis)
+{
+	return axis == 0 ? vector.m_X : (axis == 1 ? vector.m_Y : vector.m_Z);
+}
+
+/**
+ * @brief Start an auto tune message.
+ *
+ * @param loop The tuned loop.
+ * @param axis The tuned axis.
+ * @param rule The tuning rule.
+ * @param gains The gains before the experiment.
+ * @return The message.
+ */
+static AutoTuneMessage StartTuningMessage(TuningLoop loop, TuningAxis axis, TuningRule rule, const PIDGains &gains)
+{
+	AutoTuneMessage message;
+	message.m_Loop = static_cast<uint8_t>(loop);
+	message.m_Axis = static_cast<uint8_t>(axis);
+	message.m_Rule = static_cast<uint8_t>(rule);
+	message.m_State = static_cast<uint8_t>(RelayTunerState::Running);
+	message.m_Gains[0] = gains.m_KP;
+	message.m_Gains[1] = gains.m_KI;
+	message.m_Gains[2] = gains.m_KD;
+	return message;
+}
+
+/**
+ * @brief Update an auto tune message with the progress of its experiment, and tune the axis once the experiment completed.
+ *
+ * @param message The message of the experiment.
+ * @param tuner The relay tuner which runs the experiment.
+ * @param controller The PID controller of the tuned loop.
+ */
+static void UpdateTuningMessage(AutoTuneMessage &message, const RelayTuner &tuner, PID &controller)
+{
+	const auto state = tuner.getState();
+	if (message.m_State == static_cast<uint8_t>(RelayTunerState::Running))
+	{
+		if (state == RelayTunerState::Completed)
+		{
+			auto gains = ComputePIDGains(tuner.getUltimateGain(), tuner.getUltimatePeriod(), static_cast<TuningRule>(message.m_Rule));
+
+			// The angle loop stays proportional, like the default gains: the rate loop below it damps it and its integral holds the trim.
+			if (message.m_Loop == static_cast<uint8_t>(TuningLoop::Angle))
+			{
+				gains.m_KI = 0.0f;
+				gains.m_KD = 0.0f;
+			}
+			else if (message.m_Axis != static_cast<uint8_t>(TuningAxis::Yaw))
+			{
+				gains.m_KI = fminf(gains.m_KI, gains.m_KP / g_RateTuningMinimumIntegralTime);
+			}
+
+			controller.tune(GetControllerAxis(static_cast<TuningAxis>(message.m_Axis)), gains);
+
+			message.m_Gains[0] = gains.m_KP;
+			message.m_Gains[1] = gains.m_KI;
+			message.m_Gains[2] = gains.m_KD;
+
+			PEREGRINE_LOG_INFO("Auto tuned the %s %s loop: Ku %.3f, Tu %.3f s.", s_TuningAxisNames[message.m_Axis], s_TuningLoopNames[message.m_Loop],
+							   tuner.getUltimateGain(), tuner.getUltimatePeriod());
+			PEREGRINE_LOG_INFO("The new gains are KP %.3f, KI %.3f, KD %.4f.", gains.m_KP, gains.m_KI, gains.m_KD);
+		}
+		else if (state == RelayTunerState::Failed)
+		{
+			PEREGRINE_LOG_WARNING("The %s %s loop auto tune failed after %u cycles!", s_TuningAxisNames[message.m_Axis], s_TuningLoopNames[message.m_Loop],
+								  tuner.getCycles());
+		}
+		else if (state == RelayTunerState::Idle)
+		{
+			PEREGRINE_LOG_INFO("Stopped the %s %s loop auto tune.", s_TuningAxisNames[message.m_Axis], s_TuningLoopNames[message.m_Loop]);
+		}
+	}
+
+	message.m_State = static_cast<uint8_t>(state);
+	message.m_Cycles = static_cast<uint16_t>(tuner.getCycles());
+	message.m_UltimateGain = tuner.getUltimateGain();
+	message.m_UltimatePeriod = tuner.getUltimatePeriod();
+}
 
 Stabilizer::Stabilizer()
-	: m_PitchStabilizer(g_PitchKP, g_PitchKI, g_PitchKD), m_RollStabilizer(g_RollKP, g_RollKI, g_RollKD), m_YawStabilizer(g_YawKP, g_YawKI, g_YawKD)
+	: m_AngleController(Vec3(g_PitchAngleKP, 0.0f, g_RollAngleKP), Vec3(g_PitchAngleKI, 0.0f, g_RollAngleKI), Vec3(g_PitchAngleKD, 0.0f, g_RollAngleKD))
+	, m_RateController(Vec3(g_PitchRateKP, g_YawRateKP, g_RollRateKP), Vec3(g_PitchRateKI, g_YawRateKI, g_RollRateKI), Vec3(g_PitchRateKD, g_YawRateKD, g_RollRateKD))
 {
 }
 
-void Stabilizer::initialize()
+void Stabilizer::initialize(II2CBus *pBus, IRecordStorage<SensorCalibration> *pCalibrationStorage)
 {
 	PEREGRINE_PRINTLN("Initializing the Stabilizer.");
 
 	// Initialize the sensor.
-	m_Sensor.initialize();
+	m_Sensor.initialize(pBus);
+	m_Sensor.setObserver(&RecordRawSample);
+
+	// Load the stored calibration, so the controller can arm without waiting for the sensor to be still.
+	m_pCalibrationStorage = pCalibrationStorage;
+	SensorCalibration calibration;
+	if (m_pCalibrationStorage && m_pCalibrationStorage->onLoad(calibration))
+	{
+		m_Sensor.getCalibrator().setCalibration(calibration);
+		m_isCalibrationLoaded = true;
+		publishCalibration();
+
+		PEREGRINE_LOG_INFO("Loaded the sensor calibration, measured at %.1f C.", calibration.m_Temperature);
+	}
+	else
+	{
+		PEREGRINE_LOG_INFO("Calibrating the sensor. Keep the aircraft still and level.");
+	}
 
 	PEREGRINE_PRINTLN("Stabilizer is initialized.");
 }
 
+void Stabilizer::setCalibration(const SensorCalibration &calibration)
+{
+	m_Sensor.getCalibrator().setCalibration(calibration);
+	m_isCalibrationFixed = true;
+	publishCalibration();
+}
+
 void Stabilizer::update()
 {
-	m_Sensor.readData();
+	updateParameters();
+	updateCalibration();
+
+	AttitudeSample sample;
+
+	{
+		PEREGRINE_PROFILE_STAGE(ProfileStage::SensorRead);
+
+		m_Sensor.readData();
+
+		sample.m_Attitude = m_Sensor.getAttitude();
+		sample.m_Rate = m_Sensor.getRate();
+		sample.m_Timestamp = m_Sensor.getTimestamp();
+		m_SensorBuffer.publish(sample);
+	}
+
+	BlackboxSystem::Instance().recordAttitude(sample);
+
+	updateRateLoop(sample);
 }
 
 Vec3 Stabilizer::computeOutputs(float thrust, float pitch, float roll, float yaw)
 {
-	const auto angles = m_Sensor.getAcceleration();
-	const auto outputPitch = m_PitchStabilizer.calculate(angles.m_Pitch, pitch);
-	const auto outputRoll = m_RollStabilizer.calculate(angles.m_Roll, roll);
+	PEREGRINE_PROFILE_STAGE(ProfileStage::Stabilization);
+
+	m_isThrustLow.store(thrust < g_CalibrationThrustLimit, std::memory_order_relaxed);
+	updateArming();
+
+	AttitudeSample sample;
+	m_SensorBuffer.read(sample);
+
+	const auto currentTime = micros();
+	const auto delta = m_PreviousTime == 0 ? g_AngleLoopPeriod : (currentTime - m_PreviousTime) * 1e-6f;
+	m_PreviousTime = currentTime;
+
+	constexpr auto minimum = static_cast<float>(g_SensorInputMinimum);
+	constexpr auto maximum = static_cast<float>(g_SensorInputMaximum);
+
+	// Since we don't have a way to calculate yaw properly using the sensor (unless we have a magnetometer), the yaw stick always commands
+	// the rate.
+	auto setpoints = Vec3(pitch * g_StickRateScale, yaw * g_StickRateScale, roll * g_StickRateScale);
+	if (g_ControlMode == ControlMode::Angle)
+	{
+		// The angle loop only takes the pitch and the roll within the sensor input range, like its setpoints.
+		const auto attitude = Vec3(clamp(sample.m_Attitude.m_Pitch, minimum, maximum), 0.0f, clamp(sample.m_Attitude.m_Roll, minimum, maximum));
+		const auto rates = m_AngleController.calculate(attitude, Vec3(pitch, 0.0f, roll), delta);
+		setpoints.m_Pitch = rates.m_Pitch;
+		setpoints.m_Roll = rates.m_Roll;
+
+		updateAngleTuning(attitude, Vec3(pitch, yaw, roll), setpoints, delta);
+	}
+	else
+	{
+		// Start from the current attitude when switching back to the angle mode.
+		m_AngleController.reset();
+
+		if (m_AngleTuner.getState() == RelayTunerState::Running)
+		{
+			m_AngleTuner.stop();
+			UpdateTuningMessage(m_AutoTune, m_AngleTuner, m_AngleController);
+		}
+	}
+
+	// Only the setpoints are clamped. The measured rates go up to the gyroscope's range, so the rate loop still sees any overshoot.
+	setpoints = Vec3(clamp(setpoints.m_Pitch, minimum, maximum), clamp(setpoints.m_Yaw, minimum, maximum), clamp(setpoints.m_Roll, minimum, maximum));
+
+	// The rate loop experiments run on the sensor core.
+	AutoTuneMessage rateTuning;
+	if (m_AutoTune.m_Loop == static_cast<uint8_t>(TuningLoop::Rate) && m_RateTuningBuffer.read(rateTuning))
+		m_AutoTune = rateTuning;
+
+	// Keep the gains of a completed experiment in the parameters.
+	if (m_AutoTune.m_State != m_AutoTuneState && m_AutoTune.m_State == static_cast<uint8_t>(RelayTunerState::Completed))
+	{
+		const auto gains = PIDGains{m_AutoTune.m_Gains[0], m_AutoTune.m_Gains[1], m_AutoTune.m_Gains[2]};
+		ParameterSystem::Instance().setGains(static_cast<TuningLoop>(m_AutoTune.m_Loop), static_cast<TuningAxis>(m_AutoTune.m_Axis), gains);
+	}
+
+	m_AutoTuneState = m_AutoTune.m_State;
+
+	m_RateSetpointBuffer.publish(setpoints);
+
+	RateControlSample control;
+	m_RateControlBuffer.read(control);
+
+	publishTelemetry(sample, control);
+
+	return m_isArmed ? control.m_Output : Vec3();
+}
+
+void Stabilizer::setParameters(const ParameterSet &parameters)
+{
+	m_AngleController.tune(0, parameters.m_PitchAngle);
+	m_AngleController.tune(2, parameters.m_RollAngle);
+
+	m_ParameterBuffer.publish(parameters);
+}
+
+bool Stabilizer::startAutoTune(TuningLoop loop, TuningAxis axis, TuningRule rule)
+{
+	if (m_AutoTune.m_State == static_cast<uint8_t>(RelayTunerState::Running))
+	{
+		PEREGRINE_LOG_WARNING("An auto tune experiment is already running!");
+		return false;
+	}
+
+	if (!m_isArmed || m_isThrustLow.load(std::memory_order_relaxed))
+	{
+		PEREGRINE_LOG_WARNING("The aircraft must be flying to auto tune!");
+		return false;
+	}
+
+	if (loop == TuningLoop::Angle && (axis == TuningAxis::Yaw || g_ControlMode != ControlMode::Angle))
+	{
+		PEREGRINE_LOG_WARNING("The angle loop of the axis is not used!");
+		return false;
+	}
+
+	const auto controllerAxis = GetControllerAxis(axis);
+	if (loop == TuningLoop::Angle)
+	{
+		m_AutoTune = StartTuningMessage(loop, axis, rule, m_AngleController.getGains(controllerAxis));
+		RelaySettings settings;
+		settings.m_Amplitude = g_AngleTuningAmplitude;
+		settings.m_MaximumAmplitude = g_AngleTuningMaximumAmplitude;
+		settings.m_Hysteresis = g_AngleTuningHysteresis;
+		settings.m_TargetAmplitude = g_AngleTuningTarget;
+		settings.m_Limit = g_AngleTuningLimit;
+		m_AngleTuner.start(settings);
+	}
+	else
+	{
+		// The gains are filled in by the sensor core, which owns the rate controller.
+		m_AutoTune = StartTuningMessage(loop, axis, rule, PIDGains());
+
+		AutoTuneRequest request;
+		request.m_Axis = axis;
+		request.m_Rule = rule;
+		request.m_isStart = true;
+		m_RateTuningRequestBuffer.publish(request);
+	}
+
+	PEREGRINE_LOG_INFO("Started the %s %s loop auto tune.", s_TuningAxisNames[static_cast<uint8_t>(axis)], s_TuningLoopNames[static_cast<uint8_t>(loop)]);
+	return true;
+}
+
+void Stabilizer::stopAutoTune()
+{
+	if (m_AutoTune.m_State != static_cast<uint8_t>(RelayTunerState::Running))
+		return;
+
+	if (m_AutoTune.m_Loop == static_cast<uint8_t>(TuningLoop::Angle))
+	{
+		m_AngleTuner.stop();
+		UpdateTuningMessage(m_AutoTune, m_AngleTuner, m_AngleController);
+	}
+	else
+	{
+		m_RateTuningRequestBuffer.publish(AutoTuneRequest());
+	}
+}
+
+void Stabilizer::updateCalibration()
+{
+	auto &calibrator = m_Sensor.getCalibrator();
+	if (calibrator.commit())
+	{
+		m_Calibrations++;
+		publishCalibration();
+
+		const auto &calibration = calibrator.getCalibration();
+		PEREGRINE_LOG_INFO("Calibrated the sensor at %.1f C.", calibration.m_Temperature);
+
+		// The calibration is stored from the control core (see storeCalibration()), so the sensor task never waits for the flash.
+		m_StoredCalibrationBuffer.publish(calibration);
+	}
+
+	// The calibration is recorded before the samples it corrects, and again if the recording started later.
+	auto &blackbox = BlackboxSystem::Instance();
+	if (!m_isCalibrationRecorded && calibrator.isCalibrated() && blackbox.isRecording())
+	{
+		blackbox.recordCalibration(m_Sensor.getTimestamp(), calibrator.getCalibration());
+		m_isCalibrationRecorded = true;
+	}
+
+	m_Sensor.setCalibrating(!m_isCalibrationFixed && m_isThrustLow.load(std::memory_order_relaxed));
+}
+
+void Stabilizer::storeCalibration()
+{
+	if (!m_pCalibrationStorage || !m_StoredCalibrationBuffer.isFresh())
+		return;
+
+	SensorCalibration calibration;
+	m_StoredCalibrationBuffer.read(calibration);
+	if (!m_pCalibrationStorage->onSave(calibration))
+		PEREGRINE_LOG_WARNING("Failed to store the sensor calibration!");
+}
+
+void Stabilizer::publishCalibration()
+{
+	const auto &calibration = m_Sensor.getCalibrator().getCalibration();
+
+	CalibrationMessage message;
+	message.m_GyroscopeBias[0] = calibration.m_GyroscopeBias.m_X;
+	message.m_GyroscopeBias[1] = calibration.m_GyroscopeBias.m_Y;
+	message.m_GyroscopeBias[2] = calibration.m_GyroscopeBias.m_Z;
+
+	message.m_AccelerometerOffset[0] = calibration.m_AccelerometerOffset.m_X;
+	message.m_AccelerometerOffset[1] = calibration.m_AccelerometerOffset.m_Y;
+	message.m_AccelerometerOffset[2] = calibration.m_AccelerometerOffset.m_Z;
+
+	message.m_Temperature = calibration.m_Temperature;
+	message.m_Calibrations = m_Calibrations;
+	message.m_Loaded = m_isCalibrationLoaded ? 1 : 0;
+	m_CalibrationBuffer.publish(message);
+
+	m_isCalibrationRecorded = false;
+	m_isCalibrated.store(true, std::memory_order_release);
+}
+
+void Stabilizer::updateArming()
+{
+	if (m_isArmed || !m_isCalibrated.load(std::memory_order_acquire))
+		return;
+
+	// The clock starts at the boot, so this is the time it took to arm.
+	m_isArmed = true;
+	m_ArmTime = micros();
+	PEREGRINE_LOG_INFO("Armed %u ms after the boot.", m_ArmTime / 1000);
+}
+
+void Stabilizer::updateParameters()
+{
+	// The parameters rarely change, so they are only copied when they did.
+	if (!m_ParameterBuffer.isFresh())
+		return;
+
+	ParameterSet parameters;
+	m_ParameterBuffer.read(parameters);
+
+	m_RateController.tune(0, parameters.m_PitchRate);
+	m_RateController.tune(1, parameters.m_YawRate);
+	m_RateController.tune(2, parameters.m_RollRate);
+
+	TuneEstimator(m_Sensor.getEstimator(), parameters);
+}
+
+void Stabilizer::updateRateLoop(const AttitudeSample &sample)
+{
+	PEREGRINE_PROFILE_STAGE(ProfileStage::RateControl);
+
+	// The samples are timestamped by the sensor, so the time step includes any delay of the sensor task.
+	const auto delta = m_PreviousSampleTime == 0 ? g_RateLoopPeriod : (sample.m_Timestamp - m_PreviousSampleTime) * 1e-6f;
+	m_PreviousSampleTime = sample.m_Timestamp;
+
+	Vec3 setpoints;
+	m_RateSetpointBuffer.read(setpoints);
+
+	RateControlSample control;
+	control.m_Output = m_RateController.calculate(sample.m_Rate, setpoints, delta);
+	updateRateTuning(sample, setpoints, control.m_Output, delta);
+
+	control.m_Proportional = m_RateController.getProportional();
+	control.m_Integral = m_RateController.getIntegral();
+	control.m_Derivative = m_RateController.getDerivative();
+	m_RateControlBuffer.publish(control);
+
+	BlackboxSystem::Instance().recordRateControl(sample.m_Timestamp, setpoints, control);
+}
+
+void Stabilizer::updateAngleTuning(Vec3 attitude, Vec3 inputs, Vec3 &setpoints, float delta)
+{
+	if (m_AngleTuner.getState() != RelayTunerState::Running)
+		return;
+
+	if (m_isThrustLow.load(std::memory_order_relaxed))
+	{
+		m_AngleTuner.stop();
+	}
+	else
+	{
+		const auto axis = GetControllerAxis(static_cast<TuningAxis>(m_AutoTune.m_Axis));
+		GetComponent(setpoints, axis) = m_AngleTuner.update(GetComponent(attitude, axis), GetComponent(inputs, axis), delta);
+	}
+
+	UpdateTuningMessage(m_AutoTune, m_AngleTuner, m_AngleController);
+}
+
+void Stabilizer::updateRateTuning(const AttitudeSample &sample, Vec3 setpoints, Vec3 &outputs, float delta)
+{
+	AutoTuneRequest request;
+	if (m_RateTuningRequestBuffer.read(request))
+	{
+		const auto axis = GetControllerAxis(request.m_Axis);
+		if (request.m_isStart)
+		{
+			// The relay switches around the output which holds the axis, which is mostly the integral.
+			m_RateTuning = StartTuningMessage(TuningLoop::Rate, request.m_Axis, request.m_Rule, m_RateController.getGains(axis));
+			RelaySettings settings;
+			settings.m_Bias = GetComponent(outputs, axis);
+			settings.m_Amplitude = g_RateTuningAmplitude;
+			settings.m_MaximumAmplitude = g_RateTuningMaximumAmplitude;
+			settings.m_Hysteresis = g_RateTuningHysteresis;
+			settings.m_TargetAmplitude = g_RateTuningTarget;
+			settings.m_Limit = g_RateTuningLimit;
+			m_RateTuner.start(settings);
+			m_RateTuningSetpoint = GetComponent(setpoints, axis);
+		}
+		else
+		{
+			m_RateTuner.stop();
+			UpdateTuningMessage(m_RateTuning, m_RateTuner, m_RateController);
+			m_RateTuningBuffer.publish(m_RateTuning);
+		}
+	}
+
+	if (m_RateTuner.getState() != RelayTunerState::Running)
+		return;
+
+	const auto axis = GetControllerAxis(static_cast<TuningAxis>(m_RateTuning.m_Axis));
+	const auto attitude = fmaxf(fabsf(sample.m_Attitude.m_Pitch), fabsf(sample.m_Attitude.m_Roll));
+	if (m_isThrustLow.load(std::memory_order_relaxed) || attitude > g_RateTuningAttitudeLimit)
+	{
+		m_RateTuner.stop();
+	}
+	else
+	{
+		auto rates = sample.m_Rate;
+		GetComponent(outputs, axis) = m_RateTuner.update(GetComponent(rates, axis), m_RateTuningSetpoint, delta);
+	}
+
+	UpdateTuningMessage(m_RateTuning, m_RateTuner, m_RateController);
+	m_RateTuningBuffer.publish(m_RateTuning);
+}
+
+void Stabilizer::publishTelemetry(const AttitudeSample &sample, const RateControlSample &control)
+{
+	auto &telemetry = TelemetrySystem::Instance();
+
+	AttitudeMessage attitude;
+	attitude.m_Pitch = sample.m_Attitude.m_Pitch;
+	attitude.m_Roll = sample.m_Attitude.m_Roll;
+	attitude.m_Yaw = sample.m_Attitude.m_Yaw;
+	attitude.m_PitchRate = sample.m_Rate.m_Pitch;
+	attitude.m_RollRate = sample.m_Rate.m_Roll;
+	attitude.m_YawRate = sample.m_Rate.m_Yaw;
+	telemetry.publish(TelemetryMessageID::Attitude, attitude);
+
+	if (telemetry.isSubscribed(TelemetryMessageID::PIDTerms))
+	{
+		PIDTermsMessage terms;
+		terms.m_Proportional[0] = control.m_Proportional.m_Pitch;
+		terms.m_Proportional[1] = control.m_Proportional.m_Roll;
+		terms.m_Proportional[2] = control.m_Proportional.m_Yaw;
+
+		terms.m_Integral[0] = control.m_Integral.m_Pitch;
+		terms.m_Integral[1] = control.m_Integral.m_Roll;
+		terms.m_Integral[2] = control.m_Integral.m_Yaw;
+
+		terms.m_Derivative[0] = control.m_Derivative.m_Pitch;
+		terms.m_Derivative[1] = control.m_Derivative.m_Roll;
+		terms.m_Derivative[2] = control.m_Derivative.m_Yaw;
+
+		terms.m_Output[0] = control.m_Output.m_Pitch;
+		terms.m_Output[1] = control.m_Output.m_Roll;
+		terms.m_Output[2] = control.m_Output.m_Yaw;
+		telemetry.publish(TelemetryMessageID::PIDTerms, terms);
+	}
 
-	// Since we don't have a way to calculate yaw properly using the sensor (unless we have a magnetometer), use the gyration.
-	const auto rotationRate = m_Sensor.getGyration();
-	const auto outputYaw = m_YawStabilizer.calculate(rotationRate.m_Yaw, yaw);
+	telemetry.publish(TelemetryMessageID::AutoTune, m_AutoTune);
 
-	return Vec3(outputPitch, outputYaw, outputRoll);
+	if (telemetry.isSubscribed(TelemetryMessageID::Calibration))
+	{
+		CalibrationMessage calibration;
+		m_CalibrationBuffer.read(calibration);
+		calibration.m_ArmTime = m_isArmed ? m_ArmTime / 1000 : 0;
+		telemetry.publish(TelemetryMessageID::Calibration, calibration);
+	}
 }
@@ -3,30 +3,148 @@
 
 #pragma once
 
+#include "core/Configuration.hpp"
+#include "core/Constants.hpp"
 #include "core/System.hpp"
-#include "components/MPU6050.hpp"
+#include "core/SnapshotBuffer.hpp"
+#include "core/IRecordStorage.hpp"
+#include "core/TelemetryMessages.hpp"
+#include "components/AttitudeSensor.hpp"
+#include "algorithms/AttitudeEstimators.hpp"
 #include "algorithms/PID.hpp"
+#include "algorithms/RelayTuner.hpp"
+
+#include <atomic>
+
+// The attitude estimator is selected at compile time (see Configuration.hpp).
+#if defined(PEREGRINE_ATTITUDE_MAHONY)
+using AttitudeEstimator = MahonyEstimator;
+
+#elif defined(PEREGRINE_ATTITUDE_COMPLEMENTARY)
+using AttitudeEstimator = ComplementaryEstimator;
+
+#elif defined(PEREGRINE_ATTITUDE_GYRO_INTEGRATION)
+using AttitudeEstimator = GyroIntegrationEstimator;
+
+#else
+using AttitudeEstimator = KalmanEstimator;
+
+#endif
 
 /**
  * @brief The PID algorithm uses some constants which can be tuned by the user to stabilize the incoming values.
  * Edit the following constants to tune the PID stabilization (for each control axis).
+ * The stabilizer is made of 2 cascaded loops. The angle loop turns the pitch and roll angle errors (degrees) into rate setpoints (degrees
+ * per second) and the rate loop turns the rate errors into the outputs. The integral constants are per second and the derivative
+ * constants are in seconds, so they don't depend on the control rate. These are the default gains, which can be changed without building
+ * the controller again (see ParameterSystem).
  */
 
-constexpr auto g_PitchKP = 0.001f;
-constexpr auto g_PitchKI = 0.01f;
-constexpr auto g_PitchKD = 1.0f;
+constexpr auto g_PitchAngleKP = 8.0f;
+constexpr auto g_PitchAngleKI = 0.0f;
+constexpr auto g_PitchAngleKD = 0.0f;
+
+constexpr auto g_RollAngleKP = 8.0f;
+constexpr auto g_RollAngleKI = 0.0f;
+constexpr auto g_RollAngleKD = 0.0f;
+
+constexpr auto g_PitchRateKP = 0.45f;
+constexpr auto g_PitchRateKI = 0.15f;
+constexpr auto g_PitchRateKD = 0.0f;
+
+constexpr auto g_RollRateKP = 0.45f;
+constexpr auto g_RollRateKI = 0.15f;
+constexpr auto g_RollRateKD = 0.0f;
+
+constexpr auto g_YawRateKP = 1.0f;
+constexpr auto g_YawRateKI = 2.0f;
+constexpr auto g_YawRateKD = 0.0f;
+
+// The rate commanded by a stick, in degrees per second per degree of stick input. The yaw stick always commands a rate and so do the
+// pitch and roll sticks in the rate control mode. The rate setpoints are clamped to the sensor input range, which the full stick reaches
+// with the default input ranges.
+constexpr auto g_StickRateScale = static_cast<float>(g_SensorInputMaximum) / g_PitchInputMaximum;
+
+// The sensor is only calibrated while the thrust is below this, so the rotors are stopped and a smooth, steady turn in flight is never
+// mistaken for the gyroscope bias.
+constexpr auto g_CalibrationThrustLimit = 0.02f * g_ThrottleInputMaximum;
 
-constexpr auto g_RollKP = 0.001f;
-constexpr auto g_RollKI = 0.01f;
-constexpr auto g_RollKD = 1.0f;
+// The relay of the rate loop auto tune switches the output (see PID) around the trim. Its amplitude is adjusted until the rate oscillates
+// with the target amplitude, which is well above the hysteresis, which is above the gyroscope noise. The hysteresis delays the switching,
+// so the loop oscillates below its phase crossover frequency and reads a lower ultimate gain, which is why it's a small fraction of the
+// target. The rate setpoint of the axis is held during the experiment, so the angle loop does not take part in the oscillation, and the
+// experiment is stopped when the attitude drifted beyond the attitude limit.
+constexpr auto g_RateTuningAmplitude = 5.0f;
+constexpr auto g_RateTuningMaximumAmplitude = 30.0f;
+constexpr auto g_RateTuningHysteresis = 0.5f; // Degrees per second.
+constexpr auto g_RateTuningTarget = 10.0f; // Degrees per second.
+constexpr auto g_RateTuningLimit = 200.0f; // Degrees per second.
+constexpr auto g_RateTuningAttitudeLimit = 20.0f; // Degrees.
 
-constexpr auto g_YawKP = 0.001f;
-constexpr auto g_YawKI = 0.01f;
-constexpr auto g_YawKD = 1.0f;
+// The tuning rules put the integral time at a fraction of the ultimate period, which only describes the loop around its ultimate
+// frequency. The authority of the wing tilt fades as it moves away from the hover, and an integral that fast winds the pitch output into
+// that region and flips the airframe, so the integral time of the tuned pitch and roll rate loops is kept above this. The yaw rate loop
+// takes the integral of the rule, it needs a fast one to stop the turns (like its default gains).
+constexpr auto g_RateTuningMinimumIntegralTime = 2.0f; // Seconds.
+
+// The relay of the angle loop auto tune switches the rate setpoint around 0.
+constexpr auto g_AngleTuningAmplitude = 20.0f; // Degrees per second.
+constexpr auto g_AngleTuningMaximumAmplitude = 90.0f; // Degrees per second.
+constexpr auto g_AngleTuningHysteresis = 0.5f; // Degrees.
+constexpr auto g_AngleTuningTarget = 3.0f; // Degrees.
+constexpr auto g_AngleTuningLimit = 20.0f; // Degrees.
+
+/**
+ * @brief Tuning loop enum.
+ */
+enum class TuningLoop : uint8_t
+{
+	Rate,
+	Angle
+};
+
+/**
+ * @brief Tuning axis enum.
+ * The axes are in the order of the telemetry messages.
+ */
+enum class TuningAxis : uint8_t
+{
+	Pitch,
+	Roll,
+	Yaw
+};
+
+/**
+ * @brief Auto tune request structure.
+ * The control core hands the rate loop experiments over to the sensor core with this.
+ */
+struct AutoTuneRequest final
+{
+	TuningAxis m_Axis = TuningAxis::Pitch;
+	TuningRule m_Rule = TuningRule::ZieglerNichols;
+	bool m_isStart = false;
+};
 
 /**
  * @brief Stabilizer class.
- * This class runs the stabilization algorithm
+ * This class runs the stabilization algorithm.
+ *
+ * The rate loop is closed on the sensor core on every sample, right after the sensor is read, so it reacts to the gyroscope with the
+ * least delay. The angle loop runs on the control core at the output rate and hands the rate setpoints over to the rate loop. In the rate
+ * control mode, the angle loop is skipped and the sticks command the rates directly.
+ *
+ * The stabilizer also owns the sensor calibration (see SensorCalibrator). The stored calibration is loaded when the stabilizer is
+ * initialized, so the controller arms right away. Otherwise it arms once the first still window of the sensor is measured. While the rotors
+ * are stopped, the calibration is measured again in the background when the gyroscope bias drifted or the temperature changed, and the new
+ * calibration is stored. The outputs stay at rest until the controller is armed.
+ *
+ * Each axis of both loops can be tuned in flight with a relay feedback experiment (see RelayTuner). The relay replaces the PID output of
+ * the tuned axis, in the task of its loop: the rate loop relay drives the output around the trim on the sensor core, and the angle loop
+ * relay drives the rate setpoint around 0 on the control core. The other axes stay stabilized. When the oscillation was measured, the new
+ * gains of the axis are computed with the selected rule and used by the running PID controller right away (the angle loop only takes the
+ * proportional gain, and the integral of the pitch and roll rate loops is limited, see g_RateTuningMinimumIntegralTime). The experiment
+ * is stopped when the thrust drops, so the aircraft must be hovering and should be well clear of the ground. The tuned gains are handed
+ * to the parameter system, so they can be saved.
  */
 class Stabilizer final : public System<Stabilizer>
 {
@@ -38,22 +156,231 @@ public:
 
 	/**
 	 * @brief Initialize the stabilizer.
+	 * This must be called from the sensor task, since the sensor notifies the initializing task when new data is available.
+	 *
+	 * @param pBus The I2C bus the sensor is connected to.
+	 * @param pCalibrationStorage The storage of the sensor calibration. This is optional, without it the sensor is calibrated on every boot.
+	 */
+	void initialize(II2CBus *pBus, IRecordStorage<SensorCalibration> *pCalibrationStorage = nullptr);
+
+	/**
+	 * @brief Set a fixed sensor calibration.
+	 * This replaces the stored calibration and stops the background calibration, so a replay corrects the samples with the recorded
+	 * calibrations. It must be called on the sensor core, in between the updates.
+	 *
+	 * @param calibration The calibration.
+	 */
+	void setCalibration(const SensorCalibration &calibration);
+
+	/**
+	 * @brief Wait until the sensor has new data.
+	 *
+	 * @return The number of data ready signals since the last call.
 	 */
-	void initialize();
+	[[nodiscard]] uint32_t waitForSensorData() { return m_Sensor.waitForData(); }
 
 	/**
 	 * @brief Update the stabilizer.
+	 * This reads the sensor, publishes the latest attitude to the control side and runs the rate loop. It runs on the sensor core.
 	 */
 	void update() override;
 
-	float yawValue() { return m_Sensor.getAcceleration().m_Pitch; }
-
+	/**
+	 * @brief Compute the stabilized outputs.
+	 * This runs the angle loop using the latest attitude published by the sensor side and returns the latest outputs of the rate loop. It
+	 * runs on the control core.
+	 *
+	 * @param thrust The input thrust.
+	 * @param pitch The input pitch.
+	 * @param roll The input roll.
+	 * @param yaw The input yaw.
+	 * @return The PID outputs. These are 0 while the controller is not armed.
+	 */
 	Vec3 computeOutputs(float thrust, float pitch, float roll, float yaw);
 
+	/**
+	 * @brief Tune the angle loop.
+	 * This must be called on the control core, in between the updates.
+	 *
+	 * @param kp The proportional constants.
+	 * @param ki The integral constants.
+	 * @param kd The derivative constants.
+	 */
+	void tuneAngleLoop(Vec3 kp, Vec3 ki, Vec3 kd) { m_AngleController.tune(kp, ki, kd); }
+
+	/**
+	 * @brief Tune the rate loop.
+	 * This must be called on the sensor core, in between the updates.
+	 *
+	 * @param kp The proportional constants.
+	 * @param ki The integral constants.
+	 * @param kd The derivative constants.
+	 */
+	void tuneRateLoop(Vec3 kp, Vec3 ki, Vec3 kd) { m_RateController.tune(kp, ki, kd); }
+
+	/**
+	 * @brief Use new parameters.
+	 * The angle loop is tuned right away and the rate loop and the attitude estimator take their parameters on the sensor core, before the
+	 * next sample is read. This must be called on the control core, in between the updates.
+	 *
+	 * @param parameters The parameters.
+	 */
+	void setParameters(const ParameterSet &parameters);
+
+	/**
+	 * @brief Start an auto tune experiment.
+	 * This must be called on the control core. The progress and the result are published in the auto tune telemetry message.
+	 *
+	 * @param loop The loop to tune.
+	 * @param axis The axis to tune. The angle loop does not have a yaw axis.
+	 * @param rule The rule which computes the gains.
+	 * @return true If the experiment was started.
+	 * @return false If the controller is not flying, the loop is not used in the control mode or an experiment is already running.
+	 */
+	bool startAutoTune(TuningLoop loop, TuningAxis axis, TuningRule rule);
+
+	/**
+	 * @brief Stop the auto tune experiment.
+	 * This must be called on the control core. The gains stay as they were.
+	 */
+	void stopAutoTune();
+
+	/**
+	 * @brief Get the progress of the last auto tune experiment.
+	 * This must be called on the control core.
+	 *
+	 * @return The auto tune message.
+	 */
+	[[nodiscard]] const AutoTuneMessage &getAutoTune() const { return m_AutoTune; }
+
+	/**
+	 * @brief Check if the controller is armed.
+	 * The controller arms on the control core, at the first computation of the outputs after the sensor is calibrated.
+	 *
+	 * @return true If the outputs are released.
+	 * @return false If the outputs must stay at rest.
+	 */
+	[[nodiscard]] bool isArmed() const { return m_isArmed; }
+
+	/**
+	 * @brief Check if the thrust is low.
+	 * The thrust is updated on the control core, when the outputs are computed.
+	 *
+	 * @return true If the thrust is below the calibration limit, so the rotors are stopped.
+	 * @return false If the aircraft may be flying.
+	 */
+	[[nodiscard]] bool isThrustLow() const { return m_isThrustLow.load(std::memory_order_relaxed); }
+
+	/**
+	 * @brief Get the time at which the controller armed.
+	 * The clock starts at the boot, so this is how long the start up took.
+	 *
+	 * @return The time in microseconds. 0 while the controller is not armed.
+	 */
+	[[nodiscard]] uint32_t getArmTime() const { return m_ArmTime; }
+
+	/**
+	 * @brief Store the latest sensor calibration, if the sensor side committed a new one.
+	 * Writing to the flash stalls both cores for a few milliseconds, so the sensor side only publishes the calibration and this stores it
+	 * from the control core (see ParameterSystem). The calibration is only committed while the thrust is low.
+	 */
+	void storeCalibration();
+
 private:
-	MPU6050 m_Sensor;
+	/**
+	 * @brief Use the new sensor calibration, if there is one, and record it and publish it to be stored.
+	 * This runs on the sensor core, before the sensor is read.
+	 */
+	void updateCalibration();
+
+	/**
+	 * @brief Publish the calibration which is used to the control core, and record it again.
+	 * This runs on the sensor core.
+	 */
+	void publishCalibration();
+
+	/**
+	 * @brief Arm the controller once the sensor is calibrated.
+	 * This runs on the control core.
+	 */
+	void updateArming();
+
+	/**
+	 * @brief Use the parameters published by the control core, if there are new ones.
+	 * This runs on the sensor core, before the sensor is read.
+	 */
+	void updateParameters();
+
+	/**
+	 * @brief Run the rate loop.
+	 *
+	 * @param sample The latest attitude sample.
+	 */
+	void updateRateLoop(const AttitudeSample &sample);
+
+	/**
+	 * @brief Update the angle loop auto tune.
+	 * This runs on the control core, after the angle loop.
+	 *
+	 * @param attitude The pitch and roll angles of the angle loop.
+	 * @param inputs The pitch, yaw and roll inputs.
+	 * @param setpoints The rate setpoints, of which the tuned axis is replaced.
+	 * @param delta The time since the previous update in seconds.
+	 */
+	void updateAngleTuning(Vec3 attitude, Vec3 inputs, Vec3 &setpoints, float delta);
+
+	/**
+	 * @brief Update the rate loop auto tune.
+	 * This runs on the sensor core, after the rate loop.
+	 *
+	 * @param sample The latest attitude sample.
+	 * @param setpoints The rate setpoints. The relay holds the setpoint of the tuned axis from the start of the experiment.
+	 * @param outputs The outputs, of which the tuned axis is replaced.
+	 * @param delta The time since the previous update in seconds.
+	 */
+	void updateRateTuning(const AttitudeSample &sample, Vec3 setpoints, Vec3 &outputs, float delta);
+
+	/**
+	 * @brief Publish the attitude and the PID terms.
+	 *
+	 * @param sample The attitude sample used to compute the setpoints.
+	 * @param control The rate loop sample which contains the outputs.
+	 */
+	void publishTelemetry(const AttitudeSample &sample, const RateControlSample &control);
+
+private:
+	AttitudeSensor<AttitudeEstimator> m_Sensor;
+	SnapshotBuffer<AttitudeSample> m_SensorBuffer;
+	SnapshotBuffer<RateControlSample> m_RateControlBuffer;
+	SnapshotBuffer<Vec3> m_RateSetpointBuffer;
+	SnapshotBuffer<CalibrationMessage> m_CalibrationBuffer;
+	SnapshotBuffer<SensorCalibration> m_StoredCalibrationBuffer;
+	SnapshotBuffer<ParameterSet> m_ParameterBuffer;
+
+	PID m_AngleController;
+	PID m_RateController;
+
+	RelayTuner m_AngleTuner;
+	RelayTuner m_RateTuner;
+	SnapshotBuffer<AutoTuneRequest> m_RateTuningRequestBuffer;
+	SnapshotBuffer<AutoTuneMessage> m_RateTuningBuffer;
+	AutoTuneMessage m_RateTuning;
+	AutoTuneMessage m_AutoTune;
+	uint8_t m_AutoTuneState = static_cast<uint8_t>(RelayTunerState::Idle);
+	float m_RateTuningSetpoint = 0.0f;
+
+	unsigned long m_PreviousTime = 0;
+	uint32_t m_PreviousSampleTime = 0;
+
+	IRecordStorage<SensorCalibration> *m_pCalibrationStorage = nullptr;
+	uint16_t m_Calibrations = 0;
+	bool m_isCalibrationLoaded = false;
+	bool m_isCalibrationFixed = false;
+	bool m_isCalibrationRecorded = false;
+
+	std::atomic<bool> m_isCalibrated = {false};
+	std::atomic<bool> m_isThrustLow = {true};
 
-	PID m_PitchStabilizer;
-	PID m_RollStabilizer;
-	PID m_YawStabilizer;
+	bool m_isArmed = false;
+	uint32_t m_ArmTime = 0;
 };
\ No newline at end of file
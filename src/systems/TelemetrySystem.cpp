@@ -0,0 +1,216 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#include "TelemetrySystem.hpp"
+#include "Stabilizer.hpp"
+#include "ParameterSystem.hpp"
+
+#include "core/Logging.hpp"
+#include "core/StageProfiler.hpp"
+
+#include <string.h>
+
+// The default message intervals in milliseconds, so the plotter shows something without having to subscribe first.
+constexpr uint16_t g_DefaultTelemetryIntervals[g_TelemetryMessageCount] = {
+	100,  // Setpoints
+	20,	  // Attitude
+	0,	  // PID terms
+	20,	  // Actuator commands
+	0,	  // Stage timings
+	0,	  // Link quality
+	1000, // Calibration
+	500,  // Auto tune
+	0	  // Parameter
+};
+
+static_assert(sizeof(StageTimingsMessage::m_Histogram) == sizeof(StageStatistics::m_Histogram), "The stage histogram does not match the message!");
+
+void TelemetrySystem::initialize()
+{
+	PEREGRINE_PRINTLN("Initializing the telemetry system.");
+
+	for (uint8_t i = 0; i < g_TelemetryMessageCount; i++)
+		subscribe(static_cast<TelemetryMessageID>(i), g_DefaultTelemetryIntervals[i]);
+
+	PEREGRINE_PRINTLN("The telemetry system is initialized.");
+}
+
+void TelemetrySystem::update()
+{
+#ifdef PEREGRINE_TELEMETRY
+	publishStageTimings();
+
+	// Transmit as much as the serial port can take without blocking.
+	const uint8_t *pData = nullptr;
+	const auto available = static_cast<size_t>(Serial.availableForWrite());
+	auto size = m_TransmitBuffer.peek(&pData);
+	if (size > available)
+		size = available;
+
+	if (size > 0)
+	{
+		Serial.write(pData, size);
+		m_TransmitBuffer.consume(size);
+	}
+
+	// Receive the host's frames.
+	while (Serial.available() > 0)
+	{
+		if (m_Decoder.decode(static_cast<uint8_t>(Serial.read())))
+			handleFrame(m_Decoder.getHeader(), m_Decoder.getMessage(), m_Decoder.getMessageSize());
+	}
+
+#endif
+}
+
+void TelemetrySystem::subscribe(TelemetryMessageID id, uint16_t interval)
+{
+	const auto index = static_cast<uint8_t>(id);
+	if (index >= g_TelemetryMessageCount)
+		return;
+
+	m_Subscriptions[index].m_Interval = static_cast<uint32_t>(interval) * 1000;
+}
+
+bool TelemetrySystem::sendText(const char *pText, size_t size)
+{
+#ifdef PEREGRINE_TELEMETRY
+	return m_TransmitBuffer.write(reinterpret_cast<const uint8_t *>(pText), size);
+
+#else
+	return false;
+
+#endif
+}
+
+void TelemetrySystem::publishStageTimings()
+{
+#ifdef PEREGRINE_PROFILING
+	if (!isSubscribed(TelemetryMessageID::StageTimings))
+		return;
+
+	const auto stage = static_cast<ProfileStage>(m_NextStage);
+	const auto &statistics = StageProfiler::GetStatistics(stage);
+	const auto frequency = StageProfiler::GetCPUFrequency();
+
+	StageTimingsMessage message;
+	message.m_Stage = m_NextStage;
+	message.m_CPUFrequency = static_cast<uint8_t>(frequency);
+	message.m_Rate = StageProfiler::GetRate(stage);
+	message.m_Count = statistics.m_Count;
+	message.m_Overruns = statistics.m_Overruns;
+	message.m_Budget = static_cast<uint16_t>(statistics.m_Budget / frequency);
+	message.m_Maximum = static_cast<uint16_t>(statistics.m_Maximum / frequency);
+	memcpy(message.m_Histogram, statistics.m_Histogram, sizeof(message.m_Histogram));
+
+	if (publish(TelemetryMessageID::StageTimings, message))
+	{
+		StageProfiler::ResetMaximum(stage);
+		m_NextStage = (m_NextStage + 1) % g_ProfileStageCount;
+	}
+
+#endif
+}
+
+bool TelemetrySystem::isDue(TelemetryMessageID id)
+{
+	auto &subscription = m_Subscriptions[static_cast<uint8_t>(id)];
+	if (subscription.m_Interval == 0)
+		return false;
+
+	const auto currentTime = micros();
+	if (currentTime - subscription.m_PreviousTime < subscription.m_Interval)
+		return false;
+
+	subscription.m_PreviousTime = currentTime;
+	return true;
+}
+
+void TelemetrySystem::send(TelemetryMessageID id, const uint8_t *pData, uint8_t size)
+{
+	TelemetryHeader header;
+	header.m_ID = id;
+	header.m_Sequence = m_Sequence++;
+	header.m_Timestamp = micros();
+
+	uint8_t encoded[g_MaxEncodedPacketSize];
+	const auto encodedSize = EncodePacket(header, pData, size, encoded);
+
+	if (!m_TransmitBuffer.write(encoded, encodedSize))
+		m_DroppedFrames++;
+}
+
+void TelemetrySystem::handleFrame(const TelemetryHeader &header, const uint8_t *pMessage, size_t size)
+{
+	if (header.m_ID == TelemetryMessageID::Subscribe && size == sizeof(SubscribeMessage))
+	{
+		SubscribeMessage message;
+		memcpy(&message, pMessage, sizeof(message));
+		subscribe(message.m_ID, message.m_Interval);
+	}
+	else if (header.m_ID == TelemetryMessageID::AutoTuneCommand && size == sizeof(AutoTuneCommandMessage))
+	{
+		AutoTuneCommandMessage message;
+		memcpy(&message, pMessage, sizeof(message));
+
+		auto &stabilizer = Stabilizer::Instance();
+		if (message.m_Start == 0)
+			stabilizer.stopAutoTune();
+		else if (message.m_Loop > static_cast<uint8_t>(TuningLoop::Angle) || message.m_Axis > static_cast<uint8_t>(TuningAxis::Yaw) || message.m_Rule >= g_TuningRuleCount)
+			PEREGRINE_LOG_WARNING("Invalid auto tune command!");
+		else
+			stabilizer.startAutoTune(static_cast<TuningLoop>(message.m_Loop), static_cast<TuningAxis>(message.m_Axis), static_cast<TuningRule>(message.m_Rule));
+	}
+	else if (header.m_ID == TelemetryMessageID::ParameterCommand && size == sizeof(ParameterCommandMessage))
+	{
+		ParameterCommandMessage message;
+		memcpy(&message, pMessage, sizeof(message));
+		handleParameterCommand(message);
+	}
+}
+
+void TelemetrySystem::handleParameterCommand(const ParameterCommandMessage &command)
+{
+	ParameterMessage message;
+	message.m_ID = command.m_ID;
+	message.m_Action = command.m_Action;
+
+	// The parameters are written to the shadow copy, which the parameter system publishes right after this update.
+	auto &parameterSystem = ParameterSystem::Instance();
+	auto status = ParameterStatus::Invalid;
+	if (command.m_ID < g_ParameterCount)
+	{
+		const auto id = static_cast<ParameterID>(command.m_ID);
+		const auto type = GetParameterDescriptor(id).m_Type;
+
+		switch (static_cast<ParameterAction>(command.m_Action))
+		{
+		case ParameterAction::Read:
+			status = ParameterStatus::Done;
+			break;
+
+		case ParameterAction::Write:
+			if (command.m_Type == static_cast<uint8_t>(type))
+				status = parameterSystem.set(id, command.m_Value) ? ParameterStatus::Done : ParameterStatus::Rejected;
+			break;
+
+		case ParameterAction::Save:
+			status = parameterSystem.save() ? ParameterStatus::Done : ParameterStatus::Rejected;
+			break;
+
+		case ParameterAction::Reset:
+			parameterSystem.reset();
+			status = ParameterStatus::Done;
+			break;
+
+		default:
+			break;
+		}
+
+		message.m_Type = static_cast<uint8_t>(type);
+		message.m_Value = parameterSystem.get(id);
+	}
+
+	message.m_Status = static_cast<uint8_t>(status);
+	reply(TelemetryMessageID::Parameter, message);
+}
@@ -0,0 +1,193 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "core/System.hpp"
+#include "core/Configuration.hpp"
+#include "core/RingBuffer.hpp"
+#include "core/TelemetryMessages.hpp"
+#include "algorithms/PacketCodec.hpp"
+
+constexpr auto g_TelemetryBufferSize = 1024;
+
+/**
+ * @brief Telemetry system class.
+ * This class streams binary telemetry frames over the serial port. Frames are encoded into a ring buffer when they are published and the
+ * buffer is drained without blocking when the system updates, so a slow serial link never stalls the control loop. The host chooses the
+ * rate of every message by sending subscribe frames.
+ *
+ * Messages are only sent when PEREGRINE_TELEMETRY is defined.
+ */
+class TelemetrySystem final : public System<TelemetrySystem>
+{
+	/**
+	 * @brief Subscription structure.
+	 * This contains the rate information of a single message.
+	 */
+	struct Subscription final
+	{
+		uint32_t m_Interval = 0;
+		uint32_t m_PreviousTime = 0;
+	};
+
+public:
+	/**
+	 * @brief Construct a new Telemetry System object.
+	 */
+	TelemetrySystem() = default;
+
+	/**
+	 * @brief Initialize the telemetry system.
+	 */
+	void initialize();
+
+	/**
+	 * @brief Update the telemetry system.
+	 * This transmits the buffered frames and handles the frames sent by the host.
+	 */
+	void update() override;
+
+	/**
+	 * @brief Set the rate of a message.
+	 *
+	 * @param id The message ID.
+	 * @param interval The minimum interval between two messages in milliseconds. 0 disables the message.
+	 */
+	void subscribe(TelemetryMessageID id, uint16_t interval);
+
+	/**
+	 * @brief Publish a message.
+	 * The message is only sent if the host is subscribed to it and its interval has elapsed.
+	 *
+	 * @tparam Message The message type.
+	 * @param id The message ID.
+	 * @param message The message to publish.
+	 * @return true If the message was due and is sent.
+	 * @return false If the message was not due, or if telemetry is disabled.
+	 */
+	template <class Message>
+	bool publish(TelemetryMessageID id, const Message &message)
+	{
+		static_assert(sizeof(TelemetryHeader) + sizeof(Message) + sizeof(uint16_t) <= g_MaxPacketSize, "The message is too large!");
+
+#ifdef PEREGRINE_TELEMETRY
+		if (!isDue(id))
+			return false;
+
+		send(id, reinterpret_cast<const uint8_t *>(&message), sizeof(Message));
+		return true;
+
+#else
+		return false;
+
+#endif
+	}
+
+	/**
+	 * @brief Reply to a command of the host.
+	 * Unlike a published message, the reply is sent whether the host is subscribed to it or not.
+	 *
+	 * @tparam Message The message type.
+	 * @param id The message ID.
+	 * @param message The message to send.
+	 */
+	template <class Message>
+	void reply(TelemetryMessageID id, const Message &message)
+	{
+		static_assert(sizeof(TelemetryHeader) + sizeof(Message) + sizeof(uint16_t) <= g_MaxPacketSize, "The message is too large!");
+
+#ifdef PEREGRINE_TELEMETRY
+		send(id, reinterpret_cast<const uint8_t *>(&message), sizeof(Message));
+
+#endif
+	}
+
+	/**
+	 * @brief Send plain text.
+	 * Text is sent between frames as is, the host treats anything that is not a valid frame as text. The text must not contain zeros.
+	 *
+	 * @param pText The text to send.
+	 * @param size The size of the text.
+	 * @return true If the text was queued.
+	 * @return false If there was not enough room in the buffer.
+	 */
+	bool sendText(const char *pText, size_t size);
+
+	/**
+	 * @brief Check if the host is subscribed to a message.
+	 * This can be used to skip gathering data for messages that are not sent.
+	 *
+	 * @param id The message ID.
+	 * @return true If the message is subscribed.
+	 * @return false If the message is not subscribed.
+	 */
+	[[nodiscard]] bool isSubscribed(TelemetryMessageID id) const { return m_Subscriptions[static_cast<uint8_t>(id)].m_Interval > 0; }
+
+	/**
+	 * @brief Get the number of frames dropped because the buffer was full.
+	 *
+	 * @return The dropped frame count.
+	 */
+	[[nodiscard]] uint32_t getDroppedFrames() const { return m_DroppedFrames; }
+
+	/**
+	 * @brief Get the free space in the transmit buffer.
+	 *
+	 * @return The free size in bytes.
+	 */
+	[[nodiscard]] size_t getTransmitFreeSize() const { return m_TransmitBuffer.getFreeSize(); }
+
+private:
+	/**
+	 * @brief Check if a message should be sent now.
+	 * This also updates the time the message was last sent.
+	 *
+	 * @param id The message ID.
+	 * @return true If the message should be sent.
+	 * @return false If the message is not subscribed or the interval has not elapsed.
+	 */
+	bool isDue(TelemetryMessageID id);
+
+	/**
+	 * @brief Publish the timings of the next control loop stage.
+	 * The stages are published one after the other, at the rate of the stage timings message.
+	 */
+	void publishStageTimings();
+
+	/**
+	 * @brief Encode a frame and queue it for transmission.
+	 *
+	 * @param id The message ID.
+	 * @param pData The message data.
+	 * @param size The message size.
+	 */
+	void send(TelemetryMessageID id, const uint8_t *pData, uint8_t size);
+
+	/**
+	 * @brief Carry out a parameter command and reply with the parameter.
+	 *
+	 * @param command The command.
+	 */
+	void handleParameterCommand(const ParameterCommandMessage &command);
+
+	/**
+	 * @brief Handle a frame received from the host.
+	 *
+	 * @param header The frame header.
+	 * @param pMessage The message data.
+	 * @param size The message size.
+	 */
+	void handleFrame(const TelemetryHeader &header, const uint8_t *pMessage, size_t size);
+
+private:
+	RingBuffer<g_TelemetryBufferSize> m_TransmitBuffer;
+	Subscription m_Subscriptions[g_TelemetryMessageCount];
+
+	PacketDecoder m_Decoder;
+
+	uint16_t m_Sequence = 0;
+	uint32_t m_DroppedFrames = 0;
+
+	uint8_t m_NextStage = 0;
+};
\ No newline at end of file
@@ -0,0 +1,330 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#include "algorithms/BlackboxDecoder.hpp"
+#include "core/GlobalState.hpp"
+#include "systems/BlackboxSystem.hpp"
+#include "systems/OutputSystem.hpp"
+#include "sim/FileBlackboxStorage.hpp"
+#include "sim/HostPlatform.hpp"
+
+#include <Arduino.h>
+
+#include <stdio.h>
+#include <unity.h>
+#include <vector>
+
+// The log file, in the working directory of the test.
+constexpr auto g_LogPath = "test_blackbox.bbx";
+
+// The samples are recorded at 1 kHz.
+constexpr uint32_t g_SamplePeriod = 1000;
+
+/**
+ * @brief Memory blackbox storage class.
+ * This keeps the written blocks in memory and can be made to fail.
+ */
+class MemoryBlackboxStorage final : public IBlackboxStorage
+{
+public:
+	bool onOpen() override { return true; }
+
+	bool onWrite(const uint8_t *pData, size_t size) override
+	{
+		if (m_isFailing)
+			return false;
+
+		m_Data.insert(m_Data.end(), pData, pData + size);
+		m_Writes++;
+		return true;
+	}
+
+	void onClose() override { m_Closes++; }
+
+	std::vector<uint8_t> m_Data;
+	uint32_t m_Writes = 0;
+	uint32_t m_Closes = 0;
+	bool m_isFailing = false;
+};
+
+/**
+ * @brief Create the raw sample of a sample index.
+ *
+ * @param index The sample index.
+ * @return The raw sample.
+ */
+static RawIMUSample CreateSample(uint32_t index)
+{
+	RawIMUSample sample;
+	for (uint8_t i = 0; i < 3; i++)
+	{
+		sample.m_Accelerometer[i] = static_cast<int16_t>(((index * 7) + (i * 1000)) % 8000) - 4000;
+		sample.m_Gyroscope[i] = static_cast<int16_t>((index % 200) * (i + 1)) - 300;
+	}
+
+	return sample;
+}
+
+/**
+ * @brief Decode all the records of a log.
+ *
+ * @param data The log.
+ * @param records The decoded records.
+ * @param sequences The sequence numbers of the blocks.
+ * @return true If every block was valid.
+ * @return false If a block was damaged.
+ */
+static bool DecodeLog(const std::vector<uint8_t> &data, std::vector<BlackboxRecord> &records, std::vector<uint32_t> &sequences)
+{
+	BlackboxDecoder decoder;
+	size_t offset = 0;
+	while (offset < data.size())
+	{
+		const auto blockSize = decoder.setBlock(data.data() + offset, data.size() - offset);
+		if (blockSize == 0)
+			return false;
+
+		BlackboxRecord record;
+		while (decoder.decode(record))
+			records.push_back(record);
+
+		if (decoder.isDamaged())
+			return false;
+
+		sequences.push_back(decoder.getHeader().m_Sequence);
+		offset += blockSize;
+	}
+
+	return true;
+}
+
+/**
+ * @brief Read a file.
+ *
+ * @param pPath The file path.
+ * @return The contents.
+ */
+static std::vector<uint8_t> ReadFile(const char *pPath)
+{
+	std::vector<uint8_t> data;
+	FILE *pFile = fopen(pPath, "rb");
+	if (!pFile)
+		return data;
+
+	uint8_t buffer[256];
+	size_t size = 0;
+	while ((size = fread(buffer, 1, sizeof(buffer), pFile)) > 0)
+		data.insert(data.end(), buffer, buffer + size);
+
+	fclose(pFile);
+	return data;
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+	remove(g_LogPath);
+}
+
+void test_log_round_trip_through_the_file_backend()
+{
+	// Ten seconds of samples, with the inputs of a 7 ms frame and the actuators every 4 samples, like the flight controller records them.
+	constexpr uint32_t sampleCount = 10000;
+
+	auto &blackboxSystem = BlackboxSystem::Instance();
+	FileBlackboxStorage storage(g_LogPath);
+	blackboxSystem.initialize(&storage);
+	TEST_ASSERT_TRUE(blackboxSystem.isRecording());
+
+	const auto droppedRecords = blackboxSystem.getDroppedRecords();
+	const auto start = micros();
+	std::vector<BlackboxRecord> expected;
+	for (uint32_t i = 0; i < sampleCount; i++)
+	{
+		const auto timestamp = start + (i * g_SamplePeriod);
+		const auto sample = CreateSample(i);
+		blackboxSystem.recordIMU(sample, 0.001f, timestamp);
+
+		BlackboxRecord record;
+		record.m_Type = BlackboxRecordType::IMU;
+		record.m_Timestamp = timestamp;
+		for (uint8_t j = 0; j < 3; j++)
+		{
+			record.m_Fields[j] = sample.m_Accelerometer[j];
+			record.m_Fields[3 + j] = sample.m_Gyroscope[j];
+		}
+
+		record.m_Fields[6] = EncodeBlackboxFloat(0.001f);
+		expected.push_back(record);
+
+		if (i % 7 == 0)
+		{
+			Setpoint inputs;
+			inputs.m_Thrust = static_cast<float>(i % 1000);
+			inputs.m_Pitch = static_cast<float>(i % 90) - 45.0f;
+			blackboxSystem.recordInputs(timestamp, inputs, timestamp - 100);
+
+			record = BlackboxRecord();
+			record.m_Type = BlackboxRecordType::Inputs;
+			record.m_Timestamp = timestamp;
+			record.m_Fields[0] = EncodeBlackboxFloat(inputs.m_Thrust);
+			record.m_Fields[1] = EncodeBlackboxFloat(inputs.m_Pitch);
+			record.m_Fields[2] = EncodeBlackboxFloat(0.0f);
+			record.m_Fields[3] = EncodeBlackboxFloat(0.0f);
+			record.m_Fields[4] = static_cast<int32_t>(timestamp - 100);
+			record.m_Fields[5] = static_cast<int32_t>(g_RequiredFlyMode);
+			record.m_Fields[6] = static_cast<int32_t>(g_ControlMode);
+			expected.push_back(record);
+		}
+
+		if (i % 4 == 0)
+		{
+			ActuatorFrame frame;
+			frame.m_LeftRotor = static_cast<float>(i % 1000) * 0.1f;
+			frame.m_RightRotor = 100.0f - frame.m_LeftRotor;
+			frame.m_LeftWing = static_cast<int32_t>(i % 180);
+			frame.m_Elevator = 90;
+			blackboxSystem.recordActuators(timestamp, frame);
+
+			record = BlackboxRecord();
+			record.m_Type = BlackboxRecordType::Actuators;
+			record.m_Timestamp = timestamp;
+			record.m_Fields[0] = EncodeBlackboxFixed(frame.m_LeftRotor);
+			record.m_Fields[1] = EncodeBlackboxFixed(frame.m_RightRotor);
+			record.m_Fields[2] = frame.m_LeftWing;
+			record.m_Fields[3] = frame.m_RightWing;
+			record.m_Fields[4] = frame.m_Elevator;
+			record.m_Fields[5] = frame.m_Rudder;
+			record.m_Fields[6] = static_cast<int32_t>(g_CurrentFlyMode);
+			expected.push_back(record);
+		}
+
+		// The blackbox task drains the queue every few milliseconds.
+		AdvanceHostTime(g_SamplePeriod);
+		if (i % 10 == 0)
+			blackboxSystem.update();
+	}
+
+	blackboxSystem.stop();
+	TEST_ASSERT_FALSE(blackboxSystem.isRecording());
+	TEST_ASSERT_EQUAL_UINT32(droppedRecords, blackboxSystem.getDroppedRecords());
+
+	// The log is a sequence of whole blocks with consecutive numbers, and contains every record.
+	std::vector<BlackboxRecord> records;
+	std::vector<uint32_t> sequences;
+	const auto data = ReadFile(g_LogPath);
+	TEST_ASSERT_TRUE(data.size() > g_BlackboxBlockSize);
+	TEST_ASSERT_TRUE(DecodeLog(data, records, sequences));
+
+	for (size_t i = 1; i < sequences.size(); i++)
+		TEST_ASSERT_EQUAL_UINT32(sequences[i - 1] + 1, sequences[i]);
+
+	TEST_ASSERT_EQUAL(expected.size(), records.size());
+	for (size_t i = 0; i < records.size(); i++)
+	{
+		TEST_ASSERT_EQUAL(static_cast<int>(expected[i].m_Type), static_cast<int>(records[i].m_Type));
+		TEST_ASSERT_EQUAL_UINT32(expected[i].m_Timestamp, records[i].m_Timestamp);
+
+		const auto fieldCount = g_BlackboxFieldCounts[static_cast<uint8_t>(expected[i].m_Type)];
+		TEST_ASSERT_EQUAL_INT32_ARRAY(expected[i].m_Fields, records[i].m_Fields, fieldCount);
+	}
+}
+
+void test_partial_block_is_written_after_the_flush_interval()
+{
+	auto &blackboxSystem = BlackboxSystem::Instance();
+	MemoryBlackboxStorage storage;
+	blackboxSystem.initialize(&storage);
+
+	blackboxSystem.recordIMU(CreateSample(1), 0.001f, micros());
+	blackboxSystem.update();
+	TEST_ASSERT_EQUAL_UINT32(0, storage.m_Writes);
+
+	AdvanceHostTime(g_BlackboxFlushInterval);
+	blackboxSystem.update();
+	TEST_ASSERT_EQUAL_UINT32(1, storage.m_Writes);
+	TEST_ASSERT_TRUE(storage.m_Data.size() < g_BlackboxBlockSize);
+
+	std::vector<BlackboxRecord> records;
+	std::vector<uint32_t> sequences;
+	TEST_ASSERT_TRUE(DecodeLog(storage.m_Data, records, sequences));
+	TEST_ASSERT_EQUAL(1, records.size());
+
+	blackboxSystem.stop();
+	TEST_ASSERT_EQUAL_UINT32(1, storage.m_Writes);
+	TEST_ASSERT_EQUAL_UINT32(1, storage.m_Closes);
+}
+
+void test_stop_writes_the_partial_block_and_closes()
+{
+	auto &blackboxSystem = BlackboxSystem::Instance();
+	MemoryBlackboxStorage storage;
+	blackboxSystem.initialize(&storage);
+
+	for (uint32_t i = 0; i < 10; i++)
+		blackboxSystem.recordIMU(CreateSample(i), 0.001f, micros() + i);
+
+	blackboxSystem.stop();
+	TEST_ASSERT_EQUAL_UINT32(1, storage.m_Writes);
+	TEST_ASSERT_EQUAL_UINT32(1, storage.m_Closes);
+
+	std::vector<BlackboxRecord> records;
+	std::vector<uint32_t> sequences;
+	TEST_ASSERT_TRUE(DecodeLog(storage.m_Data, records, sequences));
+	TEST_ASSERT_EQUAL(10, records.size());
+
+	// Nothing is recorded or closed again after the stop.
+	blackboxSystem.recordIMU(CreateSample(0), 0.001f, micros());
+	blackboxSystem.stop();
+	TEST_ASSERT_EQUAL_UINT32(1, storage.m_Writes);
+	TEST_ASSERT_EQUAL_UINT32(1, storage.m_Closes);
+}
+
+void test_write_failure_stops_recording()
+{
+	auto &blackboxSystem = BlackboxSystem::Instance();
+	MemoryBlackboxStorage storage;
+	storage.m_isFailing = true;
+	blackboxSystem.initialize(&storage);
+
+	blackboxSystem.recordIMU(CreateSample(0), 0.001f, micros());
+	AdvanceHostTime(g_BlackboxFlushInterval);
+	blackboxSystem.update();
+	TEST_ASSERT_FALSE(blackboxSystem.isRecording());
+	TEST_ASSERT_TRUE(storage.m_Data.empty());
+}
+
+void test_full_queue_drops_records()
+{
+	auto &blackboxSystem = BlackboxSystem::Instance();
+	MemoryBlackboxStorage storage;
+	blackboxSystem.initialize(&storage);
+
+	// The blackbox task fell behind.
+	const auto droppedRecords = blackboxSystem.getDroppedRecords();
+	for (uint32_t i = 0; i < g_BlackboxQueueSize * 2; i++)
+		blackboxSystem.recordIMU(CreateSample(i), 0.001f, micros() + i);
+
+	const auto dropped = blackboxSystem.getDroppedRecords() - droppedRecords;
+	TEST_ASSERT_TRUE(dropped >= g_BlackboxQueueSize);
+	blackboxSystem.stop();
+
+	std::vector<BlackboxRecord> records;
+	std::vector<uint32_t> sequences;
+	TEST_ASSERT_TRUE(DecodeLog(storage.m_Data, records, sequences));
+	TEST_ASSERT_EQUAL((g_BlackboxQueueSize * 2) - dropped, records.size());
+}
+
+int main()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_log_round_trip_through_the_file_backend);
+	RUN_TEST(test_partial_block_is_written_after_the_flush_interval);
+	RUN_TEST(test_stop_writes_the_partial_block_and_closes);
+	RUN_TEST(test_write_failure_stops_recording);
+	RUN_TEST(test_full_queue_drops_records);
+	return UNITY_END();
+}
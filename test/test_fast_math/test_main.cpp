@@ -0,0 +1,65 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#include "core/FastMath.hpp"
+
+#include <math.h>
+#include <unity.h>
+
+// The number of angles of the accuracy check.
+constexpr auto g_AccuracySamples = 100000;
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_fast_atan2_is_within_the_error_bound()
+{
+	// A full circle at a couple of different magnitudes, compared with the double precision library function.
+	constexpr double radii[] = {0.001, 1.0, 9.81, 1000.0};
+
+	auto maximumError = 0.0;
+	for (uint32_t i = 0; i < g_AccuracySamples; i++)
+	{
+		const auto angle = (2.0 * M_PI * i / g_AccuracySamples) - M_PI;
+		const auto y = static_cast<float>(radii[i % 4] * sin(angle));
+		const auto x = static_cast<float>(radii[i % 4] * cos(angle));
+		const auto error = fabs(static_cast<double>(FastAtan2(y, x)) - atan2(static_cast<double>(y), static_cast<double>(x)));
+		maximumError = error > maximumError ? error : maximumError;
+	}
+
+	TEST_ASSERT_FLOAT_WITHIN(g_FastAtan2MaximumError, 0.0f, static_cast<float>(maximumError));
+}
+
+void test_fast_atan2_axes_and_origin()
+{
+	TEST_ASSERT_EQUAL_FLOAT(0.0f, FastAtan2(0.0f, 0.0f));
+	TEST_ASSERT_FLOAT_WITHIN(g_FastAtan2MaximumError, 0.0f, FastAtan2(0.0f, 1.0f));
+	TEST_ASSERT_FLOAT_WITHIN(g_FastAtan2MaximumError, g_HalfPi, FastAtan2(1.0f, 0.0f));
+	TEST_ASSERT_FLOAT_WITHIN(g_FastAtan2MaximumError, -g_HalfPi, FastAtan2(-1.0f, 0.0f));
+	TEST_ASSERT_FLOAT_WITHIN(g_FastAtan2MaximumError, g_Pi, FastAtan2(0.0f, -1.0f));
+	TEST_ASSERT_FLOAT_WITHIN(g_FastAtan2MaximumError, g_Pi / 4.0f, FastAtan2(2.0f, 2.0f));
+	TEST_ASSERT_FLOAT_WITHIN(g_FastAtan2MaximumError, -3.0f * g_Pi / 4.0f, FastAtan2(-2.0f, -2.0f));
+}
+
+void test_fast_atan2_is_odd_in_y()
+{
+	for (auto x = -5.0f; x <= 5.0f; x += 0.25f)
+	{
+		for (auto y = 0.125f; y <= 5.0f; y += 0.25f)
+			TEST_ASSERT_EQUAL_FLOAT(-FastAtan2(y, x), FastAtan2(-y, x));
+	}
+}
+
+int main()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_fast_atan2_is_within_the_error_bound);
+	RUN_TEST(test_fast_atan2_axes_and_origin);
+	RUN_TEST(test_fast_atan2_is_odd_in_y);
+	return UNITY_END();
+}
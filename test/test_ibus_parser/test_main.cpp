@@ -0,0 +1,368 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#include "algorithms/IBusParser.hpp"
+#include "components/FSi6DataLink.hpp"
+#include "core/Constants.hpp"
+#include "sim/HostPlatform.hpp"
+
+#include <Arduino.h>
+
+#include <unity.h>
+#include <vector>
+
+// The receiver sends a frame every 7 ms, and a byte takes 10 bits at 115200 baud (about 87 microseconds).
+constexpr uint32_t g_FramePeriod = 7000;
+constexpr uint32_t g_ByteTime = (g_IBusBitsPerByte * 1000000) / g_IBusBaudRate;
+
+/**
+ * @brief Received byte structure.
+ * This is a byte of a recorded stream with its arrival time.
+ */
+struct ReceivedByte final
+{
+	uint8_t m_Value = 0;
+	uint32_t m_Timestamp = 0;
+};
+
+/**
+ * @brief Fill the channels of a frame with values that change from frame to frame.
+ *
+ * @param index The frame index.
+ * @param pChannels The g_IBusChannelCount channel values.
+ */
+static void FillChannels(uint32_t index, uint16_t *pChannels)
+{
+	for (uint32_t i = 0; i < g_IBusChannelCount; i++)
+		pChannels[i] = static_cast<uint16_t>(1000 + (((index * 37) + (i * 71)) % 1001));
+}
+
+/**
+ * @brief Append a frame to a stream, with the bytes back to back.
+ *
+ * @param stream The stream.
+ * @param pFrame The g_IBusFrameSize bytes of the frame.
+ * @param timestamp The arrival time of the first byte.
+ */
+static void AppendFrame(std::vector<ReceivedByte> &stream, const uint8_t *pFrame, uint32_t timestamp)
+{
+	for (uint32_t i = 0; i < g_IBusFrameSize; i++)
+		stream.push_back(ReceivedByte{pFrame[i], timestamp + (i * g_ByteTime)});
+}
+
+/**
+ * @brief Get the next value of a pseudo random sequence.
+ *
+ * @param state The state of the sequence.
+ * @return The value (0 - 32767).
+ */
+static uint32_t NextRandom(uint32_t &state)
+{
+	state = (state * 1103515245u) + 12345u;
+	return (state >> 16) & 0x7FFF;
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_encoded_frame_is_parsed()
+{
+	uint16_t channels[g_IBusChannelCount];
+	FillChannels(3, channels);
+
+	uint8_t frame[g_IBusFrameSize];
+	EncodeIBusFrame(channels, frame);
+	TEST_ASSERT_EQUAL_HEX8(g_IBusFrameLength, frame[0]);
+	TEST_ASSERT_EQUAL_HEX8(g_IBusServoCommand, frame[1]);
+
+	IBusParser parser;
+	for (uint32_t i = 0; i < g_IBusFrameSize - 1; i++)
+		TEST_ASSERT_FALSE(parser.parse(frame[i], 1000 + (i * g_ByteTime)));
+
+	TEST_ASSERT_EQUAL_UINT32(0, parser.getFrame().m_Sequence);
+	TEST_ASSERT_TRUE(parser.parse(frame[g_IBusFrameSize - 1], 5000));
+
+	const auto &parsed = parser.getFrame();
+	TEST_ASSERT_EQUAL_UINT16_ARRAY(channels, parsed.m_Channels, g_IBusChannelCount);
+	TEST_ASSERT_EQUAL_UINT32(5000, parsed.m_Timestamp);
+	TEST_ASSERT_EQUAL_UINT32(1, parsed.m_Sequence);
+	TEST_ASSERT_EQUAL_UINT32(0, parser.getChecksumErrors());
+}
+
+void test_extra_channel_bits_are_masked()
+{
+	uint16_t channels[g_IBusChannelCount];
+	FillChannels(0, channels);
+	channels[5] |= 0xA000;
+
+	uint8_t frame[g_IBusFrameSize];
+	EncodeIBusFrame(channels, frame);
+
+	IBusParser parser;
+	for (uint32_t i = 0; i < g_IBusFrameSize; i++)
+		parser.parse(frame[i], i * g_ByteTime);
+
+	TEST_ASSERT_EQUAL_UINT16(channels[5] & g_IBusChannelMask, parser.getFrame().m_Channels[5]);
+}
+
+void test_checksum_error_drops_the_frame()
+{
+	uint16_t channels[g_IBusChannelCount];
+	FillChannels(1, channels);
+
+	uint8_t frame[g_IBusFrameSize];
+	EncodeIBusFrame(channels, frame);
+	frame[10] ^= 0x04;
+
+	IBusParser parser;
+	for (uint32_t i = 0; i < g_IBusFrameSize; i++)
+		TEST_ASSERT_FALSE(parser.parse(frame[i], i * g_ByteTime));
+
+	TEST_ASSERT_EQUAL_UINT32(1, parser.getChecksumErrors());
+	TEST_ASSERT_EQUAL_UINT32(0, parser.getFrame().m_Sequence);
+
+	// The next frame is parsed.
+	frame[10] ^= 0x04;
+	for (uint32_t i = 0; i < g_IBusFrameSize; i++)
+		parser.parse(frame[i], g_FramePeriod + (i * g_ByteTime));
+
+	TEST_ASSERT_EQUAL_UINT32(1, parser.getFrame().m_Sequence);
+	TEST_ASSERT_EQUAL_UINT16_ARRAY(channels, parser.getFrame().m_Channels, g_IBusChannelCount);
+}
+
+void test_garbage_before_the_header_is_skipped()
+{
+	uint16_t channels[g_IBusChannelCount];
+	FillChannels(2, channels);
+
+	uint8_t frame[g_IBusFrameSize];
+	EncodeIBusFrame(channels, frame);
+
+	// A length byte right before the header, which must not be taken as the start of the frame.
+	const uint8_t garbage[] = {0x55, 0x40, 0x20, 0x13, 0x20};
+
+	IBusParser parser;
+	uint32_t timestamp = 0;
+	for (const auto value : garbage)
+		TEST_ASSERT_FALSE(parser.parse(value, timestamp += g_ByteTime));
+
+	auto isParsed = false;
+	for (uint32_t i = 0; i < g_IBusFrameSize; i++)
+		isParsed = parser.parse(frame[i], timestamp += g_ByteTime);
+
+	TEST_ASSERT_TRUE(isParsed);
+	TEST_ASSERT_EQUAL_UINT16_ARRAY(channels, parser.getFrame().m_Channels, g_IBusChannelCount);
+	TEST_ASSERT_EQUAL_UINT32(0, parser.getChecksumErrors());
+}
+
+void test_gap_resynchronizes_the_parser()
+{
+	uint16_t channels[g_IBusChannelCount];
+	FillChannels(4, channels);
+
+	uint8_t frame[g_IBusFrameSize];
+	EncodeIBusFrame(channels, frame);
+
+	// The first half of a frame is received, the rest was lost. The next frame starts after the usual gap.
+	IBusParser parser;
+	for (uint32_t i = 0; i < g_IBusFrameSize / 2; i++)
+		parser.parse(frame[i], i * g_ByteTime);
+
+	auto isParsed = false;
+	for (uint32_t i = 0; i < g_IBusFrameSize; i++)
+		isParsed = parser.parse(frame[i], g_FramePeriod + (i * g_ByteTime));
+
+	TEST_ASSERT_TRUE(isParsed);
+	TEST_ASSERT_EQUAL_UINT32(1, parser.getFrame().m_Sequence);
+	TEST_ASSERT_EQUAL_UINT32(0, parser.getChecksumErrors());
+}
+
+void test_recorded_stream_is_parsed()
+{
+	// A second of frames as the receiver sends them, with the byte timing of the UART. The clock wraps around in the middle.
+	constexpr uint32_t frameCount = 1000000 / g_FramePeriod;
+	const auto start = UINT32_MAX - (frameCount / 2 * g_FramePeriod);
+
+	std::vector<ReceivedByte> stream;
+	for (uint32_t i = 0; i < frameCount; i++)
+	{
+		uint16_t channels[g_IBusChannelCount];
+		FillChannels(i, channels);
+
+		uint8_t frame[g_IBusFrameSize];
+		EncodeIBusFrame(channels, frame);
+		AppendFrame(stream, frame, start + (i * g_FramePeriod));
+	}
+
+	IBusParser parser;
+	uint32_t parsed = 0;
+	for (const auto &received : stream)
+	{
+		if (!parser.parse(received.m_Value, received.m_Timestamp))
+			continue;
+
+		uint16_t channels[g_IBusChannelCount];
+		FillChannels(parsed, channels);
+		TEST_ASSERT_EQUAL_UINT16_ARRAY(channels, parser.getFrame().m_Channels, g_IBusChannelCount);
+		TEST_ASSERT_EQUAL_UINT32(start + (parsed * g_FramePeriod) + ((g_IBusFrameSize - 1) * g_ByteTime), parser.getFrame().m_Timestamp);
+
+		parsed++;
+		TEST_ASSERT_EQUAL_UINT32(parsed, parser.getFrame().m_Sequence);
+	}
+
+	TEST_ASSERT_EQUAL_UINT32(frameCount, parsed);
+	TEST_ASSERT_EQUAL_UINT32(0, parser.getChecksumErrors());
+}
+
+void test_fuzzed_stream_only_yields_sent_frames()
+{
+	// Frames with random bit flips, lost bytes and noise in between. Every parsed frame must be one that was sent, unchanged, and every
+	// intact frame which follows a gap must be parsed.
+	constexpr uint32_t frameCount = 20000;
+
+	uint32_t state = 42;
+	uint32_t timestamp = 0;
+	uint32_t intactFrames = 0;
+	uint32_t parsedFrames = 0;
+	uint32_t corruptFrames = 0;
+
+	IBusParser parser;
+	for (uint32_t i = 0; i < frameCount; i++)
+	{
+		uint16_t channels[g_IBusChannelCount];
+		FillChannels(i, channels);
+
+		uint8_t frame[g_IBusFrameSize];
+		EncodeIBusFrame(channels, frame);
+
+		// Noise on the line before the frame, which ends with a gap.
+		const auto noiseSize = NextRandom(state) % 4 == 0 ? NextRandom(state) % 40 : 0;
+		for (uint32_t j = 0; j < noiseSize; j++)
+		{
+			const auto value = NextRandom(state) % 3 == 0 ? (j % 2 == 0 ? g_IBusFrameLength : g_IBusServoCommand) : static_cast<uint8_t>(NextRandom(state));
+			parser.parse(value, timestamp += g_ByteTime);
+		}
+
+		timestamp += g_FramePeriod - (g_IBusFrameSize * g_ByteTime);
+
+		// The frame, possibly damaged.
+		auto isIntact = true;
+		uint32_t size = g_IBusFrameSize;
+		switch (NextRandom(state) % 8)
+		{
+		case 0:
+			frame[NextRandom(state) % g_IBusFrameSize] ^= static_cast<uint8_t>(1 << (NextRandom(state) % 8));
+			isIntact = false;
+			break;
+
+		case 1:
+			size = NextRandom(state) % g_IBusFrameSize;
+			isIntact = false;
+			break;
+
+		default:
+			break;
+		}
+
+		auto isParsed = false;
+		for (uint32_t j = 0; j < size; j++)
+		{
+			if (!parser.parse(frame[j], timestamp += g_ByteTime))
+				continue;
+
+			isParsed = true;
+			parsedFrames++;
+			TEST_ASSERT_EQUAL_UINT32(g_IBusFrameSize - 1, j);
+			TEST_ASSERT_EQUAL_UINT16_ARRAY(channels, parser.getFrame().m_Channels, g_IBusChannelCount);
+			TEST_ASSERT_EQUAL_UINT32(parsedFrames, parser.getFrame().m_Sequence);
+		}
+
+		TEST_ASSERT_FALSE(!isIntact && isParsed);
+		TEST_ASSERT_FALSE(isIntact && !isParsed);
+
+		intactFrames += isIntact ? 1 : 0;
+		corruptFrames += isIntact ? 0 : 1;
+	}
+
+	TEST_ASSERT_EQUAL_UINT32(intactFrames, parsedFrames);
+	TEST_ASSERT_TRUE(corruptFrames > frameCount / 8);
+}
+
+void test_data_link_stamps_each_frame_with_its_last_byte()
+{
+	FSi6DataLink link;
+	link.onInitialize();
+
+	// Two frames are drained by the same receive event, and the second one is damaged.
+	uint16_t channels[g_IBusChannelCount];
+	for (auto &channel : channels)
+		channel = 1500;
+
+	uint8_t frames[g_IBusFrameSize * 2];
+	EncodeIBusFrame(channels, frames);
+	channels[0] = 1600;
+	EncodeIBusFrame(channels, frames + g_IBusFrameSize);
+	frames[(g_IBusFrameSize * 2) - 1] ^= 0xFF;
+
+	AdvanceHostTime(100000);
+	const auto time = micros();
+	Serial2.receive(frames, sizeof(frames));
+	link.onUpdate();
+
+	// The first frame's last byte arrived 32 byte times before the event.
+	TEST_ASSERT_EQUAL_UINT32(1, link.getFrame().m_Sequence);
+	TEST_ASSERT_EQUAL_UINT32(time - ((g_IBusFrameSize * g_IBusBitsPerByte * 1000000) / g_IBusBaudRate), link.getFrame().m_Timestamp);
+	TEST_ASSERT_EQUAL_UINT16(1500, link.getFrame().m_Channels[0]);
+	TEST_ASSERT_EQUAL_UINT32(link.getFrame().m_Timestamp, link.onGetTimestamp());
+}
+
+void test_data_link_maps_the_channels_and_times_out()
+{
+	FSi6DataLink link;
+	link.onInitialize();
+
+	uint16_t channels[g_IBusChannelCount];
+	for (auto &channel : channels)
+		channel = 1500;
+
+	channels[static_cast<uint8_t>(FSi6InputChannel::Throttle)] = g_ChannelMaximum;
+
+	uint8_t frame[g_IBusFrameSize];
+	EncodeIBusFrame(channels, frame);
+
+	AdvanceHostTime(g_FramePeriod);
+	Serial2.receive(frame, sizeof(frame));
+	link.onUpdate();
+	TEST_ASSERT_EQUAL_FLOAT(static_cast<float>(g_ThrottleInputMaximum), link.onGetThrust());
+
+	// The receiver stopped sending frames.
+	AdvanceHostTime(g_IBusTimeout / 2);
+	link.onUpdate();
+	TEST_ASSERT_EQUAL_UINT32(1, link.getFrame().m_Sequence);
+
+	AdvanceHostTime(g_IBusTimeout);
+	link.onUpdate();
+	TEST_ASSERT_EQUAL_UINT32(0, link.getFrame().m_Sequence);
+	TEST_ASSERT_EQUAL_UINT32(0, link.onGetTimestamp());
+	TEST_ASSERT_EQUAL_FLOAT(static_cast<float>(g_ThrottleInputMinimum), link.onGetThrust());
+}
+
+int main()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_encoded_frame_is_parsed);
+	RUN_TEST(test_extra_channel_bits_are_masked);
+	RUN_TEST(test_checksum_error_drops_the_frame);
+	RUN_TEST(test_garbage_before_the_header_is_skipped);
+	RUN_TEST(test_gap_resynchronizes_the_parser);
+	RUN_TEST(test_recorded_stream_is_parsed);
+	RUN_TEST(test_fuzzed_stream_only_yields_sent_frames);
+	RUN_TEST(test_data_link_stamps_each_frame_with_its_last_byte);
+	RUN_TEST(test_data_link_maps_the_channels_and_times_out);
+	return UNITY_END();
+}
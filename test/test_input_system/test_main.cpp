@@ -0,0 +1,227 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#include "systems/InputSystem.hpp"
+#include "systems/ParameterSystem.hpp"
+#include "core/Configuration.hpp"
+#include "core/Constants.hpp"
+
+#include <unity.h>
+
+// The receiver sends a frame every 7 ms.
+constexpr uint32_t g_FramePeriod = 7000;
+
+/**
+ * @brief Fake data link class.
+ * This returns the inputs and the frame timestamp set by the test.
+ */
+class FakeDataLink final : public IDataLink
+{
+public:
+	void onInitialize() override {}
+	void onUpdate() override {}
+
+	[[nodiscard]] float onGetThrust() override { return m_Inputs.m_Thrust; }
+	[[nodiscard]] float onGetPitch() override { return m_Inputs.m_Pitch; }
+	[[nodiscard]] float onGetRoll() override { return m_Inputs.m_Roll; }
+	[[nodiscard]] float onGetYaw() override { return m_Inputs.m_Yaw; }
+	[[nodiscard]] uint32_t onGetTimestamp() override { return m_Timestamp; }
+
+	/**
+	 * @brief Receive a frame.
+	 *
+	 * @param timestamp The arrival time of the frame.
+	 * @param pitch The pitch input. The other inputs follow it.
+	 */
+	void receive(uint32_t timestamp, float pitch)
+	{
+		m_Timestamp = timestamp;
+		m_Inputs.m_Thrust = 500.0f + pitch;
+		m_Inputs.m_Pitch = pitch;
+		m_Inputs.m_Roll = -pitch;
+		m_Inputs.m_Yaw = pitch * 0.5f;
+	}
+
+	Setpoint m_Inputs;
+	uint32_t m_Timestamp = 0;
+};
+
+static FakeDataLink s_DataLink;
+
+void setUp()
+{
+	// The input system is a singleton, so it's reset by losing the receiver (a timestamp of 0).
+	auto &inputSystem = InputSystem::Instance();
+	inputSystem.initialize(&s_DataLink);
+	inputSystem.setParameters(g_DefaultParameters);
+
+	s_DataLink.receive(0, 0.0f);
+	inputSystem.update();
+	(void)inputSystem.getSetpoint(0);
+}
+
+void tearDown()
+{
+}
+
+void test_first_frame_steps()
+{
+	auto &inputSystem = InputSystem::Instance();
+	s_DataLink.receive(100000, 10.0f);
+	inputSystem.update();
+
+	const auto setpoint = inputSystem.getSetpoint(100000);
+	TEST_ASSERT_EQUAL_FLOAT(510.0f, setpoint.m_Thrust);
+	TEST_ASSERT_EQUAL_FLOAT(10.0f, setpoint.m_Pitch);
+	TEST_ASSERT_EQUAL_FLOAT(-10.0f, setpoint.m_Roll);
+	TEST_ASSERT_EQUAL_FLOAT(5.0f, setpoint.m_Yaw);
+}
+
+#ifndef PEREGRINE_SETPOINT_PREDICTION
+void test_setpoint_is_interpolated_over_a_frame_period()
+{
+	auto &inputSystem = InputSystem::Instance();
+	s_DataLink.receive(100000, 0.0f);
+	inputSystem.update();
+	s_DataLink.receive(100000 + g_FramePeriod, 10.0f);
+	inputSystem.update();
+
+	const auto latest = 100000 + g_FramePeriod;
+	TEST_ASSERT_EQUAL_FLOAT(0.0f, inputSystem.getSetpoint(latest).m_Pitch);
+	TEST_ASSERT_FLOAT_WITHIN(1e-4f, 2.5f, inputSystem.getSetpoint(latest + (g_FramePeriod / 4)).m_Pitch);
+	TEST_ASSERT_FLOAT_WITHIN(1e-4f, -5.0f, inputSystem.getSetpoint(latest + (g_FramePeriod / 2)).m_Roll);
+	TEST_ASSERT_FLOAT_WITHIN(1e-4f, 505.0f, inputSystem.getSetpoint(latest + (g_FramePeriod / 2)).m_Thrust);
+	TEST_ASSERT_EQUAL_FLOAT(10.0f, inputSystem.getSetpoint(latest + g_FramePeriod).m_Pitch);
+
+	// The setpoint holds when the next frame is late.
+	TEST_ASSERT_EQUAL_FLOAT(10.0f, inputSystem.getSetpoint(latest + (g_FramePeriod * 2)).m_Pitch);
+}
+
+void test_interpolation_across_the_clock_wrap()
+{
+	auto &inputSystem = InputSystem::Instance();
+	const auto first = UINT32_MAX - (g_FramePeriod / 2);
+	s_DataLink.receive(first, 0.0f);
+	inputSystem.update();
+	s_DataLink.receive(first + g_FramePeriod, 20.0f);
+	inputSystem.update();
+
+	TEST_ASSERT_FLOAT_WITHIN(1e-3f, 10.0f, inputSystem.getSetpoint(first + g_FramePeriod + (g_FramePeriod / 2)).m_Pitch);
+}
+
+#else
+void test_setpoint_is_predicted_over_a_frame_period()
+{
+	auto &inputSystem = InputSystem::Instance();
+	s_DataLink.receive(100000, 0.0f);
+	inputSystem.update();
+	s_DataLink.receive(100000 + g_FramePeriod, 10.0f);
+	inputSystem.update();
+
+	const auto latest = 100000 + g_FramePeriod;
+	TEST_ASSERT_EQUAL_FLOAT(10.0f, inputSystem.getSetpoint(latest).m_Pitch);
+	TEST_ASSERT_FLOAT_WITHIN(1e-4f, 15.0f, inputSystem.getSetpoint(latest + (g_FramePeriod / 2)).m_Pitch);
+	TEST_ASSERT_EQUAL_FLOAT(20.0f, inputSystem.getSetpoint(latest + g_FramePeriod).m_Pitch);
+	TEST_ASSERT_EQUAL_FLOAT(20.0f, inputSystem.getSetpoint(latest + (g_FramePeriod * 2)).m_Pitch);
+}
+
+#endif
+
+void test_lost_frames_step()
+{
+	auto &inputSystem = InputSystem::Instance();
+	s_DataLink.receive(100000, 0.0f);
+	inputSystem.update();
+	s_DataLink.receive(100000 + g_MaximumInputFramePeriod + 1, 10.0f);
+	inputSystem.update();
+
+	TEST_ASSERT_EQUAL_FLOAT(10.0f, inputSystem.getSetpoint(100000 + g_MaximumInputFramePeriod + 1).m_Pitch);
+}
+
+void test_inputs_are_only_read_for_new_frames()
+{
+	auto &inputSystem = InputSystem::Instance();
+	s_DataLink.receive(100000, 10.0f);
+	inputSystem.update();
+
+	// The inputs changed without a new frame.
+	s_DataLink.m_Inputs.m_Pitch = 30.0f;
+	inputSystem.update();
+	TEST_ASSERT_EQUAL_FLOAT(10.0f, inputSystem.getSetpoint(101000).m_Pitch);
+}
+
+void test_unchanged_flag()
+{
+	auto &inputSystem = InputSystem::Instance();
+	s_DataLink.receive(100000, 0.0f);
+	inputSystem.update();
+	s_DataLink.receive(100000 + g_FramePeriod, 10.0f);
+	inputSystem.update();
+
+	(void)inputSystem.getSetpoint(100000 + g_FramePeriod + 1000);
+	TEST_ASSERT_FALSE(inputSystem.isSetpointUnchanged());
+	(void)inputSystem.getSetpoint(100000 + g_FramePeriod + 1000);
+	TEST_ASSERT_TRUE(inputSystem.isSetpointUnchanged());
+
+	(void)inputSystem.getSetpoint(100000 + g_FramePeriod + 2000);
+	TEST_ASSERT_FALSE(inputSystem.isSetpointUnchanged());
+
+	// Once the setpoint reached the latest inputs, it doesn't change until the next frame.
+	(void)inputSystem.getSetpoint(100000 + (g_FramePeriod * 3));
+	(void)inputSystem.getSetpoint(100000 + (g_FramePeriod * 3) + 1000);
+	TEST_ASSERT_TRUE(inputSystem.isSetpointUnchanged());
+}
+
+void test_receiver_lost_steps_to_the_inputs()
+{
+	auto &inputSystem = InputSystem::Instance();
+	s_DataLink.receive(100000, 0.0f);
+	inputSystem.update();
+	s_DataLink.receive(100000 + g_FramePeriod, 10.0f);
+	inputSystem.update();
+
+	s_DataLink.receive(0, 0.0f);
+	inputSystem.update();
+	TEST_ASSERT_EQUAL_FLOAT(0.0f, inputSystem.getSetpoint(100000 + g_FramePeriod + 1000).m_Pitch);
+	TEST_ASSERT_EQUAL_FLOAT(500.0f, inputSystem.getSetpoint(100000 + g_FramePeriod + 1000).m_Thrust);
+}
+
+void test_input_ranges_scale_the_inputs()
+{
+	auto parameters = g_DefaultParameters;
+	parameters.m_PitchInputRange = g_PitchInputMaximum / 2;
+	parameters.m_RollInputRange = g_RollInputMaximum * 2;
+
+	auto &inputSystem = InputSystem::Instance();
+	inputSystem.setParameters(parameters);
+	s_DataLink.receive(100000, 10.0f);
+	inputSystem.update();
+
+	const auto setpoint = inputSystem.getSetpoint(100000);
+	TEST_ASSERT_EQUAL_FLOAT(510.0f, setpoint.m_Thrust);
+	TEST_ASSERT_EQUAL_FLOAT(10.0f * parameters.m_PitchInputRange / g_PitchInputMaximum, setpoint.m_Pitch);
+	TEST_ASSERT_EQUAL_FLOAT(-20.0f, setpoint.m_Roll);
+	TEST_ASSERT_EQUAL_FLOAT(5.0f, setpoint.m_Yaw);
+}
+
+int main()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_first_frame_steps);
+
+#ifndef PEREGRINE_SETPOINT_PREDICTION
+	RUN_TEST(test_setpoint_is_interpolated_over_a_frame_period);
+	RUN_TEST(test_interpolation_across_the_clock_wrap);
+
+#else
+	RUN_TEST(test_setpoint_is_predicted_over_a_frame_period);
+
+#endif
+
+	RUN_TEST(test_lost_frames_step);
+	RUN_TEST(test_inputs_are_only_read_for_new_frames);
+	RUN_TEST(test_unchanged_flag);
+	RUN_TEST(test_receiver_lost_steps_to_the_inputs);
+	RUN_TEST(test_input_ranges_scale_the_inputs);
+	return UNITY_END();
+}
@@ -0,0 +1,204 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#include "algorithms/MahonyFilter.hpp"
+#include "core/Constants.hpp"
+#include "core/FastMath.hpp"
+
+#include <math.h>
+#include <unity.h>
+
+// The sample rate of the tests (the sensor's sample rate).
+constexpr auto g_TestSampleRate = 1000;
+constexpr auto g_TestDelta = 1.0f / g_TestSampleRate;
+
+/**
+ * @brief Get the specific force measured by a resting sensor.
+ * This is gravity (up) in the sensor frame: X to the right wing, Y to the front and Z up.
+ *
+ * @param pitch The pitch angle in degrees (nose up).
+ * @param roll The roll angle in degrees (right wing down).
+ * @return The specific force in meters per square second.
+ */
+static Vec3 GetGravity(float pitch, float roll)
+{
+	const auto pitchRadians = pitch * g_DegreesToRadians;
+	const auto rollRadians = roll * g_DegreesToRadians;
+	return Vec3(-g_StandardGravity * cosf(pitchRadians) * sinf(rollRadians), g_StandardGravity * sinf(pitchRadians),
+				g_StandardGravity * cosf(pitchRadians) * cosf(rollRadians));
+}
+
+/**
+ * @brief Get the rates of a sample.
+ *
+ * @param pitch The pitch rate in degrees per second.
+ * @param yaw The yaw rate in degrees per second.
+ * @param roll The roll rate in degrees per second.
+ * @return The rates (pitch, yaw and roll).
+ */
+static Vec3 GetRates(float pitch, float yaw, float roll)
+{
+	Vec3 rates;
+	rates.m_Pitch = pitch;
+	rates.m_Yaw = yaw;
+	rates.m_Roll = roll;
+	return rates;
+}
+
+/**
+ * @brief Update the filter with the same sample for a while.
+ *
+ * @param filter The filter.
+ * @param acceleration The specific force.
+ * @param rates The rates.
+ * @param duration The duration in seconds.
+ */
+static void Run(MahonyFilter &filter, Vec3 acceleration, Vec3 rates, float duration)
+{
+	const auto samples = static_cast<int>(duration * g_TestSampleRate);
+	for (auto i = 0; i < samples; i++)
+		filter.update(acceleration, rates, g_TestDelta);
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_first_sample_aligns_with_gravity()
+{
+	MahonyFilter filter;
+	filter.update(GetGravity(20.0f, -10.0f), Vec3(), g_TestDelta);
+
+	const auto angles = filter.getEulerAngles();
+	TEST_ASSERT_FLOAT_WITHIN(0.01f, 20.0f, angles.m_Pitch);
+	TEST_ASSERT_FLOAT_WITHIN(0.01f, -10.0f, angles.m_Roll);
+	TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, angles.m_Yaw);
+}
+
+void test_converges_to_a_tilted_gravity_vector()
+{
+	// Without the integral, which would learn a bias from the initial error, the error decays with a single time constant of about 1/Kp
+	// seconds. So it's less than 0.1% after 7 time constants.
+	MahonyFilter filter;
+	filter.tune(g_MahonyProportionalGain, 0.0f);
+	filter.update(GetGravity(0.0f, 0.0f), Vec3(), g_TestDelta);
+
+	const auto gravity = GetGravity(20.0f, -10.0f);
+	Run(filter, gravity, Vec3(), 0.5f / g_MahonyProportionalGain);
+
+	const auto halfway = filter.getEulerAngles();
+	TEST_ASSERT_TRUE(halfway.m_Pitch > 5.0f && halfway.m_Pitch < 19.0f);
+	TEST_ASSERT_TRUE(halfway.m_Roll < -2.5f && halfway.m_Roll > -9.5f);
+
+	Run(filter, gravity, Vec3(), 6.5f / g_MahonyProportionalGain);
+
+	const auto angles = filter.getEulerAngles();
+	TEST_ASSERT_FLOAT_WITHIN(0.05f, 20.0f, angles.m_Pitch);
+	TEST_ASSERT_FLOAT_WITHIN(0.05f, -10.0f, angles.m_Roll);
+}
+
+void test_yaw_integrates_the_z_rate()
+{
+	MahonyFilter filter;
+	filter.update(GetGravity(0.0f, 0.0f), Vec3(), g_TestDelta);
+
+	// A positive yaw rate turns the nose right, and the accelerometer can't correct the yaw.
+	Run(filter, GetGravity(0.0f, 0.0f), GetRates(0.0f, 30.0f, 0.0f), 2.0f);
+
+	auto angles = filter.getEulerAngles();
+	TEST_ASSERT_FLOAT_WITHIN(0.1f, 60.0f, angles.m_Yaw);
+	TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, angles.m_Pitch);
+	TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, angles.m_Roll);
+
+	// The yaw wraps around at 180 degrees.
+	Run(filter, GetGravity(0.0f, 0.0f), GetRates(0.0f, -30.0f, 0.0f), 10.0f);
+
+	angles = filter.getEulerAngles();
+	TEST_ASSERT_FLOAT_WITHIN(0.5f, 120.0f, angles.m_Yaw);
+}
+
+void test_pitch_sweep_to_90_degrees_has_no_jumps()
+{
+	MahonyFilter filter;
+	filter.update(GetGravity(0.0f, 0.0f), Vec3(), g_TestDelta);
+
+	// Pitch up to the vertical and back at 45 degrees per second, with the accelerometer following the attitude.
+	constexpr auto rate = 45.0f;
+	constexpr auto samples = 2 * g_TestSampleRate;
+
+	auto pitch = 0.0f;
+	auto previousPitch = 0.0f;
+	for (auto i = 0; i < 2 * samples; i++)
+	{
+		const auto direction = i < samples ? 1.0f : -1.0f;
+		pitch += direction * rate * g_TestDelta;
+		filter.update(GetGravity(pitch, 0.0f), GetRates(direction * rate, 0.0f, 0.0f), g_TestDelta);
+
+		const auto angles = filter.getEulerAngles();
+		TEST_ASSERT_FLOAT_WITHIN(0.5f, pitch, angles.m_Pitch);
+		TEST_ASSERT_FLOAT_WITHIN(0.5f, rate * g_TestDelta, fabsf(angles.m_Pitch - previousPitch));
+		previousPitch = angles.m_Pitch;
+	}
+
+	// The roll and the yaw are undefined at the vertical, but come back once the nose is lowered.
+	const auto angles = filter.getEulerAngles();
+	TEST_ASSERT_FLOAT_WITHIN(0.5f, 0.0f, angles.m_Pitch);
+	TEST_ASSERT_FLOAT_WITHIN(0.5f, 0.0f, angles.m_Roll);
+	TEST_ASSERT_FLOAT_WITHIN(0.5f, 0.0f, angles.m_Yaw);
+}
+
+void test_gyroscope_bias_is_rejected()
+{
+	// Without the integral, a constant bias leaves a constant error of bias/Kp.
+	constexpr auto pitchBias = 1.0f;
+	constexpr auto rollBias = -0.5f;
+
+	MahonyFilter proportional;
+	proportional.tune(g_MahonyProportionalGain, 0.0f);
+	proportional.update(GetGravity(0.0f, 0.0f), Vec3(), g_TestDelta);
+	Run(proportional, GetGravity(0.0f, 0.0f), GetRates(pitchBias, 0.0f, rollBias), 300.0f);
+
+	const auto biased = proportional.getEulerAngles();
+	TEST_ASSERT_FLOAT_WITHIN(0.05f, pitchBias / g_MahonyProportionalGain, biased.m_Pitch);
+	TEST_ASSERT_FLOAT_WITHIN(0.05f, rollBias / g_MahonyProportionalGain, biased.m_Roll);
+
+	// The integral learns the bias, so the error goes away.
+	MahonyFilter filter;
+	filter.update(GetGravity(0.0f, 0.0f), Vec3(), g_TestDelta);
+	Run(filter, GetGravity(0.0f, 0.0f), GetRates(pitchBias, 0.0f, rollBias), 300.0f);
+
+	const auto angles = filter.getEulerAngles();
+	TEST_ASSERT_FLOAT_WITHIN(0.02f, 0.0f, angles.m_Pitch);
+	TEST_ASSERT_FLOAT_WITHIN(0.02f, 0.0f, angles.m_Roll);
+}
+
+void test_acceleration_outside_the_tolerance_is_ignored()
+{
+	MahonyFilter filter;
+	filter.update(GetGravity(0.0f, 0.0f), Vec3(), g_TestDelta);
+
+	// A strong forward acceleration (like during the transition) would tilt the estimate nose up.
+	auto acceleration = GetGravity(0.0f, 0.0f);
+	acceleration.m_Y = g_StandardGravity;
+	Run(filter, acceleration, Vec3(), 2.0f);
+
+	const auto angles = filter.getEulerAngles();
+	TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, angles.m_Pitch);
+	TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, angles.m_Roll);
+}
+
+int main()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_first_sample_aligns_with_gravity);
+	RUN_TEST(test_converges_to_a_tilted_gravity_vector);
+	RUN_TEST(test_yaw_integrates_the_z_rate);
+	RUN_TEST(test_pitch_sweep_to_90_degrees_has_no_jumps);
+	RUN_TEST(test_gyroscope_bias_is_rejected);
+	RUN_TEST(test_acceleration_outside_the_tolerance_is_ignored);
+	return UNITY_END();
+}
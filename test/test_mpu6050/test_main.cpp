@@ -0,0 +1,504 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#include "components/MPU6050.hpp"
+#include "core/Configuration.hpp"
+#include "core/Constants.hpp"
+
+#include <deque>
+#include <unity.h>
+#include <vector>
+
+/**
+ * @brief Fake I2C bus class.
+ * This acts as an MPU6050 with a register file and a FIFO. The register writes are logged, and the reads can be made to fail.
+ */
+class FakeI2CBus final : public II2CBus
+{
+public:
+	/**
+	 * @brief Register write structure.
+	 */
+	struct RegisterWrite final
+	{
+		uint8_t m_Register = 0;
+		uint8_t m_Value = 0;
+	};
+
+	/**
+	 * @brief Construct a new Fake I2C Bus object.
+	 */
+	FakeI2CBus() { m_Registers[static_cast<uint8_t>(MPU6050Register::WhoAmI)] = g_MPU6050Identity; }
+
+	/**
+	 * @brief On write register method.
+	 * Log the write and store the value in the register file.
+	 */
+	bool onWriteRegister(uint8_t address, uint8_t reg, uint8_t value) override
+	{
+		if (address != g_MPU6050Address)
+			return false;
+
+		m_Writes.push_back(RegisterWrite{reg, value});
+		m_Registers[reg] = value;
+
+		if (reg == static_cast<uint8_t>(MPU6050Register::UserControl) && (value & g_MPU6050UserControlFIFOReset))
+			m_FIFO.clear();
+
+		return true;
+	}
+
+	/**
+	 * @brief On read registers method.
+	 * The FIFO count and the FIFO data registers read from the FIFO, the others from the register file.
+	 */
+	bool onReadRegisters(uint8_t address, uint8_t reg, uint8_t *pData, size_t size) override
+	{
+		if (address != g_MPU6050Address || m_isFailing)
+			return false;
+
+		if (reg == static_cast<uint8_t>(MPU6050Register::FIFOCount))
+		{
+			m_FIFOCountReads++;
+			const auto count = m_FIFOCount != 0 ? m_FIFOCount : m_FIFO.size();
+			pData[0] = static_cast<uint8_t>(count >> 8);
+			pData[1] = static_cast<uint8_t>(count);
+			return true;
+		}
+
+		if (reg == static_cast<uint8_t>(MPU6050Register::FIFOReadWrite))
+		{
+			for (size_t i = 0; i < size; i++)
+			{
+				pData[i] = m_FIFO.empty() ? 0 : m_FIFO.front();
+				if (!m_FIFO.empty())
+					m_FIFO.pop_front();
+			}
+
+			return true;
+		}
+
+		for (size_t i = 0; i < size; i++)
+			pData[i] = m_Registers[(reg + i) & 0x7F];
+
+		return true;
+	}
+
+	/**
+	 * @brief Push a record to the FIFO, like the sensor does every sample.
+	 *
+	 * @param sample The raw sample.
+	 */
+	void pushRecord(const RawIMUSample &sample)
+	{
+		for (const auto value : sample.m_Accelerometer)
+			pushWord(value);
+
+		for (const auto value : sample.m_Gyroscope)
+			pushWord(value);
+	}
+
+	/**
+	 * @brief Push a big-endian word to the FIFO.
+	 *
+	 * @param value The value.
+	 */
+	void pushWord(int16_t value)
+	{
+		m_FIFO.push_back(static_cast<uint8_t>(static_cast<uint16_t>(value) >> 8));
+		m_FIFO.push_back(static_cast<uint8_t>(value));
+	}
+
+	/**
+	 * @brief Set a big-endian register pair.
+	 *
+	 * @param reg The register of the high byte.
+	 * @param value The value.
+	 */
+	void setWord(MPU6050Register reg, int16_t value)
+	{
+		m_Registers[static_cast<uint8_t>(reg)] = static_cast<uint8_t>(static_cast<uint16_t>(value) >> 8);
+		m_Registers[static_cast<uint8_t>(reg) + 1] = static_cast<uint8_t>(value);
+	}
+
+	/**
+	 * @brief Count the writes of a value to a register.
+	 *
+	 * @param reg The register.
+	 * @param value The value.
+	 * @return The number of writes.
+	 */
+	[[nodiscard]] size_t countWrites(MPU6050Register reg, uint8_t value) const
+	{
+		size_t count = 0;
+		for (const auto &write : m_Writes)
+			count += write.m_Register == static_cast<uint8_t>(reg) && write.m_Value == value ? 1 : 0;
+
+		return count;
+	}
+
+	/**
+	 * @brief Get a register of the register file.
+	 *
+	 * @param reg The register.
+	 * @return The value.
+	 */
+	[[nodiscard]] uint8_t getRegister(MPU6050Register reg) const { return m_Registers[static_cast<uint8_t>(reg)]; }
+
+	std::vector<RegisterWrite> m_Writes;
+	std::deque<uint8_t> m_FIFO;
+
+	// When this is not 0, it's reported as the FIFO count instead of the size of the FIFO.
+	size_t m_FIFOCount = 0;
+	uint32_t m_FIFOCountReads = 0;
+
+	bool m_isFailing = false;
+
+private:
+	uint8_t m_Registers[128] = {};
+};
+
+/**
+ * @brief Create a raw sample with distinct values on every axis.
+ *
+ * @param index The sample index.
+ * @return The raw sample.
+ */
+static RawIMUSample CreateSample(int16_t index)
+{
+	RawIMUSample sample;
+	for (int16_t i = 0; i < 3; i++)
+	{
+		sample.m_Accelerometer[i] = static_cast<int16_t>((index * 100) + i - 4096);
+		sample.m_Gyroscope[i] = static_cast<int16_t>(-(index * 10) - i);
+	}
+
+	return sample;
+}
+
+static FakeI2CBus *s_pBus = nullptr;
+static MPU6050 *s_pSensor = nullptr;
+
+void setUp()
+{
+	s_pBus = new FakeI2CBus();
+	s_pSensor = new MPU6050();
+	s_pSensor->initialize(s_pBus);
+}
+
+void tearDown()
+{
+	delete s_pSensor;
+	delete s_pBus;
+}
+
+void test_words_are_big_endian()
+{
+	const uint8_t words[] = {0xFF, 0xFE, 0x12, 0x34, 0x80, 0x00};
+	TEST_ASSERT_EQUAL_INT16(-2, DecodeMPU6050Word(words));
+	TEST_ASSERT_EQUAL_INT16(0x1234, DecodeMPU6050Word(words + 2));
+	TEST_ASSERT_EQUAL_INT16(-32768, DecodeMPU6050Word(words + 4));
+}
+
+void test_burst_skips_the_temperature()
+{
+	const uint8_t burst[g_MPU6050BurstSize] = {0x00, 0x01, 0xFF, 0xFF, 0x10, 0x00, 0x0B, 0xB8, 0x80, 0x00, 0x7F, 0xFF, 0x00, 0x00};
+	int16_t temperature = 0;
+	const auto sample = DecodeMPU6050Burst(burst, &temperature);
+	TEST_ASSERT_EQUAL_INT16(1, sample.m_Accelerometer[0]);
+	TEST_ASSERT_EQUAL_INT16(-1, sample.m_Accelerometer[1]);
+	TEST_ASSERT_EQUAL_INT16(4096, sample.m_Accelerometer[2]);
+	TEST_ASSERT_EQUAL_INT16(3000, temperature);
+	TEST_ASSERT_EQUAL_INT16(-32768, sample.m_Gyroscope[0]);
+	TEST_ASSERT_EQUAL_INT16(32767, sample.m_Gyroscope[1]);
+	TEST_ASSERT_EQUAL_INT16(0, sample.m_Gyroscope[2]);
+
+	// The temperature is optional.
+	const auto withoutTemperature = DecodeMPU6050Burst(burst);
+	TEST_ASSERT_EQUAL_MEMORY(&sample, &withoutTemperature, sizeof(sample));
+}
+
+void test_fifo_records_are_parsed_in_order()
+{
+	const uint8_t data[(g_MPU6050FIFORecordSize * 2) + 2] = {
+		0x00, 0x01, 0x00, 0x02, 0x00, 0x03, 0xFF, 0xFF, 0xFF, 0xFE, 0xFF, 0xFD,
+		0x10, 0x00, 0x20, 0x00, 0x30, 0x00, 0x7F, 0xFF, 0x80, 0x00, 0x00, 0x00,
+		0x12, 0x34};
+
+	// A trailing partial record is not parsed.
+	RawIMUSample samples[3];
+	TEST_ASSERT_EQUAL(2, ParseMPU6050FIFO(data, sizeof(data), samples));
+
+	for (int16_t i = 0; i < 3; i++)
+	{
+		TEST_ASSERT_EQUAL_INT16(i + 1, samples[0].m_Accelerometer[i]);
+		TEST_ASSERT_EQUAL_INT16(-(i + 1), samples[0].m_Gyroscope[i]);
+		TEST_ASSERT_EQUAL_INT16((i + 1) * 0x1000, samples[1].m_Accelerometer[i]);
+	}
+
+	TEST_ASSERT_EQUAL_INT16(32767, samples[1].m_Gyroscope[0]);
+	TEST_ASSERT_EQUAL_INT16(-32768, samples[1].m_Gyroscope[1]);
+	TEST_ASSERT_EQUAL_INT16(0, samples[1].m_Gyroscope[2]);
+}
+
+void test_sensitivities_and_temperature()
+{
+	TEST_ASSERT_EQUAL_FLOAT(16384.0f, GetMPU6050AccelerometerSensitivity(MPU6050AccelerometerRange::Range2G));
+	TEST_ASSERT_EQUAL_FLOAT(4096.0f, GetMPU6050AccelerometerSensitivity(MPU6050AccelerometerRange::Range8G));
+	TEST_ASSERT_EQUAL_FLOAT(131.0f, GetMPU6050GyroscopeSensitivity(MPU6050GyroscopeRange::Range250Degrees));
+	TEST_ASSERT_EQUAL_FLOAT(65.5f, GetMPU6050GyroscopeSensitivity(MPU6050GyroscopeRange::Range500Degrees));
+
+	TEST_ASSERT_FLOAT_WITHIN(0.01f, 36.53f, ConvertMPU6050Temperature(0));
+	TEST_ASSERT_FLOAT_WITHIN(0.01f, 25.0f, ConvertMPU6050Temperature(-3920));
+}
+
+void test_initialize_configures_the_sensor()
+{
+	// The device is reset first, then woken up on the gyroscope's clock.
+	TEST_ASSERT_TRUE(s_pBus->m_Writes.size() > 2);
+	TEST_ASSERT_EQUAL_HEX8(static_cast<uint8_t>(MPU6050Register::PowerManagement1), s_pBus->m_Writes[0].m_Register);
+	TEST_ASSERT_EQUAL_HEX8(g_MPU6050DeviceReset, s_pBus->m_Writes[0].m_Value);
+	TEST_ASSERT_EQUAL_HEX8(g_MPU6050ClockPLLGyroscopeX, s_pBus->getRegister(MPU6050Register::PowerManagement1));
+
+	TEST_ASSERT_EQUAL_HEX8((1000 / g_SensorSampleRate) - 1, s_pBus->getRegister(MPU6050Register::SampleRateDivider));
+	TEST_ASSERT_EQUAL_HEX8(static_cast<uint8_t>(g_MPU6050FilterBandwidth), s_pBus->getRegister(MPU6050Register::Configuration));
+	TEST_ASSERT_EQUAL_HEX8(static_cast<uint8_t>(MPU6050AccelerometerRange::Range8G) << 3, s_pBus->getRegister(MPU6050Register::AccelerometerConfiguration));
+	TEST_ASSERT_EQUAL_HEX8(static_cast<uint8_t>(MPU6050GyroscopeRange::Range500Degrees) << 3, s_pBus->getRegister(MPU6050Register::GyroscopeConfiguration));
+	TEST_ASSERT_EQUAL_HEX8(g_MPU6050InterruptClearOnRead, s_pBus->getRegister(MPU6050Register::InterruptPinConfiguration));
+	TEST_ASSERT_EQUAL_HEX8(g_MPU6050InterruptDataReady, s_pBus->getRegister(MPU6050Register::InterruptEnable));
+
+#ifdef PEREGRINE_MPU6050_FIFO
+	TEST_ASSERT_EQUAL_HEX8(g_MPU6050FIFOAccelerometerAndGyroscope, s_pBus->getRegister(MPU6050Register::FIFOEnable));
+	TEST_ASSERT_EQUAL(1, s_pBus->countWrites(MPU6050Register::UserControl, g_MPU6050UserControlFIFOEnable | g_MPU6050UserControlFIFOReset));
+
+#endif
+}
+
+#ifdef PEREGRINE_DEBUG
+void test_initialize_stops_on_a_wrong_identity()
+{
+	FakeI2CBus bus;
+	bus.onWriteRegister(g_MPU6050Address, static_cast<uint8_t>(MPU6050Register::WhoAmI), 0x70);
+	bus.m_Writes.clear();
+
+	MPU6050 sensor;
+	sensor.initialize(&bus);
+	TEST_ASSERT_EQUAL(0, bus.countWrites(MPU6050Register::SampleRateDivider, 0));
+	TEST_ASSERT_EQUAL(0, bus.getRegister(MPU6050Register::InterruptEnable));
+}
+
+#endif
+
+void test_convert_sample_scales_to_the_ranges()
+{
+	RawIMUSample sample;
+	sample.m_Accelerometer[2] = 4096;
+	sample.m_Gyroscope[0] = 655;
+	sample.m_Gyroscope[1] = -131;
+
+	const auto converted = s_pSensor->convertSample(sample, 0.002f);
+	TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.0f, converted.m_Acceleration.m_X);
+	TEST_ASSERT_FLOAT_WITHIN(1e-4f, g_StandardGravity, converted.m_Acceleration.m_Z);
+	TEST_ASSERT_FLOAT_WITHIN(1e-4f, 10.0f, converted.m_Rate.m_X);
+	TEST_ASSERT_FLOAT_WITHIN(1e-4f, -2.0f, converted.m_Rate.m_Y);
+	TEST_ASSERT_FLOAT_WITHIN(1e-7f, 0.002f, converted.m_DeltaTime);
+}
+
+/**
+ * @brief Assert that a sample is the converted raw sample.
+ *
+ * @param expected The raw sample.
+ * @param sample The converted sample.
+ */
+static void AssertSample(const RawIMUSample &expected, const IMUSample &sample)
+{
+	const auto converted = s_pSensor->convertSample(expected, sample.m_DeltaTime);
+	TEST_ASSERT_EQUAL_MEMORY(&converted, &sample, sizeof(converted));
+}
+
+#ifdef PEREGRINE_MPU6050_FIFO
+void test_fifo_records_are_read_in_order()
+{
+	for (int16_t i = 0; i < 3; i++)
+		s_pBus->pushRecord(CreateSample(i));
+
+	IMUSample samples[16];
+	RawIMUSample rawSamples[16];
+	TEST_ASSERT_EQUAL(3, s_pSensor->readData(samples, 16, rawSamples));
+
+	for (int16_t i = 0; i < 3; i++)
+	{
+		const auto expected = CreateSample(i);
+		AssertSample(expected, samples[i]);
+		TEST_ASSERT_EQUAL_MEMORY(&expected, &rawSamples[i], sizeof(expected));
+		TEST_ASSERT_FLOAT_WITHIN(1e-4f, expected.m_Accelerometer[0] * g_StandardGravity / 4096.0f, samples[i].m_Acceleration.m_X);
+		TEST_ASSERT_FLOAT_WITHIN(1e-4f, expected.m_Gyroscope[2] / 65.5f, samples[i].m_Rate.m_Z);
+		TEST_ASSERT_FLOAT_WITHIN(1e-7f, 1.0f / g_SensorSampleRate, samples[i].m_DeltaTime);
+	}
+
+	TEST_ASSERT_EQUAL(0, s_pSensor->readData(samples, 16));
+}
+
+void test_fifo_reads_are_batched()
+{
+	for (int16_t i = 0; i < 25; i++)
+		s_pBus->pushRecord(CreateSample(i));
+
+	// The count is read once and the records are read in batches, limited by the capacity and the I2C buffer.
+	IMUSample samples[16];
+	TEST_ASSERT_EQUAL(4, s_pSensor->readData(samples, 4));
+	AssertSample(CreateSample(3), samples[3]);
+	TEST_ASSERT_EQUAL(g_MaxFIFORecordsPerRead, s_pSensor->readData(samples, 16));
+	AssertSample(CreateSample(4), samples[0]);
+	TEST_ASSERT_EQUAL(g_MaxFIFORecordsPerRead, s_pSensor->readData(samples, 16));
+	TEST_ASSERT_EQUAL(1, s_pSensor->readData(samples, 16));
+	AssertSample(CreateSample(24), samples[0]);
+	TEST_ASSERT_EQUAL_UINT32(1, s_pBus->m_FIFOCountReads);
+}
+
+void test_fifo_partial_record_is_left()
+{
+	s_pBus->pushRecord(CreateSample(1));
+	s_pBus->pushWord(1000);
+
+	IMUSample samples[4];
+	TEST_ASSERT_EQUAL(1, s_pSensor->readData(samples, 4));
+	TEST_ASSERT_EQUAL(2, s_pBus->m_FIFO.size());
+}
+
+void test_fifo_overflow_resets_the_fifo()
+{
+	for (int16_t i = 0; i < 4; i++)
+		s_pBus->pushRecord(CreateSample(i));
+
+	s_pBus->m_FIFOCount = g_MPU6050FIFOSize;
+
+	IMUSample samples[4];
+	TEST_ASSERT_EQUAL(0, s_pSensor->readData(samples, 4));
+	TEST_ASSERT_EQUAL_UINT32(1, s_pSensor->getFIFOOverflows());
+	TEST_ASSERT_EQUAL(2, s_pBus->countWrites(MPU6050Register::UserControl, g_MPU6050UserControlFIFOEnable | g_MPU6050UserControlFIFOReset));
+	TEST_ASSERT_TRUE(s_pBus->m_FIFO.empty());
+
+	// The next samples are read normally.
+	s_pBus->m_FIFOCount = 0;
+	s_pBus->pushRecord(CreateSample(7));
+	TEST_ASSERT_EQUAL(1, s_pSensor->readData(samples, 4));
+}
+
+void test_fifo_bus_failure_drops_the_pending_records()
+{
+	for (int16_t i = 0; i < 4; i++)
+		s_pBus->pushRecord(CreateSample(i));
+
+	IMUSample samples[4];
+	TEST_ASSERT_EQUAL(2, s_pSensor->readData(samples, 2));
+
+	s_pBus->m_isFailing = true;
+	TEST_ASSERT_EQUAL(0, s_pSensor->readData(samples, 2));
+
+	// The count is read again, and the records still in the FIFO are read.
+	s_pBus->m_isFailing = false;
+	TEST_ASSERT_EQUAL(2, s_pSensor->readData(samples, 4));
+	TEST_ASSERT_EQUAL_UINT32(2, s_pBus->m_FIFOCountReads);
+	AssertSample(CreateSample(2), samples[0]);
+}
+
+void test_fifo_temperature_is_read_at_the_decimated_rate()
+{
+	s_pBus->setWord(MPU6050Register::Temperature, -3920);
+
+	IMUSample samples[g_MaxFIFORecordsPerRead];
+	for (auto i = 0; i < g_TemperatureDecimation - g_MaxFIFORecordsPerRead; i += g_MaxFIFORecordsPerRead)
+	{
+		for (auto j = 0; j < g_MaxFIFORecordsPerRead; j++)
+			s_pBus->pushRecord(CreateSample(static_cast<int16_t>(j)));
+
+		TEST_ASSERT_EQUAL(g_MaxFIFORecordsPerRead, s_pSensor->readData(samples, g_MaxFIFORecordsPerRead));
+	}
+
+	// The temperature of the initialization is kept until enough samples were read.
+	TEST_ASSERT_FLOAT_WITHIN(0.01f, 36.53f, s_pSensor->getTemperature());
+
+	for (auto j = 0; j < g_MaxFIFORecordsPerRead; j++)
+		s_pBus->pushRecord(CreateSample(static_cast<int16_t>(j)));
+
+	TEST_ASSERT_EQUAL(g_MaxFIFORecordsPerRead, s_pSensor->readData(samples, g_MaxFIFORecordsPerRead));
+	TEST_ASSERT_FLOAT_WITHIN(0.01f, 25.0f, s_pSensor->getTemperature());
+}
+
+#else
+void test_burst_read_decodes_the_data_registers()
+{
+	const auto sample = CreateSample(5);
+	for (uint8_t i = 0; i < 3; i++)
+	{
+		s_pBus->setWord(static_cast<MPU6050Register>(static_cast<uint8_t>(MPU6050Register::AccelerometerX) + (i * 2)), sample.m_Accelerometer[i]);
+		s_pBus->setWord(static_cast<MPU6050Register>(static_cast<uint8_t>(MPU6050Register::GyroscopeX) + (i * 2)), sample.m_Gyroscope[i]);
+	}
+
+	IMUSample samples[1];
+	RawIMUSample rawSamples[1];
+	TEST_ASSERT_EQUAL(1, s_pSensor->readData(samples, 1, rawSamples));
+	AssertSample(sample, samples[0]);
+	TEST_ASSERT_EQUAL_MEMORY(&sample, &rawSamples[0], sizeof(sample));
+	TEST_ASSERT_EQUAL(0, s_pSensor->readData(samples, 0));
+}
+
+void test_burst_bus_failure_reads_nothing()
+{
+	s_pBus->m_isFailing = true;
+
+	IMUSample samples[1];
+	TEST_ASSERT_EQUAL(0, s_pSensor->readData(samples, 1));
+}
+
+void test_burst_temperature_is_converted_at_the_decimated_rate()
+{
+	s_pBus->setWord(MPU6050Register::Temperature, -3920);
+
+	IMUSample samples[1];
+	for (auto i = 0; i < g_TemperatureDecimation - 1; i++)
+		TEST_ASSERT_EQUAL(1, s_pSensor->readData(samples, 1));
+
+	// The temperature of the initialization is kept until enough samples were read.
+	TEST_ASSERT_FLOAT_WITHIN(0.01f, 36.53f, s_pSensor->getTemperature());
+
+	TEST_ASSERT_EQUAL(1, s_pSensor->readData(samples, 1));
+	TEST_ASSERT_FLOAT_WITHIN(0.01f, 25.0f, s_pSensor->getTemperature());
+}
+
+#endif
+
+int main()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_words_are_big_endian);
+	RUN_TEST(test_burst_skips_the_temperature);
+	RUN_TEST(test_fifo_records_are_parsed_in_order);
+	RUN_TEST(test_sensitivities_and_temperature);
+	RUN_TEST(test_initialize_configures_the_sensor);
+
+#ifdef PEREGRINE_DEBUG
+	RUN_TEST(test_initialize_stops_on_a_wrong_identity);
+
+#endif
+
+	RUN_TEST(test_convert_sample_scales_to_the_ranges);
+
+#ifdef PEREGRINE_MPU6050_FIFO
+	RUN_TEST(test_fifo_records_are_read_in_order);
+	RUN_TEST(test_fifo_reads_are_batched);
+	RUN_TEST(test_fifo_partial_record_is_left);
+	RUN_TEST(test_fifo_overflow_resets_the_fifo);
+	RUN_TEST(test_fifo_bus_failure_drops_the_pending_records);
+	RUN_TEST(test_fifo_temperature_is_read_at_the_decimated_rate);
+
+#else
+	RUN_TEST(test_burst_read_decodes_the_data_registers);
+	RUN_TEST(test_burst_bus_failure_reads_nothing);
+	RUN_TEST(test_burst_temperature_is_converted_at_the_decimated_rate);
+
+#endif
+
+	return UNITY_END();
+}
@@ -0,0 +1,286 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#include "algorithms/COBS.hpp"
+#include "algorithms/CRC.hpp"
+#include "algorithms/PacketCodec.hpp"
+
+#include <string.h>
+#include <unity.h>
+#include <vector>
+
+/**
+ * @brief Encode data using COBS, check that the frame has no zeros and decode it again.
+ *
+ * @param data The data to encode.
+ * @return The encoded size.
+ */
+static size_t CheckCOBSRoundTrip(const std::vector<uint8_t> &data)
+{
+	std::vector<uint8_t> encoded(GetCOBSEncodedSize(data.size()));
+	const auto encodedSize = EncodeCOBS(data.data(), data.size(), encoded.data());
+	TEST_ASSERT_TRUE(encodedSize <= encoded.size());
+
+	for (size_t i = 0; i < encodedSize; i++)
+		TEST_ASSERT_NOT_EQUAL(0, encoded[i]);
+
+	std::vector<uint8_t> decoded(encodedSize);
+	TEST_ASSERT_EQUAL(data.size(), DecodeCOBS(encoded.data(), encodedSize, decoded.data()));
+	if (!data.empty())
+		TEST_ASSERT_EQUAL_MEMORY(data.data(), decoded.data(), data.size());
+
+	return encodedSize;
+}
+
+/**
+ * @brief Feed bytes to a packet decoder.
+ *
+ * @param decoder The decoder.
+ * @param pData The bytes.
+ * @param size The number of bytes.
+ * @return The number of valid packets which were decoded.
+ */
+static uint32_t Decode(PacketDecoder &decoder, const uint8_t *pData, size_t size)
+{
+	uint32_t packets = 0;
+	for (size_t i = 0; i < size; i++)
+		packets += decoder.decode(pData[i]) ? 1 : 0;
+
+	return packets;
+}
+
+/**
+ * @brief Encode a test packet.
+ *
+ * @param sequence The sequence number.
+ * @param pOutput The output buffer. It must be at least g_MaxEncodedPacketSize bytes.
+ * @return The encoded size.
+ */
+static size_t EncodeTestPacket(uint16_t sequence, uint8_t *pOutput)
+{
+	TelemetryHeader header;
+	header.m_ID = TelemetryMessageID::Attitude;
+	header.m_Sequence = sequence;
+	header.m_Timestamp = 123456;
+
+	AttitudeMessage message;
+	message.m_Pitch = 1.5f;
+	message.m_Roll = -2.5f;
+	return EncodePacket(header, &message, sizeof(message), pOutput);
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_cobs_reference_frames()
+{
+	// The examples of the reference (see COBS.hpp).
+	const std::vector<std::vector<uint8_t>> data = {{0x00}, {0x00, 0x00}, {0x11, 0x22, 0x00, 0x33}, {0x11, 0x22, 0x33, 0x44}, {0x11, 0x00, 0x00, 0x00}};
+	const std::vector<std::vector<uint8_t>> frames = {{0x01, 0x01}, {0x01, 0x01, 0x01}, {0x03, 0x11, 0x22, 0x02, 0x33}, {0x05, 0x11, 0x22, 0x33, 0x44}, {0x02, 0x11, 0x01, 0x01, 0x01}};
+
+	for (size_t i = 0; i < data.size(); i++)
+	{
+		uint8_t encoded[8];
+		TEST_ASSERT_EQUAL(frames[i].size(), EncodeCOBS(data[i].data(), data[i].size(), encoded));
+		TEST_ASSERT_EQUAL_MEMORY(frames[i].data(), encoded, frames[i].size());
+		CheckCOBSRoundTrip(data[i]);
+	}
+}
+
+void test_cobs_zero_heavy_data()
+{
+	// Every zero is replaced by a code byte, so the size only grows by one.
+	std::vector<uint8_t> zeros(300, 0);
+	TEST_ASSERT_EQUAL(zeros.size() + 1, CheckCOBSRoundTrip(zeros));
+
+	std::vector<uint8_t> alternating(301);
+	for (size_t i = 0; i < alternating.size(); i++)
+		alternating[i] = (i % 2) ? static_cast<uint8_t>(i) : 0;
+
+	TEST_ASSERT_EQUAL(alternating.size() + 1, CheckCOBSRoundTrip(alternating));
+}
+
+void test_cobs_maximum_length_blocks()
+{
+	// Data without zeros needs a code byte for every 254 bytes, which is the maximum overhead.
+	for (const size_t size : {253u, 254u, 255u, 508u, 1000u})
+	{
+		std::vector<uint8_t> data(size);
+		for (size_t i = 0; i < size; i++)
+			data[i] = static_cast<uint8_t>((i % 255) + 1);
+
+		TEST_ASSERT_EQUAL(GetCOBSEncodedSize(size), CheckCOBSRoundTrip(data));
+
+		// A zero right after a full block.
+		data.push_back(0);
+		CheckCOBSRoundTrip(data);
+	}
+}
+
+void test_cobs_malformed_frames_are_rejected()
+{
+	uint8_t decoded[8];
+
+	// A zero is never part of a frame, and a block must not end after the frame.
+	const uint8_t zero[] = {0x03, 0x11, 0x00, 0x33};
+	TEST_ASSERT_EQUAL(0, DecodeCOBS(zero, sizeof(zero), decoded));
+
+	const uint8_t truncated[] = {0x05, 0x11, 0x22};
+	TEST_ASSERT_EQUAL(0, DecodeCOBS(truncated, sizeof(truncated), decoded));
+}
+
+void test_crc_check_value()
+{
+	// The check value of CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF).
+	const auto *pCheck = reinterpret_cast<const uint8_t *>("123456789");
+	TEST_ASSERT_EQUAL_HEX16(0x29B1, ComputeCRC16(pCheck, 9));
+	TEST_ASSERT_EQUAL_HEX16(0xFFFF, ComputeCRC16(pCheck, 0));
+
+	// The CRC can be computed in pieces.
+	TEST_ASSERT_EQUAL_HEX16(0x29B1, ComputeCRC16(pCheck + 4, 5, ComputeCRC16(pCheck, 4)));
+}
+
+void test_crc_detects_single_bit_errors()
+{
+	uint8_t data[32];
+	for (size_t i = 0; i < sizeof(data); i++)
+		data[i] = static_cast<uint8_t>(i * 37);
+
+	const auto crc = ComputeCRC16(data, sizeof(data));
+	for (size_t bit = 0; bit < sizeof(data) * 8; bit++)
+	{
+		data[bit / 8] ^= static_cast<uint8_t>(1 << (bit % 8));
+		TEST_ASSERT_NOT_EQUAL(crc, ComputeCRC16(data, sizeof(data)));
+		data[bit / 8] ^= static_cast<uint8_t>(1 << (bit % 8));
+	}
+}
+
+void test_packet_round_trip()
+{
+	uint8_t encoded[g_MaxEncodedPacketSize];
+	const auto size = EncodeTestPacket(7, encoded);
+	TEST_ASSERT_EQUAL_UINT8(0, encoded[0]);
+	TEST_ASSERT_EQUAL_UINT8(0, encoded[size - 1]);
+
+	// The packet is complete on the trailing delimiter.
+	PacketDecoder decoder;
+	TEST_ASSERT_EQUAL_UINT32(0, Decode(decoder, encoded, size - 1));
+	TEST_ASSERT_TRUE(decoder.decode(encoded[size - 1]));
+
+	TEST_ASSERT_TRUE(decoder.getHeader().m_ID == TelemetryMessageID::Attitude);
+	TEST_ASSERT_EQUAL_UINT16(7, decoder.getHeader().m_Sequence);
+	TEST_ASSERT_EQUAL_UINT32(123456, decoder.getHeader().m_Timestamp);
+	TEST_ASSERT_EQUAL(sizeof(AttitudeMessage), decoder.getMessageSize());
+
+	AttitudeMessage message;
+	memcpy(&message, decoder.getMessage(), sizeof(message));
+	TEST_ASSERT_EQUAL_FLOAT(1.5f, message.m_Pitch);
+	TEST_ASSERT_EQUAL_FLOAT(-2.5f, message.m_Roll);
+	TEST_ASSERT_EQUAL_UINT32(0, decoder.getErrors());
+}
+
+void test_decoder_rejects_invalid_checksums()
+{
+	PacketDecoder decoder;
+	uint8_t encoded[g_MaxEncodedPacketSize];
+	const auto size = EncodeTestPacket(1, encoded);
+
+	// Every single bit error in between the delimiters is rejected. It either breaks the COBS code or the checksum.
+	uint32_t errors = 0;
+	for (size_t bit = 8; bit < (size - 1) * 8; bit++)
+	{
+		const auto mask = static_cast<uint8_t>(1 << (bit % 8));
+		if (encoded[bit / 8] == mask)
+			continue;
+
+		encoded[bit / 8] ^= mask;
+		TEST_ASSERT_EQUAL_UINT32(0, Decode(decoder, encoded, size));
+		encoded[bit / 8] ^= mask;
+		TEST_ASSERT_EQUAL_UINT32(++errors, decoder.getErrors());
+	}
+
+	TEST_ASSERT_EQUAL_UINT32(1, Decode(decoder, encoded, size));
+	TEST_ASSERT_EQUAL_UINT32(errors, decoder.getErrors());
+}
+
+void test_decoder_rejects_other_versions()
+{
+	TelemetryHeader header;
+	header.m_Version = g_TelemetryVersion + 1;
+
+	AttitudeMessage message;
+	uint8_t encoded[g_MaxEncodedPacketSize];
+	const auto size = EncodePacket(header, &message, sizeof(message), encoded);
+
+	PacketDecoder decoder;
+	TEST_ASSERT_EQUAL_UINT32(0, Decode(decoder, encoded, size));
+	TEST_ASSERT_EQUAL_UINT32(1, decoder.getErrors());
+}
+
+void test_decoder_rejects_oversize_frames()
+{
+	// A frame with a valid checksum which is longer than g_MaxPacketSize.
+	uint8_t frame[g_MaxPacketSize + 16] = {};
+	TelemetryHeader header;
+	memcpy(frame, &header, sizeof(header));
+	for (size_t i = sizeof(header); i < sizeof(frame) - 2; i++)
+		frame[i] = static_cast<uint8_t>(i);
+
+	const auto crc = ComputeCRC16(frame, sizeof(frame) - 2);
+	memcpy(frame + sizeof(frame) - 2, &crc, 2);
+
+	uint8_t encoded[GetCOBSEncodedSize(sizeof(frame)) + 2] = {};
+	const auto size = EncodeCOBS(frame, sizeof(frame), encoded + 1) + 2;
+
+	PacketDecoder decoder;
+	TEST_ASSERT_EQUAL_UINT32(0, Decode(decoder, encoded, size));
+	TEST_ASSERT_EQUAL_UINT32(1, decoder.getErrors());
+
+	// The decoder is ready for the next frame.
+	uint8_t packet[g_MaxEncodedPacketSize];
+	TEST_ASSERT_EQUAL_UINT32(1, Decode(decoder, packet, EncodeTestPacket(2, packet)));
+	TEST_ASSERT_EQUAL_UINT32(1, decoder.getErrors());
+}
+
+void test_decoder_resynchronizes_after_text()
+{
+	// Text (like a log line) and a frame which was cut short, right before a frame.
+	const char text[] = "Initializing the packet data link.\r\n";
+	uint8_t packet[g_MaxEncodedPacketSize];
+	const auto size = EncodeTestPacket(3, packet);
+
+	std::vector<uint8_t> stream(text, text + sizeof(text) - 1);
+	stream.insert(stream.end(), packet + 1, packet + (size / 2));
+	stream.insert(stream.end(), packet, packet + size);
+	stream.insert(stream.end(), text, text + sizeof(text) - 1);
+	stream.insert(stream.end(), packet, packet + size);
+
+	PacketDecoder decoder;
+	TEST_ASSERT_EQUAL_UINT32(2, Decode(decoder, stream.data(), stream.size()));
+	TEST_ASSERT_EQUAL_UINT16(3, decoder.getHeader().m_Sequence);
+
+	// The text and the cut frame end on the leading delimiter of the frames, and are dropped.
+	TEST_ASSERT_EQUAL_UINT32(2, decoder.getErrors());
+}
+
+int main()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_cobs_reference_frames);
+	RUN_TEST(test_cobs_zero_heavy_data);
+	RUN_TEST(test_cobs_maximum_length_blocks);
+	RUN_TEST(test_cobs_malformed_frames_are_rejected);
+	RUN_TEST(test_crc_check_value);
+	RUN_TEST(test_crc_detects_single_bit_errors);
+	RUN_TEST(test_packet_round_trip);
+	RUN_TEST(test_decoder_rejects_invalid_checksums);
+	RUN_TEST(test_decoder_rejects_other_versions);
+	RUN_TEST(test_decoder_rejects_oversize_frames);
+	RUN_TEST(test_decoder_resynchronizes_after_text);
+	return UNITY_END();
+}
@@ -0,0 +1,231 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#include "components/PacketDataLink.hpp"
+#include "core/Constants.hpp"
+#include "core/GlobalState.hpp"
+#include "sim/GroundStation.hpp"
+#include "sim/HostPlatform.hpp"
+#include "sim/LoopbackTransport.hpp"
+
+#include <Arduino.h>
+
+#include <unity.h>
+
+// The step of the simulated time in the round trip test (microseconds).
+constexpr uint32_t g_TestStep = 100;
+
+/**
+ * @brief Send a control message to the data link, like the ground station does when nothing is lost on the way.
+ *
+ * @param transport The data link's transport.
+ * @param message The message.
+ * @param sequence The sequence number.
+ * @param timestamp The ground station time in microseconds.
+ * @param damagedByte The index of the encoded byte to damage, or 0 to send the frame intact.
+ */
+static void SendControl(LoopbackTransport &transport, const ControlMessage &message, uint16_t sequence, uint32_t timestamp,
+						size_t damagedByte = 0)
+{
+	TelemetryHeader header;
+	header.m_ID = TelemetryMessageID::Control;
+	header.m_Sequence = sequence;
+	header.m_Timestamp = timestamp;
+
+	uint8_t encoded[g_MaxEncodedPacketSize];
+	const auto size = EncodePacket(header, &message, sizeof(message), encoded);
+	if (damagedByte != 0)
+		encoded[damagedByte] ^= 0x10;
+
+	transport.inject(encoded, size);
+}
+
+/**
+ * @brief Get a control message with a pitch input.
+ *
+ * @param pitch The pitch input (-1 to 1).
+ * @return The message.
+ */
+static ControlMessage GetControl(float pitch)
+{
+	ControlMessage message;
+	message.m_Thrust = 0.5f;
+	message.m_Pitch = pitch;
+	return message;
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+	g_RequiredFlyMode = FlyMode::Hover;
+	g_CurrentFlyMode = FlyMode::Hover;
+	g_ControlMode = ControlMode::Angle;
+}
+
+void test_setpoints_and_modes_are_decoded()
+{
+	LoopbackTransport transport;
+	PacketDataLink link(&transport);
+	link.onInitialize();
+
+	ControlMessage message;
+	message.m_Thrust = 1.0f;
+	message.m_Pitch = 0.5f;
+	message.m_Roll = -1.0f;
+	message.m_Yaw = 2.0f;
+	message.m_FlyMode = static_cast<uint8_t>(FlyMode::Cruise);
+	message.m_ControlMode = static_cast<uint8_t>(ControlMode::Rate);
+	message.m_Channels[3] = 1234;
+
+	AdvanceHostTime(1000);
+	SendControl(transport, message, 0, 500);
+	link.onUpdate();
+
+	TEST_ASSERT_EQUAL_FLOAT(g_ThrottleInputMaximum, link.onGetThrust());
+	TEST_ASSERT_EQUAL_FLOAT(g_PitchInputMaximum / 2.0f, link.onGetPitch());
+	TEST_ASSERT_EQUAL_FLOAT(g_RollInputMinimum, link.onGetRoll());
+	TEST_ASSERT_EQUAL_FLOAT(g_YawInputMaximum, link.onGetYaw());
+	TEST_ASSERT_EQUAL_UINT16(1234, link.getChannel(3));
+	TEST_ASSERT_EQUAL_UINT32(micros(), link.onGetTimestamp());
+	TEST_ASSERT_TRUE(g_RequiredFlyMode == FlyMode::Cruise);
+	TEST_ASSERT_TRUE(g_ControlMode == ControlMode::Rate);
+
+	// The ground station was lost, so the setpoints and the modes fall back to their defaults.
+	AdvanceHostTime(g_PacketLinkTimeout);
+	link.onUpdate();
+
+	TEST_ASSERT_EQUAL_FLOAT(g_ThrottleInputMinimum, link.onGetThrust());
+	TEST_ASSERT_EQUAL_FLOAT(g_PitchInputMiddle, link.onGetPitch());
+	TEST_ASSERT_EQUAL_UINT32(0, link.onGetTimestamp());
+	TEST_ASSERT_TRUE(g_RequiredFlyMode == FlyMode::Hover);
+	TEST_ASSERT_TRUE(g_ControlMode == ControlMode::Angle);
+}
+
+void test_sequence_gaps_count_as_lost()
+{
+	LoopbackTransport transport;
+	PacketDataLink link(&transport);
+	link.onInitialize();
+
+	// 2 messages are missing in between, and the sequence number wraps around.
+	SendControl(transport, GetControl(0.1f), 0xFFFE, 0);
+	SendControl(transport, GetControl(0.2f), 0xFFFF, 4000);
+	SendControl(transport, GetControl(0.3f), 2, 16000);
+
+	// A duplicate and a message which arrived late are dropped.
+	SendControl(transport, GetControl(0.4f), 2, 16000);
+	SendControl(transport, GetControl(0.5f), 1, 12000);
+	link.onUpdate();
+
+	const auto quality = link.onGetLinkQuality();
+	TEST_ASSERT_EQUAL_UINT32(3, quality.m_Received);
+	TEST_ASSERT_EQUAL_UINT32(2, quality.m_Lost);
+	TEST_ASSERT_EQUAL_UINT32(0, quality.m_Errors);
+	TEST_ASSERT_EQUAL_UINT32(16000, quality.m_RemoteTimestamp);
+	TEST_ASSERT_EQUAL_FLOAT(0.3f * g_PitchInputMaximum, link.onGetPitch());
+}
+
+void test_latency_and_jitter_are_measured()
+{
+	LoopbackTransport transport;
+	PacketDataLink link(&transport);
+	link.onInitialize();
+
+	// The messages arrive exactly as far apart as they were sent, then one is 1.6 ms late.
+	for (uint16_t i = 0; i < 4; i++)
+	{
+		AdvanceHostTime(4000);
+		SendControl(transport, GetControl(0.0f), i, i * 4000);
+	}
+
+	link.onUpdate();
+	TEST_ASSERT_EQUAL_UINT32(0, link.onGetLinkQuality().m_Jitter);
+
+	AdvanceHostTime(5600);
+	SendControl(transport, GetControl(0.0f), 4, 16000);
+	link.onUpdate();
+	TEST_ASSERT_EQUAL_UINT32(100, link.onGetLinkQuality().m_Jitter);
+
+	// The age is the time since the last message arrived.
+	AdvanceHostTime(3000);
+	TEST_ASSERT_EQUAL_UINT32(3000, link.onGetLinkQuality().m_Age);
+}
+
+void test_ground_station_measures_the_round_trip()
+{
+	LoopbackTransport transport;
+	PacketDataLink link(&transport);
+	link.onInitialize();
+
+	GroundStation groundStation(transport, 1);
+	const auto start = GetHostTime() - (GetHostTime() % g_GroundStationPeriod);
+	for (uint64_t time = start + g_TestStep; time <= start + 1000000; time += g_TestStep)
+	{
+		AdvanceHostTime(static_cast<uint32_t>(time - GetHostTime()));
+		if (time % g_GroundStationPeriod == 0)
+			groundStation.send(GetControl(0.0f), time);
+
+		groundStation.update(time);
+		link.onUpdate();
+	}
+
+	// The link quality is sent every 100 ms, and both directions take the latency plus up to the jitter. The reply leaves with the next
+	// ground station update.
+	TEST_ASSERT_TRUE(groundStation.getReportCount() >= 8);
+	TEST_ASSERT_TRUE(groundStation.getMinimumRoundTrip() >= 2 * g_GroundStationLatency);
+	TEST_ASSERT_TRUE(groundStation.getMaximumRoundTrip() <= 2 * (g_GroundStationLatency + g_GroundStationJitter) + g_TestStep);
+
+	// Every message up to the echoed one was either received or lost (or damaged) on the way.
+	const auto &report = groundStation.getReport();
+	const auto sent = static_cast<uint32_t>((report.m_RemoteTimestamp - start) / g_GroundStationPeriod);
+	TEST_ASSERT_EQUAL_UINT32(sent, report.m_Received + report.m_Lost);
+	TEST_ASSERT_TRUE(report.m_Lost < sent / 10);
+}
+
+void test_corrupted_frames_are_rejected()
+{
+	LoopbackTransport transport;
+	PacketDataLink link(&transport);
+	link.onInitialize();
+
+	SendControl(transport, GetControl(0.1f), 0, 0);
+	link.onUpdate();
+
+	// A damaged message is never used, and counts as lost.
+	SendControl(transport, GetControl(0.9f), 1, 4000, 10);
+	link.onUpdate();
+	TEST_ASSERT_EQUAL_FLOAT(0.1f * g_PitchInputMaximum, link.onGetPitch());
+
+	// A frame which was cut short doesn't damage the next one.
+	TelemetryHeader header;
+	header.m_ID = TelemetryMessageID::Control;
+	header.m_Sequence = 2;
+
+	const auto message = GetControl(0.8f);
+	uint8_t encoded[g_MaxEncodedPacketSize];
+	const auto size = EncodePacket(header, &message, sizeof(message), encoded);
+	transport.inject(encoded, size / 2);
+
+	SendControl(transport, GetControl(0.3f), 3, 12000);
+	link.onUpdate();
+
+	const auto quality = link.onGetLinkQuality();
+	TEST_ASSERT_EQUAL_FLOAT(0.3f * g_PitchInputMaximum, link.onGetPitch());
+	TEST_ASSERT_EQUAL_UINT32(2, quality.m_Received);
+	TEST_ASSERT_EQUAL_UINT32(2, quality.m_Lost);
+	TEST_ASSERT_EQUAL_UINT32(2, quality.m_Errors);
+}
+
+int main()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_setpoints_and_modes_are_decoded);
+	RUN_TEST(test_sequence_gaps_count_as_lost);
+	RUN_TEST(test_latency_and_jitter_are_measured);
+	RUN_TEST(test_ground_station_measures_the_round_trip);
+	RUN_TEST(test_corrupted_frames_are_rejected);
+	return UNITY_END();
+}
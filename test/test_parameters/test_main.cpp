@@ -0,0 +1,399 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#include "algorithms/PacketCodec.hpp"
+#include "algorithms/ParameterRegistry.hpp"
+#include "algorithms/SensorCalibrator.hpp"
+#include "systems/ParameterSystem.hpp"
+#include "systems/TelemetrySystem.hpp"
+#include "sim/FileRecordStorage.hpp"
+#include "sim/HostPlatform.hpp"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <unity.h>
+#include <vector>
+
+// The stored records, in the working directory of the test.
+constexpr auto g_ParameterPath = "test_parameters.bin";
+constexpr auto g_CalibrationPath = "test_calibration.bin";
+constexpr auto g_MissingPath = "test_missing.bin";
+
+// The serial output of the controller.
+static FILE *s_pSerialOutput = nullptr;
+
+/**
+ * @brief Create a parameter value.
+ *
+ * @param value The value.
+ * @return The parameter value.
+ */
+static ParameterValue CreateFloat(float value)
+{
+	ParameterValue parameter;
+	parameter.m_Float = value;
+	return parameter;
+}
+
+/**
+ * @brief Create a parameter value.
+ *
+ * @param value The value.
+ * @return The parameter value.
+ */
+static ParameterValue CreateInteger(int32_t value)
+{
+	ParameterValue parameter;
+	parameter.m_Integer = value;
+	return parameter;
+}
+
+/**
+ * @brief Send a parameter command like the host, and run the telemetry and the parameter systems like the control task.
+ *
+ * @param action The action.
+ * @param id The parameter ID.
+ * @param type The value type.
+ * @param value The value to write.
+ */
+static void SendCommand(ParameterAction action, uint8_t id, ParameterType type = ParameterType::Float, ParameterValue value = {0.0f})
+{
+	ParameterCommandMessage message;
+	message.m_Action = static_cast<uint8_t>(action);
+	message.m_ID = id;
+	message.m_Type = static_cast<uint8_t>(type);
+	message.m_Value = value;
+
+	TelemetryHeader header;
+	header.m_ID = TelemetryMessageID::ParameterCommand;
+
+	uint8_t encoded[g_MaxEncodedPacketSize];
+	const auto size = EncodePacket(header, &message, sizeof(message), encoded);
+	Serial.receive(encoded, size);
+
+	TelemetrySystem::Instance().update();
+	ParameterSystem::Instance().update();
+
+	// Give the serial port the time to transmit the reply.
+	for (uint8_t i = 0; i < 10; i++)
+	{
+		AdvanceHostTime(1000);
+		TelemetrySystem::Instance().update();
+	}
+}
+
+/**
+ * @brief Read the parameter messages the controller sent.
+ *
+ * @return The messages, in the order they were sent.
+ */
+static std::vector<ParameterMessage> ReadReplies()
+{
+	fflush(s_pSerialOutput);
+	rewind(s_pSerialOutput);
+
+	std::vector<ParameterMessage> replies;
+	PacketDecoder decoder;
+	int value = 0;
+	while ((value = fgetc(s_pSerialOutput)) != EOF)
+	{
+		if (decoder.decode(static_cast<uint8_t>(value)) && decoder.getHeader().m_ID == TelemetryMessageID::Parameter)
+		{
+			TEST_ASSERT_EQUAL(sizeof(ParameterMessage), decoder.getMessageSize());
+
+			ParameterMessage message;
+			memcpy(&message, decoder.getMessage(), sizeof(message));
+			replies.push_back(message);
+		}
+	}
+
+	fseek(s_pSerialOutput, 0, SEEK_END);
+	return replies;
+}
+
+/**
+ * @brief Send a parameter command and get the reply.
+ *
+ * @param action The action.
+ * @param id The parameter ID.
+ * @param type The value type.
+ * @param value The value to write.
+ * @return The reply.
+ */
+static ParameterMessage SendCommandAndReceive(ParameterAction action, uint8_t id, ParameterType type = ParameterType::Float, ParameterValue value = {0.0f})
+{
+	const auto previousReplies = ReadReplies().size();
+	SendCommand(action, id, type, value);
+
+	const auto replies = ReadReplies();
+	TEST_ASSERT_EQUAL(previousReplies + 1, replies.size());
+	return replies.back();
+}
+
+void setUp()
+{
+	remove(g_ParameterPath);
+	remove(g_CalibrationPath);
+
+	s_pSerialOutput = tmpfile();
+	SetHostSerialOutput(s_pSerialOutput);
+
+	// Only the replies are sent.
+	auto &telemetrySystem = TelemetrySystem::Instance();
+	for (uint8_t i = 0; i < g_TelemetryMessageCount; i++)
+		telemetrySystem.subscribe(static_cast<TelemetryMessageID>(i), 0);
+
+	// The systems are singletons, so every test starts from the defaults.
+	auto &parameterSystem = ParameterSystem::Instance();
+	parameterSystem.initialize(nullptr);
+	parameterSystem.reset();
+	parameterSystem.update();
+}
+
+void tearDown()
+{
+	SetHostSerialOutput(nullptr);
+	fclose(s_pSerialOutput);
+
+	remove(g_ParameterPath);
+	remove(g_CalibrationPath);
+}
+
+void test_defaults_are_the_constants()
+{
+	const auto &parameters = g_DefaultParameters;
+	TEST_ASSERT_EQUAL_FLOAT(g_PitchRateKP, GetParameter(parameters, ParameterID::PitchRateKP).m_Float);
+	TEST_ASSERT_EQUAL_FLOAT(g_RollAngleKI, GetParameter(parameters, ParameterID::RollAngleKI).m_Float);
+	TEST_ASSERT_EQUAL_INT32(g_WingServoOffsetHover, GetParameter(parameters, ParameterID::WingServoOffsetHover).m_Integer);
+	TEST_ASSERT_EQUAL_INT32(g_YawInputMaximum, GetParameter(parameters, ParameterID::YawInputRange).m_Integer);
+	TEST_ASSERT_EQUAL_FLOAT(g_KalmanMeasurementNoise, GetParameter(parameters, ParameterID::KalmanMeasurementNoise).m_Float);
+
+	// Every default is in the range of its parameter, so it can be written back.
+	for (uint8_t i = 0; i < g_ParameterCount; i++)
+	{
+		auto copy = parameters;
+		const auto id = static_cast<ParameterID>(i);
+		TEST_ASSERT_TRUE(SetParameter(copy, id, GetParameter(parameters, id)));
+	}
+}
+
+void test_descriptors_cover_the_parameter_set()
+{
+	// Every parameter has a name and its own 4 bytes of the set, and together they cover all of it.
+	bool isCovered[sizeof(ParameterSet)] = {};
+	for (uint8_t i = 0; i < g_ParameterCount; i++)
+	{
+		const auto &descriptor = GetParameterDescriptor(static_cast<ParameterID>(i));
+		TEST_ASSERT_NOT_NULL(descriptor.m_pName);
+		TEST_ASSERT_TRUE(strlen(descriptor.m_pName) > 0);
+		TEST_ASSERT_TRUE(descriptor.m_Minimum <= descriptor.m_Maximum);
+		TEST_ASSERT_TRUE(descriptor.m_Offset + sizeof(ParameterValue) <= sizeof(ParameterSet));
+
+		for (uint8_t j = 0; j < sizeof(ParameterValue); j++)
+		{
+			TEST_ASSERT_FALSE(isCovered[descriptor.m_Offset + j]);
+			isCovered[descriptor.m_Offset + j] = true;
+		}
+
+		for (uint8_t j = 0; j < i; j++)
+			TEST_ASSERT_NOT_EQUAL(0, strcmp(descriptor.m_pName, GetParameterDescriptor(static_cast<ParameterID>(j)).m_pName));
+	}
+
+	for (size_t i = 0; i < sizeof(ParameterSet); i++)
+		TEST_ASSERT_TRUE(isCovered[i]);
+}
+
+void test_set_checks_the_range()
+{
+	auto parameters = g_DefaultParameters;
+	TEST_ASSERT_TRUE(SetParameter(parameters, ParameterID::PitchRateKP, CreateFloat(0.6f)));
+	TEST_ASSERT_EQUAL_FLOAT(0.6f, parameters.m_PitchRate.m_KP);
+
+	TEST_ASSERT_TRUE(SetParameter(parameters, ParameterID::WingServoOffsetHover, CreateInteger(50)));
+	TEST_ASSERT_EQUAL_INT32(50, parameters.m_WingServoOffsetHover);
+
+	// Rejected values leave the parameter as it was.
+	TEST_ASSERT_FALSE(SetParameter(parameters, ParameterID::PitchRateKP, CreateFloat(-1.0f)));
+	TEST_ASSERT_FALSE(SetParameter(parameters, ParameterID::YawRateKI, CreateFloat(NAN)));
+	TEST_ASSERT_FALSE(SetParameter(parameters, ParameterID::YawRateKD, CreateFloat(INFINITY)));
+	TEST_ASSERT_FALSE(SetParameter(parameters, ParameterID::ElevatorOffset, CreateInteger(g_ServoOutputMaximum + 1)));
+	TEST_ASSERT_FALSE(SetParameter(parameters, ParameterID::RollInputRange, CreateInteger(0)));
+	TEST_ASSERT_FALSE(SetParameter(parameters, ParameterID::KalmanAngleNoise, CreateFloat(0.0f)));
+	TEST_ASSERT_EQUAL_FLOAT(0.6f, parameters.m_PitchRate.m_KP);
+	TEST_ASSERT_EQUAL_INT32(g_ElevatorOffset, parameters.m_ElevatorOffset);
+	TEST_ASSERT_EQUAL_INT32(g_RollInputMaximum, parameters.m_RollInputRange);
+}
+
+void test_record_detects_damage_and_other_versions()
+{
+	auto parameters = g_DefaultParameters;
+	parameters.m_RollRate.m_KD = 0.01f;
+	parameters.m_RudderOffset = 80;
+
+	auto record = EncodeParameterRecord(parameters);
+	ParameterSet decoded;
+	TEST_ASSERT_TRUE(DecodeParameterRecord(record, decoded));
+	TEST_ASSERT_EQUAL_MEMORY(&parameters, &decoded, sizeof(parameters));
+
+	record.m_Parameters.m_RudderOffset++;
+	TEST_ASSERT_FALSE(DecodeParameterRecord(record, decoded));
+
+	record = EncodeParameterRecord(parameters);
+	record.m_Version++;
+	TEST_ASSERT_FALSE(DecodeParameterRecord(record, decoded));
+
+	// An intact record with a value out of its range is not loaded either.
+	parameters.m_PitchInputRange = 0;
+	TEST_ASSERT_FALSE(DecodeParameterRecord(EncodeParameterRecord(parameters), decoded));
+}
+
+void test_file_storage_round_trip()
+{
+	FileRecordStorage<ParameterSet> missing(g_MissingPath);
+	ParameterSet parameters;
+	TEST_ASSERT_FALSE(missing.onLoad(parameters));
+
+	auto saved = g_DefaultParameters;
+	saved.m_YawRate.m_KI = 0.2f;
+	saved.m_KalmanBiasNoise = 0.01f;
+
+	FileRecordStorage<ParameterSet> parameterStorage(g_ParameterPath);
+	TEST_ASSERT_TRUE(parameterStorage.onSave(saved));
+	TEST_ASSERT_TRUE(parameterStorage.onLoad(parameters));
+	TEST_ASSERT_EQUAL_MEMORY(&saved, &parameters, sizeof(saved));
+
+	// The calibration is stored through the same storage.
+	SensorCalibration calibration;
+	calibration.m_GyroscopeBias = Vec3(0.5f, -1.25f, 2.0f);
+	calibration.m_AccelerometerOffset = Vec3(0.1f, 0.2f, -0.3f);
+	calibration.m_Temperature = 31.5f;
+
+	FileRecordStorage<SensorCalibration> calibrationStorage(g_CalibrationPath);
+	TEST_ASSERT_TRUE(calibrationStorage.onSave(calibration));
+
+	SensorCalibration loaded;
+	TEST_ASSERT_TRUE(calibrationStorage.onLoad(loaded));
+	TEST_ASSERT_EQUAL_MEMORY(&calibration, &loaded, sizeof(calibration));
+
+	// A file of the other record type is rejected.
+	FileRecordStorage<ParameterSet> wrongStorage(g_CalibrationPath);
+	TEST_ASSERT_FALSE(wrongStorage.onLoad(parameters));
+}
+
+void test_written_parameters_are_published_on_update()
+{
+	auto &parameterSystem = ParameterSystem::Instance();
+	TEST_ASSERT_TRUE(parameterSystem.set(ParameterID::RollRateKP, CreateFloat(0.7f)));
+	TEST_ASSERT_TRUE(parameterSystem.set(ParameterID::RudderOffset, CreateInteger(100)));
+	TEST_ASSERT_FALSE(parameterSystem.set(ParameterID::RudderOffset, CreateInteger(-1)));
+
+	// The writes only go to the shadow copy until the update.
+	TEST_ASSERT_EQUAL_FLOAT(0.7f, parameterSystem.get(ParameterID::RollRateKP).m_Float);
+	TEST_ASSERT_EQUAL_FLOAT(g_RollRateKP, parameterSystem.getParameters().m_RollRate.m_KP);
+	TEST_ASSERT_EQUAL_INT32(g_RudderOffset, parameterSystem.getParameters().m_RudderOffset);
+
+	parameterSystem.update();
+	TEST_ASSERT_EQUAL_FLOAT(0.7f, parameterSystem.getParameters().m_RollRate.m_KP);
+	TEST_ASSERT_EQUAL_INT32(100, parameterSystem.getParameters().m_RudderOffset);
+
+	parameterSystem.reset();
+	parameterSystem.update();
+	TEST_ASSERT_EQUAL_MEMORY(&g_DefaultParameters, &parameterSystem.getParameters(), sizeof(ParameterSet));
+}
+
+void test_stored_parameters_are_loaded()
+{
+	auto stored = g_DefaultParameters;
+	stored.m_PitchAngle.m_KP = 3.5f;
+
+	FileRecordStorage<ParameterSet> storage(g_ParameterPath);
+	TEST_ASSERT_TRUE(storage.onSave(stored));
+
+	auto &parameterSystem = ParameterSystem::Instance();
+	parameterSystem.initialize(&storage);
+	TEST_ASSERT_EQUAL_FLOAT(3.5f, parameterSystem.getParameters().m_PitchAngle.m_KP);
+	TEST_ASSERT_EQUAL_FLOAT(3.5f, parameterSystem.get(ParameterID::PitchAngleKP).m_Float);
+}
+
+void test_commands_read_and_write_parameters()
+{
+	auto reply = SendCommandAndReceive(ParameterAction::Read, static_cast<uint8_t>(ParameterID::PitchRateKI));
+	TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(ParameterID::PitchRateKI), reply.m_ID);
+	TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(ParameterType::Float), reply.m_Type);
+	TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(ParameterAction::Read), reply.m_Action);
+	TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(ParameterStatus::Done), reply.m_Status);
+	TEST_ASSERT_EQUAL_FLOAT(g_PitchRateKI, reply.m_Value.m_Float);
+
+	// A write is published by the parameter system update right after the telemetry system.
+	reply = SendCommandAndReceive(ParameterAction::Write, static_cast<uint8_t>(ParameterID::WingServoOffsetHover), ParameterType::Integer, CreateInteger(50));
+	TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(ParameterStatus::Done), reply.m_Status);
+	TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(ParameterType::Integer), reply.m_Type);
+	TEST_ASSERT_EQUAL_INT32(50, reply.m_Value.m_Integer);
+	TEST_ASSERT_EQUAL_INT32(50, ParameterSystem::Instance().getParameters().m_WingServoOffsetHover);
+
+	// A rejected write answers with the value that is kept.
+	reply = SendCommandAndReceive(ParameterAction::Write, static_cast<uint8_t>(ParameterID::WingServoOffsetHover), ParameterType::Integer, CreateInteger(1000));
+	TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(ParameterStatus::Rejected), reply.m_Status);
+	TEST_ASSERT_EQUAL_INT32(50, reply.m_Value.m_Integer);
+
+	// So does a write of the wrong type.
+	reply = SendCommandAndReceive(ParameterAction::Write, static_cast<uint8_t>(ParameterID::WingServoOffsetHover), ParameterType::Float, CreateFloat(60.0f));
+	TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(ParameterStatus::Invalid), reply.m_Status);
+	TEST_ASSERT_EQUAL_INT32(50, ParameterSystem::Instance().getParameters().m_WingServoOffsetHover);
+
+	reply = SendCommandAndReceive(ParameterAction::Reset, static_cast<uint8_t>(ParameterID::WingServoOffsetHover));
+	TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(ParameterStatus::Done), reply.m_Status);
+	TEST_ASSERT_EQUAL_INT32(g_WingServoOffsetHover, reply.m_Value.m_Integer);
+	TEST_ASSERT_EQUAL_INT32(g_WingServoOffsetHover, ParameterSystem::Instance().getParameters().m_WingServoOffsetHover);
+}
+
+void test_commands_reject_invalid_ids_and_actions()
+{
+	auto reply = SendCommandAndReceive(ParameterAction::Read, g_ParameterCount);
+	TEST_ASSERT_EQUAL_UINT8(g_ParameterCount, reply.m_ID);
+	TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(ParameterStatus::Invalid), reply.m_Status);
+
+	reply = SendCommandAndReceive(static_cast<ParameterAction>(0xFF), static_cast<uint8_t>(ParameterID::PitchRateKP));
+	TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(ParameterStatus::Invalid), reply.m_Status);
+	TEST_ASSERT_EQUAL_FLOAT(g_PitchRateKP, reply.m_Value.m_Float);
+}
+
+void test_commands_save_the_parameters()
+{
+	// Without a storage the parameters can't be saved.
+	auto reply = SendCommandAndReceive(ParameterAction::Save, static_cast<uint8_t>(ParameterID::YawRateKP));
+	TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(ParameterStatus::Rejected), reply.m_Status);
+
+	FileRecordStorage<ParameterSet> storage(g_ParameterPath);
+	ParameterSystem::Instance().initialize(&storage);
+
+	reply = SendCommandAndReceive(ParameterAction::Write, static_cast<uint8_t>(ParameterID::YawRateKP), ParameterType::Float, CreateFloat(0.9f));
+	TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(ParameterStatus::Done), reply.m_Status);
+
+	reply = SendCommandAndReceive(ParameterAction::Save, static_cast<uint8_t>(ParameterID::YawRateKP));
+	TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(ParameterAction::Save), reply.m_Action);
+	TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(ParameterStatus::Done), reply.m_Status);
+	TEST_ASSERT_EQUAL_FLOAT(0.9f, reply.m_Value.m_Float);
+
+	ParameterSet loaded;
+	TEST_ASSERT_TRUE(storage.onLoad(loaded));
+	TEST_ASSERT_EQUAL_FLOAT(0.9f, loaded.m_YawRate.m_KP);
+	TEST_ASSERT_EQUAL_MEMORY(&ParameterSystem::Instance().getParameters(), &loaded, sizeof(loaded));
+}
+
+int main()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_defaults_are_the_constants);
+	RUN_TEST(test_descriptors_cover_the_parameter_set);
+	RUN_TEST(test_set_checks_the_range);
+	RUN_TEST(test_record_detects_damage_and_other_versions);
+	RUN_TEST(test_file_storage_round_trip);
+	RUN_TEST(test_written_parameters_are_published_on_update);
+	RUN_TEST(test_stored_parameters_are_loaded);
+	RUN_TEST(test_commands_read_and_write_parameters);
+	RUN_TEST(test_commands_reject_invalid_ids_and_actions);
+	RUN_TEST(test_commands_save_the_parameters);
+	return UNITY_END();
+}
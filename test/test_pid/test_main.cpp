@@ -0,0 +1,161 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#include "algorithms/PID.hpp"
+#include "core/Constants.hpp"
+
+#include <math.h>
+#include <unity.h>
+
+// The control rate of the derivative filter test. This is high enough for the backward difference to be close to the true derivative.
+constexpr auto g_DerivativeTestRate = 10000;
+
+/**
+ * @brief Run the controller against a measurement which follows a function of time.
+ * The pitch, yaw and roll are all set to the measurement.
+ *
+ * @param controller The controller.
+ * @param measurement The measurement at a time in seconds.
+ * @param expected The expected value.
+ * @param rate The control rate in hertz.
+ * @param start The time of the previous calculation in seconds.
+ * @param end The time of the last calculation in seconds.
+ * @return The pitch output of the last calculation.
+ */
+template <class Function>
+static float Run(PID &controller, Function measurement, float expected, int rate, float start, float end)
+{
+	const auto delta = 1.0f / rate;
+	const auto first = static_cast<int>(start * rate + 0.5f);
+	const auto last = static_cast<int>(end * rate + 0.5f);
+
+	auto output = controller.getOutput().m_Pitch;
+	for (auto i = first + 1; i <= last; i++)
+		output = controller.calculate(Vec3(measurement(i * delta)), Vec3(expected), delta).m_Pitch;
+
+	return output;
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_outputs_do_not_depend_on_the_control_rate()
+{
+	// A slow oscillation around a constant offset from the setpoint exercises all 3 terms.
+	constexpr auto angularFrequency = 2.0f * 3.14159265f;
+	const auto measurement = [](float time)
+	{ return 2.0f + 5.0f * sinf(angularFrequency * time); };
+
+	PID slow(Vec3(2.0f), Vec3(1.0f), Vec3(0.2f));
+	PID fast(Vec3(2.0f), Vec3(1.0f), Vec3(0.2f));
+
+	for (auto i = 1; i <= 8; i++)
+	{
+		const auto end = 0.25f * i;
+		const auto slowOutput = Run(slow, measurement, 0.0f, 500, end - 0.25f, end);
+		const auto fastOutput = Run(fast, measurement, 0.0f, 1000, end - 0.25f, end);
+
+		TEST_ASSERT_FLOAT_WITHIN(0.1f, slowOutput, fastOutput);
+		TEST_ASSERT_FLOAT_WITHIN(0.01f, slow.getIntegral().m_Pitch, fast.getIntegral().m_Pitch);
+
+		// The integral of the error.
+		const auto integral = -2.0f * end - 5.0f * (1.0f - cosf(angularFrequency * end)) / angularFrequency;
+		TEST_ASSERT_FLOAT_WITHIN(0.01f, integral, fast.getIntegral().m_Pitch);
+	}
+}
+
+void test_integral_stops_while_saturated()
+{
+	PID controller(Vec3(1.0f), Vec3(10.0f), Vec3(0.0f));
+
+	const auto zero = [](float)
+	{ return 0.0f; };
+
+	// The error of 100 saturates the output on its own, so the integral never starts.
+	auto output = Run(controller, zero, 100.0f, 500, 0.0f, 1.0f);
+	TEST_ASSERT_EQUAL_FLOAT(g_PIDOutputMaximum, output);
+	TEST_ASSERT_EQUAL_FLOAT(0.0f, controller.getIntegral().m_Pitch);
+
+	output = Run(controller, zero, -100.0f, 500, 1.0f, 2.0f);
+	TEST_ASSERT_EQUAL_FLOAT(g_PIDOutputMinimum, output);
+	TEST_ASSERT_EQUAL_FLOAT(0.0f, controller.getIntegral().m_Pitch);
+
+	// A smaller error lets the integral grow until the output reaches the maximum (within one integration step of 0.8), and no further.
+	output = Run(controller, zero, 40.0f, 500, 2.0f, 12.0f);
+	TEST_ASSERT_FLOAT_WITHIN(0.8f, g_PIDOutputMaximum, output);
+
+	const auto integral = controller.getIntegral().m_Pitch;
+	TEST_ASSERT_FLOAT_WITHIN(0.8f, g_PIDOutputMaximum - 40.0f, integral);
+
+	Run(controller, zero, 40.0f, 500, 12.0f, 22.0f);
+	TEST_ASSERT_EQUAL_FLOAT(integral, controller.getIntegral().m_Pitch);
+
+	// So the output leaves the saturation as soon as the error changes sign.
+	output = Run(controller, zero, -5.0f, 500, 22.0f, 22.002f);
+	TEST_ASSERT_TRUE(output < g_PIDOutputMaximum - 40.0f);
+}
+
+void test_setpoint_step_does_not_kick_the_derivative()
+{
+	const auto constant = [](float)
+	{ return 10.0f; };
+
+	PID controller(Vec3(0.0f), Vec3(0.0f), Vec3(1.0f));
+	Run(controller, constant, 0.0f, 500, 0.0f, 0.1f);
+
+	const auto output = Run(controller, constant, 30.0f, 500, 0.1f, 0.102f);
+	TEST_ASSERT_EQUAL_FLOAT(0.0f, output);
+	TEST_ASSERT_EQUAL_FLOAT(0.0f, controller.getDerivative().m_Pitch);
+
+	// The first measurement doesn't kick it either.
+	PID first(Vec3(0.0f), Vec3(0.0f), Vec3(1.0f));
+	TEST_ASSERT_EQUAL_FLOAT(0.0f, Run(first, constant, 0.0f, 500, 0.0f, 0.002f));
+}
+
+void test_derivative_is_low_pass_filtered()
+{
+	constexpr auto cutoff = 10.0f;
+	constexpr auto amplitude = 0.1f;
+
+	// The amplitude of the derivative of a sine, relative to the unfiltered one, after the filter settled.
+	const auto gain = [](float frequency)
+	{
+		PID controller(Vec3(0.0f), Vec3(0.0f), Vec3(1.0f), cutoff);
+		const auto angularFrequency = 2.0f * 3.14159265f * frequency;
+		const auto measurement = [angularFrequency](float time)
+		{ return amplitude * sinf(angularFrequency * time); };
+
+		Run(controller, measurement, 0.0f, g_DerivativeTestRate, 0.0f, 1.0f);
+
+		// Then find the peak over one period.
+		auto peak = 0.0f;
+		const auto samples = static_cast<int>(g_DerivativeTestRate / frequency);
+		for (auto i = 1; i <= samples; i++)
+		{
+			const auto time = 1.0f + static_cast<float>(i) / g_DerivativeTestRate;
+			const auto output = controller.calculate(Vec3(measurement(time)), Vec3(), 1.0f / g_DerivativeTestRate);
+			peak = fmaxf(peak, fabsf(output.m_Pitch));
+		}
+
+		return peak / (amplitude * angularFrequency);
+	};
+
+	TEST_ASSERT_FLOAT_WITHIN(0.01f, 1.0f, gain(cutoff / 10.0f));
+	TEST_ASSERT_FLOAT_WITHIN(0.02f, 1.0f / sqrtf(2.0f), gain(cutoff));
+	TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.1f, gain(cutoff * 10.0f));
+}
+
+int main()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_outputs_do_not_depend_on_the_control_rate);
+	RUN_TEST(test_integral_stops_while_saturated);
+	RUN_TEST(test_setpoint_step_does_not_kick_the_derivative);
+	RUN_TEST(test_derivative_is_low_pass_filtered);
+	return UNITY_END();
+}
@@ -0,0 +1,336 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#include "algorithms/RelayTuner.hpp"
+
+#include <math.h>
+#include <random>
+#include <unity.h>
+#include <vector>
+
+// The loops run at 1 kHz.
+constexpr auto g_TimeStep = 0.001f;
+
+/**
+ * @brief Plant structure.
+ * This is a first order plant with dead time, or when integrating, a first order actuator driving an integrator (like a rate command
+ * driving an angle).
+ */
+struct Plant final
+{
+	bool m_isIntegrating = false;
+	float m_Gain = 0.0f;
+	float m_TimeConstant = 0.0f;
+	float m_DeadTime = 0.0f;
+	float m_Noise = 0.0f;
+};
+
+/**
+ * @brief Compute the ultimate gain and period of a plant.
+ * The ultimate frequency is where the phase of the plant reaches -180 degrees. The relay output is held for a time step, which adds half
+ * a step of dead time.
+ *
+ * @param plant The plant.
+ * @param ultimateGain The ultimate gain.
+ * @param ultimatePeriod The ultimate period in seconds.
+ */
+static void ComputeUltimatePoint(const Plant &plant, float &ultimateGain, float &ultimatePeriod)
+{
+	// The integrator adds 90 degrees of lag.
+	const auto target = plant.m_isIntegrating ? M_PI / 2.0 : M_PI;
+	const auto deadTime = plant.m_DeadTime + (g_TimeStep / 2.0f);
+	auto low = 0.1;
+	auto high = 10000.0;
+	for (uint8_t i = 0; i < 100; i++)
+	{
+		const auto frequency = (low + high) / 2.0;
+		if (atan(frequency * plant.m_TimeConstant) + (frequency * deadTime) < target)
+			low = frequency;
+		else
+			high = frequency;
+	}
+
+	const auto magnitude = plant.m_Gain / sqrt(1.0 + (low * low * plant.m_TimeConstant * plant.m_TimeConstant));
+	ultimateGain = static_cast<float>((plant.m_isIntegrating ? low : 1.0) / magnitude);
+	ultimatePeriod = static_cast<float>(2.0 * M_PI / low);
+}
+
+/**
+ * @brief Run the experiment on a plant until it completes or fails.
+ *
+ * @param tuner The tuner, which is started.
+ * @param plant The plant.
+ * @param seed The seed of the measurement noise.
+ * @return The largest measurement error.
+ */
+static float RunExperiment(RelayTuner &tuner, const Plant &plant, uint32_t seed = 1)
+{
+	std::vector<float> delay(static_cast<size_t>(lroundf(plant.m_DeadTime / g_TimeStep)), 0.0f);
+	size_t delayIndex = 0;
+
+	std::mt19937 generator(seed);
+	std::normal_distribution<float> noise(0.0f, plant.m_Noise);
+
+	auto output = 0.0f;
+	auto actuator = 0.0f;
+	auto maximumError = 0.0f;
+	for (uint32_t i = 0; i < 20000 && tuner.getState() == RelayTunerState::Running; i++)
+	{
+		const auto measurement = plant.m_Noise > 0.0f ? output + noise(generator) : output;
+		auto input = tuner.update(measurement, 0.0f, g_TimeStep);
+		maximumError = fmaxf(maximumError, fabsf(output));
+
+		if (!delay.empty())
+		{
+			std::swap(input, delay[delayIndex]);
+			delayIndex = (delayIndex + 1) % delay.size();
+		}
+
+		if (plant.m_isIntegrating)
+		{
+			actuator += (input - actuator) * g_TimeStep / plant.m_TimeConstant;
+			output += plant.m_Gain * actuator * g_TimeStep;
+		}
+		else
+		{
+			output += ((plant.m_Gain * input) - output) * g_TimeStep / plant.m_TimeConstant;
+		}
+	}
+
+	return maximumError;
+}
+
+/**
+ * @brief Check the ultimate gain and period measured on plants against the analytic ones.
+ *
+ * @param pPlants The plants.
+ * @param count The number of plants.
+ * @param gainTolerance The relative tolerance of the ultimate gain.
+ * @param periodTolerance The relative tolerance of the ultimate period.
+ */
+static void CheckPlants(const Plant *pPlants, size_t count, float gainTolerance, float periodTolerance)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		const auto &plant = pPlants[i];
+
+		float ultimateGain = 0.0f;
+		float ultimatePeriod = 0.0f;
+		ComputeUltimatePoint(plant, ultimateGain, ultimatePeriod);
+
+		RelaySettings settings;
+		settings.m_Amplitude = 10.0f;
+		settings.m_MaximumAmplitude = 10000.0f;
+		// The oscillation is kept a few times larger than the hysteresis, like on the airframe.
+		settings.m_Hysteresis = (plant.m_Noise * 3.0f) + 0.01f;
+		settings.m_TargetAmplitude = plant.m_Noise > 0.0f ? settings.m_Hysteresis * 10.0f : 0.0f;
+		settings.m_Limit = 10000.0f;
+
+		RelayTuner tuner;
+		tuner.start(settings);
+		RunExperiment(tuner, plant);
+
+		TEST_ASSERT_EQUAL(static_cast<int>(RelayTunerState::Completed), static_cast<int>(tuner.getState()));
+		TEST_ASSERT_FLOAT_WITHIN(ultimateGain * gainTolerance, ultimateGain, tuner.getUltimateGain());
+		TEST_ASSERT_FLOAT_WITHIN(ultimatePeriod * periodTolerance, ultimatePeriod, tuner.getUltimatePeriod());
+	}
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_gains_follow_the_tuning_rules()
+{
+	const auto zieglerNichols = ComputePIDGains(2.0f, 0.5f, TuningRule::ZieglerNichols);
+	TEST_ASSERT_FLOAT_WITHIN(1e-6f, 1.2f, zieglerNichols.m_KP);
+	TEST_ASSERT_FLOAT_WITHIN(1e-5f, 4.8f, zieglerNichols.m_KI);
+	TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.075f, zieglerNichols.m_KD);
+
+	const auto zieglerNicholsPI = ComputePIDGains(2.0f, 0.5f, TuningRule::ZieglerNicholsPI);
+	TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.9f, zieglerNicholsPI.m_KP);
+	TEST_ASSERT_FLOAT_WITHIN(1e-5f, 2.16f, zieglerNicholsPI.m_KI);
+	TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.0f, zieglerNicholsPI.m_KD);
+
+	const auto tyreusLuyben = ComputePIDGains(2.2f, 1.0f, TuningRule::TyreusLuyben);
+	TEST_ASSERT_FLOAT_WITHIN(1e-6f, 1.0f, tyreusLuyben.m_KP);
+	TEST_ASSERT_FLOAT_WITHIN(1e-5f, 1.0f / 2.2f, tyreusLuyben.m_KI);
+	TEST_ASSERT_FLOAT_WITHIN(1e-6f, 1.0f / 6.3f, tyreusLuyben.m_KD);
+
+	// The rules without overshoot are less aggressive, but all of them have the same period scaling.
+	const auto someOvershoot = ComputePIDGains(3.0f, 1.0f, TuningRule::SomeOvershoot);
+	const auto noOvershoot = ComputePIDGains(3.0f, 1.0f, TuningRule::NoOvershoot);
+	TEST_ASSERT_FLOAT_WITHIN(1e-6f, 1.0f, someOvershoot.m_KP);
+	TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.6f, noOvershoot.m_KP);
+	TEST_ASSERT_FLOAT_WITHIN(1e-5f, 2.0f, someOvershoot.m_KI);
+	TEST_ASSERT_FLOAT_WITHIN(1e-6f, 1.0f / 3.0f, someOvershoot.m_KD);
+}
+
+void test_first_order_plants_with_dead_time()
+{
+	const Plant plants[] = {
+		{false, 20.0f, 0.05f, 0.01f, 0.0f},
+		{false, 5.0f, 0.2f, 0.02f, 0.0f},
+		{false, 50.0f, 0.03f, 0.005f, 0.0f},
+	};
+
+	CheckPlants(plants, sizeof(plants) / sizeof(plants[0]), 0.1f, 0.05f);
+}
+
+void test_integrating_plants()
+{
+	const Plant plants[] = {
+		{true, 2000.0f, 0.03f, 0.004f, 0.0f},
+		{true, 600.0f, 0.05f, 0.006f, 0.0f},
+		{true, 4000.0f, 0.02f, 0.003f, 0.0f},
+	};
+
+	CheckPlants(plants, sizeof(plants) / sizeof(plants[0]), 0.1f, 0.05f);
+}
+
+void test_noisy_plants()
+{
+	// The hysteresis keeps the relay from chattering. It also delays the switching by about asin(h / a) of phase, so the oscillation is
+	// slower than the ultimate one and the result is further off than without noise.
+	const Plant plants[] = {
+		{false, 20.0f, 0.05f, 0.01f, 1.0f},
+		{false, 5.0f, 0.2f, 0.02f, 0.5f},
+		{false, 50.0f, 0.03f, 0.005f, 2.0f},
+		{true, 2000.0f, 0.03f, 0.004f, 1.0f},
+		{true, 600.0f, 0.05f, 0.006f, 0.5f},
+		{true, 4000.0f, 0.02f, 0.003f, 2.0f},
+	};
+
+	CheckPlants(plants, sizeof(plants) / sizeof(plants[0]), 0.25f, 0.2f);
+}
+
+void test_relay_amplitude_adapts_to_the_target()
+{
+	const Plant plant = {true, 2000.0f, 0.03f, 0.004f, 0.0f};
+
+	RelaySettings settings;
+	settings.m_Amplitude = 1.0f;
+	settings.m_MaximumAmplitude = 1000.0f;
+	settings.m_Hysteresis = 0.5f;
+	settings.m_TargetAmplitude = 20.0f;
+	settings.m_Limit = 1000.0f;
+
+	RelayTuner tuner;
+	tuner.start(settings);
+	RunExperiment(tuner, plant);
+
+	TEST_ASSERT_EQUAL(static_cast<int>(RelayTunerState::Completed), static_cast<int>(tuner.getState()));
+	TEST_ASSERT_TRUE(tuner.getAmplitude() > settings.m_Amplitude);
+
+	// The relay amplitude for the target is about pi / 4 times the target amplitude and the ultimate gain.
+	float ultimateGain = 0.0f;
+	float ultimatePeriod = 0.0f;
+	ComputeUltimatePoint(plant, ultimateGain, ultimatePeriod);
+	const auto amplitude = (4.0f * tuner.getAmplitude()) / (static_cast<float>(M_PI) * ultimateGain);
+	TEST_ASSERT_FLOAT_WITHIN(settings.m_TargetAmplitude * g_RelayAmplitudeTolerance * 1.2f, settings.m_TargetAmplitude, amplitude);
+	TEST_ASSERT_FLOAT_WITHIN(ultimateGain * 0.1f, ultimateGain, tuner.getUltimateGain());
+}
+
+void test_relay_amplitude_is_limited()
+{
+	const Plant plant = {true, 2000.0f, 0.03f, 0.004f, 0.0f};
+
+	RelaySettings settings;
+	settings.m_Amplitude = 1.0f;
+	settings.m_MaximumAmplitude = 3.0f;
+	settings.m_Hysteresis = 0.5f;
+	settings.m_TargetAmplitude = 100.0f;
+	settings.m_Limit = 1000.0f;
+
+	RelayTuner tuner;
+	tuner.start(settings);
+	RunExperiment(tuner, plant);
+
+	TEST_ASSERT_EQUAL(static_cast<int>(RelayTunerState::Completed), static_cast<int>(tuner.getState()));
+	TEST_ASSERT_EQUAL_FLOAT(settings.m_MaximumAmplitude, tuner.getAmplitude());
+}
+
+void test_limit_fails_the_experiment()
+{
+	const Plant plant = {true, 2000.0f, 0.03f, 0.004f, 0.0f};
+
+	RelaySettings settings;
+	settings.m_Bias = 2.0f;
+	settings.m_Amplitude = 10.0f;
+	settings.m_MaximumAmplitude = 10.0f;
+	settings.m_Hysteresis = 0.5f;
+	settings.m_Limit = 5.0f;
+
+	RelayTuner tuner;
+	tuner.start(settings);
+	const auto maximumError = RunExperiment(tuner, plant);
+
+	TEST_ASSERT_EQUAL(static_cast<int>(RelayTunerState::Failed), static_cast<int>(tuner.getState()));
+	TEST_ASSERT_TRUE(maximumError > settings.m_Limit);
+	TEST_ASSERT_EQUAL_FLOAT(settings.m_Bias, tuner.update(0.0f, 0.0f, g_TimeStep));
+}
+
+void test_timeout_fails_the_experiment()
+{
+	RelaySettings settings;
+	settings.m_Bias = 1.0f;
+	settings.m_Amplitude = 10.0f;
+	settings.m_MaximumAmplitude = 10.0f;
+	settings.m_Hysteresis = 0.5f;
+	settings.m_Limit = 100.0f;
+
+	// A loop which does not respond never crosses the hysteresis.
+	RelayTuner tuner;
+	tuner.start(settings);
+	uint32_t updates = 0;
+	while (tuner.getState() == RelayTunerState::Running && updates < 20000)
+	{
+		tuner.update(0.0f, 0.0f, g_TimeStep);
+		updates++;
+	}
+
+	TEST_ASSERT_EQUAL(static_cast<int>(RelayTunerState::Failed), static_cast<int>(tuner.getState()));
+	TEST_ASSERT_UINT32_WITHIN(2, static_cast<uint32_t>(g_RelayTimeout / g_TimeStep), updates);
+}
+
+void test_idle_tuner_outputs_the_bias()
+{
+	RelaySettings settings;
+	settings.m_Bias = 3.0f;
+	settings.m_Amplitude = 10.0f;
+	settings.m_MaximumAmplitude = 10.0f;
+	settings.m_Hysteresis = 0.5f;
+	settings.m_Limit = 100.0f;
+
+	RelayTuner tuner;
+	TEST_ASSERT_EQUAL(static_cast<int>(RelayTunerState::Idle), static_cast<int>(tuner.getState()));
+
+	// The relay switches up when the measurement is below the setpoint.
+	tuner.start(settings);
+	TEST_ASSERT_EQUAL_FLOAT(13.0f, tuner.update(-1.0f, 0.0f, g_TimeStep));
+	TEST_ASSERT_EQUAL_FLOAT(13.0f, tuner.update(0.0f, 0.0f, g_TimeStep));
+	TEST_ASSERT_EQUAL_FLOAT(-7.0f, tuner.update(1.0f, 0.0f, g_TimeStep));
+
+	tuner.stop();
+	TEST_ASSERT_EQUAL(static_cast<int>(RelayTunerState::Idle), static_cast<int>(tuner.getState()));
+	TEST_ASSERT_EQUAL_FLOAT(settings.m_Bias, tuner.update(-1.0f, 0.0f, g_TimeStep));
+}
+
+int main()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_gains_follow_the_tuning_rules);
+	RUN_TEST(test_first_order_plants_with_dead_time);
+	RUN_TEST(test_integrating_plants);
+	RUN_TEST(test_noisy_plants);
+	RUN_TEST(test_relay_amplitude_adapts_to_the_target);
+	RUN_TEST(test_relay_amplitude_is_limited);
+	RUN_TEST(test_limit_fails_the_experiment);
+	RUN_TEST(test_timeout_fails_the_experiment);
+	RUN_TEST(test_idle_tuner_outputs_the_bias);
+	return UNITY_END();
+}
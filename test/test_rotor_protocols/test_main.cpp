@@ -0,0 +1,184 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#include "algorithms/RotorProtocols.hpp"
+
+#include <math.h>
+#include <unity.h>
+
+constexpr RotorProtocol g_DShotProtocols[] = {RotorProtocol::DShot150, RotorProtocol::DShot300, RotorProtocol::DShot600};
+constexpr uint32_t g_DShotBitRates[] = {150000, 300000, 600000};
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_dshot_frames_match_the_specification()
+{
+	// The frame is the value, the telemetry bit and the XOR of the three nibbles of both.
+	for (uint16_t value = 0; value <= g_DShotThrottleMaximum; value++)
+	{
+		for (uint16_t telemetry = 0; telemetry < 2; telemetry++)
+		{
+			const uint16_t data = static_cast<uint16_t>((value << 1) | telemetry);
+			const uint16_t expected = static_cast<uint16_t>((data << 4) | ((data ^ (data >> 4) ^ (data >> 8)) & 0x0F));
+			TEST_ASSERT_EQUAL_HEX16(expected, EncodeDShotFrame(value, telemetry != 0));
+
+			uint16_t decoded = 0;
+			TEST_ASSERT_TRUE(DecodeDShotFrame(expected, decoded));
+			TEST_ASSERT_EQUAL_UINT16(value, decoded);
+		}
+	}
+
+	TEST_ASSERT_EQUAL_HEX16(0x0000, EncodeDShotFrame(0));
+	TEST_ASSERT_EQUAL_HEX16(0x0606, EncodeDShotFrame(g_DShotThrottleMinimum));
+	TEST_ASSERT_EQUAL_HEX16(0xFFEE, EncodeDShotFrame(g_DShotThrottleMaximum));
+}
+
+void test_dshot_checksum_detects_single_bit_errors()
+{
+	for (uint16_t value = 0; value <= g_DShotThrottleMaximum; value++)
+	{
+		const auto frame = EncodeDShotFrame(value);
+		for (uint8_t bit = 0; bit < g_DShotFrameBits; bit++)
+		{
+			uint16_t decoded = 0;
+			TEST_ASSERT_FALSE(DecodeDShotFrame(static_cast<uint16_t>(frame ^ (1 << bit)), decoded));
+		}
+	}
+}
+
+void test_dshot_timing_tables()
+{
+	for (uint8_t i = 0; i < 3; i++)
+	{
+		const auto &timing = GetDShotTiming(g_DShotProtocols[i]);
+
+		// The bit period and the high times are rounded to the nearest tick.
+		TEST_ASSERT_UINT32_WITHIN(1, g_RotorPulseTickRate / g_DShotBitRates[i], timing.m_BitPeriod);
+		TEST_ASSERT_UINT32_WITHIN(1, (timing.m_BitPeriod * 3) / 8, timing.m_ZeroHigh);
+		TEST_ASSERT_UINT32_WITHIN(1, (timing.m_BitPeriod * 3) / 4, timing.m_OneHigh);
+		TEST_ASSERT_TRUE(timing.m_OneHigh < timing.m_BitPeriod);
+	}
+}
+
+void test_dshot_values_of_the_throttle()
+{
+	TEST_ASSERT_EQUAL_UINT16(0, GetDShotValue(0.0f));
+	TEST_ASSERT_EQUAL_UINT16(0, GetDShotValue(-0.5f));
+	TEST_ASSERT_EQUAL_UINT16(0, GetDShotValue(NAN));
+	TEST_ASSERT_EQUAL_UINT16(g_DShotThrottleMinimum, GetDShotValue(1e-6f));
+	TEST_ASSERT_EQUAL_UINT16(g_DShotThrottleMinimum + 1000, GetDShotValue(0.5f));
+	TEST_ASSERT_EQUAL_UINT16(g_DShotThrottleMaximum, GetDShotValue(1.0f));
+	TEST_ASSERT_EQUAL_UINT16(g_DShotThrottleMaximum, GetDShotValue(2.0f));
+
+	// The values never fall into the commands.
+	for (uint32_t i = 1; i <= 10000; i++)
+	{
+		const auto value = GetDShotValue(i / 10000.0f);
+		TEST_ASSERT_TRUE(value >= g_DShotThrottleMinimum && value <= g_DShotThrottleMaximum);
+	}
+}
+
+void test_dshot_pulses_round_trip()
+{
+	constexpr auto step = 1.0f / (g_DShotThrottleMaximum - g_DShotThrottleMinimum);
+
+	for (const auto protocol : g_DShotProtocols)
+	{
+		const auto &timing = GetDShotTiming(protocol);
+		for (uint32_t i = 0; i <= 10000; i++)
+		{
+			const auto throttle = i / 10000.0f;
+
+			RotorPulse pulses[g_MaxRotorPulses];
+			const auto count = EncodeRotorPulses(protocol, throttle, pulses);
+			TEST_ASSERT_EQUAL(g_DShotFrameBits, count);
+
+			for (size_t j = 0; j < count; j++)
+			{
+				TEST_ASSERT_EQUAL_UINT32(timing.m_BitPeriod, pulses[j].m_High + pulses[j].m_Low);
+				TEST_ASSERT_TRUE(pulses[j].m_High == timing.m_ZeroHigh || pulses[j].m_High == timing.m_OneHigh);
+			}
+
+			auto decoded = -1.0f;
+			TEST_ASSERT_TRUE(DecodeRotorPulses(protocol, pulses, count, decoded));
+			TEST_ASSERT_FLOAT_WITHIN(step * 0.5f + 1e-6f, throttle, decoded);
+		}
+	}
+}
+
+void test_oneshot125_pulses()
+{
+	RotorPulse pulses[g_MaxRotorPulses];
+	TEST_ASSERT_EQUAL(1, EncodeRotorPulses(RotorProtocol::OneShot125, 0.0f, pulses));
+	TEST_ASSERT_EQUAL_UINT16(g_OneShot125MinimumPulse, pulses[0].m_High);
+	TEST_ASSERT_EQUAL_UINT16(g_OneShot125Gap, pulses[0].m_Low);
+
+	// 125 us to 250 us at 12.5 ns per tick.
+	TEST_ASSERT_EQUAL_UINT32(125, (g_OneShot125MinimumPulse * 1000000ull) / g_RotorPulseTickRate);
+	TEST_ASSERT_EQUAL_UINT32(250, (g_OneShot125MaximumPulse * 1000000ull) / g_RotorPulseTickRate);
+
+	EncodeRotorPulses(RotorProtocol::OneShot125, 1.0f, pulses);
+	TEST_ASSERT_EQUAL_UINT16(g_OneShot125MaximumPulse, pulses[0].m_High);
+
+	EncodeRotorPulses(RotorProtocol::OneShot125, -1.0f, pulses);
+	TEST_ASSERT_EQUAL_UINT16(g_OneShot125MinimumPulse, pulses[0].m_High);
+
+	EncodeRotorPulses(RotorProtocol::OneShot125, 3.0f, pulses);
+	TEST_ASSERT_EQUAL_UINT16(g_OneShot125MaximumPulse, pulses[0].m_High);
+
+	constexpr auto step = 1.0f / (g_OneShot125MaximumPulse - g_OneShot125MinimumPulse);
+	for (uint32_t i = 0; i <= 10000; i++)
+	{
+		const auto throttle = i / 10000.0f;
+		const auto count = EncodeRotorPulses(RotorProtocol::OneShot125, throttle, pulses);
+
+		auto decoded = -1.0f;
+		TEST_ASSERT_TRUE(DecodeRotorPulses(RotorProtocol::OneShot125, pulses, count, decoded));
+		TEST_ASSERT_FLOAT_WITHIN(step * 0.5f + 1e-6f, throttle, decoded);
+	}
+}
+
+void test_invalid_pulses_are_rejected()
+{
+	RotorPulse pulses[g_MaxRotorPulses];
+	auto throttle = 0.0f;
+
+	// A OneShot125 pulse out of range, and a DShot frame with a missing bit.
+	pulses[0].m_High = g_OneShot125MaximumPulse + 1;
+	TEST_ASSERT_FALSE(DecodeRotorPulses(RotorProtocol::OneShot125, pulses, 1, throttle));
+	TEST_ASSERT_FALSE(DecodeRotorPulses(RotorProtocol::OneShot125, pulses, 2, throttle));
+
+	const auto count = EncodeRotorPulses(RotorProtocol::DShot600, 0.5f, pulses);
+	TEST_ASSERT_FALSE(DecodeRotorPulses(RotorProtocol::DShot600, pulses, count - 1, throttle));
+
+	// A damaged bit.
+	const auto &timing = GetDShotTiming(RotorProtocol::DShot600);
+	pulses[3].m_High = pulses[3].m_High == timing.m_OneHigh ? timing.m_ZeroHigh : timing.m_OneHigh;
+	TEST_ASSERT_FALSE(DecodeRotorPulses(RotorProtocol::DShot600, pulses, count, throttle));
+
+	// A command is not a throttle.
+	const auto frame = EncodeDShotFrame(10);
+	for (uint8_t i = 0; i < g_DShotFrameBits; i++)
+		pulses[i].m_High = (frame & (0x8000 >> i)) != 0 ? timing.m_OneHigh : timing.m_ZeroHigh;
+
+	TEST_ASSERT_FALSE(DecodeRotorPulses(RotorProtocol::DShot600, pulses, g_DShotFrameBits, throttle));
+}
+
+int main()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_dshot_frames_match_the_specification);
+	RUN_TEST(test_dshot_checksum_detects_single_bit_errors);
+	RUN_TEST(test_dshot_timing_tables);
+	RUN_TEST(test_dshot_values_of_the_throttle);
+	RUN_TEST(test_dshot_pulses_round_trip);
+	RUN_TEST(test_oneshot125_pulses);
+	RUN_TEST(test_invalid_pulses_are_rejected);
+	return UNITY_END();
+}
@@ -0,0 +1,251 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#include "core/Scheduler.hpp"
+
+#include <string.h>
+#include <unity.h>
+
+// The tick rate of the tested schedulers (1 ms ticks).
+constexpr auto g_TestTickRate = 1000;
+
+static uint32_t s_Time = 0;
+static uint32_t s_TickCount = 0;
+
+static char s_Order[32] = {};
+static uint8_t s_OrderSize = 0;
+
+/**
+ * @brief Get the time of the virtual clock.
+ *
+ * @return The time in microseconds.
+ */
+static uint32_t GetTime()
+{
+	return s_Time;
+}
+
+/**
+ * @brief Test system class.
+ * This counts its updates, writes its name to the update order and advances the virtual clock by its execution time.
+ */
+class TestSystem final : public ISystem
+{
+public:
+	/**
+	 * @brief Construct a new Test System object.
+	 *
+	 * @param name The name written to the update order.
+	 * @param executionTime The time an update takes in microseconds.
+	 */
+	explicit TestSystem(char name, uint32_t executionTime = 0) : m_ExecutionTime(executionTime), m_Name(name) {}
+
+	/**
+	 * @brief Update the system.
+	 */
+	void update() override
+	{
+		m_Updates++;
+		s_Time += m_ExecutionTime;
+
+		if (s_OrderSize < sizeof(s_Order) - 1)
+			s_Order[s_OrderSize++] = m_Name;
+	}
+
+	uint32_t m_Updates = 0;
+	uint32_t m_ExecutionTime = 0;
+
+private:
+	char m_Name = 0;
+};
+
+/**
+ * @brief Run ticks of the scheduler, released one base tick period apart like by the tick timer.
+ *
+ * @param scheduler The scheduler.
+ * @param count The number of ticks.
+ */
+static void RunTicks(Scheduler &scheduler, uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++)
+	{
+		s_Time = s_TickCount++ * scheduler.getTickPeriod();
+		scheduler.tick();
+	}
+}
+
+void setUp()
+{
+	s_Time = 0;
+	s_TickCount = 0;
+	s_OrderSize = 0;
+	memset(s_Order, 0, sizeof(s_Order));
+}
+
+void tearDown()
+{
+}
+
+void test_tasks_run_at_their_divider()
+{
+	Scheduler scheduler(g_TestTickRate, &GetTime);
+	TestSystem everyTick('a'), everySecondTick('b'), everyFourthTick('c');
+	TEST_ASSERT_TRUE(scheduler.addTask(&everyTick, 1));
+	TEST_ASSERT_TRUE(scheduler.addTask(&everySecondTick, 2));
+	TEST_ASSERT_TRUE(scheduler.addTask(&everyFourthTick, 4));
+
+	RunTicks(scheduler, 16);
+	TEST_ASSERT_EQUAL_UINT32(16, everyTick.m_Updates);
+	TEST_ASSERT_EQUAL_UINT32(8, everySecondTick.m_Updates);
+	TEST_ASSERT_EQUAL_UINT32(4, everyFourthTick.m_Updates);
+	TEST_ASSERT_EQUAL_UINT32(16, scheduler.getTickCount());
+	TEST_ASSERT_EQUAL_UINT32(0, scheduler.getMissedTicks());
+}
+
+void test_phase_spreads_the_releases()
+{
+	Scheduler scheduler(g_TestTickRate, &GetTime);
+	TestSystem first('a'), second('b'), third('c');
+	scheduler.addTask(&first, 4, 0);
+	scheduler.addTask(&second, 4, 1);
+	scheduler.addTask(&third, 4, 3);
+
+	RunTicks(scheduler, 8);
+	TEST_ASSERT_EQUAL_STRING("abcabc", s_Order);
+}
+
+void test_tasks_run_in_the_order_of_addition()
+{
+	Scheduler scheduler(g_TestTickRate, &GetTime);
+	TestSystem input('i'), output('o'), telemetry('t');
+	scheduler.addTask(&input, 1);
+	scheduler.addTask(&output, 1);
+	scheduler.addTask(&telemetry, 2);
+
+	RunTicks(scheduler, 2);
+	TEST_ASSERT_EQUAL_STRING("iotio", s_Order);
+}
+
+void test_invalid_tasks_are_rejected()
+{
+	Scheduler scheduler(g_TestTickRate, &GetTime);
+	TestSystem system('a');
+	TEST_ASSERT_FALSE(scheduler.addTask(nullptr, 1));
+	TEST_ASSERT_FALSE(scheduler.addTask(&system, 0));
+	TEST_ASSERT_FALSE(scheduler.addTask(&system, 2, 2));
+
+	for (auto i = 0; i < g_MaxScheduledTasks; i++)
+		TEST_ASSERT_TRUE(scheduler.addTask(&system, 1));
+
+	TEST_ASSERT_FALSE(scheduler.addTask(&system, 1));
+	TEST_ASSERT_EQUAL_UINT8(g_MaxScheduledTasks, scheduler.getTaskCount());
+}
+
+void test_missed_ticks_run_every_task_once()
+{
+	Scheduler scheduler(g_TestTickRate, &GetTime);
+	TestSystem everyTick('a'), everyFourthTick('b');
+	scheduler.addTask(&everyTick, 1);
+	scheduler.addTask(&everyFourthTick, 4);
+
+	scheduler.tick();
+	scheduler.tick(6);
+	TEST_ASSERT_EQUAL_UINT32(7, scheduler.getTickCount());
+	TEST_ASSERT_EQUAL_UINT32(5, scheduler.getMissedTicks());
+	TEST_ASSERT_EQUAL_UINT32(2, everyTick.m_Updates);
+	TEST_ASSERT_EQUAL_UINT32(5, scheduler.getStatistics(0).m_SkippedReleases);
+	TEST_ASSERT_EQUAL_UINT32(2, everyFourthTick.m_Updates);
+	TEST_ASSERT_EQUAL_UINT32(0, scheduler.getStatistics(1).m_SkippedReleases);
+
+	// The releases continue on the original grid.
+	scheduler.tick();
+	TEST_ASSERT_EQUAL_UINT32(2, everyFourthTick.m_Updates);
+	scheduler.tick();
+	TEST_ASSERT_EQUAL_UINT32(3, everyFourthTick.m_Updates);
+}
+
+void test_no_pending_ticks_does_nothing()
+{
+	Scheduler scheduler(g_TestTickRate, &GetTime);
+	TestSystem system('a'), idle('i');
+	scheduler.addTask(&system, 1);
+	scheduler.setIdleTask(&idle);
+
+	scheduler.tick(0);
+	TEST_ASSERT_EQUAL_UINT32(0, system.m_Updates);
+	TEST_ASSERT_EQUAL_UINT32(0, idle.m_Updates);
+	TEST_ASSERT_EQUAL_UINT32(0, scheduler.getTickCount());
+}
+
+void test_idle_task_runs_after_the_due_tasks()
+{
+	Scheduler scheduler(g_TestTickRate, &GetTime);
+	TestSystem system('a'), idle('i');
+	scheduler.addTask(&system, 2);
+	scheduler.setIdleTask(&idle);
+
+	RunTicks(scheduler, 4);
+	TEST_ASSERT_EQUAL_UINT32(4, idle.m_Updates);
+	TEST_ASSERT_EQUAL_STRING("aiiaii", s_Order);
+}
+
+void test_overruns_and_execution_times_are_measured()
+{
+	Scheduler scheduler(g_TestTickRate, &GetTime);
+	TestSystem fast('a', 100), slow('b', 500);
+	scheduler.addTask(&fast, 1);
+	scheduler.addTask(&slow, 1);
+
+	// The second task ends 600 us after the release, within the 1 ms period.
+	RunTicks(scheduler, 4);
+	TEST_ASSERT_EQUAL_UINT32(0, scheduler.getStatistics(1).m_Overruns);
+	TEST_ASSERT_EQUAL_UINT32(500, scheduler.getStatistics(1).m_MaxExecutionTime);
+
+	// Now it ends 1.1 ms after the release.
+	slow.m_ExecutionTime = 1000;
+	RunTicks(scheduler, 2);
+	TEST_ASSERT_EQUAL_UINT32(2, scheduler.getStatistics(1).m_Overruns);
+	TEST_ASSERT_EQUAL_UINT32(1000, scheduler.getStatistics(1).m_LastExecutionTime);
+	TEST_ASSERT_EQUAL_UINT32(0, scheduler.getStatistics(0).m_Overruns);
+
+	scheduler.resetStatistics();
+	TEST_ASSERT_EQUAL_UINT32(0, scheduler.getStatistics(1).m_Overruns);
+	TEST_ASSERT_EQUAL_UINT32(0, scheduler.getStatistics(1).m_Runs);
+}
+
+void test_jitter_is_the_deviation_from_the_period()
+{
+	Scheduler scheduler(g_TestTickRate, &GetTime);
+	TestSystem first('a', 0), second('b', 0);
+	scheduler.addTask(&first, 1);
+	scheduler.addTask(&second, 1);
+
+	RunTicks(scheduler, 2);
+
+	// The first task takes 200 us on the third tick, so the second one starts 200 us late, and on time again on the fourth.
+	first.m_ExecutionTime = 200;
+	RunTicks(scheduler, 1);
+	first.m_ExecutionTime = 0;
+	RunTicks(scheduler, 1);
+
+	const auto &statistics = scheduler.getStatistics(1);
+	TEST_ASSERT_EQUAL_INT32(200, statistics.m_MaxJitter);
+	TEST_ASSERT_EQUAL_INT32(-200, statistics.m_MinJitter);
+	TEST_ASSERT_EQUAL_UINT32(400, statistics.m_AbsoluteJitterSum);
+	TEST_ASSERT_EQUAL_INT32(0, scheduler.getStatistics(0).m_MaxJitter);
+}
+
+int main()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_tasks_run_at_their_divider);
+	RUN_TEST(test_phase_spreads_the_releases);
+	RUN_TEST(test_tasks_run_in_the_order_of_addition);
+	RUN_TEST(test_invalid_tasks_are_rejected);
+	RUN_TEST(test_missed_ticks_run_every_task_once);
+	RUN_TEST(test_no_pending_ticks_does_nothing);
+	RUN_TEST(test_idle_task_runs_after_the_due_tasks);
+	RUN_TEST(test_overruns_and_execution_times_are_measured);
+	RUN_TEST(test_jitter_is_the_deviation_from_the_period);
+	return UNITY_END();
+}
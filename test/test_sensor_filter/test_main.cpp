@@ -0,0 +1,326 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#include "algorithms/BiquadFilter.hpp"
+#include "algorithms/SensorFilter.hpp"
+#include "algorithms/SpectrumAnalyzer.hpp"
+#include "core/Constants.hpp"
+
+#include <math.h>
+#include <unity.h>
+
+// The number of samples of every accuracy check.
+constexpr auto g_AccuracySamples = 100000;
+
+constexpr auto g_SampleRate = static_cast<double>(g_SensorSampleRate);
+
+/**
+ * @brief Reference biquad filter structure.
+ * This is a double precision filter in the direct form I. It's designed from the analog prototype using the bilinear transform,
+ * independently of the audio EQ cookbook formulas of the firmware.
+ */
+struct ReferenceBiquad final
+{
+	/**
+	 * @brief Construct a new Reference Biquad object.
+	 * The prototype is H(s) = (s^2 + 1) / (s^2 + s / q + 1) for a notch and H(s) = 1 / (s^2 + s / q + 1) for a low pass filter. The
+	 * frequency is prewarped so that it's exact after the transform.
+	 *
+	 * @param frequency The cutoff or center frequency in hertz.
+	 * @param sampleRate The sample rate in hertz.
+	 * @param q The quality factor.
+	 * @param isNotch Whether the filter is a notch.
+	 */
+	ReferenceBiquad(double frequency, double sampleRate, double q, bool isNotch)
+	{
+		const auto k = tan(M_PI * frequency / sampleRate);
+		const auto scale = 1.0 / (1.0 + (k / q) + (k * k));
+
+		m_B[0] = (isNotch ? 1.0 + (k * k) : k * k) * scale;
+		m_B[1] = (isNotch ? 2.0 * ((k * k) - 1.0) : 2.0 * k * k) * scale;
+		m_B[2] = m_B[0];
+		m_A[0] = 2.0 * ((k * k) - 1.0) * scale;
+		m_A[1] = (1.0 - (k / q) + (k * k)) * scale;
+	}
+
+	/**
+	 * @brief Filter a sample.
+	 *
+	 * @param input The input sample.
+	 * @return The output sample.
+	 */
+	double apply(double input)
+	{
+		const auto output = (m_B[0] * input) + (m_B[1] * m_Inputs[0]) + (m_B[2] * m_Inputs[1]) - (m_A[0] * m_Outputs[0]) - (m_A[1] * m_Outputs[1]);
+		m_Inputs[1] = m_Inputs[0];
+		m_Inputs[0] = input;
+		m_Outputs[1] = m_Outputs[0];
+		m_Outputs[0] = output;
+		return output;
+	}
+
+	double m_B[3] = {};
+	double m_A[2] = {};
+	double m_Inputs[2] = {};
+	double m_Outputs[2] = {};
+};
+
+/**
+ * @brief Get the maximum error of biquad filters on chirps.
+ * Every chirp sweeps logarithmically from 1 Hz to just below half of the sample rate with an amplitude of 1, and is filtered by the
+ * firmware's filter and the reference filter.
+ *
+ * @param frequencies The cutoff or center frequencies of the filters, one chirp per filter.
+ * @param qs The quality factors of the filters.
+ * @param count The number of filters.
+ * @param isNotch Whether the filters are notches, instead of low pass filters.
+ * @return The maximum absolute difference of the outputs.
+ */
+static double GetMaximumBiquadError(const double *frequencies, const double *qs, uint32_t count, bool isNotch)
+{
+	const auto chirpLength = g_AccuracySamples / count;
+
+	auto maximumError = 0.0;
+	for (uint32_t i = 0; i < count; i++)
+	{
+		BiquadFilter filter;
+		filter.setCoefficients(isNotch ? ComputeNotchCoefficients(static_cast<float>(frequencies[i]), g_SensorSampleRate, static_cast<float>(qs[i])) : ComputeLowPassCoefficients(static_cast<float>(frequencies[i]), g_SensorSampleRate, static_cast<float>(qs[i])));
+		ReferenceBiquad reference(frequencies[i], g_SampleRate, qs[i], isNotch);
+
+		auto phase = 0.0;
+		for (uint32_t j = 0; j < chirpLength; j++)
+		{
+			phase += 2.0 * M_PI * pow(g_SampleRate * 0.499, static_cast<double>(j) / chirpLength) / g_SampleRate;
+
+			const auto input = sin(phase);
+			maximumError = fmax(maximumError, fabs(static_cast<double>(filter.apply(static_cast<float>(input))) - reference.apply(input)));
+		}
+	}
+
+	return maximumError;
+}
+
+/**
+ * @brief Run a spectrum analysis to completion.
+ *
+ * @param analyzer The analyzer.
+ */
+static void CompleteAnalysis(SpectrumAnalyzer &analyzer)
+{
+	while (!analyzer.step())
+	{
+	}
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_low_pass_matches_the_reference()
+{
+	constexpr double cutoffs[] = {20.0, g_GyroscopeLowPassCutoff, 250.0, 450.0};
+	constexpr double qs[] = {g_ButterworthQ, g_ButterworthQ, g_ButterworthQ, g_ButterworthQ};
+	TEST_ASSERT_FLOAT_WITHIN(g_BiquadMaximumError, 0.0f, static_cast<float>(GetMaximumBiquadError(cutoffs, qs, 4, false)));
+}
+
+void test_notch_matches_the_reference()
+{
+	constexpr double centers[] = {50.0, 150.0, 300.0, 450.0};
+	constexpr double qs[] = {g_StaticNotchQ, g_DynamicNotchQ, 1.0, 10.0};
+	TEST_ASSERT_FLOAT_WITHIN(g_BiquadMaximumError, 0.0f, static_cast<float>(GetMaximumBiquadError(centers, qs, 4, true)));
+}
+
+void test_spectrum_matches_a_dft()
+{
+	double cosines[g_SpectrumWindowSize];
+	double sines[g_SpectrumWindowSize];
+	for (uint32_t j = 0; j < g_SpectrumWindowSize; j++)
+	{
+		cosines[j] = cos(2.0 * M_PI * j / g_SpectrumWindowSize);
+		sines[j] = sin(2.0 * M_PI * j / g_SpectrumWindowSize);
+	}
+
+	// Every window has two tones with some noise and an offset. The error is relative to the largest magnitude of the window.
+	SpectrumAnalyzer analyzer;
+	auto maximumError = 0.0;
+	for (uint32_t window = 0; window < g_AccuracySamples / g_SpectrumBinCount; window++)
+	{
+		const auto first = 2.0 * M_PI * (20.0 + (window % 450)) / g_SampleRate;
+		const auto second = 2.0 * M_PI * (100.0 + ((window * 7) % 380)) / g_SampleRate;
+
+		uint32_t noise = window;
+		double samples[g_SpectrumWindowSize];
+		for (uint32_t j = 0; j < g_SpectrumWindowSize; j++)
+		{
+			noise = (noise * 1103515245u) + 12345u;
+			samples[j] = (30.0 * sin(first * j)) + (5.0 * sin((second * j) + window)) + (static_cast<double>(static_cast<int32_t>(noise >> 16) % 100) * 0.01) + 2.0;
+			analyzer.addSample(static_cast<float>(samples[j]));
+		}
+
+		CompleteAnalysis(analyzer);
+		analyzer.computePowers();
+
+		double magnitudes[g_SpectrumBinCount];
+		auto largest = 1.0;
+		for (uint32_t k = 0; k < g_SpectrumBinCount; k++)
+		{
+			auto real = 0.0;
+			auto imaginary = 0.0;
+			for (uint32_t j = 0; j < g_SpectrumWindowSize; j++)
+			{
+				const auto value = samples[j] * (1.0 - cosines[j]) * (2.0 / g_SpectrumWindowSize);
+				real += value * cosines[(k * j) % g_SpectrumWindowSize];
+				imaginary -= value * sines[(k * j) % g_SpectrumWindowSize];
+			}
+
+			magnitudes[k] = sqrt((real * real) + (imaginary * imaginary));
+			largest = fmax(largest, magnitudes[k]);
+		}
+
+		for (uint32_t k = 0; k < g_SpectrumBinCount; k++)
+			maximumError = fmax(maximumError, fabs(sqrt(static_cast<double>(analyzer.getPower(k))) - magnitudes[k]) / largest);
+	}
+
+	TEST_ASSERT_FLOAT_WITHIN(g_SpectrumMaximumError, 0.0f, static_cast<float>(maximumError));
+}
+
+void test_peak_frequency_of_a_tone()
+{
+	constexpr auto binWidth = g_SampleRate / g_SpectrumWindowSize;
+	constexpr auto minimum = static_cast<double>(g_DynamicNotchMinimum);
+	constexpr auto maximum = static_cast<double>(g_DynamicNotchMaximum);
+
+	SpectrumAnalyzer analyzer;
+	analyzer.configure(g_SensorSampleRate, g_DynamicNotchMinimum, g_DynamicNotchMaximum);
+
+	// A single tone sweeps over the range of the dynamic notch, starting at a different phase every time.
+	auto maximumError = 0.0;
+	constexpr auto toneCount = 5000;
+	for (uint32_t i = 0; i < toneCount; i++)
+	{
+		const auto frequency = minimum + ((maximum - minimum) * i / toneCount);
+		const auto phase = 2.0 * M_PI * frequency / g_SampleRate;
+		for (uint32_t j = 0; j < g_SpectrumWindowSize; j++)
+			analyzer.addSample(static_cast<float>(10.0 * sin((phase * j) + (i * 2.4))));
+
+		CompleteAnalysis(analyzer);
+		maximumError = fmax(maximumError, fabs(static_cast<double>(analyzer.getPeakFrequency()) - frequency) / binWidth);
+	}
+
+	TEST_ASSERT_FLOAT_WITHIN(g_SpectrumPeakMaximumError, 0.0f, static_cast<float>(maximumError));
+}
+
+void test_no_peak_in_noise()
+{
+	SpectrumAnalyzer analyzer;
+	analyzer.configure(g_SensorSampleRate, g_DynamicNotchMinimum, g_DynamicNotchMaximum);
+
+	uint32_t noise = 1;
+	for (uint32_t j = 0; j < g_SpectrumWindowSize; j++)
+	{
+		noise = (noise * 1103515245u) + 12345u;
+		analyzer.addSample(static_cast<float>(static_cast<int32_t>(noise >> 16) % 100) * 0.01f);
+	}
+
+	CompleteAnalysis(analyzer);
+	TEST_ASSERT_EQUAL_FLOAT(0.0f, analyzer.getPeakFrequency());
+}
+
+void test_analysis_takes_a_step_per_sample()
+{
+	SpectrumAnalyzer analyzer;
+	analyzer.configure(g_SensorSampleRate, g_DynamicNotchMinimum, g_DynamicNotchMaximum);
+
+	for (uint32_t i = 0; i < g_SpectrumStepCount - 1; i++)
+		TEST_ASSERT_FALSE(analyzer.step());
+
+	TEST_ASSERT_TRUE(analyzer.step());
+	TEST_ASSERT_FALSE(analyzer.step());
+}
+
+void test_sensor_filter_places_the_dynamic_notch()
+{
+	// A 230 Hz rotor vibration on the roll rate.
+	constexpr auto vibration = 230.0;
+
+	SensorFilter filter;
+	IMUSample sample;
+	sample.m_DeltaTime = 1.0f / g_SensorSampleRate;
+
+	auto residual = 0.0f;
+	for (uint32_t i = 0; i < g_SensorSampleRate; i++)
+	{
+		sample.m_Rate.m_X = static_cast<float>(20.0 * sin(2.0 * M_PI * vibration * i / g_SampleRate));
+		const auto filtered = filter.apply(sample);
+
+		// The last quarter of a second, after the notch settled.
+		if (i >= g_SensorSampleRate * 3 / 4)
+			residual = fmaxf(residual, fabsf(filtered.m_Rate.m_X));
+	}
+
+	TEST_ASSERT_FLOAT_WITHIN(2.0f, static_cast<float>(vibration), filter.getDynamicNotchFrequencies().m_X);
+	TEST_ASSERT_TRUE(residual < 1.0f);
+
+	// The other axes had no peak.
+	TEST_ASSERT_EQUAL_FLOAT(0.0f, filter.getDynamicNotchFrequencies().m_Y);
+	TEST_ASSERT_EQUAL_FLOAT(0.0f, filter.getDynamicNotchFrequencies().m_Z);
+}
+
+void test_sensor_filter_passes_a_constant()
+{
+	SensorFilter filter;
+	IMUSample sample;
+	sample.m_Acceleration = Vec3(0.5f, -0.25f, g_StandardGravity);
+	sample.m_Rate = Vec3(10.0f, -5.0f, 2.0f);
+	sample.m_DeltaTime = 1.0f / g_SensorSampleRate;
+
+	IMUSample filtered;
+	for (uint32_t i = 0; i < g_SensorSampleRate; i++)
+		filtered = filter.apply(sample);
+
+	TEST_ASSERT_FLOAT_WITHIN(1e-3f, sample.m_Acceleration.m_Z, filtered.m_Acceleration.m_Z);
+	TEST_ASSERT_FLOAT_WITHIN(1e-3f, sample.m_Acceleration.m_X, filtered.m_Acceleration.m_X);
+	TEST_ASSERT_FLOAT_WITHIN(1e-3f, sample.m_Rate.m_X, filtered.m_Rate.m_X);
+	TEST_ASSERT_FLOAT_WITHIN(1e-3f, sample.m_Rate.m_Y, filtered.m_Rate.m_Y);
+	TEST_ASSERT_FLOAT_WITHIN(1e-6f, sample.m_DeltaTime, filtered.m_DeltaTime);
+}
+
+void test_sensor_filter_disabled_passes_through()
+{
+	SensorFilterSettings settings;
+	settings.m_GyroscopeLowPassCutoff = 0.0f;
+	settings.m_AccelerometerLowPassCutoff = 0.0f;
+	settings.m_isDynamicNotchEnabled = false;
+
+	SensorFilter filter;
+	filter.configure(settings);
+
+	IMUSample sample;
+	for (uint32_t i = 0; i < 100; i++)
+	{
+		sample.m_Rate.m_X = static_cast<float>(i % 7) - 3.0f;
+		sample.m_Acceleration.m_Y = static_cast<float>(i % 5);
+		const auto filtered = filter.apply(sample);
+		TEST_ASSERT_EQUAL_FLOAT(sample.m_Rate.m_X, filtered.m_Rate.m_X);
+		TEST_ASSERT_EQUAL_FLOAT(sample.m_Acceleration.m_Y, filtered.m_Acceleration.m_Y);
+	}
+}
+
+int main()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_low_pass_matches_the_reference);
+	RUN_TEST(test_notch_matches_the_reference);
+	RUN_TEST(test_spectrum_matches_a_dft);
+	RUN_TEST(test_peak_frequency_of_a_tone);
+	RUN_TEST(test_no_peak_in_noise);
+	RUN_TEST(test_analysis_takes_a_step_per_sample);
+	RUN_TEST(test_sensor_filter_places_the_dynamic_notch);
+	RUN_TEST(test_sensor_filter_passes_a_constant);
+	RUN_TEST(test_sensor_filter_disabled_passes_through);
+	return UNITY_END();
+}
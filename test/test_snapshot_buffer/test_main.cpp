@@ -0,0 +1,184 @@
+// Copyright 2023 Dhiraj Wishal
+// SPDX-License-Identifier: Apache-2.0
+
+#include "core/SnapshotBuffer.hpp"
+
+#include <atomic>
+#include <thread>
+#include <unity.h>
+
+// The number of snapshots published by the stress test.
+constexpr uint32_t g_StressSnapshotCount = 1000000;
+
+// The number of words of a stress test snapshot. It's large, so a torn copy is likely to be seen.
+constexpr auto g_StressSnapshotSize = 16;
+
+/**
+ * @brief Stress snapshot structure.
+ * Every word of a snapshot is derived from its sequence number, so a snapshot mixed from two publishes is detected.
+ */
+struct StressSnapshot final
+{
+	uint32_t m_Sequence = 0;
+	uint32_t m_Words[g_StressSnapshotSize] = {};
+};
+
+/**
+ * @brief Create a stress snapshot.
+ *
+ * @param sequence The sequence number.
+ * @return The snapshot.
+ */
+static StressSnapshot CreateSnapshot(uint32_t sequence)
+{
+	StressSnapshot snapshot;
+	snapshot.m_Sequence = sequence;
+	for (uint32_t i = 0; i < g_StressSnapshotSize; i++)
+		snapshot.m_Words[i] = (sequence * 2654435761u) ^ i;
+
+	return snapshot;
+}
+
+/**
+ * @brief Check if a stress snapshot is intact.
+ * The consumer can read before the first publish, which returns the empty snapshot (sequence number 0, all words 0).
+ *
+ * @param snapshot The snapshot.
+ * @return true If every word matches the sequence number.
+ * @return false If the snapshot is torn.
+ */
+static bool IsIntact(const StressSnapshot &snapshot)
+{
+	for (uint32_t i = 0; i < g_StressSnapshotSize; i++)
+	{
+		const auto expected = snapshot.m_Sequence == 0 ? 0 : ((snapshot.m_Sequence * 2654435761u) ^ i);
+		if (snapshot.m_Words[i] != expected)
+			return false;
+	}
+
+	return true;
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_read_before_publish_is_not_fresh()
+{
+	SnapshotBuffer<int> buffer;
+	TEST_ASSERT_FALSE(buffer.isFresh());
+
+	auto value = -1;
+	TEST_ASSERT_FALSE(buffer.read(value));
+	TEST_ASSERT_EQUAL_INT(0, value);
+}
+
+void test_published_snapshot_is_read_once()
+{
+	SnapshotBuffer<int> buffer;
+	buffer.publish(42);
+	TEST_ASSERT_TRUE(buffer.isFresh());
+
+	auto value = 0;
+	TEST_ASSERT_TRUE(buffer.read(value));
+	TEST_ASSERT_EQUAL_INT(42, value);
+	TEST_ASSERT_FALSE(buffer.isFresh());
+
+	// The same snapshot is returned again, but not as fresh.
+	value = 0;
+	TEST_ASSERT_FALSE(buffer.read(value));
+	TEST_ASSERT_EQUAL_INT(42, value);
+}
+
+void test_read_returns_the_latest_snapshot()
+{
+	SnapshotBuffer<int> buffer;
+	for (auto i = 1; i <= 10; i++)
+		buffer.publish(i);
+
+	auto value = 0;
+	TEST_ASSERT_TRUE(buffer.read(value));
+	TEST_ASSERT_EQUAL_INT(10, value);
+
+	buffer.publish(11);
+	buffer.publish(12);
+	TEST_ASSERT_TRUE(buffer.read(value));
+	TEST_ASSERT_EQUAL_INT(12, value);
+	TEST_ASSERT_FALSE(buffer.read(value));
+	TEST_ASSERT_EQUAL_INT(12, value);
+}
+
+void test_alternating_publish_and_read()
+{
+	SnapshotBuffer<int> buffer;
+	auto value = 0;
+	for (auto i = 1; i <= 100; i++)
+	{
+		buffer.publish(i);
+		TEST_ASSERT_TRUE(buffer.read(value));
+		TEST_ASSERT_EQUAL_INT(i, value);
+	}
+}
+
+void test_concurrent_snapshots_are_never_torn()
+{
+	static SnapshotBuffer<StressSnapshot> buffer;
+	std::atomic<bool> isDone = {false};
+
+	std::thread producer([&isDone]()
+						 {
+		for (uint32_t sequence = 1; sequence <= g_StressSnapshotCount; sequence++)
+			buffer.publish(CreateSnapshot(sequence));
+
+		isDone.store(true, std::memory_order_release); });
+
+	uint32_t reads = 0;
+	uint32_t freshReads = 0;
+	uint32_t tornReads = 0;
+	uint32_t outOfOrderReads = 0;
+	uint32_t previousSequence = 0;
+
+	StressSnapshot snapshot;
+	auto isFinished = false;
+	while (!isFinished)
+	{
+		// Read once more after the producer finished, so the last snapshot is seen.
+		isFinished = isDone.load(std::memory_order_acquire);
+
+		const auto isFresh = buffer.read(snapshot);
+		reads++;
+
+		if (!IsIntact(snapshot))
+			tornReads++;
+
+		// A fresh snapshot is always newer than the previous one, and a stale one is the same.
+		if (isFresh ? snapshot.m_Sequence <= previousSequence : snapshot.m_Sequence != previousSequence)
+			outOfOrderReads++;
+
+		freshReads += isFresh ? 1 : 0;
+		previousSequence = snapshot.m_Sequence;
+	}
+
+	producer.join();
+
+	TEST_ASSERT_EQUAL_UINT32(0, tornReads);
+	TEST_ASSERT_EQUAL_UINT32(0, outOfOrderReads);
+	TEST_ASSERT_EQUAL_UINT32(g_StressSnapshotCount, previousSequence);
+	TEST_ASSERT_GREATER_THAN_UINT32(1, freshReads);
+	TEST_ASSERT_GREATER_OR_EQUAL_UINT32(freshReads, reads);
+}
+
+int main()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_read_before_publish_is_not_fresh);
+	RUN_TEST(test_published_snapshot_is_read_once);
+	RUN_TEST(test_read_returns_the_latest_snapshot);
+	RUN_TEST(test_alternating_publish_and_read);
+	RUN_TEST(test_concurrent_snapshots_are_never_torn);
+	return UNITY_END();
+}